@@ -0,0 +1,117 @@
+/****************************************************************************************************************************
+  BlockSampler.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Samples PORTD at 20kHz with TimerInterrupt_Generic_Sampler.h. The ITimer1 ISR only reads the port into a block of
+  256 samples, and loop() measures the frequency and duty cycle of the signal on D2 (PD2) one block (12.8ms) at a
+  time. Wire D9 to D2 : the 1kHz tone() on D9 is measured.
+  Port reads are used since analogRead() takes ~110us on AVR, too slow for 20kHz.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Sampler.h"
+
+#define SAMPLE_FREQ_HZ            20000
+#define BLOCK_SIZE                256
+
+#define SIGNAL_MASK               _BV(PD2)
+
+#define TONE_PIN                  9
+#define TONE_FREQ_HZ              1000
+
+uint8_t readPort()
+{
+  return PIND;
+}
+
+TISR_BlockSampler<uint8_t, BLOCK_SIZE, readPort> sampler;
+
+uint32_t  numRising   = 0;
+uint32_t  numHigh     = 0;
+uint32_t  numSamples  = 0;
+uint8_t   lastSample  = 0;
+
+void TimerHandler()
+{
+  sampler.update();
+}
+
+// One call per 256 samples, in loop()
+void processBlock(const uint8_t* samples, const uint16_t& count, const uint32_t& baseMicros)
+{
+  (void) baseMicros;
+
+  for (uint16_t i = 0; i < count; i++)
+  {
+    uint8_t sample = samples[i] & SIGNAL_MASK;
+
+    if (sample)
+    {
+      numHigh++;
+
+      if (!lastSample)
+        numRising++;
+    }
+
+    lastSample = sample;
+  }
+
+  numSamples += count;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting BlockSampler on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  pinMode(2, INPUT);
+  tone(TONE_PIN, TONE_FREQ_HZ);
+
+  sampler.begin(processBlock);
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterrupt(SAMPLE_FREQ_HZ, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+}
+
+void loop()
+{
+  static unsigned long lastPrint = 0;
+
+  sampler.run();
+
+  if ( (millis() - lastPrint > 1000) && (numSamples > 0) )
+  {
+    lastPrint = millis();
+
+    Serial.print(F("Freq = "));         Serial.print( (float) numRising * SAMPLE_FREQ_HZ / numSamples, 1);
+    Serial.print(F(" Hz, duty = "));    Serial.print( (float) numHigh * 100 / numSamples, 1);
+    Serial.print(F(" %, blocks = "));   Serial.print(sampler.getNumBlocks());
+    Serial.print(F(", overruns = "));   Serial.println(sampler.getNumOverruns());
+
+    numRising   = 0;
+    numHigh     = 0;
+    numSamples  = 0;
+  }
+}
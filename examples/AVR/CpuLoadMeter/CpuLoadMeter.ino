@@ -0,0 +1,150 @@
+/****************************************************************************************************************************
+  CpuLoadMeter.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Demonstrates the optional CPU utilization meter (TISR_LOAD_ENABLE). loop() calls TISR_LoadMeter.idle() whenever it has
+  nothing to do, and a 1s ISR_Timer callback closes each measurement window. The idle() cost is calibrated in setup(),
+  before the application load starts.
+
+  Every window prints the total CPU load and the share of the ITimer1 ISR and of the ISR_Timer callbacks. Send a
+  character over Serial to change the simulated application load :
+    '0' : none
+    '1' : ~25%
+    '2' : ~50%
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define TISR_LOAD_ENABLE              true
+
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt_Generic.h"
+#include "ISR_Timer_Generic.h"
+
+#define HW_TIMER_INTERVAL_MS          1L
+
+#define LOAD_WINDOW_MS                1000L
+
+ISR_Timer ISR_timer;
+
+// Simulated application work per 10ms, in us
+uint16_t workPer10ms = 0;
+
+void TimerHandler()
+{
+  ISR_timer.run();
+}
+
+void doingSomething()
+{
+  delayMicroseconds(50);
+}
+
+void closeLoadWindow()
+{
+  TISR_LoadMeter.onWindow();
+}
+
+void printLoad(const __FlashStringHelper* name, const uint16_t& load)
+{
+  Serial.print(name);
+  Serial.print(load / 100);
+  Serial.print('.');
+
+  if ( (load % 100) < 10)
+    Serial.print('0');
+
+  Serial.print(load % 100);
+  Serial.print(F("%"));
+}
+
+void checkCommand()
+{
+  if (Serial.available())
+  {
+    switch (Serial.read())
+    {
+      case '0':
+        workPer10ms = 0;
+        break;
+
+      case '1':
+        workPer10ms = 2500;
+        break;
+
+      case '2':
+        workPer10ms = 5000;
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting CpuLoadMeter on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterruptInterval(HW_TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+  ISR_timer.setInterval(5L, doingSomething);
+
+  // Unloaded baseline, with the timers already running
+  Serial.flush();
+  TISR_LoadMeter.calibrate(500);
+
+  Serial.print(F("idle() cost = ")); Serial.print(TISR_LoadMeter.getIdleCost() / 256.0f); Serial.println(F(" us"));
+
+  TISR_LoadMeter.begin();
+  ISR_timer.setInterval(LOAD_WINDOW_MS, closeLoadWindow);
+}
+
+void loop()
+{
+  static unsigned long lastWork = 0;
+
+  checkCommand();
+
+  if ( (workPer10ms > 0) && (millis() - lastWork >= 10) )
+  {
+    lastWork = millis();
+
+    delayMicroseconds(workPer10ms);
+  }
+  else
+  {
+    TISR_LoadMeter.idle();
+  }
+
+  tisr_load_window_t window;
+
+  if (TISR_LoadMeter.getWindow(window))
+  {
+    printLoad(F("CPU load = "),         window.cpuLoad);
+    printLoad(F(", ITimer1 ISR = "),    window.hwTimerLoad);
+    printLoad(F(", ISR_Timer callbacks = "), window.callbackLoad);
+    Serial.println();
+  }
+}
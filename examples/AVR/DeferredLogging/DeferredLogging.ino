@@ -0,0 +1,64 @@
+/****************************************************************************************************************************
+  DeferredLogging.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Demonstrates the deferred, ISR-safe TISR_LOGxxx backend (TISR_LOG_DEFERRED).
+
+  With _TIMERINTERRUPT_LOGLEVEL_ 4, ISR(TIMER1_COMPA_vect) logs every callback. With the direct backend this prints
+  from inside the ISR, changes the timer timing completely and can hang on a full UART buffer. With the deferred
+  backend the ISR only queues a small record, and loop() prints the pending records with TISR_LOG_FLUSH().
+
+  Set TISR_LOG_DEFERRED_BINARY true to send compact binary records instead of text, and decode them on the host with
+  extras/log/tisr_log_decode and the sketch's ELF file.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// With TISR_LOG_DEFERRED, _TIMERINTERRUPT_LOGLEVEL_ 4 is safe to use from ISRs
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     4
+
+#define TISR_LOG_DEFERRED             true
+#define TISR_LOG_DEFERRED_BINARY      false
+
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt_Generic.h"
+
+#define TIMER1_INTERVAL_MS    100
+
+volatile uint32_t timer1Count = 0;
+
+void TimerHandler1()
+{
+  timer1Count++;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting DeferredLogging on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterruptInterval(TIMER1_INTERVAL_MS, TimerHandler1))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+}
+
+void loop()
+{
+  // Print what the library logged since the last call, including from ISR(TIMER1_COMPA_vect)
+  TISR_LOG_FLUSH();
+}
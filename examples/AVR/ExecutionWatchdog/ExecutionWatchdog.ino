@@ -0,0 +1,146 @@
+/****************************************************************************************************************************
+  ExecutionWatchdog.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Demonstrates the optional execution-budget watchdog (TISR_WATCHDOG_ENABLE) on the ISR_Timer callbacks run from ITimer1.
+
+  - slowCallback() overruns its 500us budget every 10th run. Its action is TISR_WATCHDOG_SKIP, so after the first
+    overrun it isn't called anymore, until 'u' is sent over Serial
+  - stuckCallback() never returns once 'h' is sent over Serial. The AVR hardware watchdog, armed around every budgeted
+    callback (TISR_WATCHDOG_USE_WDT), resets the board, and the next boot reports which callback was stuck
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define TISR_WATCHDOG_ENABLE          true
+#define TISR_WATCHDOG_USE_WDT         true
+
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt_Generic.h"
+#include "ISR_Timer_Generic.h"
+
+#define HW_TIMER_INTERVAL_MS          1L
+
+ISR_Timer ISR_timer;
+
+int slowTimer;
+int stuckTimer;
+
+volatile bool hangRequested = false;
+
+void TimerHandler()
+{
+  ISR_timer.run();
+}
+
+void slowCallback()
+{
+  static uint8_t runs = 0;
+
+  if (++runs >= 10)
+  {
+    runs = 0;
+    delayMicroseconds(1200);
+  }
+  else
+    delayMicroseconds(100);
+}
+
+void stuckCallback()
+{
+  while (hangRequested);
+}
+
+void printSource(const uint8_t& source)
+{
+  if (source >= TISR_WATCHDOG_CALLBACK(0))
+  {
+    Serial.print(F("ISR_Timer callback ")); Serial.print(source - TISR_WATCHDOG_CALLBACK(0));
+  }
+  else
+  {
+    Serial.print(F("ITimer")); Serial.print(source);
+  }
+}
+
+void setup()
+{
+  // First, before the watchdog reset leftovers are overwritten
+  TISR_Watchdog.begin();
+
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting ExecutionWatchdog on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  if (TISR_Watchdog.getResetSource() != TISR_WATCHDOG_NO_SOURCE)
+  {
+    Serial.print(F("Last reset while running "));
+    printSource(TISR_Watchdog.getResetSource());
+    Serial.println();
+  }
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterruptInterval(HW_TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+  slowTimer   = ISR_timer.setInterval(5L, slowCallback);
+  stuckTimer  = ISR_timer.setInterval(100L, stuckCallback);
+
+  TISR_Watchdog.setBudget(TISR_WATCHDOG_CALLBACK(slowTimer),  500, TISR_WATCHDOG_SKIP);
+  TISR_Watchdog.setBudget(TISR_WATCHDOG_CALLBACK(stuckTimer), 500, TISR_WATCHDOG_LOG);
+
+  Serial.println(F("Send 'h' to hang stuckCallback(), 'u' to unskip slowCallback()"));
+}
+
+void loop()
+{
+  static uint32_t numViolations = 0;
+
+  if (Serial.available())
+  {
+    switch (Serial.read())
+    {
+      case 'h':
+        hangRequested = true;
+        break;
+
+      case 'u':
+        TISR_Watchdog.unskip(TISR_WATCHDOG_CALLBACK(slowTimer));
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  tisr_watchdog_violation_t violation;
+
+  if ( (TISR_Watchdog.getNumViolations() != numViolations) && TISR_Watchdog.getLastViolation(violation) )
+  {
+    numViolations = TISR_Watchdog.getNumViolations();
+
+    Serial.print(F("Violation #")); Serial.print(numViolations);
+    Serial.print(F(" : "));
+    printSource(violation.source);
+    Serial.print(F(" ran ")); Serial.print(violation.elapsedUs);
+    Serial.print(F(" us at millis() = ")); Serial.print(violation.millis);
+    Serial.println( (violation.action == TISR_WATCHDOG_SKIP) ? F(", now skipped") : F("") );
+  }
+}
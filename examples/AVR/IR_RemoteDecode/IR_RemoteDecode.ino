@@ -0,0 +1,96 @@
+/****************************************************************************************************************************
+  IR_RemoteDecode.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  IR remote decoder and sender with TimerInterrupt_Generic_IR.h. On a 328(P) board :
+    IR receiver module (TSOP38238, VS1838B, ...) output on D8 (ICP1) : the edges are timestamped by the Timer1 capture
+    IR LED, through a transistor, on D3 (OC2B) : the 38kHz carrier from Timer2
+  The NEC, Sony and RC5 frames received are printed. A NEC frame, then a repeat frame, are sent every 5s : point the
+  LED at the receiver to see them decoded. No interrupt at all between the IR pulses, and no polling timer.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_IR.h"
+
+#if defined(TISR_IR_ICP_PIN)
+  #define IR_RECEIVE_PIN      TISR_IR_ICP_PIN
+#else
+  // Pin change interrupt
+  #define IR_RECEIVE_PIN      2
+#endif
+
+// NEC : address, ~address, command, ~command, LSB first
+#define NEC_ADDRESS           0x04
+#define NEC_COMMAND           0x08
+
+TISR_IrReceiver irReceiver;
+#if defined(TISR_IR_SENDER)
+  // Timer2 : not on 32u4
+  TISR_IrSender irSender;
+#endif
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting IR_RemoteDecode on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  irReceiver.begin(IR_RECEIVE_PIN);
+  Serial.print(F("IR receiver on pin ")); Serial.println(IR_RECEIVE_PIN);
+
+#if defined(TISR_IR_SENDER)
+  irSender.begin();
+
+  Serial.print(F("IR LED on pin ")); Serial.println(TISR_IR_SEND_PIN);
+#endif
+}
+
+void loop()
+{
+  tisr_ir_result_t result;
+
+  if (irReceiver.decode(result))
+  {
+    Serial.print(result.protocol->name);
+    Serial.print(F(" : 0x"));  Serial.print(result.data, HEX);
+    Serial.print(F(", "));     Serial.print(result.numBits);
+    Serial.println(result.repeat ? F(" bits, repeat") : F(" bits"));
+  }
+
+#if defined(TISR_IR_SENDER)
+  static unsigned long lastSend   = 0;
+  static bool          sendRepeat = false;
+
+  if (sendRepeat && (millis() - lastSend > 110) && !irSender.isBusy())
+  {
+    sendRepeat = false;
+
+    irSender.send(tisr_ir_protocols[0], 0, true);
+  }
+
+  if (millis() - lastSend > 5000)
+  {
+    lastSend = millis();
+
+    uint32_t data = NEC_ADDRESS | ( (uint32_t) (NEC_ADDRESS ^ 0xFF) << 8 ) | ( (uint32_t) NEC_COMMAND << 16 )
+                    | ( (uint32_t) (NEC_COMMAND ^ 0xFF) << 24 );
+
+    sendRepeat = irSender.send(tisr_ir_protocols[0], data);
+
+    Serial.print(F("Sent NEC 0x")); Serial.println(data, HEX);
+  }
+#endif
+}
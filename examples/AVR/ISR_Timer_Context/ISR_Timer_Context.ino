@@ -0,0 +1,138 @@
+/****************************************************************************************************************************
+  ISR_Timer_Context.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Demonstrates the ISR_Timer callbacks receiving a tisr_timer_context_t : scheduled deadline, millis() and TISR_CYCLES()
+  at entry, missed periods, interval and user pointer, with no extra clock read in the callback.
+
+  - integrate() keeps a ramp exact even when periods are skipped, using dt = interval * (missed + 1)
+  - sample() timestamps each sample with the entry time of its dispatch
+  Send a character over Serial to pause ITimer1 for 35ms once, and see the missed periods being accounted for.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt_Generic.h"
+#include "ISR_Timer_Generic.h"
+
+#define HW_TIMER_INTERVAL_MS          1L
+
+#define INTEGRATE_INTERVAL_MS         10L
+#define SAMPLE_INTERVAL_MS            250L
+
+// Ramp slope, units per second
+#define RAMP_RATE                     100.0f
+
+ISR_Timer ISR_timer;
+
+typedef struct
+{
+  float         value;
+  uint32_t      numMissed;
+} Ramp;
+
+volatile Ramp ramp = { 0.0f, 0 };
+
+typedef struct
+{
+  unsigned long scheduledMillis;
+  tisr_cycles_t entryCycles;
+  int           value;
+  bool          ready;
+} Sample;
+
+volatile Sample lastSample = { 0, 0, 0, false };
+
+void TimerHandler()
+{
+  ISR_timer.run();
+}
+
+void integrate(const tisr_timer_context_t& context)
+{
+  volatile Ramp* state = (volatile Ramp*) context.param;
+
+  // Exact time since the previous call, however late this one is
+  float dt = context.interval * (context.missed + 1) / 1000.0f;
+
+  state->value     += RAMP_RATE * dt;
+  state->numMissed += context.missed;
+}
+
+void sample(const tisr_timer_context_t& context)
+{
+  lastSample.scheduledMillis  = context.scheduledMillis;
+  lastSample.entryCycles      = context.entryCycles;
+  lastSample.value            = analogRead(A0);
+  lastSample.ready            = true;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting ISR_Timer_Context on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterruptInterval(HW_TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+  ISR_timer.setInterval(INTEGRATE_INTERVAL_MS, integrate, (void*) &ramp);
+  ISR_timer.setInterval(SAMPLE_INTERVAL_MS, sample);
+}
+
+void loop()
+{
+  if (Serial.available())
+  {
+    Serial.read();
+
+    // Pauses ITimer1, so ISR_timer.run() misses 3 integrate() periods
+    ITimer1.pauseTimer();
+    delay(35);
+    ITimer1.resumeTimer();
+  }
+
+  if (lastSample.ready)
+  {
+    Sample  current;
+    Ramp    state;
+
+    noInterrupts();
+
+    current.scheduledMillis = lastSample.scheduledMillis;
+    current.entryCycles     = lastSample.entryCycles;
+    current.value           = lastSample.value;
+    lastSample.ready        = false;
+
+    state.value             = ramp.value;
+    state.numMissed         = ramp.numMissed;
+
+    interrupts();
+
+    Serial.print(F("Sample due at ")); Serial.print(current.scheduledMillis);
+    Serial.print(F(" ms, taken at ")); Serial.print(tisr_cycles_to_us(current.entryCycles));
+    Serial.print(F(" us : ")); Serial.print(current.value);
+    Serial.print(F(", ramp = ")); Serial.print(state.value);
+    Serial.print(F(" (expected ")); Serial.print(RAMP_RATE * millis() / 1000.0f);
+    Serial.print(F("), missed periods = ")); Serial.println(state.numMissed);
+  }
+}
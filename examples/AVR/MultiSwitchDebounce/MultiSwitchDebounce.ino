@@ -0,0 +1,126 @@
+/****************************************************************************************************************************
+  MultiSwitchDebounce.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Debounces 17 switches at once with TimerInterrupt_Generic_Debounce.h, from one ITimer1 tick every 5ms.
+  On a 328(P) board, switches to GND on D2 - D12 and A0 - A5. Ports D, B and C are read whole and packed into one
+  32-bit word, so the ISR does the same few operations for all of them, instead of one digitalRead() and millis()
+  comparison per switch as in SwitchDebounce.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Debounce.h"
+
+#define TIMER1_INTERVAL_MS        5L
+
+// Bit n of the packed word : PORTD for 0 - 7, PORTB for 8 - 15, PORTC for 16 - 23
+#define SWITCH_PINS               ( 0x003F1FFCUL )      // PD2 - PD7, PB0 - PB4, PC0 - PC5
+
+// 1 port, up to 16 queued events
+TISR_Debouncer<1, 16> switches;
+
+uint32_t readSwitches(const uint8_t& port)
+{
+#if defined(PINC)
+  return ( (uint32_t) PINC << 16 ) | ( (uint16_t) PINB << 8 ) | PIND;
+#else
+  return ( (uint16_t) PINB << 8 ) | PIND;
+#endif
+}
+
+void TimerHandler()
+{
+  switches.update();
+}
+
+void printPins(const uint32_t& pins)
+{
+  for (uint8_t bit = 0; bit < 32; bit++)
+  {
+    if (pins & (1UL << bit))
+    {
+      // Arduino pin number on a 328(P) board
+      Serial.print(F(" "));
+
+      if (bit < 14)
+        Serial.print(bit);
+      else
+      {
+        Serial.print(F("A")); Serial.print(bit - 16);
+      }
+    }
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting MultiSwitchDebounce on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  for (uint8_t pin = 2; pin <= 12; pin++)
+    pinMode(pin, INPUT_PULLUP);
+
+  for (uint8_t pin = A0; pin <= A5; pin++)
+    pinMode(pin, INPUT_PULLUP);
+
+  // Switches to GND, and no events for D0 / D1 (Serial) or D13 (LED)
+  switches.setActiveLow(0, SWITCH_PINS);
+  switches.setMask(0, SWITCH_PINS);
+  switches.begin(readSwitches);
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterruptInterval(TIMER1_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+}
+
+void loop()
+{
+  tisr_debounce_event_t event;
+
+  while (switches.getEvent(event))
+  {
+    Serial.print(event.millis);
+
+    if (event.pressed)
+    {
+      Serial.print(F(" pressed :"));
+      printPins(event.pressed);
+    }
+
+    if (event.released)
+    {
+      Serial.print(F(" released :"));
+      printPins(event.released);
+    }
+
+    Serial.println();
+  }
+
+  if (switches.getNumDropped())
+  {
+    Serial.print(F("Events dropped : ")); Serial.println(switches.getNumDropped());
+  }
+
+  delay(10);
+}
@@ -0,0 +1,104 @@
+/****************************************************************************************************************************
+  QuadratureEncoders.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Decodes 3 quadrature encoders with TimerInterrupt_Generic_Quadrature.h, sampled by ITimer1 at 10kHz. On a 328(P)
+  board, encoder A / B pins on D2 / D3, D4 / D5 and D6 / D7, all on PORTD, read at once in each tick.
+  The CPU load is the same at any shaft speed, unlike one attachInterrupt() per edge as in RPM_Measure, which can
+  starve loop() at high speed. Up to ~2500 encoder cycles / s per channel (10000 edges / s).
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Quadrature.h"
+
+#define SAMPLE_FREQ_HZ            10000
+#define TICK_MICROS               ( 1000000L / SAMPLE_FREQ_HZ )
+
+// Velocity over 1000 ticks, i.e. 100ms
+#define VELOCITY_WINDOW_TICKS     1000
+
+#define NUM_ENCODERS              3
+
+// Encoder cycles (x4 counts) per revolution
+#define COUNTS_PER_REV            ( 4 * 100 )
+
+// 3 channels, 1 port
+TISR_QuadratureDecoder<NUM_ENCODERS, 1> encoders;
+
+uint32_t readEncoders(const uint8_t& port)
+{
+  return PIND;
+}
+
+void TimerHandler()
+{
+  encoders.update();
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting QuadratureEncoders on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  for (uint8_t channel = 0; channel < NUM_ENCODERS; channel++)
+  {
+    uint8_t pinA = 2 + 2 * channel;
+
+    pinMode(pinA,     INPUT_PULLUP);
+    pinMode(pinA + 1, INPUT_PULLUP);
+
+    // D2 - D7 are PD2 - PD7
+    encoders.attach(channel, 0, pinA, pinA + 1);
+  }
+
+  encoders.begin(readEncoders, TICK_MICROS, VELOCITY_WINDOW_TICKS);
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterrupt(SAMPLE_FREQ_HZ, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+  Serial.println(F("Send 'z' to zero the positions"));
+}
+
+void loop()
+{
+  if (Serial.available() && (Serial.read() == 'z'))
+  {
+    for (uint8_t channel = 0; channel < NUM_ENCODERS; channel++)
+      encoders.setPosition(channel, 0);
+  }
+
+  for (uint8_t channel = 0; channel < NUM_ENCODERS; channel++)
+  {
+    Serial.print(F("Enc")); Serial.print(channel);
+    Serial.print(F(" pos = "));       Serial.print(encoders.getPosition(channel));
+    Serial.print(F(", RPM = "));      Serial.print(encoders.getVelocity(channel) * 60 / COUNTS_PER_REV, 1);
+    Serial.print(F(", illegal = "));  Serial.print(encoders.getNumIllegal(channel));
+    Serial.print(F("   "));
+  }
+
+  Serial.println();
+
+  delay(500);
+}
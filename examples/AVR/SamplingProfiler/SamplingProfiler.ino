@@ -0,0 +1,83 @@
+/****************************************************************************************************************************
+  SamplingProfiler.ino
+  For Arduino and Adadruit AVR 328(P) and 2560 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Statistical profiling of loop() with TimerInterrupt_Generic_Profiler.h. Timer2 samples the interrupted address at
+  1kHz, and the (address, count) table is dumped every 10s. Capture the Serial output and symbolize it on the host with
+  the sketch's ELF file :
+
+    extras/profile/tisr_profile SamplingProfiler.ino.elf capture.txt
+
+  Expect busyFloat() to take most of the samples, then busyInteger(), then millis() / the Serial code.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+// Timer2 is used by the profiler
+#define USE_TIMER_1     true
+#define USE_TIMER_2     false
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Profiler.h"
+
+#define REPORT_INTERVAL_MS            10000L
+
+volatile float    floatResult;
+volatile uint32_t integerResult;
+
+// Software floating point, slow on AVR
+void __attribute__((noinline)) busyFloat()
+{
+  float value = 1.0f;
+
+  for (uint16_t i = 1; i < 200; i++)
+    value = value * 1.0001f + 1.0f / i;
+
+  floatResult = value;
+}
+
+void __attribute__((noinline)) busyInteger()
+{
+  uint32_t value = 1;
+
+  for (uint16_t i = 1; i < 200; i++)
+    value = value * 33 + i;
+
+  integerResult = value;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting SamplingProfiler on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  TISR_Profiler.begin();
+}
+
+void loop()
+{
+  static unsigned long lastReport = 0;
+
+  busyFloat();
+  busyInteger();
+
+  if (millis() - lastReport >= REPORT_INTERVAL_MS)
+  {
+    lastReport = millis();
+
+    TISR_Profiler.dump(Serial);
+    TISR_Profiler.clear();
+  }
+}
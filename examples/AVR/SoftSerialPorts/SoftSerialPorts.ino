@@ -0,0 +1,92 @@
+/****************************************************************************************************************************
+  SoftSerialPorts.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Two full-duplex software serial ports at 57600 baud with TimerInterrupt_Generic_SoftSerial.h, bridged to Serial.
+  On a 328(P) board :
+    port1 : RX D8 (ICP1, timestamped by the capture unit), TX D9 (OC1A, switched by the compare unit)
+    port2 : RX D2 (pin change interrupt),                  TX D3 (compare interrupt)
+  On a 32u4 board, where D2 has no pin change interrupt :
+    port1 : RX D4 (ICP1),                                   TX D9 (OC1A)
+    port2 : RX D8 (pin change interrupt),                  TX D3 (compare interrupt)
+  Wire port1 TX to port2 RX and port2 TX to port1 RX for a loopback test : the lines typed in the Serial Monitor go out of port1, come back on
+  port2, which echoes them back to port1. Unlike SoftwareSerial, both ports receive and send at the same time, and
+  millis() and the other interrupts keep running.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_SoftSerial.h"
+
+#define SOFT_BAUD           57600
+
+#if defined(__AVR_ATmega32U4__)
+  TISR_SoftSerial port1(4, 9);
+  TISR_SoftSerial port2(8, 3);
+#else
+  TISR_SoftSerial port1(8, 9);
+  TISR_SoftSerial port2(2, 3);
+#endif
+
+void printStatus(const char* name, TISR_SoftSerial& port)
+{
+  Serial.print(name);
+  Serial.print(F(" : TX "));  Serial.print(port.isTxHardware() ? F("compare output") : F("compare interrupt"));
+  Serial.print(F(", RX "));   Serial.print(port.isRxCapture()  ? F("input capture")  : F("pin change"));
+  Serial.print(F(", framing errors = ")); Serial.print(port.getNumFramingErrors());
+  Serial.print(F(", overruns = "));       Serial.println(port.getNumOverruns());
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting SoftSerialPorts on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  if (port1.begin(SOFT_BAUD) && port2.begin(SOFT_BAUD))
+  {
+    Serial.print(F("Starting  ports OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't start the ports"));
+
+  printStatus("port1", port1);
+  printStatus("port2", port2);
+}
+
+void loop()
+{
+  static unsigned long lastStatus = 0;
+
+  // Serial Monitor -> port1
+  while (Serial.available())
+    port1.write(Serial.read());
+
+  // port2 echoes back what it receives
+  while (port2.available())
+    port2.write(port2.read());
+
+  // port1 -> Serial Monitor
+  while (port1.available())
+    Serial.write(port1.read());
+
+  if (millis() - lastStatus > 10000)
+  {
+    lastStatus = millis();
+
+    printStatus("port1", port1);
+    printStatus("port2", port2);
+  }
+}
@@ -0,0 +1,96 @@
+/****************************************************************************************************************************
+  StackWatermark.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Demonstrates the optional interrupt stack watermarking (TISR_STACK_ENABLE) : the worst stack depth used by the ITimer1
+  ISR and by each ISR_Timer callback, plus the part of the free stack never touched since boot.
+
+  doingDeep() uses a local buffer on purpose, so its depth stands out.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define TISR_STACK_ENABLE             true
+
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt_Generic.h"
+#include "ISR_Timer_Generic.h"
+
+#define HW_TIMER_INTERVAL_MS          1L
+
+#define REPORT_INTERVAL_MS            5000L
+
+ISR_Timer ISR_timer;
+
+int shallowTimer;
+int deepTimer;
+
+void TimerHandler()
+{
+  ISR_timer.run();
+}
+
+volatile uint8_t checksum;
+
+void doingShallow()
+{
+  checksum++;
+}
+
+void doingDeep()
+{
+  volatile uint8_t buffer[48];
+
+  for (uint8_t i = 0; i < sizeof(buffer); i++)
+    buffer[i] = i;
+
+  checksum += buffer[sizeof(buffer) - 1];
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting StackWatermark on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  Serial.print(F("Painted free stack = ")); Serial.print(TISR_Stack.paint()); Serial.println(F(" bytes"));
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterruptInterval(HW_TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+  shallowTimer  = ISR_timer.setInterval(2L,  doingShallow);
+  deepTimer     = ISR_timer.setInterval(10L, doingDeep);
+}
+
+void loop()
+{
+  static unsigned long lastReport = 0;
+
+  if (millis() - lastReport >= REPORT_INTERVAL_MS)
+  {
+    lastReport = millis();
+
+    Serial.print(F("Stack depth (bytes) : ITimer1 = "));  Serial.print(TISR_Stack.getMaxDepth(TISR_STACK_HW_TIMER(1)));
+    Serial.print(F(", doingShallow = "));                 Serial.print(TISR_Stack.getMaxDepth(TISR_STACK_CALLBACK(shallowTimer)));
+    Serial.print(F(", doingDeep = "));                    Serial.print(TISR_Stack.getMaxDepth(TISR_STACK_CALLBACK(deepTimer)));
+    Serial.print(F(", never used = "));                   Serial.println(TISR_Stack.getUnusedBytes());
+  }
+}
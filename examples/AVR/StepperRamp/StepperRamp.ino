@@ -0,0 +1,79 @@
+/****************************************************************************************************************************
+  StepperRamp.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Moves a stepper motor back and forth with TimerInterrupt_Generic_Stepper.h, with S-curve acceleration ramps.
+  Timer1 outputs the step pulses itself on D10 (D12 on Mega), with the direction on D8, to a STEP / DIR driver
+  such as A4988, DRV8825 or TMC2208. The ISR only computes the period after next, ~40kHz max. at 16MHz.
+  Timer1 is used by TISR_Stepper, so ITimer1 (USE_TIMER_1) can't be used.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Stepper.h"
+
+#define DIR_PIN                 8
+
+// Steps / s and steps / s^2, with 1/16 microstepping on a 200 steps / rev motor : 3200 steps / rev
+#define MAX_SPEED               16000
+#define ACCELERATION            20000
+
+// Acceleration ramped in / out over 400 steps
+#define JERK_STEPS              400
+
+#define MOVE_STEPS              32000L
+
+TISR_Stepper stepper;
+
+int32_t moveSteps = MOVE_STEPS;
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting StepperRamp on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  // Timer1 at F_CPU / 8 = 2MHz : periods of 0.5us to 32ms, i.e. down to ~31 steps / s
+  stepper.begin(DIR_PIN, 8);
+
+  stepper.setMaxSpeed(MAX_SPEED);
+  stepper.setAcceleration(ACCELERATION);
+  stepper.setSCurve(JERK_STEPS);
+}
+
+void loop()
+{
+  static unsigned long lastPrint = 0;
+
+  if (!stepper.isMoving())
+  {
+    Serial.print(F("At ")); Serial.print(stepper.getPosition());
+    Serial.print(F(", moving ")); Serial.println(moveSteps);
+
+    delay(1000);
+
+    stepper.moveSteps(moveSteps);
+    moveSteps = -moveSteps;
+  }
+
+  if (millis() - lastPrint > 200)
+  {
+    lastPrint = millis();
+
+    Serial.print(F("pos = "));          Serial.print(stepper.getPosition());
+    Serial.print(F(", speed = "));      Serial.print(stepper.getSpeed(), 0);
+    Serial.print(F(", remaining = "));  Serial.println(stepper.getRemaining());
+  }
+}
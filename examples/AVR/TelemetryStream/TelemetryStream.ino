@@ -0,0 +1,163 @@
+/****************************************************************************************************************************
+  TelemetryStream.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Demonstrates the binary telemetry stream (TimerInterrupt_Generic_Telemetry.h), as a compact alternative to printing
+  the timer stats in text. Once per second, loop() queues a STATUS, a LOAD and one STATS record per timer, and
+  TISR_Telemetry.poll() sends them within a budget of 10% of the 115200 bps link. The CONFIG records are repeated every
+  10s, so the host tool can be started at any time.
+
+  On the host, build extras/telemetry/tisr_telemetry and run it on the serial port to get a live dashboard :
+    stty -F /dev/ttyUSB0 115200 raw -echo
+    ./tisr_telemetry /dev/ttyUSB0
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define TISR_STATS_ENABLE             true
+#define TISR_LOAD_ENABLE              true
+
+// One second of records, ~230 bytes, must fit in the queue
+#define TISR_TELEMETRY_QUEUE_SIZE     256
+
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt_Generic.h"
+#include "ISR_Timer_Generic.h"
+#include "TimerInterrupt_Generic_Telemetry.h"
+
+#define HW_TIMER_INTERVAL_MS          1L
+
+#define REPORT_INTERVAL_MS            1000L
+#define CONFIG_INTERVAL_MS            10000L
+
+// 10% of 115200 bps
+#define TELEMETRY_BYTES_PER_SECOND    1152
+
+#define NUMBER_ISR_TIMERS             4
+
+ISR_Timer ISR_timer;
+
+const unsigned long TimerInterval[NUMBER_ISR_TIMERS] = { 5L, 20L, 100L, 500L };
+
+void TimerHandler()
+{
+  ISR_timer.run();
+}
+
+void doingSomething0()
+{
+  delayMicroseconds(20);
+}
+
+void doingSomething1()
+{
+  delayMicroseconds(100);
+}
+
+void doingSomething2()
+{
+  delayMicroseconds(500);
+}
+
+void doingSomething3()
+{
+  delayMicroseconds(1000);
+}
+
+const timer_callback TimerCallback[NUMBER_ISR_TIMERS] = { doingSomething0, doingSomething1, doingSomething2, doingSomething3 };
+
+void closeLoadWindow()
+{
+  TISR_LoadMeter.onWindow();
+}
+
+void sendConfig()
+{
+  TISR_Telemetry.sendConfig(TISR_TELEMETRY_HW_TIMER, 1, true, HW_TIMER_INTERVAL_MS);
+
+  for (uint8_t i = 0; i < NUMBER_ISR_TIMERS; i++)
+  {
+    TISR_Telemetry.sendConfig(TISR_TELEMETRY_ISR_TIMER, i, ISR_timer.isEnabled(i), TimerInterval[i]);
+  }
+}
+
+void sendStats()
+{
+  tisr_timer_stats_t stats;
+
+  TISR_HwStats[1].getSnapshot(stats);
+  TISR_Telemetry.sendStats(TISR_TELEMETRY_HW_TIMER, 1, stats);
+
+  for (uint8_t i = 0; i < NUMBER_ISR_TIMERS; i++)
+  {
+    if (ISR_timer.getStats(i, stats))
+      TISR_Telemetry.sendStats(TISR_TELEMETRY_ISR_TIMER, i, stats);
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  // Text printed before the frames is skipped by the host tool
+  Serial.print(F("\nStarting TelemetryStream on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterruptInterval(HW_TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+  for (uint8_t i = 0; i < NUMBER_ISR_TIMERS; i++)
+  {
+    ISR_timer.setInterval(TimerInterval[i], TimerCallback[i]);
+  }
+
+  Serial.flush();
+  TISR_LoadMeter.calibrate(500);
+  TISR_LoadMeter.begin();
+  ISR_timer.setInterval(REPORT_INTERVAL_MS, closeLoadWindow);
+
+  TISR_Telemetry.begin(TELEMETRY_BYTES_PER_SECOND);
+  sendConfig();
+}
+
+void loop()
+{
+  static unsigned long lastConfig = 0;
+
+  TISR_Telemetry.poll(Serial);
+
+  tisr_load_window_t window;
+
+  // One report per load window
+  if (TISR_LoadMeter.getWindow(window))
+  {
+    if (millis() - lastConfig >= CONFIG_INTERVAL_MS)
+    {
+      lastConfig = millis();
+      sendConfig();
+    }
+
+    TISR_Telemetry.sendStatus();
+    TISR_Telemetry.sendLoad(window);
+    sendStats();
+  }
+
+  TISR_LoadMeter.idle();
+}
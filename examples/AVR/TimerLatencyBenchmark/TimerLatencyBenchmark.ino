@@ -0,0 +1,147 @@
+/****************************************************************************************************************************
+  TimerLatencyBenchmark.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Measures the ISR entry latency and period jitter of ITimer1 under selectable background loads, using the
+  shared TISR_LatencyRecorder histograms, and streams p50 / p99 / p99.9 / max as one JSON object per line.
+
+  Entry latency is read directly from TCNT1 : Timer1 runs in CTC mode, so TCNT1 at callback entry is the number of
+  timer ticks elapsed since the compare match that raised the interrupt (the timer runs at F_CPU with prescaler 1).
+
+  Send a character over Serial to select the load mode :
+    '0' : no load
+    's' : Serial flood (UART TX interrupt competing with Timer1)
+    'f' : EEPROM writes (flash / EEPROM programming with interrupts briefly disabled)
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Latency.h"
+
+#include <EEPROM.h>
+
+// 1kHz => OCR1A = 15999 with prescaler 1 at 16MHz, TCNT1 counts CPU cycles
+#define TIMER1_FREQ_HZ          1000
+
+#define REPORT_INTERVAL_MS      5000L
+
+TISR_LatencyRecorder latencyRecorder;
+
+enum
+{
+  LOAD_NONE = 0,
+  LOAD_SERIAL,
+  LOAD_FLASH
+};
+
+const char* loadModeName[] = { "none", "serial", "flash" };
+
+uint8_t loadMode = LOAD_NONE;
+
+void TimerHandler1()
+{
+  uint16_t ticksSinceMatch = TCNT1;
+
+  latencyRecorder.onISREntry();
+  latencyRecorder.recordLatency(ticksSinceMatch);
+}
+
+void runLoad()
+{
+  static uint16_t eepromAddress = 0;
+
+  switch (loadMode)
+  {
+    case LOAD_SERIAL:
+      if (Serial.availableForWrite() > 8)
+        Serial.print(F("........"));
+
+      break;
+
+    case LOAD_FLASH:
+      EEPROM.write(eepromAddress, (uint8_t) eepromAddress);
+
+      if (++eepromAddress >= 64)
+        eepromAddress = 0;
+
+      break;
+
+    default:
+      break;
+  }
+}
+
+void checkCommand()
+{
+  if (Serial.available())
+  {
+    switch (Serial.read())
+    {
+      case '0':
+        loadMode = LOAD_NONE;
+        break;
+
+      case 's':
+        loadMode = LOAD_SERIAL;
+        break;
+
+      case 'f':
+        loadMode = LOAD_FLASH;
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting TimerLatencyBenchmark on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  latencyRecorder.begin(TISR_CYCLES_HZ / TIMER1_FREQ_HZ);
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterrupt(TIMER1_FREQ_HZ, TimerHandler1))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+}
+
+void loop()
+{
+  static unsigned long lastReport = 0;
+
+  checkCommand();
+  runLoad();
+
+  if (millis() - lastReport >= REPORT_INTERVAL_MS)
+  {
+    lastReport = millis();
+
+    uint8_t index = latencyRecorder.swap();
+
+    Serial.println();
+    latencyRecorder.latency(index).printJSON(Serial, "T1_entry_latency", loadModeName[loadMode], F_CPU);
+    latencyRecorder.jitter(index).printJSON(Serial, "T1_period_jitter", loadModeName[loadMode], TISR_CYCLES_HZ);
+  }
+}
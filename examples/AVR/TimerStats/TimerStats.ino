@@ -0,0 +1,123 @@
+/****************************************************************************************************************************
+  TimerStats.ino
+  For Arduino and Adadruit AVR 328(P) and 32u4 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Demonstrates the optional runtime statistics (TISR_STATS_ENABLE) of the hardware timer and of the ISR_Timer slots :
+  invocation count, missed / coalesced periods, min / avg / max callback duration and min / max lateness.
+
+  One of the ISR_Timer callbacks is intentionally slow, and loop() periodically blocks interrupts, so that both show up
+  in the printed statistics.
+ *****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define TISR_STATS_ENABLE             true
+
+#define USE_TIMER_1     true
+
+#include "TimerInterrupt_Generic.h"
+#include "ISR_Timer_Generic.h"
+
+#define HW_TIMER_INTERVAL_MS          1L
+
+#define REPORT_INTERVAL_MS            5000L
+
+ISR_Timer ISR_timer;
+
+int fastTimer;
+int slowTimer;
+
+void TimerHandler()
+{
+  ISR_timer.run();
+}
+
+volatile uint32_t fastCount = 0;
+
+void doingFast()
+{
+  fastCount++;
+}
+
+// Intentionally slow callback
+void doingSlow()
+{
+  delayMicroseconds(500);
+}
+
+void printStats(const __FlashStringHelper* name, const tisr_timer_stats_t& stats, const __FlashStringHelper* lateUnit)
+{
+  Serial.print(name);
+  Serial.print(F(": count = "));      Serial.print(stats.count);
+  Serial.print(F(", missed = "));     Serial.print(stats.missed);
+  Serial.print(F(", dur(us) = "));    Serial.print(stats.durMin);
+  Serial.print(F("/"));               Serial.print(TISR_TimerStats::getAvgDuration(stats));
+  Serial.print(F("/"));               Serial.print(stats.durMax);
+  Serial.print(F(", late("));         Serial.print(lateUnit);
+  Serial.print(F(") = "));            Serial.print(stats.lateMin);
+  Serial.print(F("/"));               Serial.println(stats.lateMax);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting TimerStats on ")); Serial.println(BOARD_TYPE);
+  Serial.println(TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  tisr_cycles_init();
+
+  ITimer1.init();
+
+  if (ITimer1.attachInterruptInterval(HW_TIMER_INTERVAL_MS, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+  fastTimer = ISR_timer.setInterval(2L,   doingFast);
+  slowTimer = ISR_timer.setInterval(100L, doingSlow);
+}
+
+void loop()
+{
+  static unsigned long lastReport = 0;
+  static unsigned long lastBlock  = 0;
+
+  // Block interrupts for ~3ms once a second, to create lateness and missed periods
+  if (millis() - lastBlock >= 1000)
+  {
+    lastBlock = millis();
+
+    noInterrupts();
+    delayMicroseconds(3000);
+    interrupts();
+  }
+
+  if (millis() - lastReport >= REPORT_INTERVAL_MS)
+  {
+    lastReport = millis();
+
+    tisr_timer_stats_t stats;
+
+    TISR_HwStats[1].getSnapshot(stats);
+    printStats(F("ITimer1  "), stats, F("us"));
+
+    ISR_timer.getStats(fastTimer, stats);
+    printStats(F("doingFast"), stats, F("ms"));
+
+    ISR_timer.getStats(slowTimer, stats);
+    printStats(F("doingSlow"), stats, F("ms"));
+  }
+}
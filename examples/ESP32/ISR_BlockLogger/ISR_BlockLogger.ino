@@ -0,0 +1,150 @@
+/****************************************************************************************************************************
+  ISR_BlockLogger.ino
+  For ESP32, ESP32_S2, ESP32_S3, ESP32_C3 boards with ESP32 core v2.0.0+
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Logs a record every 500us (2kHz) from ITimer0 to /log.bin on LittleFS for 10s, with TimerInterrupt_Generic_Logger.h.
+  The ISR only copies each record into a RAM buffer of 8 blocks of 4KB, the flash sector size. loop() writes the full
+  blocks to the file, and can block through the sector erases meanwhile. The log is then read back and checked : every
+  sequence number in order, none missing unless counted as dropped.
+*****************************************************************************************************************************/
+
+#if !defined( ESP32 )
+  #error This code is intended to run on the ESP32 platform! Please check your Tools->Board setting.
+#endif
+
+// These define's must be placed at the beginning before #include "ESP32_New_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Logger.h"
+
+#include <LittleFS.h>
+
+#define TIMER0_INTERVAL_US        500
+#define LOG_DURATION_MS           10000
+
+#define LOG_FILE                  "/log.bin"
+
+// Flash sector
+#define ERASE_SIZE                4096
+
+typedef struct
+{
+  uint32_t  sequence;
+  uint32_t  atMicros;
+} LogRecord;
+
+TISR_BlockLogger<ERASE_SIZE, 8> logger;
+
+File                  logFile;
+TISR_LogPrintDevice*  logDevice;
+
+// Owned by the ISR
+uint32_t isrSequence = 0;
+
+// Init ESP32 timer 0
+ESP32Timer ITimer0(0);
+
+bool IRAM_ATTR TimerHandler0(void * timerNo)
+{
+  LogRecord record = { isrSequence++, (uint32_t) micros() };
+
+  logger.write(record);
+
+  return true;
+}
+
+void checkLog()
+{
+  File      file      = LittleFS.open(LOG_FILE, FILE_READ);
+  LogRecord record;
+  uint32_t  numRead   = 0;
+  uint32_t  numGaps   = 0;
+  uint32_t  expected  = 0;
+
+  while (file.read((uint8_t*) &record, sizeof(record)) == sizeof(record))
+  {
+    if (record.sequence != expected)
+      numGaps++;
+
+    expected = record.sequence + 1;
+    numRead++;
+  }
+
+  file.close();
+
+  Serial.print(F("Read back ")); Serial.print(numRead);
+  Serial.print(F(" records, gaps = ")); Serial.println(numGaps);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  delay(100);
+
+  Serial.print(F("\nStarting ISR_BlockLogger on ")); Serial.println(ARDUINO_BOARD);
+  Serial.println(ESP32_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  if (!LittleFS.begin(true))
+  {
+    Serial.println(F("LittleFS mount failed"));
+
+    while (true)
+      delay(1000);
+  }
+
+  logFile   = LittleFS.open(LOG_FILE, FILE_WRITE);
+  logDevice = new TISR_LogPrintDevice(logFile, ERASE_SIZE);
+
+  if (!logFile || !logger.begin(logDevice))
+  {
+    Serial.println(F("Can't start the logger"));
+
+    while (true)
+      delay(1000);
+  }
+
+  // Interval in microsecs
+  if (ITimer0.attachInterruptInterval(TIMER0_INTERVAL_US, TimerHandler0))
+  {
+    Serial.print(F("Starting  ITimer0 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer0. Select another freq. or timer"));
+}
+
+void loop()
+{
+  static bool logging = true;
+
+  if (!logging)
+    return;
+
+  logger.run();
+
+  if (millis() > LOG_DURATION_MS)
+  {
+    logging = false;
+
+    ITimer0.detachInterrupt();
+
+    logger.end();
+    logFile.close();
+
+    Serial.print(F("Records = "));            Serial.print(logger.getNumRecords());
+    Serial.print(F(", dropped = "));          Serial.print(logger.getNumDropped());
+    Serial.print(F(", write errors = "));     Serial.println(logger.getNumWriteErrors());
+    Serial.print(F("Longest block write = ")); Serial.print(logger.getMaxWriteMicros());
+    Serial.print(F(" us, most blocks queued = ")); Serial.println(logger.getMaxBlocksQueued());
+
+    checkLog();
+  }
+}
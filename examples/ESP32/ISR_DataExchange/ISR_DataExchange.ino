@@ -0,0 +1,200 @@
+/****************************************************************************************************************************
+  ISR_DataExchange.ino
+  For ESP32, ESP32_S2, ESP32_S3, ESP32_C3 boards with ESP32 core v2.0.0+
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Demonstrates the lock-free ISR to loop() primitives of TimerInterrupt_Generic_Exchange.h, instead of the bare volatile
+  arrays and noInterrupts() of the other examples :
+  1) TISR_SeqLock       : ITimer0 (1ms) publishes a multi-word tick record, always read back consistent by loop()
+  2) TISR_TripleBuffer  : ITimer1 (100ms) publishes a 64-bucket histogram of ITimer0 periods, used in place by loop()
+  3) TISR_SpscRing      : ITimer0 queues an event every time its period is more than 20us off, none lost
+
+  loop() runs on core 1 while the timer ISRs run on the core which attached them, no interrupt is ever masked.
+*****************************************************************************************************************************/
+
+#if !defined( ESP32 )
+  #error This code is intended to run on the ESP32 platform! Please check your Tools->Board setting.
+#endif
+
+// These define's must be placed at the beginning before #include "ESP32_New_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Exchange.h"
+
+#define TIMER0_INTERVAL_US        1000
+#define TIMER1_INTERVAL_MS        100
+
+#define HISTOGRAM_BUCKETS         64
+// 1us per bucket, centered on TIMER0_INTERVAL_US
+#define HISTOGRAM_FIRST_US        ( TIMER0_INTERVAL_US - HISTOGRAM_BUCKETS / 2 )
+
+#define EVENT_THRESHOLD_US        20
+
+typedef struct
+{
+  uint32_t  numTicks;
+  uint32_t  lastMicros;
+  uint32_t  minPeriod;
+  uint32_t  maxPeriod;
+} TickRecord;
+
+typedef struct
+{
+  uint32_t  windowNumber;
+  uint16_t  buckets[HISTOGRAM_BUCKETS];
+} Histogram;
+
+typedef struct
+{
+  uint32_t  atMicros;
+  int32_t   errorUs;
+} PeriodEvent;
+
+TISR_SeqLock<TickRecord>          tickRecord;
+TISR_TripleBuffer<Histogram>      histogram;
+TISR_SpscRing<PeriodEvent, 32>    periodEvents;
+
+// Owned by the ISRs
+TickRecord  isrTicks = { 0, 0, 0xFFFFFFFFUL, 0 };
+Histogram   isrHistogram;
+
+// Init ESP32 timer 0 and 1
+ESP32Timer ITimer0(0);
+ESP32Timer ITimer1(1);
+
+bool IRAM_ATTR TimerHandler0(void * timerNo)
+{
+  uint32_t now = micros();
+
+  if (isrTicks.numTicks > 0)
+  {
+    uint32_t period = now - isrTicks.lastMicros;
+
+    if (period < isrTicks.minPeriod)
+      isrTicks.minPeriod = period;
+
+    if (period > isrTicks.maxPeriod)
+      isrTicks.maxPeriod = period;
+
+    int32_t bucket = (int32_t) period - HISTOGRAM_FIRST_US;
+
+    if (bucket < 0)
+      bucket = 0;
+    else if (bucket >= HISTOGRAM_BUCKETS)
+      bucket = HISTOGRAM_BUCKETS - 1;
+
+    isrHistogram.buckets[bucket]++;
+
+    int32_t error = (int32_t) period - TIMER0_INTERVAL_US;
+
+    if ( (error > EVENT_THRESHOLD_US) || (error < -EVENT_THRESHOLD_US) )
+    {
+      PeriodEvent event = { now, error };
+
+      periodEvents.push(event);
+    }
+  }
+
+  isrTicks.numTicks++;
+  isrTicks.lastMicros = now;
+
+  tickRecord.write(isrTicks);
+
+  return true;
+}
+
+bool IRAM_ATTR TimerHandler1(void * timerNo)
+{
+  // Both timer ISRs run on the same core, so isrHistogram isn't being updated meanwhile
+  isrHistogram.windowNumber++;
+
+  histogram.write(isrHistogram);
+
+  memset(isrHistogram.buckets, 0, sizeof(isrHistogram.buckets));
+
+  return true;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  delay(100);
+
+  Serial.print(F("\nStarting ISR_DataExchange on ")); Serial.println(ARDUINO_BOARD);
+  Serial.println(ESP32_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  memset(&isrHistogram, 0, sizeof(isrHistogram));
+
+  // Interval in microsecs
+  if (ITimer0.attachInterruptInterval(TIMER0_INTERVAL_US, TimerHandler0))
+  {
+    Serial.print(F("Starting  ITimer0 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer0. Select another freq. or timer"));
+
+  // Interval in microsecs
+  if (ITimer1.attachInterruptInterval(TIMER1_INTERVAL_MS * 1000, TimerHandler1))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+  Serial.flush();
+}
+
+void printHistogram(const Histogram& window)
+{
+  Serial.print(F("Window ")); Serial.print(window.windowNumber); Serial.print(F(" periods (us) :"));
+
+  for (uint8_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+  {
+    if (window.buckets[i] > 0)
+    {
+      Serial.print(' '); Serial.print(HISTOGRAM_FIRST_US + i);
+      Serial.print('x'); Serial.print(window.buckets[i]);
+    }
+  }
+
+  Serial.println();
+}
+
+void loop()
+{
+  static unsigned long lastPrint = 0;
+
+  PeriodEvent event;
+
+  while (periodEvents.pop(event))
+  {
+    Serial.print(F("Period off by ")); Serial.print(event.errorUs);
+    Serial.print(F(" us at micros() = ")); Serial.println(event.atMicros);
+  }
+
+  if (millis() - lastPrint >= 1000)
+  {
+    lastPrint = millis();
+
+    TickRecord ticks;
+
+    tickRecord.read(ticks);
+
+    Serial.print(F("Ticks = ")); Serial.print(ticks.numTicks);
+    Serial.print(F(", period min = ")); Serial.print(ticks.minPeriod);
+    Serial.print(F(" us, max = ")); Serial.print(ticks.maxPeriod);
+    Serial.print(F(" us, events dropped = ")); Serial.println(periodEvents.getNumDropped());
+
+    // The buffer stays valid, and is never written by the ISR, until the next update()
+    if (histogram.update())
+      printHistogram(histogram.get());
+  }
+}
@@ -0,0 +1,145 @@
+/****************************************************************************************************************************
+  ISR_TaskService.ino
+  For ESP32, ESP32_S2, ESP32_S3, ESP32_C3 boards with ESP32 core v2.0.0+
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Demonstrates the FreeRTOS timer service of TimerInterrupt_Generic_TaskService.h. The hardware timer ISRs only notify
+  worker tasks, the heavy work runs in task context :
+  - ITimer0 (10ms) wakes the high priority controlJob(), which needs a short and stable wake latency
+  - ITimer1 (250ms) wakes the low priority reportJob(), which takes ~20ms of CPU
+  Both print over Serial, guarded by a TISR_TaskMutex so reportJob() holding it is boosted instead of blocking
+  controlJob(). loop() prints the ISR to task latency of both jobs every 2s.
+*****************************************************************************************************************************/
+
+#if !defined( ESP32 )
+  #error This code is intended to run on the ESP32 platform! Please check your Tools->Board setting.
+#endif
+
+// These define's must be placed at the beginning before #include "ESP32_New_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_TaskService.h"
+
+#define TIMER0_INTERVAL_MS        10
+#define TIMER1_INTERVAL_MS        250
+
+#define CONTROL_PRIORITY          ( configMAX_PRIORITIES - 2 )
+#define REPORT_PRIORITY           2
+
+int controlJobId;
+int reportJobId;
+
+TISR_TaskMutex serialMutex;
+
+// Init ESP32 timer 0 and 1
+ESP32Timer ITimer0(0);
+ESP32Timer ITimer1(1);
+
+bool IRAM_ATTR TimerHandler0(void * timerNo)
+{
+  // true if the worker must run right after this ISR
+  return TISR_Tasks.notifyFromISR(controlJobId);
+}
+
+bool IRAM_ATTR TimerHandler1(void * timerNo)
+{
+  return TISR_Tasks.notifyFromISR(reportJobId);
+}
+
+void controlJob(void* param)
+{
+  static uint32_t numRuns = 0;
+
+  // Task context : floats, Serial, blocking calls are allowed
+  float setpoint = 50.0f + 10.0f * sinf(numRuns++ * 0.01f);
+
+  if ( (numRuns % 100) == 0 )
+  {
+    serialMutex.lock();
+    Serial.print(F("Control setpoint = ")); Serial.println(setpoint);
+    serialMutex.unlock();
+  }
+}
+
+void reportJob(void* param)
+{
+  serialMutex.lock();
+
+  // Busy for ~20ms while holding the mutex
+  unsigned long start = millis();
+
+  while (millis() - start < 20);
+
+  serialMutex.unlock();
+}
+
+void printStats(const char* name, const int& jobId)
+{
+  tisr_task_stats_t stats;
+
+  if (TISR_Tasks.getStats(jobId, stats))
+  {
+    serialMutex.lock();
+
+    Serial.print(name);
+    Serial.print(F(" : runs = "));      Serial.print(stats.count);
+    Serial.print(F(", coalesced = "));  Serial.print(stats.coalesced);
+    Serial.print(F(", latency us min = ")); Serial.print(stats.latencyMin);
+    Serial.print(F(", avg = "));        Serial.print(stats.latencyAvg);
+    Serial.print(F(", max = "));        Serial.println(stats.latencyMax);
+
+    serialMutex.unlock();
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  delay(100);
+
+  Serial.print(F("\nStarting ISR_TaskService on ")); Serial.println(ARDUINO_BOARD);
+  Serial.println(ESP32_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  serialMutex.begin();
+
+  // Jobs first, so the ISRs never notify a job which doesn't exist yet
+  controlJobId  = TISR_Tasks.addJob(controlJob, NULL, CONTROL_PRIORITY);
+  reportJobId   = TISR_Tasks.addJob(reportJob,  NULL, REPORT_PRIORITY);
+
+  if ( (controlJobId < 0) || (reportJobId < 0) )
+    Serial.println(F("Can't create the worker tasks"));
+
+  // Interval in microsecs
+  if (ITimer0.attachInterruptInterval(TIMER0_INTERVAL_MS * 1000, TimerHandler0))
+  {
+    Serial.print(F("Starting  ITimer0 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer0. Select another freq. or timer"));
+
+  // Interval in microsecs
+  if (ITimer1.attachInterruptInterval(TIMER1_INTERVAL_MS * 1000, TimerHandler1))
+  {
+    Serial.print(F("Starting  ITimer1 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+  Serial.flush();
+}
+
+void loop()
+{
+  delay(2000);
+
+  printStats("controlJob", controlJobId);
+  printStats("reportJob ", reportJobId);
+}
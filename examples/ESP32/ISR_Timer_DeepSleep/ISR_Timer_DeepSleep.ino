@@ -0,0 +1,146 @@
+/****************************************************************************************************************************
+  ISR_Timer_DeepSleep.ino
+  For ESP32, ESP32_S2, ESP32_S3, ESP32_C3 boards with ESP32 core v2.0.0+
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Demonstrates TimerInterrupt_Generic_Sleep.h : the ISR_Timer schedule is saved in RTC memory before deep sleep and
+  restored after the wake, instead of being set up again from zero.
+  - measureSensor() every 10s, reportData() every 60s, keep their phase over the sleep cycles
+  - blinkLED() runs 5 times only, in total : its run count survives the sleeps too
+  The board sleeps until the next timer is due, then stays awake AWAKE_TIME_MS to serve it.
+  Reset the board (power-on, not EN) to start a new schedule.
+*****************************************************************************************************************************/
+
+#if !defined( ESP32 )
+  #error This code is intended to run on the ESP32 platform! Please check your Tools->Board setting.
+#endif
+
+// These define's must be placed at the beginning before #include "ESP32_New_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "ISR_Timer_Generic.h"
+#include "TimerInterrupt_Generic_Sleep.h"
+
+#ifndef LED_BUILTIN
+  #define LED_BUILTIN       2
+#endif
+
+#define HW_TIMER_INTERVAL_US      1000L
+
+#define MEASURE_INTERVAL_MS       10000L
+#define REPORT_INTERVAL_MS        60000L
+#define BLINK_INTERVAL_MS         1000L
+
+#define AWAKE_TIME_MS             200L
+
+// Stable callback IDs, must not change between builds
+#define ID_MEASURE                0
+#define ID_REPORT                 1
+#define ID_BLINK                  2
+
+// Init ESP32 timer 0
+ESP32Timer ITimer0(0);
+
+// Init ESP32_ISR_Timer
+ISR_Timer ISR_timer;
+
+volatile bool measureDue  = false;
+volatile bool reportDue   = false;
+
+bool IRAM_ATTR TimerHandler(void * timerNo)
+{
+  ISR_timer.run();
+
+  return true;
+}
+
+void measureSensor()
+{
+  measureDue = true;
+}
+
+void reportData(const tisr_timer_context_t& context)
+{
+  // missed > 0 if the report came due more than once during the sleep
+  reportDue = true;
+}
+
+void blinkLED()
+{
+  digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+}
+
+void setup()
+{
+  pinMode(LED_BUILTIN, OUTPUT);
+
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting ISR_Timer_DeepSleep on ")); Serial.println(ARDUINO_BOARD);
+  Serial.println(ESP32_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+
+  // Same bindings on every boot
+  TISR_Sleep.bind(ID_MEASURE, measureSensor);
+  TISR_Sleep.bind(ID_REPORT,  reportData);
+  TISR_Sleep.bind(ID_BLINK,   blinkLED);
+
+  uint32_t numSleeps = TISR_Sleep.getNumSleeps();
+
+  if (TISR_Sleep.restore(ISR_timer))
+  {
+    Serial.print(F("Schedule restored after sleep #")); Serial.println(numSleeps);
+  }
+  else
+  {
+    Serial.println(F("New schedule"));
+
+    ISR_timer.setInterval(MEASURE_INTERVAL_MS,  measureSensor);
+    ISR_timer.setInterval(REPORT_INTERVAL_MS,   reportData);
+    ISR_timer.setTimer(BLINK_INTERVAL_MS,       blinkLED, 5);
+  }
+
+  // Interval in microsecs
+  if (ITimer0.attachInterruptInterval(HW_TIMER_INTERVAL_US, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer0 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer0. Select another freq. or timer"));
+}
+
+void loop()
+{
+  if (measureDue)
+  {
+    measureDue = false;
+    Serial.print(F("Measure, analogRead = ")); Serial.println(analogRead(A0));
+  }
+
+  if (reportDue)
+  {
+    reportDue = false;
+    Serial.println(F("Report"));
+  }
+
+  if ( (millis() < AWAKE_TIME_MS) || measureDue || reportDue )
+    return;
+
+  ITimer0.stopTimer();
+
+  if (!TISR_Sleep.save(ISR_timer))
+    Serial.println(F("A timer has no bound callback ID, not saved"));
+
+  uint64_t sleepTime = TISR_Sleep.getMicrosToNextDeadline();
+
+  Serial.print(F("Sleeping for ")); Serial.print( (uint32_t) (sleepTime / 1000) ); Serial.println(F(" ms"));
+  Serial.flush();
+
+  esp_sleep_enable_timer_wakeup(sleepTime);
+  esp_deep_sleep_start();
+}
@@ -0,0 +1,102 @@
+/****************************************************************************************************************************
+  ISR_Timer_Trace.ino
+  For ESP32, ESP32_S2, ESP32_S3, ESP32_C3 boards with ESP32 core v2.0.0+
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Demonstrates the optional binary event tracing (TISR_TRACE_ENABLE). The hardware timer ISR, every ISR_Timer::run()
+  and every ISR_Timer callback dispatch are recorded into the TISR_Trace ring.
+
+  Send 'd' over Serial to dump the ring (binary), then convert the capture on the host :
+
+    cat /dev/ttyUSB0 > capture.bin
+    extras/trace/tisr_trace2json capture.bin trace.json
+
+  and open trace.json in https://ui.perfetto.dev to see which ISR / callback ran long.
+*****************************************************************************************************************************/
+
+#if !defined( ESP32 )
+  #error This code is intended to run on the ESP32 platform! Please check your Tools->Board setting.
+#endif
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+// Compile the trace points in. Optional, TISR_TRACE_BUFFER_SIZE (power of 2) events are kept
+#define TISR_TRACE_ENABLE             true
+#define TISR_TRACE_BUFFER_SIZE        1024
+
+#include "TimerInterrupt_Generic.h"
+#include "ISR_Timer_Generic.h"
+
+#define HW_TIMER_INTERVAL_MS      1L
+
+// Init ESP32 timer 1
+ESP32Timer ITimer(1);
+
+// Init ESP32_ISR_Timer
+ISR_Timer ESP32_ISR_Timer;
+
+bool IRAM_ATTR TimerHandler(void * timerNo)
+{
+  // The ESP32 core calls this handler directly, trace it as hardware timer 1
+  TISR_TRACE_BEGIN(traceStart);
+
+  ESP32_ISR_Timer.run();
+
+  TISR_TRACE_END(TISR_TRACE_HW_TIMER, 1, traceStart);
+
+  return true;
+}
+
+volatile uint32_t fastCount = 0;
+
+void IRAM_ATTR doingFast()
+{
+  fastCount++;
+}
+
+// Intentionally slow callback, to show up as a long span in the trace
+void IRAM_ATTR doingSlow()
+{
+  delayMicroseconds(200);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  delay(200);
+
+  Serial.print(F("\nStarting ISR_Timer_Trace on ")); Serial.println(ARDUINO_BOARD);
+  Serial.println(ESP32_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  TISR_Trace.begin();
+
+  // Interval in microsecs
+  if (ITimer.attachInterruptInterval(HW_TIMER_INTERVAL_MS * 1000, TimerHandler))
+  {
+    Serial.print(F("Starting  ITimer OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer. Select another freq. or timer"));
+
+  ESP32_ISR_Timer.setInterval(2L,   doingFast);
+  ESP32_ISR_Timer.setInterval(50L,  doingSlow);
+
+  Serial.println(F("Send 'd' to dump the trace ring"));
+}
+
+void loop()
+{
+  if (Serial.available() && (Serial.read() == 'd'))
+  {
+    TISR_Trace.dump(Serial);
+    Serial.flush();
+    TISR_Trace.clear();
+  }
+}
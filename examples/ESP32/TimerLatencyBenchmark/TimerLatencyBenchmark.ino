@@ -0,0 +1,174 @@
+/****************************************************************************************************************************
+  TimerLatencyBenchmark.ino
+  For ESP32, ESP32_S2, ESP32_S3, ESP32_C3 boards with ESP32 core v2.0.0+
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Measures the ISR entry latency and period jitter of an ESP32 hardware timer under selectable background loads,
+  using the shared TISR_LatencyRecorder histograms, and streams p50 / p99 / p99.9 / max as one JSON object per line.
+
+  Entry latency is read from the timer counter itself : the timer auto-reloads to 0 on alarm, so its value at callback
+  entry is the number of timer ticks (TIMER_SCALE Hz) elapsed since the alarm. Jitter uses the CPU cycle counter (CCOUNT).
+
+  Send a character over Serial to select the load mode :
+    '0' : no load
+    's' : Serial flood
+    'f' : NVS flash writes (flash cache disabled during erase / program)
+    'w' : WiFi scan (radio and WiFi task activity)
+*****************************************************************************************************************************/
+
+#if !defined( ESP32 )
+  #error This code is intended to run on the ESP32 platform! Please check your Tools->Board setting.
+#endif
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Latency.h"
+
+#include <WiFi.h>
+#include <Preferences.h>
+
+#define TIMER0_INTERVAL_US      1000
+
+#define REPORT_INTERVAL_MS      5000L
+
+// Init ESP32 timer 0
+ESP32Timer ITimer0(0);
+
+TISR_LatencyRecorder latencyRecorder;
+
+Preferences preferences;
+
+enum
+{
+  LOAD_NONE = 0,
+  LOAD_SERIAL,
+  LOAD_FLASH,
+  LOAD_WIFI
+};
+
+const char* loadModeName[] = { "none", "serial", "flash", "wifi" };
+
+uint8_t loadMode = LOAD_NONE;
+
+// With core v2.0.0+, you can't use Serial.print/println in ISR or crash.
+// and you can't use float calculation inside ISR
+bool IRAM_ATTR TimerHandler0(void * timerNo)
+{
+  uint64_t ticksSinceAlarm = timer_group_get_counter_value_in_isr(TIMER_GROUP_0, TIMER_0);
+
+  latencyRecorder.onISREntry();
+  latencyRecorder.recordLatency((uint32_t) ticksSinceAlarm);
+
+  return true;
+}
+
+void runLoad()
+{
+  static uint32_t flashCounter = 0;
+
+  switch (loadMode)
+  {
+    case LOAD_SERIAL:
+      if (Serial.availableForWrite() > 32)
+        Serial.print(F("................................"));
+
+      break;
+
+    case LOAD_FLASH:
+      preferences.putUInt("counter", flashCounter++);
+
+      break;
+
+    case LOAD_WIFI:
+      // Start a new asynchronous scan as soon as the previous one is done
+      if (WiFi.scanComplete() != WIFI_SCAN_RUNNING)
+      {
+        WiFi.scanDelete();
+        WiFi.scanNetworks(true);
+      }
+
+      break;
+
+    default:
+      break;
+  }
+}
+
+void checkCommand()
+{
+  if (Serial.available())
+  {
+    switch (Serial.read())
+    {
+      case '0':
+        loadMode = LOAD_NONE;
+        break;
+
+      case 's':
+        loadMode = LOAD_SERIAL;
+        break;
+
+      case 'f':
+        loadMode = LOAD_FLASH;
+        break;
+
+      case 'w':
+        loadMode = LOAD_WIFI;
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  delay(200);
+
+  Serial.print(F("\nStarting TimerLatencyBenchmark on ")); Serial.println(ARDUINO_BOARD);
+  Serial.println(ESP32_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  WiFi.mode(WIFI_STA);
+  preferences.begin("tisr_bench", false);
+
+  latencyRecorder.begin( (uint32_t) ( ( (uint64_t) TISR_CYCLES_HZ * TIMER0_INTERVAL_US ) / 1000000ULL ) );
+
+  // Interval in microsecs
+  if (ITimer0.attachInterruptInterval(TIMER0_INTERVAL_US, TimerHandler0))
+  {
+    Serial.print(F("Starting  ITimer0 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer0. Select another freq. or timer"));
+}
+
+void loop()
+{
+  static unsigned long lastReport = 0;
+
+  checkCommand();
+  runLoad();
+
+  if (millis() - lastReport >= REPORT_INTERVAL_MS)
+  {
+    lastReport = millis();
+
+    uint8_t index = latencyRecorder.swap();
+
+    Serial.println();
+    latencyRecorder.latency(index).printJSON(Serial, "T0_entry_latency", loadModeName[loadMode], TIMER_SCALE);
+    latencyRecorder.jitter(index).printJSON(Serial, "T0_period_jitter", loadModeName[loadMode], TISR_CYCLES_HZ);
+  }
+}
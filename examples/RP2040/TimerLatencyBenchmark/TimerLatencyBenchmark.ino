@@ -0,0 +1,169 @@
+/****************************************************************************************************************************
+  TimerLatencyBenchmark.ino
+  For RP2040-based boards such as RASPBERRY_PI_PICO, ADAFRUIT_FEATHER_RP2040 and GENERIC_RP2040.
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Measures the period jitter and callback entry latency of an RPI_PICO_Timer under selectable background loads,
+  using the shared TISR_LatencyRecorder histograms, and streams p50 / p99 / p99.9 / max as one JSON object per line.
+
+  Timestamps come from the 1MHz system timer (timer_hw->timerawl), the same time base the repeating alarms use.
+  The ideal firing time of each alarm is known (first firing + n * period), so the entry latency is the timer value at
+  callback entry minus that ideal time.
+
+  Send a character over Serial to select the load mode :
+    '0' : no load
+    's' : Serial flood
+    'f' : EEPROM (flash) commits, which run with interrupts disabled and XIP off
+*****************************************************************************************************************************/
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Latency.h"
+
+#include <EEPROM.h>
+
+#define TIMER0_INTERVAL_US      1000
+
+#define REPORT_INTERVAL_MS      5000L
+
+// Init RPI_PICO_Timer
+RPI_PICO_Timer ITimer0(0);
+
+TISR_LatencyRecorder latencyRecorder;
+
+volatile uint32_t idealFireTime;
+volatile bool     firstFire = true;
+
+enum
+{
+  LOAD_NONE = 0,
+  LOAD_SERIAL,
+  LOAD_FLASH
+};
+
+const char* loadModeName[] = { "none", "serial", "flash" };
+
+uint8_t loadMode = LOAD_NONE;
+
+bool TimerHandler0(struct repeating_timer *t)
+{
+  (void) t;
+
+  uint32_t now = timer_hw->timerawl;
+
+  latencyRecorder.onISREntry();
+
+  // Resynchronize on the first firing and after a long stall (e.g. flash commit), rather than reporting the stall
+  // in every later sample
+  if ( firstFire || ( (int32_t) (now - idealFireTime) > (int32_t) (10 * TIMER0_INTERVAL_US) ) )
+  {
+    idealFireTime = now;
+    firstFire     = false;
+  }
+
+  // Alarms scheduled from the start of the previous callback never fire early, clamp anything negative to 0
+  latencyRecorder.recordLatency( ( (int32_t) (now - idealFireTime) > 0 ) ? (now - idealFireTime) : 0 );
+  idealFireTime += TIMER0_INTERVAL_US;
+
+  return true;
+}
+
+void runLoad()
+{
+  static uint16_t eepromAddress = 0;
+
+  switch (loadMode)
+  {
+    case LOAD_SERIAL:
+      if (Serial.availableForWrite() > 32)
+        Serial.print(F("................................"));
+
+      break;
+
+    case LOAD_FLASH:
+      EEPROM.write(eepromAddress, (uint8_t) eepromAddress);
+      EEPROM.commit();
+
+      if (++eepromAddress >= 64)
+        eepromAddress = 0;
+
+      break;
+
+    default:
+      break;
+  }
+}
+
+void checkCommand()
+{
+  if (Serial.available())
+  {
+    switch (Serial.read())
+    {
+      case '0':
+        loadMode = LOAD_NONE;
+        break;
+
+      case 's':
+        loadMode = LOAD_SERIAL;
+        break;
+
+      case 'f':
+        loadMode = LOAD_FLASH;
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  delay(100);
+
+  Serial.print(F("\nStarting TimerLatencyBenchmark on ")); Serial.println(BOARD_NAME);
+  Serial.println(RPI_PICO_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  EEPROM.begin(256);
+
+  latencyRecorder.begin(TIMER0_INTERVAL_US * (TISR_CYCLES_HZ / 1000000UL));
+
+  // Interval in microsecs
+  if (ITimer0.attachInterruptInterval(TIMER0_INTERVAL_US, TimerHandler0))
+  {
+    Serial.print(F("Starting  ITimer0 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer0. Select another freq. or timer"));
+}
+
+void loop()
+{
+  static unsigned long lastReport = 0;
+
+  checkCommand();
+  runLoad();
+
+  if (millis() - lastReport >= REPORT_INTERVAL_MS)
+  {
+    lastReport = millis();
+
+    uint8_t index = latencyRecorder.swap();
+
+    Serial.println();
+    latencyRecorder.latency(index).printJSON(Serial, "T0_entry_latency", loadModeName[loadMode], 1000000UL);
+    latencyRecorder.jitter(index).printJSON(Serial, "T0_period_jitter", loadModeName[loadMode], TISR_CYCLES_HZ);
+  }
+}
@@ -0,0 +1,117 @@
+/****************************************************************************************************************************
+  DDS_Waveforms.ino
+  For SAMD boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Generates test signals on the DAC (A0) with TimerInterrupt_Generic_DDS.h, at 32k samples / s from TC3. Voice 0 is a
+  1kHz sine, voice 1 a triangle from a sketch wavetable. Send from the Serial Monitor :
+    f<Hz>  : voice 0 frequency, changed without phase jump, e.g. f440
+    c      : voice 0 chirps from 100Hz to 5kHz in 2s, repeatedly
+    m      : voice 1 on / off
+  Unlike analogWrite() with sin() in the timer callback, a sample takes a few integer operations per voice.
+*****************************************************************************************************************************/
+
+#if !( defined(ARDUINO_SAMD_ZERO) || defined(ARDUINO_SAMD_MKR1000) || defined(ARDUINO_SAMD_MKRWIFI1010) \
+      || defined(ARDUINO_SAMD_NANO_33_IOT) || defined(ARDUINO_SAMD_MKRFox1200) || defined(ARDUINO_SAMD_MKRWAN1300) || defined(ARDUINO_SAMD_MKRWAN1310) \
+      || defined(ARDUINO_SAMD_MKRGSM1400) || defined(ARDUINO_SAMD_MKRNB1500) || defined(ARDUINO_SAMD_MKRVIDOR4000) \
+      || defined(ARDUINO_SAMD_CIRCUITPLAYGROUND_EXPRESS) || defined(__SAMD51__) || defined(__SAMD51J20A__) \
+      || defined(__SAMD51J19A__) || defined(__SAMD51G19A__) || defined(__SAMD51P19A__)  \
+      || defined(__SAMD21E15A__) || defined(__SAMD21E16A__) || defined(__SAMD21E17A__) || defined(__SAMD21E18A__) \
+      || defined(__SAMD21G15A__) || defined(__SAMD21G16A__) || defined(__SAMD21G17A__) || defined(__SAMD21G18A__) \
+      || defined(__SAMD21J15A__) || defined(__SAMD21J16A__) || defined(__SAMD21J17A__) || defined(__SAMD21J18A__) )
+  #error This code is designed to run on SAMD21/SAMD51 platform! Please check your Tools->Board setting.
+#endif
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USING_TIMER_TC3         true      // Only TC3 can be used for SAMD51
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_DDS.h"
+
+#define SAMPLE_HZ               32000
+
+SAMDTimer ITimer(TIMER_TC3);
+
+// 2 voices, summed
+TISR_DDS<2> dds;
+
+// Triangle, one period
+int16_t triangle[TISR_DDS_TABLE_SIZE];
+
+void TimerHandler()
+{
+  dds.update();
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting DDS_Waveforms on ")); Serial.println(BOARD_NAME);
+  Serial.println(SAMD_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  for (uint16_t i = 0; i < TISR_DDS_TABLE_SIZE; i++)
+  {
+    int32_t ramp = (int32_t) i * 4 * 32767 / TISR_DDS_TABLE_SIZE;
+
+    triangle[i] = (i < TISR_DDS_TABLE_SIZE / 2) ? (ramp - 32767) : (3 * 32767 - ramp);
+  }
+
+  dds.beginDac(SAMPLE_HZ);
+
+  // Half scale each, so the sum never clips
+  dds.setFrequency(0, 1000);
+  dds.setAmplitude(0, TISR_DDS_AMPLITUDE_MAX / 2);
+
+  dds.setWaveform(1, triangle);
+  dds.setFrequency(1, 250);
+  dds.setAmplitude(1, TISR_DDS_AMPLITUDE_MAX / 2);
+
+  if (ITimer.attachInterrupt(SAMPLE_HZ, TimerHandler))
+  {
+    Serial.print(F("Starting ITimer OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer. Select another freq. or timer"));
+}
+
+void loop()
+{
+  if (!Serial.available())
+    return;
+
+  char command = Serial.read();
+
+  if (command == 'f')
+  {
+    float hz = Serial.parseFloat();
+
+    dds.setFrequency(0, hz);
+    Serial.print(F("Voice 0 at ")); Serial.print(dds.getFrequency(0), 3); Serial.println(F(" Hz"));
+  }
+  else if (command == 'c')
+  {
+    dds.setChirp(0, 100, 5000, 2000);
+    Serial.println(F("Voice 0 chirping 100Hz - 5kHz"));
+  }
+  else if (command == 'm')
+  {
+    static bool muted = false;
+
+    muted = !muted;
+    dds.setAmplitude(1, muted ? 0 : TISR_DDS_AMPLITUDE_MAX / 2);
+    Serial.println(muted ? F("Voice 1 off") : F("Voice 1 on"));
+  }
+}
@@ -0,0 +1,147 @@
+/****************************************************************************************************************************
+  DecimatedADC.ino
+  For STM32 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Oversamples A0 at 8kHz from the TIM2 interrupt, filtered and decimated down to 250Hz with
+  TimerInterrupt_Generic_Sampler.h and TimerInterrupt_Generic_Decimator.h :
+    8kHz  -> 3rd order CIC, ratio 8      -> 1kHz
+    1kHz  -> 16-tap FIR low-pass 100Hz, ratio 4  -> 250Hz, into a ring
+  The stages run in the ISR once per block of 64 samples, so loop() can stall for up to a second (the 256 outputs of
+  the ring) without losing a sample. On STM32F3/F4/F7/G4/L4/H7 the FIR uses the SMLAD dual multiply-accumulate.
+*****************************************************************************************************************************/
+
+#if !( defined(STM32F0) || defined(STM32F1) || defined(STM32F2) || defined(STM32F3)  ||defined(STM32F4) || defined(STM32F7) || \
+       defined(STM32L0) || defined(STM32L1) || defined(STM32L4) || defined(STM32H7)  ||defined(STM32G0) || defined(STM32G4) || \
+       defined(STM32WB) || defined(STM32MP1) || defined(STM32L5) )
+  #error This code is designed to run on STM32F/L/H/G/WB/MP1 platform! Please check your Tools->Board setting.
+#endif
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Sampler.h"
+#include "TimerInterrupt_Generic_Decimator.h"
+
+#define SAMPLE_FREQ_HZ          8000L
+#define BLOCK_SIZE              64
+
+#define CIC_RATIO               8
+#define FIR_RATIO               4
+
+#define OUTPUT_FREQ_HZ          ( SAMPLE_FREQ_HZ / CIC_RATIO / FIR_RATIO )
+
+#define ADC_PIN                 A0
+
+// Init STM32 timer TIM2
+STM32Timer ITimer0(TIM2);
+
+uint16_t readAdc()
+{
+  return analogRead(ADC_PIN);
+}
+
+TISR_BlockSampler<uint16_t, BLOCK_SIZE, readAdc> sampler;
+
+TISR_CicDecimator<3, CIC_RATIO> cic;
+TISR_FirDecimator<16, FIR_RATIO> fir;
+
+// Hamming windowed sinc, cutoff 0.1 of 1kHz, Q15, sum 1.0
+const int16_t firCoefficients[16] =
+{
+  -114, -159, -139, 291, 1450, 3284, 5246, 6525, 6525, 5246, 3284, 1450, 291, -139, -159, -114
+};
+
+TISR_SpscRing<int16_t, 256> outputRing;
+
+void TimerHandler0()
+{
+  sampler.update();
+}
+
+// In the ISR, every 8ms
+void processBlock(const uint16_t* samples, const uint16_t& count, const uint32_t& baseMicros)
+{
+  (void) baseMicros;
+
+  int16_t   cicOut[BLOCK_SIZE / CIC_RATIO + 1];
+  int16_t   firOut[BLOCK_SIZE / CIC_RATIO / FIR_RATIO + 1];
+
+  uint16_t  numCic = cic.process(samples, count, cicOut);
+  uint16_t  numFir = fir.process(cicOut, numCic, firOut);
+
+  outputRing.push(firOut, numFir);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print(F("\nStarting DecimatedADC on ")); Serial.println(BOARD_NAME);
+  Serial.println(STM32_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  Serial.print(F("FIR with SMLAD = ")); Serial.println(TISR_DECIMATOR_USING_SMLAD ? F("yes") : F("no"));
+
+  fir.begin(firCoefficients);
+
+  // The stages run in the ISR
+  sampler.begin(processBlock, true);
+
+  if (ITimer0.attachInterrupt(SAMPLE_FREQ_HZ, TimerHandler0))
+  {
+    Serial.print(F("Starting  ITimer0 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer0. Select another freq. or timer"));
+}
+
+void loop()
+{
+  static int32_t  sum     = 0;
+  static int16_t  minimum = 32767;
+  static int16_t  maximum = -32768;
+  static uint16_t count   = 0;
+
+  int16_t   values[32];
+  uint32_t  numValues;
+
+  while ( (numValues = outputRing.pop(values, 32)) > 0 )
+  {
+    for (uint32_t i = 0; i < numValues; i++)
+    {
+      sum += values[i];
+
+      if (values[i] < minimum)
+        minimum = values[i];
+
+      if (values[i] > maximum)
+        maximum = values[i];
+    }
+
+    count += numValues;
+  }
+
+  // Once per second of output
+  if (count >= OUTPUT_FREQ_HZ)
+  {
+    Serial.print(F("A0 mean = "));    Serial.print(sum / count);
+    Serial.print(F(", min = "));      Serial.print(minimum);
+    Serial.print(F(", max = "));      Serial.print(maximum);
+    Serial.print(F(", blocks = "));   Serial.print(sampler.getNumBlocks());
+    Serial.print(F(", dropped = "));  Serial.println(outputRing.getNumDropped());
+
+    sum     = 0;
+    minimum = 32767;
+    maximum = -32768;
+    count   = 0;
+  }
+}
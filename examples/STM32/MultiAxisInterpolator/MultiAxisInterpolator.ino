@@ -0,0 +1,230 @@
+/****************************************************************************************************************************
+  MultiAxisInterpolator.ino
+  For STM32 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Moves 3 stepper axes along straight lines with TimerInterrupt_Generic_Interpolator.h, all stepped from one 100kHz
+  TIM2 interrupt. STEP / DIR drivers with X / Y / Z step pins on PB0 / PB1 / PB2 and direction pins on PB4 / PB5 / PB6,
+  all written with a single GPIOB->BSRR store per tick.
+  loop() plans each line with a trapezoidal speed profile and feeds it as 5ms segments, ahead of the ISR.
+*****************************************************************************************************************************/
+
+#if !( defined(STM32F0) || defined(STM32F1) || defined(STM32F2) || defined(STM32F3)  ||defined(STM32F4) || defined(STM32F7) || \
+       defined(STM32L0) || defined(STM32L1) || defined(STM32L4) || defined(STM32H7)  ||defined(STM32G0) || defined(STM32G4) || \
+       defined(STM32WB) || defined(STM32MP1) || defined(STM32L5) )
+  #error This code is designed to run on STM32F/L/H/G/WB/MP1 platform! Please check your Tools->Board setting.
+#endif
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Interpolator.h"
+
+#define TICK_HZ                 100000L
+
+#define NUM_AXES                3
+
+#define STEP_PINS_MASK          0x0007      // PB0 - PB2
+#define DIR_PINS_MASK           0x0070      // PB4 - PB6
+
+#define SEGMENT_US              5000L
+
+// Steps / s and steps / s^2 along the line
+#define MAX_SPEED               20000.0f
+#define ACCELERATION            40000.0f
+
+// Init STM32 timer TIM2
+STM32Timer ITimer0(TIM2);
+
+TISR_Interpolator<NUM_AXES, 32> interpolator;
+
+const uint8_t stepPins[NUM_AXES]  = { PB0, PB1, PB2 };
+const uint8_t dirPins[NUM_AXES]   = { PB4, PB5, PB6 };
+
+// Corners of the path, in steps
+const int32_t path[][NUM_AXES] =
+{
+  {     0,      0,     0 },
+  { 40000,      0,  2000 },
+  { 40000,  30000,  4000 },
+  {     0,  30000,  2000 },
+};
+
+#define NUM_CORNERS     ( sizeof(path) / sizeof(path[0]) )
+
+// One store sets the given pins and clears the other ones of the mask
+void writeSteps(const uint32_t& bits)
+{
+  GPIOB->BSRR = bits | ( (STEP_PINS_MASK & ~bits) << 16 );
+}
+
+void writeDirs(const uint32_t& bits)
+{
+  GPIOB->BSRR = bits | ( (DIR_PINS_MASK & ~bits) << 16 );
+}
+
+void TimerHandler0()
+{
+  interpolator.update();
+}
+
+///////////////////////////////////////////
+
+// Planner state of the line being fed
+int32_t   lineStart[NUM_AXES];
+int32_t   lineSteps[NUM_AXES];
+float     lineLength;           // steps along the line
+float     lineTime;             // s
+float     feedTime;             // s, fed so far
+int32_t   fedSteps[NUM_AXES];
+uint8_t   corner = 0;
+
+// Distance along the line after t s, trapezoidal (or triangular) speed profile
+float distanceAt(float t)
+{
+  float accelTime = MAX_SPEED / ACCELERATION;
+  float speed     = MAX_SPEED;
+
+  if (lineLength < MAX_SPEED * accelTime)
+  {
+    accelTime = sqrtf(lineLength / ACCELERATION);
+    speed     = ACCELERATION * accelTime;
+  }
+
+  if (t <= accelTime)
+    return 0.5f * ACCELERATION * t * t;
+
+  if (t >= lineTime - accelTime)
+  {
+    float left = lineTime - t;
+
+    return lineLength - 0.5f * ACCELERATION * left * left;
+  }
+
+  return 0.5f * speed * accelTime + speed * (t - accelTime);
+}
+
+void startLine()
+{
+  const int32_t* from = path[corner];
+  const int32_t* to   = path[(corner + 1) % NUM_CORNERS];
+
+  float length2 = 0;
+
+  for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+  {
+    lineStart[axis]  = from[axis];
+    lineSteps[axis]  = to[axis] - from[axis];
+    fedSteps[axis]   = 0;
+    length2         += (float) lineSteps[axis] * lineSteps[axis];
+  }
+
+  lineLength  = sqrtf(length2);
+  feedTime    = 0;
+
+  if (lineLength < MAX_SPEED * MAX_SPEED / ACCELERATION)
+    lineTime = 2 * sqrtf(lineLength / ACCELERATION);
+  else
+    lineTime = lineLength / MAX_SPEED + MAX_SPEED / ACCELERATION;
+
+  corner = (corner + 1) % NUM_CORNERS;
+}
+
+// Queues the next segment of the current line. false if the queue is full
+bool feedSegment()
+{
+  uint32_t  ticks     = (uint32_t) SEGMENT_US * TICK_HZ / 1000000L;
+  float     nextTime  = feedTime + SEGMENT_US / 1000000.0f;
+  bool      last      = (nextTime >= lineTime);
+  int32_t   steps[NUM_AXES];
+
+  // Rounded along the whole line, so the last segment ends exactly on the corner
+  float fraction = last ? 1.0f : distanceAt(nextTime) / lineLength;
+
+  for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+  {
+    int32_t target = (int32_t) lroundf(lineSteps[axis] * fraction);
+
+    steps[axis] = target - fedSteps[axis];
+  }
+
+  // The lines follow each other without stop : the queue running empty is always a starvation
+  if (!interpolator.addSegment(steps, ticks, true))
+    return false;
+
+  for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+    fedSteps[axis] += steps[axis];
+
+  feedTime = nextTime;
+
+  return true;
+}
+
+///////////////////////////////////////////
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  delay(100);
+
+  Serial.print(F("\nStarting MultiAxisInterpolator on ")); Serial.println(BOARD_NAME);
+  Serial.println(STM32_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+  {
+    pinMode(stepPins[axis], OUTPUT);
+    pinMode(dirPins[axis],  OUTPUT);
+
+    // PB0 - PB2 are step bits 0 - 2, PB4 - PB6 direction bits 4 - 6
+    interpolator.attach(axis, 1UL << axis, 1UL << (4 + axis));
+  }
+
+  interpolator.begin(writeSteps, writeDirs, TICK_HZ);
+
+  if (ITimer0.attachInterrupt(TICK_HZ, TimerHandler0))
+  {
+    Serial.print(F("Starting  ITimer0 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer0. Select another freq. or timer"));
+
+  startLine();
+}
+
+void loop()
+{
+  static unsigned long lastPrint = 0;
+
+  // Keep the queue full, one line after the other
+  while (interpolator.getNumFree() > 0)
+  {
+    if (feedTime >= lineTime)
+      startLine();
+
+    if (!feedSegment())
+      break;
+  }
+
+  if (millis() - lastPrint > 500)
+  {
+    lastPrint = millis();
+
+    for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+    {
+      Serial.print((char) ('X' + axis)); Serial.print(F(" = ")); Serial.print(interpolator.getPosition(axis));
+      Serial.print(F("  "));
+    }
+
+    Serial.print(F("starved = ")); Serial.println(interpolator.getNumStarved());
+  }
+}
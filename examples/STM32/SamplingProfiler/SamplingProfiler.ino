@@ -0,0 +1,105 @@
+/****************************************************************************************************************************
+  SamplingProfiler.ino
+  For STM32 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Statistical profiling of loop() with TimerInterrupt_Generic_Profiler.h. The TIM2 callback takes the stacked PC of the
+  interrupted code at 2kHz, and the (address, count) table is dumped every 10s. Capture the Serial output and symbolize
+  it on the host with the sketch's ELF file :
+
+    extras/profile/tisr_profile SamplingProfiler.ino.elf capture.txt
+
+  Expect busyFloat() (software floating point on FPU-less parts) and busyInteger() to take most of the samples.
+*****************************************************************************************************************************/
+
+#if !( defined(STM32F0) || defined(STM32F1) || defined(STM32F2) || defined(STM32F3)  ||defined(STM32F4) || defined(STM32F7) || \
+       defined(STM32L0) || defined(STM32L1) || defined(STM32L4) || defined(STM32H7)  ||defined(STM32G0) || defined(STM32G4) || \
+       defined(STM32WB) || defined(STM32MP1) || defined(STM32L5) )
+  #error This code is designed to run on STM32F/L/H/G/WB/MP1 platform! Please check your Tools->Board setting.
+#endif
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Profiler.h"
+
+// 2kHz, not a multiple of the 1ms SysTick, so the samples don't lock onto its phase
+#define TIMER0_INTERVAL_US      487
+
+#define REPORT_INTERVAL_MS      10000L
+
+// Init STM32 timer TIM2
+STM32Timer ITimer0(TIM2);
+
+volatile double   floatResult;
+volatile uint32_t integerResult;
+
+void TimerHandler0()
+{
+  TISR_PROFILER_SAMPLE();
+}
+
+void __attribute__((noinline)) busyFloat()
+{
+  double value = 1.0;
+
+  for (uint16_t i = 1; i < 500; i++)
+    value = value * 1.0001 + 1.0 / i;
+
+  floatResult = value;
+}
+
+void __attribute__((noinline)) busyInteger()
+{
+  uint32_t value = 1;
+
+  for (uint16_t i = 1; i < 500; i++)
+    value = value * 33 + i;
+
+  integerResult = value;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  delay(100);
+
+  Serial.print(F("\nStarting SamplingProfiler on ")); Serial.println(BOARD_NAME);
+  Serial.println(STM32_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  TISR_Profiler.begin();
+
+  // Interval in microsecs
+  if (ITimer0.attachInterruptInterval(TIMER0_INTERVAL_US, TimerHandler0))
+  {
+    Serial.print(F("Starting  ITimer0 OK, millis() = ")); Serial.println(millis());
+  }
+  else
+    Serial.println(F("Can't set ITimer0. Select another freq. or timer"));
+}
+
+void loop()
+{
+  static unsigned long lastReport = 0;
+
+  busyFloat();
+  busyInteger();
+
+  if (millis() - lastReport >= REPORT_INTERVAL_MS)
+  {
+    lastReport = millis();
+
+    TISR_Profiler.dump(Serial);
+    TISR_Profiler.clear();
+  }
+}
@@ -0,0 +1,163 @@
+/****************************************************************************************************************************
+  TimerLatencyBenchmark.ino
+  For STM32 boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Measures the ISR entry latency and period jitter of an STM32 hardware timer under selectable background loads,
+  using the shared TISR_LatencyRecorder histograms, and streams p50 / p99 / p99.9 / max as one JSON object per line.
+
+  Entry latency is read from the timer counter itself : the timer restarts from 0 on its update event, so TIM2->CNT
+  at callback entry is the number of timer ticks elapsed since the update. The tick rate is derived from the
+  auto-reload value, as (ARR + 1) ticks span exactly one interval. Jitter uses the DWT cycle counter on Cortex-M3/M4/M7,
+  micros() on Cortex-M0/M0+.
+
+  Send a character over Serial to select the load mode :
+    '0' : no load
+    's' : Serial flood
+    'f' : EEPROM emulation writes (flash erase / program stalls the bus)
+*****************************************************************************************************************************/
+
+#if !( defined(STM32F0) || defined(STM32F1) || defined(STM32F2) || defined(STM32F3)  ||defined(STM32F4) || defined(STM32F7) || \
+       defined(STM32L0) || defined(STM32L1) || defined(STM32L4) || defined(STM32H7)  ||defined(STM32G0) || defined(STM32G4) || \
+       defined(STM32WB) || defined(STM32MP1) || defined(STM32L5) )
+  #error This code is designed to run on STM32F/L/H/G/WB/MP1 platform! Please check your Tools->Board setting.
+#endif
+
+// These define's must be placed at the beginning before #include "TimerInterrupt_Generic.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#include "TimerInterrupt_Generic.h"
+#include "TimerInterrupt_Generic_Latency.h"
+
+#include <EEPROM.h>
+
+#define TIMER0_INTERVAL_US      1000
+
+#define REPORT_INTERVAL_MS      5000L
+
+// Init STM32 timer TIM2
+STM32Timer ITimer0(TIM2);
+
+TISR_LatencyRecorder latencyRecorder;
+
+// Timer ticks per second, known once the timer is started
+uint32_t timerTickHz = 1000000UL;
+
+enum
+{
+  LOAD_NONE = 0,
+  LOAD_SERIAL,
+  LOAD_FLASH
+};
+
+const char* loadModeName[] = { "none", "serial", "flash" };
+
+uint8_t loadMode = LOAD_NONE;
+
+void TimerHandler0()
+{
+  uint32_t ticksSinceUpdate = TIM2->CNT;
+
+  latencyRecorder.onISREntry();
+  latencyRecorder.recordLatency(ticksSinceUpdate);
+}
+
+void runLoad()
+{
+  static uint16_t eepromAddress = 0;
+
+  switch (loadMode)
+  {
+    case LOAD_SERIAL:
+      if (Serial.availableForWrite() > 32)
+        Serial.print(F("................................"));
+
+      break;
+
+    case LOAD_FLASH:
+      EEPROM.write(eepromAddress, (uint8_t) millis());
+
+      if (++eepromAddress >= 64)
+        eepromAddress = 0;
+
+      break;
+
+    default:
+      break;
+  }
+}
+
+void checkCommand()
+{
+  if (Serial.available())
+  {
+    switch (Serial.read())
+    {
+      case '0':
+        loadMode = LOAD_NONE;
+        break;
+
+      case 's':
+        loadMode = LOAD_SERIAL;
+        break;
+
+      case 'f':
+        loadMode = LOAD_FLASH;
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  delay(100);
+
+  Serial.print(F("\nStarting TimerLatencyBenchmark on ")); Serial.println(BOARD_NAME);
+  Serial.println(STM32_TIMER_INTERRUPT_VERSION);
+  Serial.println(TIMER_INTERRUPT_GENERIC_VERSION);
+  Serial.print(F("CPU Frequency = ")); Serial.print(F_CPU / 1000000); Serial.println(F(" MHz"));
+
+  latencyRecorder.begin( (uint32_t) ( ( (uint64_t) TISR_CYCLES_HZ * TIMER0_INTERVAL_US ) / 1000000ULL ) );
+
+  // Interval in microsecs
+  if (ITimer0.attachInterruptInterval(TIMER0_INTERVAL_US, TimerHandler0))
+  {
+    Serial.print(F("Starting  ITimer0 OK, millis() = ")); Serial.println(millis());
+
+    timerTickHz = (uint32_t) ( ( (uint64_t) (TIM2->ARR + 1) * 1000000ULL ) / TIMER0_INTERVAL_US );
+
+    Serial.print(F("TIM2 tick frequency = ")); Serial.print(timerTickHz); Serial.println(F(" Hz"));
+  }
+  else
+    Serial.println(F("Can't set ITimer0. Select another freq. or timer"));
+}
+
+void loop()
+{
+  static unsigned long lastReport = 0;
+
+  checkCommand();
+  runLoad();
+
+  if (millis() - lastReport >= REPORT_INTERVAL_MS)
+  {
+    lastReport = millis();
+
+    uint8_t index = latencyRecorder.swap();
+
+    Serial.println();
+    latencyRecorder.latency(index).printJSON(Serial, "T0_entry_latency", loadModeName[loadMode], timerTickHz);
+    latencyRecorder.jitter(index).printJSON(Serial, "T0_period_jitter", loadModeName[loadMode], TISR_CYCLES_HZ);
+  }
+}
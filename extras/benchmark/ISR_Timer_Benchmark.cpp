@@ -0,0 +1,567 @@
+/****************************************************************************************************************************
+  ISR_Timer_Benchmark.cpp
+  Native (host) micro-benchmarks for TimerInterrupt_Generic scheduler hot paths
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  This file is not part of the Arduino library build (extras/ is excluded by library.json). It compiles ISR_Timer_Generic.h
+  on the host against a virtual millis() clock and measures :
+
+  1) ISR_Timer::run() cost versus the number of armed timers and the number of those that are due
+  2) setupTimer() / deleteTimer() churn throughput (via setInterval(), setTimeout() and deleteTimer())
+  3) The prescaler / compare value solvers used by the hardware timer backends
+  4) Dispatch overhead per callback type (none, void* parameter, tisr_timer_context_t)
+
+  Build and run from this directory :
+
+    g++ -O2 -std=gnu++11 -I../../src ISR_Timer_Benchmark.cpp -o ISR_Timer_Benchmark
+    ./ISR_Timer_Benchmark                              // human readable table
+    ./ISR_Timer_Benchmark --json results.json          // plus Google-Benchmark compatible JSON
+    ./ISR_Timer_Benchmark --filter run/ --min_time 0.5 // only benchmarks whose name contains "run/"
+
+  The JSON output follows the Google Benchmark schema ("context" + "benchmarks"), so the usual compare.py and
+  tracking tools can consume it unchanged.
+*****************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <stdint.h>
+
+///////////////////////////////////////////
+
+// Virtual clock used by ISR_Timer on the host. Benchmarks move it forward to make timers due.
+static unsigned long benchMillis = 0;
+
+unsigned long millis()
+{
+  return benchMillis;
+}
+
+// TISR_CYCLES() source on the host, read for the entryCycles of the context callbacks
+unsigned long micros()
+{
+  return benchMillis * 1000;
+}
+
+#include "ISR_Timer_Generic.h"
+
+///////////////////////////////////////////
+
+// Keep the compiler from optimizing away values and memory
+template <typename T>
+static inline void doNotOptimize(T const& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+static inline void clobberMemory()
+{
+  asm volatile("" : : : "memory");
+}
+
+///////////////////////////////////////////
+
+class BenchState
+{
+  public:
+
+    BenchState(uint64_t iterations) : _iterations(iterations), _items(0) {}
+
+    uint64_t iterations() const
+    {
+      return _iterations;
+    }
+
+    void setItemsProcessed(uint64_t items)
+    {
+      _items = items;
+    }
+
+    uint64_t itemsProcessed() const
+    {
+      return _items;
+    }
+
+  private:
+
+    uint64_t _iterations;
+    uint64_t _items;
+};
+
+typedef void (*benchFunction)(BenchState& state, int arg0, int arg1);
+
+typedef struct
+{
+  char          name[64];
+  benchFunction func;
+  int           arg0;
+  int           arg1;
+} benchmark_t;
+
+#define MAX_BENCHMARKS      128
+
+static benchmark_t  benchmarks[MAX_BENCHMARKS];
+static int          numBenchmarks = 0;
+
+static void registerBenchmark(const char* name, benchFunction func, int arg0 = -1, int arg1 = -1)
+{
+  if (numBenchmarks >= MAX_BENCHMARKS)
+    return;
+
+  benchmark_t& b = benchmarks[numBenchmarks++];
+
+  if (arg0 < 0)
+    snprintf(b.name, sizeof(b.name), "%s", name);
+  else if (arg1 < 0)
+    snprintf(b.name, sizeof(b.name), "%s/%d", name, arg0);
+  else
+    snprintf(b.name, sizeof(b.name), "%s/%d/%d", name, arg0, arg1);
+
+  b.func = func;
+  b.arg0 = arg0;
+  b.arg1 = arg1;
+}
+
+static double wallSeconds()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double cpuSeconds()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+///////////////////////////////////////////
+// Callbacks used by the scheduler benchmarks
+///////////////////////////////////////////
+
+static volatile uint32_t callbackCount = 0;
+
+static void benchCallback()
+{
+  callbackCount = callbackCount + 1;
+}
+
+static void benchCallbackParam(void* param)
+{
+  callbackCount = callbackCount + (uint32_t) (uintptr_t) param;
+}
+
+static void benchCallbackContext(const tisr_timer_context_t& context)
+{
+  callbackCount = callbackCount + context.missed + 1;
+}
+
+///////////////////////////////////////////
+
+#define BENCH_INTERVAL_MS         10
+
+// Arm 'armed' timers, of which 'due' use BENCH_INTERVAL_MS and the rest a practically infinite interval,
+// so that every run() call after advancing the virtual clock by BENCH_INTERVAL_MS dispatches exactly 'due' callbacks
+static void armTimers(ISR_Timer& isrTimer, int armed, int due, int callbackType)
+{
+  benchMillis = 0;
+  isrTimer.init();
+
+  for (int i = 0; i < armed; i++)
+  {
+    float interval = (i < due) ? BENCH_INTERVAL_MS : 1.0e9f;
+
+    if (callbackType == TIMER_CALLBACK_CONTEXT)
+      isrTimer.setInterval(interval, benchCallbackContext, NULL);
+    else if (callbackType == TIMER_CALLBACK_PARAM)
+      isrTimer.setInterval(interval, benchCallbackParam, (void*) (uintptr_t) 1);
+    else
+      isrTimer.setInterval(interval, benchCallback);
+  }
+}
+
+// ISR_Timer::run() versus number of armed and due timers
+static void BM_run(BenchState& state, int armed, int due)
+{
+  static ISR_Timer isrTimer;
+
+  armTimers(isrTimer, armed, due, TIMER_CALLBACK_NO_PARAM);
+
+  for (uint64_t i = 0; i < state.iterations(); i++)
+  {
+    benchMillis += BENCH_INTERVAL_MS;
+    isrTimer.run();
+  }
+
+  clobberMemory();
+  state.setItemsProcessed(state.iterations() * due);
+}
+
+// Dispatch overhead per callback type, one due timer
+static void BM_dispatch_noParam(BenchState& state, int, int)
+{
+  static ISR_Timer isrTimer;
+
+  armTimers(isrTimer, 1, 1, TIMER_CALLBACK_NO_PARAM);
+
+  for (uint64_t i = 0; i < state.iterations(); i++)
+  {
+    benchMillis += BENCH_INTERVAL_MS;
+    isrTimer.run();
+  }
+
+  state.setItemsProcessed(state.iterations());
+}
+
+static void BM_dispatch_param(BenchState& state, int, int)
+{
+  static ISR_Timer isrTimer;
+
+  armTimers(isrTimer, 1, 1, TIMER_CALLBACK_PARAM);
+
+  for (uint64_t i = 0; i < state.iterations(); i++)
+  {
+    benchMillis += BENCH_INTERVAL_MS;
+    isrTimer.run();
+  }
+
+  state.setItemsProcessed(state.iterations());
+}
+
+static void BM_dispatch_context(BenchState& state, int, int)
+{
+  static ISR_Timer isrTimer;
+
+  armTimers(isrTimer, 1, 1, TIMER_CALLBACK_CONTEXT);
+
+  for (uint64_t i = 0; i < state.iterations(); i++)
+  {
+    benchMillis += BENCH_INTERVAL_MS;
+    isrTimer.run();
+  }
+
+  state.setItemsProcessed(state.iterations());
+}
+
+// setupTimer() / deleteTimer() churn with 'resident' other timers already occupying the low slots
+static void BM_churn_setInterval(BenchState& state, int resident, int)
+{
+  static ISR_Timer isrTimer;
+
+  armTimers(isrTimer, resident, 0, TIMER_CALLBACK_NO_PARAM);
+
+  for (uint64_t i = 0; i < state.iterations(); i++)
+  {
+    int numTimer = isrTimer.setInterval(BENCH_INTERVAL_MS, benchCallback);
+
+    doNotOptimize(numTimer);
+    isrTimer.deleteTimer(numTimer);
+  }
+
+  state.setItemsProcessed(state.iterations());
+}
+
+// setTimeout() timers delete themselves from run() after their single invocation
+static void BM_churn_setTimeout(BenchState& state, int resident, int)
+{
+  static ISR_Timer isrTimer;
+
+  armTimers(isrTimer, resident, 0, TIMER_CALLBACK_NO_PARAM);
+
+  for (uint64_t i = 0; i < state.iterations(); i++)
+  {
+    isrTimer.setTimeout(BENCH_INTERVAL_MS, benchCallback);
+    benchMillis += BENCH_INTERVAL_MS;
+    isrTimer.run();
+  }
+
+  state.setItemsProcessed(state.iterations());
+}
+
+///////////////////////////////////////////
+// Prescaler / compare value solvers
+// The very functions the backends call, from TimerInterrupt_Generic_Solvers.h, with the clocks of the boards
+///////////////////////////////////////////
+
+#include "TimerInterrupt_Generic_Solvers.h"
+
+// Prescaler tables of AVRTimerInterrupt_Generic.h
+static const unsigned int prescalerDiv   [6] = { 1, 1, 8, 64, 256, 1024 };
+static const unsigned int prescalerDivT2 [8] = { 1, 1, 8, 32,  64,  128, 256, 1024 };
+
+#define BENCH_AVR_F_CPU       16000000UL
+#define BENCH_SAMD_TIMER_HZ   48000000UL
+#define BENCH_DUE_MCK         84000000UL
+#define BENCH_TEENSY4_F_BUS   150000000UL
+
+// Sweep of requested frequencies, from very slow (multi-overflow) to the fastest practical rates
+static const float sweepHz[] = { 0.01f, 0.5f, 1.0f, 10.0f, 50.0f, 100.0f, 1000.0f, 5000.0f, 10000.0f, 50000.0f };
+#define SWEEP_LEN     ( sizeof(sweepHz) / sizeof(sweepHz[0]) )
+
+static void BM_solver_avr16(BenchState& state, int, int)
+{
+  unsigned long OCRValue;
+
+  for (uint64_t i = 0; i < state.iterations(); i++)
+  {
+    int index = tisr_solver_avr(BENCH_AVR_F_CPU, sweepHz[i % SWEEP_LEN], prescalerDiv,
+                                tisr_solver_avr_first_index(sweepHz[i % SWEEP_LEN] * 17179.840, false), 5, 65535, OCRValue);
+    doNotOptimize(index);
+    doNotOptimize(OCRValue);
+  }
+
+  state.setItemsProcessed(state.iterations());
+}
+
+static void BM_solver_avrT2(BenchState& state, int, int)
+{
+  unsigned long OCRValue;
+
+  for (uint64_t i = 0; i < state.iterations(); i++)
+  {
+    int index = tisr_solver_avr(BENCH_AVR_F_CPU, sweepHz[i % SWEEP_LEN], prescalerDivT2,
+                                tisr_solver_avr_first_index(sweepHz[i % SWEEP_LEN] * 17179.840, true), 7, 255, OCRValue);
+    doNotOptimize(index);
+    doNotOptimize(OCRValue);
+  }
+
+  state.setItemsProcessed(state.iterations());
+}
+
+static void BM_solver_samdTC(BenchState& state, int, int)
+{
+  int     compareValue;
+  uint8_t prescalerField;
+
+  for (uint64_t i = 0; i < state.iterations(); i++)
+  {
+    int prescaler = tisr_solver_samd(BENCH_SAMD_TIMER_HZ, 1000000.0f / sweepHz[i % SWEEP_LEN], prescalerField, compareValue);
+    doNotOptimize(prescaler);
+    doNotOptimize(compareValue);
+  }
+
+  state.setItemsProcessed(state.iterations());
+}
+
+static void BM_solver_dueBestClock(BenchState& state, int, int)
+{
+  uint32_t rc;
+
+  for (uint64_t i = 0; i < state.iterations(); i++)
+  {
+    uint8_t clock = tisr_solver_due(BENCH_DUE_MCK, sweepHz[i % SWEEP_LEN], rc);
+    doNotOptimize(clock);
+    doNotOptimize(rc);
+  }
+
+  state.setItemsProcessed(state.iterations());
+}
+
+static void BM_solver_teensy4(BenchState& state, int, int)
+{
+  uint32_t prescale;
+
+  for (uint64_t i = 0; i < state.iterations(); i++)
+  {
+    uint32_t period = tisr_solver_teensy4(BENCH_TEENSY4_F_BUS, 1000000.0f / sweepHz[i % SWEEP_LEN], prescale);
+    doNotOptimize(period);
+    doNotOptimize(prescale);
+  }
+
+  state.setItemsProcessed(state.iterations());
+}
+
+///////////////////////////////////////////
+
+static void registerAll()
+{
+  // run() with no timer due, as in the vast majority of hardware timer ticks
+  for (int armed = 0; armed <= MAX_NUMBER_TIMERS; armed += 4)
+    registerBenchmark("BM_run", BM_run, armed, 0);
+
+  // run() with all armed timers due
+  for (int armed = 1; armed <= MAX_NUMBER_TIMERS; armed *= 2)
+    registerBenchmark("BM_run", BM_run, armed, armed);
+
+  registerBenchmark("BM_dispatch_noParam",    BM_dispatch_noParam);
+  registerBenchmark("BM_dispatch_param",      BM_dispatch_param);
+  registerBenchmark("BM_dispatch_context",    BM_dispatch_context);
+
+  registerBenchmark("BM_churn_setInterval",   BM_churn_setInterval, 0);
+  registerBenchmark("BM_churn_setInterval",   BM_churn_setInterval, MAX_NUMBER_TIMERS - 1);
+  registerBenchmark("BM_churn_setTimeout",    BM_churn_setTimeout,  0);
+  registerBenchmark("BM_churn_setTimeout",    BM_churn_setTimeout,  MAX_NUMBER_TIMERS - 1);
+
+  registerBenchmark("BM_solver_avr16",        BM_solver_avr16);
+  registerBenchmark("BM_solver_avrT2",        BM_solver_avrT2);
+  registerBenchmark("BM_solver_samdTC",       BM_solver_samdTC);
+  registerBenchmark("BM_solver_dueBestClock", BM_solver_dueBestClock);
+  registerBenchmark("BM_solver_teensy4",      BM_solver_teensy4);
+}
+
+///////////////////////////////////////////
+
+typedef struct
+{
+  uint64_t  iterations;
+  double    realNs;       // per iteration
+  double    cpuNs;        // per iteration
+  double    itemsPerSec;
+} result_t;
+
+static result_t runBenchmark(const benchmark_t& b, double minTime)
+{
+  uint64_t iterations = 1;
+  result_t result;
+
+  // Grow the iteration count until one batch lasts at least minTime, as Google Benchmark does
+  while (true)
+  {
+    BenchState state(iterations);
+
+    double wallStart = wallSeconds();
+    double cpuStart  = cpuSeconds();
+
+    b.func(state, b.arg0, b.arg1);
+
+    double wall = wallSeconds() - wallStart;
+    double cpu  = cpuSeconds()  - cpuStart;
+
+    if ( (wall >= minTime) || (iterations >= 1000000000ULL) )
+    {
+      result.iterations   = iterations;
+      result.realNs       = wall * 1e9 / iterations;
+      result.cpuNs        = cpu  * 1e9 / iterations;
+      result.itemsPerSec  = (cpu > 0) ? state.itemsProcessed() / cpu : 0;
+
+      return result;
+    }
+
+    double multiplier = (wall > 0) ? (minTime * 1.4 / wall) : 10.0;
+
+    if (multiplier > 10.0)
+      multiplier = 10.0;
+    else if (multiplier < 1.5)
+      multiplier = 1.5;
+
+    iterations = (uint64_t) (iterations * multiplier) + 1;
+  }
+}
+
+static void writeJsonHeader(FILE* json)
+{
+  char dateStr[64];
+  time_t now = time(NULL);
+
+  strftime(dateStr, sizeof(dateStr), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+
+  fprintf(json, "{\n  \"context\": {\n");
+  fprintf(json, "    \"date\": \"%s\",\n", dateStr);
+  fprintf(json, "    \"executable\": \"ISR_Timer_Benchmark\",\n");
+  fprintf(json, "    \"library_version\": \"%s\",\n", TIMER_INTERRUPT_GENERIC_VERSION);
+  fprintf(json, "    \"max_number_timers\": %d,\n", MAX_NUMBER_TIMERS);
+#if defined(__OPTIMIZE__)
+  fprintf(json, "    \"library_build_type\": \"release\"\n");
+#else
+  fprintf(json, "    \"library_build_type\": \"debug\"\n");
+#endif
+  fprintf(json, "  },\n  \"benchmarks\": [\n");
+}
+
+static void writeJsonResult(FILE* json, const benchmark_t& b, const result_t& r, bool last)
+{
+  fprintf(json, "    {\n");
+  fprintf(json, "      \"name\": \"%s\",\n", b.name);
+  fprintf(json, "      \"run_name\": \"%s\",\n", b.name);
+  fprintf(json, "      \"run_type\": \"iteration\",\n");
+  fprintf(json, "      \"iterations\": %llu,\n", (unsigned long long) r.iterations);
+  fprintf(json, "      \"real_time\": %.4f,\n", r.realNs);
+  fprintf(json, "      \"cpu_time\": %.4f,\n", r.cpuNs);
+  fprintf(json, "      \"time_unit\": \"ns\",\n");
+  fprintf(json, "      \"items_per_second\": %.2f\n", r.itemsPerSec);
+  fprintf(json, "    }%s\n", last ? "" : ",");
+}
+
+int main(int argc, char* argv[])
+{
+  const char* jsonPath  = NULL;
+  const char* filter    = NULL;
+  double      minTime   = 0.2;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if ( (strcmp(argv[i], "--json") == 0) && (i + 1 < argc) )
+      jsonPath = argv[++i];
+    else if ( (strcmp(argv[i], "--filter") == 0) && (i + 1 < argc) )
+      filter = argv[++i];
+    else if ( (strcmp(argv[i], "--min_time") == 0) && (i + 1 < argc) )
+      minTime = atof(argv[++i]);
+    else
+    {
+      fprintf(stderr, "Usage: %s [--json file] [--filter substring] [--min_time seconds]\n", argv[0]);
+
+      return 1;
+    }
+  }
+
+  registerAll();
+
+  FILE* json = NULL;
+
+  if (jsonPath)
+  {
+    json = (strcmp(jsonPath, "-") == 0) ? stdout : fopen(jsonPath, "w");
+
+    if (json == NULL)
+    {
+      perror(jsonPath);
+
+      return 1;
+    }
+
+    writeJsonHeader(json);
+  }
+
+  // Select first, so that the JSON separator of the last entry is known
+  int selected[MAX_BENCHMARKS];
+  int numSelected = 0;
+
+  for (int i = 0; i < numBenchmarks; i++)
+  {
+    if ( (filter == NULL) || strstr(benchmarks[i].name, filter) )
+      selected[numSelected++] = i;
+  }
+
+  FILE* console = (json == stdout) ? stderr : stdout;
+
+  fprintf(console, "%-32s %14s %14s %14s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations");
+  fprintf(console, "--------------------------------------------------------------------------------\n");
+
+  for (int i = 0; i < numSelected; i++)
+  {
+    const benchmark_t& b = benchmarks[selected[i]];
+    result_t r = runBenchmark(b, minTime);
+
+    fprintf(console, "%-32s %14.2f %14.2f %14llu\n", b.name, r.realNs, r.cpuNs, (unsigned long long) r.iterations);
+
+    if (json)
+      writeJsonResult(json, b, r, i == numSelected - 1);
+  }
+
+  if (json)
+  {
+    fprintf(json, "  ]\n}\n");
+
+    if (json != stdout)
+      fclose(json);
+  }
+
+  return 0;
+}
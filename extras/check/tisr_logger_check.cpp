@@ -0,0 +1,100 @@
+/****************************************************************************************************************************
+  tisr_logger_check.cpp
+  Native (host) build and check of TISR_BlockLogger of TimerInterrupt_Generic_Logger.h
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Builds the logger without ARDUINO, with TISR_LogFileDevice, and checks that :
+  1) begin() refuses a block size which isn't a multiple of the device's erase size
+  2) the log file holds the records written, in order, across the blocks and the partial last block
+  3) the records which didn't fit while run() was late are counted as dropped, not written
+
+  Build and run from this directory :
+
+    g++ -O2 -std=gnu++11 -I../../src tisr_logger_check.cpp -o tisr_logger_check
+    ./tisr_logger_check                 // exit code 0 if all the checks pass
+*****************************************************************************************************************************/
+
+#include "TimerInterrupt_Generic_Logger.h"
+
+// 10 bytes : records straddle the blocks
+typedef struct __attribute__((packed))
+{
+  uint32_t  sequence;
+  int16_t   values[3];
+} Record;
+
+#define NUM_RECORDS       20000
+
+TISR_BlockLogger<512, 4> logger;
+
+int main()
+{
+  int numFailed = 0;
+
+  FILE* file = tmpfile();
+
+  if (file == NULL)
+  {
+    printf("FAIL  tmpfile()\n");
+    return 1;
+  }
+
+  TISR_LogFileDevice device(file, 512);
+
+  // 1) Erase size
+  TISR_BlockLogger<500, 2> misaligned;
+
+  bool passed = !misaligned.begin(&device) && logger.begin(&device);
+
+  printf("%s  begin() checks the erase size\n", passed ? "OK  " : "FAIL");
+
+  if (!passed)
+    numFailed++;
+
+  // 2) and 3) run() only every 300 records : the 4 blocks hold about 200, the others are dropped
+  uint32_t numWritten = 0;
+
+  for (uint32_t i = 0; i < NUM_RECORDS; i++)
+  {
+    Record record = { numWritten, { (int16_t) i, 2, 3 } };
+
+    if (logger.write(record))
+      numWritten++;
+
+    if (i % 300 == 299)
+      logger.run();
+  }
+
+  logger.end();
+
+  rewind(file);
+
+  Record    record;
+  uint32_t  numRead     = 0;
+  uint32_t  numBadOrder = 0;
+
+  while (fread(&record, sizeof(record), 1, file) == 1)
+  {
+    if (record.sequence != numRead)
+      numBadOrder++;
+
+    numRead++;
+  }
+
+  fclose(file);
+
+  passed = (numRead == numWritten) && (numBadOrder == 0) && (logger.getNumRecords() == numWritten) &&
+           (numWritten + logger.getNumDropped() == NUM_RECORDS) && (logger.getNumDropped() > 0) &&
+           (logger.getNumWriteErrors() == 0);
+
+  printf("%s  %lu records written, %lu read back in order, %lu dropped, max %u blocks queued\n",
+         passed ? "OK  " : "FAIL", (unsigned long) numWritten, (unsigned long) (numRead - numBadOrder),
+         (unsigned long) logger.getNumDropped(), logger.getMaxBlocksQueued());
+
+  if (!passed)
+    numFailed++;
+
+  return (numFailed == 0) ? 0 : 1;
+}
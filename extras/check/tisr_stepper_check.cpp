@@ -0,0 +1,95 @@
+/****************************************************************************************************************************
+  tisr_stepper_check.cpp
+  Native (host) check of the TISR_StepperRamp profiles of TimerInterrupt_Generic_Stepper.h
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Runs moves through nextInterval(), trapezoidal and S-curve, long and short (triangle), and checks that each one :
+  1) issues exactly the requested steps
+  2) never falls to the slowest period (maxTicks) before the end, i.e. the deceleration doesn't stop early
+  3) ends slowing down : the last period is at least 1/10 of the first one of the trapezoid, as it starts
+
+  Build and run from this directory :
+
+    g++ -O2 -std=gnu++11 -I../../src tisr_stepper_check.cpp -o tisr_stepper_check
+    ./tisr_stepper_check                // exit code 0 if all the moves pass
+*****************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "TimerInterrupt_Generic_Stepper.h"
+
+typedef struct
+{
+  uint32_t  timerHz;
+  float     accel;
+  float     speed;
+  int32_t   steps;
+  uint16_t  jerkSteps;
+} MoveCase;
+
+static const MoveCase moveCases[] =
+{
+  { 2000000,  4000,   4000,   20000,  0    },
+  { 2000000,  4000,   4000,   20000,  50   },
+  { 2000000,  4000,   4000,   20000,  200  },
+  { 2000000,  4000,   4000,   20000,  500  },
+  { 2000000,  4000,   4000,   20000,  2000 },
+  { 2000000,  4000,   4000,   -3000,  0    },
+  { 2000000,  4000,   4000,   3000,   200  },
+  { 2000000,  4000,   4000,   3000,   500  },
+  { 2000000,  20000,  40000,  200,    0    },
+  { 2000000,  20000,  40000,  200,    100  },
+  { 1000000,  5000,   10000,  50000,  1000 },
+};
+
+int main()
+{
+  int numFailed = 0;
+
+  for (size_t i = 0; i < sizeof(moveCases) / sizeof(moveCases[0]); i++)
+  {
+    const MoveCase& move = moveCases[i];
+
+    TISR_StepperRamp ramp;
+
+    ramp.begin(move.timerHz, 4, 0xFFFF);
+    ramp.setAcceleration(move.accel);
+    ramp.setMaxSpeed(move.speed);
+    ramp.setSCurve(move.jerkSteps);
+    ramp.move(move.steps);
+
+    uint32_t  numSteps    = 0;
+    uint32_t  numClamped  = 0;
+    uint16_t  lastTicks   = 0;
+    double    seconds     = 0;
+    uint16_t  ticks;
+
+    while ( (ticks = ramp.nextInterval()) != 0 )
+    {
+      numSteps++;
+      seconds   += (double) ticks / move.timerHz;
+      lastTicks  = ticks;
+
+      if (ticks == 0xFFFF)
+        numClamped++;
+    }
+
+    // AVR446 first period of the trapezoid
+    double firstTicks = 0.676 * move.timerHz * sqrt(2.0 / move.accel);
+
+    bool passed = (ramp.getPosition() == move.steps) && (numClamped == 0) && (lastTicks >= firstTicks / 10);
+
+    printf("%s  steps %6ld, S-curve %4u : %.3f s, last period %5u ticks (first %5.0f), %lu at maxTicks\n",
+           passed ? "OK  " : "FAIL", (long) move.steps, move.jerkSteps, seconds, lastTicks, firstTicks,
+           (unsigned long) numClamped);
+
+    if (!passed)
+      numFailed++;
+  }
+
+  return (numFailed == 0) ? 0 : 1;
+}
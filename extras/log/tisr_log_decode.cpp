@@ -0,0 +1,62 @@
+/****************************************************************************************************************************
+  tisr_log_decode.cpp
+  Converts TimerInterrupt_Generic_DeferredLog.h binary records back to text
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Build and run from this directory :
+
+    g++ -O2 -std=gnu++11 tisr_log_decode.cpp -o tisr_log_decode
+    ./tisr_log_decode sketch.ino.elf capture.bin
+
+  sketch.ino.elf is the ELF file of the exact build that produced the capture (Arduino IDE : Sketch -> Export compiled
+  Binary, or the build folder). capture.bin is the raw serial output, e.g. "cat /dev/ttyUSB0 > capture.bin".
+*****************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tisr_log_decode.h"
+
+int main(int argc, char** argv)
+{
+  if (argc < 3)
+  {
+    fprintf(stderr, "Usage: %s sketch.elf capture.bin\n", argv[0]);
+    return 1;
+  }
+
+  TISR_ElfStrings strings;
+
+  if (!strings.load(argv[1]))
+  {
+    fprintf(stderr, "Can't load ELF file %s\n", argv[1]);
+    return 1;
+  }
+
+  FILE* in = fopen(argv[2], "rb");
+
+  if (in == NULL)
+  {
+    perror(argv[2]);
+    return 1;
+  }
+
+  std::vector<uint8_t>  data;
+  uint8_t               buffer[4096];
+  size_t                numRead;
+
+  while ( (numRead = fread(buffer, 1, sizeof(buffer), in)) > 0 )
+    data.insert(data.end(), buffer, buffer + numRead);
+
+  fclose(in);
+
+  TISR_LogDecoder decoder(strings);
+
+  std::string text = decoder.decode(data.data(), data.size());
+
+  fwrite(text.data(), 1, text.size(), stdout);
+
+  return 0;
+}
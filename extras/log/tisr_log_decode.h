@@ -0,0 +1,323 @@
+/****************************************************************************************************************************
+  tisr_log_decode.h
+  Host-side decoder for the binary records of TimerInterrupt_Generic_DeferredLog.h
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Header-only, C++11, no dependency beyond the standard library. This file is not part of the Arduino library build
+  (extras/ is excluded by library.json).
+
+  TISR_ElfStrings loads the allocated sections of the sketch's ELF file (32 or 64-bit, little-endian) and resolves the
+  string addresses carried by the records. On AVR, RAM addresses (TISR_DLOG_STR) live at 0x800000 + address in the ELF
+  file, flash addresses (TISR_DLOG_FSTR) are used as is.
+
+  TISR_LogDecoder turns a raw serial capture into text. Bytes outside records (anything else the sketch printed)
+  are passed through unchanged.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TISR_LOG_DECODE_H
+#define TISR_LOG_DECODE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+// Must match TimerInterrupt_Generic_DeferredLog.h
+#define TISR_DLOG_RAW                   0x80
+#define TISR_DLOG_DROPPED               0x7F
+
+#define TISR_DLOG_STR                   1
+#define TISR_DLOG_FSTR                  2
+#define TISR_DLOG_INT                   3
+#define TISR_DLOG_UINT                  4
+#define TISR_DLOG_FLOAT                 5
+#define TISR_DLOG_CHAR                  6
+#define TISR_DLOG_PTR                   7
+
+#define TISR_DLOG_SYNC0                 0xA5
+#define TISR_DLOG_SYNC1                 0x5A
+
+#define TISR_DLOG_MAX_ARGS              6
+
+///////////////////////////////////////////
+
+class TISR_ElfStrings
+{
+  public:
+
+    TISR_ElfStrings() : _isAVR(false)
+    {
+    }
+
+    // Returns false if the file can't be read or isn't a little-endian ELF file
+    bool load(const char* path)
+    {
+      FILE* file = fopen(path, "rb");
+
+      if (file == NULL)
+        return false;
+
+      fseek(file, 0, SEEK_END);
+      _image.resize((size_t) ftell(file));
+      fseek(file, 0, SEEK_SET);
+
+      bool ok = ( fread(_image.data(), 1, _image.size(), file) == _image.size() );
+
+      fclose(file);
+
+      return ok && parse();
+    }
+
+    bool isAVR() const
+    {
+      return _isAVR;
+    }
+
+    // NULL if the address isn't inside an allocated section with file contents
+    const char* lookup(uint32_t address, const uint8_t& tag) const
+    {
+      if (_isAVR && (tag == TISR_DLOG_STR))
+        address |= 0x800000UL;
+
+      for (size_t i = 0; i < _sections.size(); i++)
+      {
+        const Section& section = _sections[i];
+
+        if ( (address >= section.address) && (address - section.address < section.size) )
+        {
+          size_t offset = (size_t) (section.offset + (address - section.address));
+
+          // Make sure the string is terminated inside the file
+          if (memchr(&_image[offset], 0, _image.size() - offset) == NULL)
+            return NULL;
+
+          return (const char*) &_image[offset];
+        }
+      }
+
+      return NULL;
+    }
+
+  private:
+
+    struct Section
+    {
+      uint64_t  address;
+      uint64_t  offset;
+      uint64_t  size;
+    };
+
+    uint64_t read(const size_t& offset, const uint8_t& numBytes) const
+    {
+      uint64_t value = 0;
+
+      if (offset + numBytes > _image.size())
+        return 0;
+
+      for (uint8_t i = numBytes; i > 0; i--)
+        value = (value << 8) | _image[offset + i - 1];
+
+      return value;
+    }
+
+    bool parse()
+    {
+      const uint8_t EM_AVR        = 83;
+      const uint32_t SHT_NOBITS   = 8;
+      const uint64_t SHF_ALLOC    = 2;
+
+      if ( (_image.size() < 52) || (memcmp(_image.data(), "\x7F" "ELF", 4) != 0) || (_image[5] != 1) )
+        return false;
+
+      bool is64 = (_image[4] == 2);
+
+      _isAVR = ( read(18, 2) == EM_AVR );
+
+      uint64_t shoff      = is64 ? read(40, 8) : read(32, 4);
+      uint16_t shentsize  = (uint16_t) read(is64 ? 58 : 46, 2);
+      uint16_t shnum      = (uint16_t) read(is64 ? 60 : 48, 2);
+
+      for (uint16_t i = 0; i < shnum; i++)
+      {
+        size_t header = (size_t) (shoff + (uint64_t) i * shentsize);
+
+        uint32_t  type    = (uint32_t) read(header + 4, 4);
+        uint64_t  flags   = is64 ? read(header + 8, 8)  : read(header + 8, 4);
+        Section   section;
+
+        section.address = is64 ? read(header + 16, 8) : read(header + 12, 4);
+        section.offset  = is64 ? read(header + 24, 8) : read(header + 16, 4);
+        section.size    = is64 ? read(header + 32, 8) : read(header + 20, 4);
+
+        if ( (flags & SHF_ALLOC) && (type != SHT_NOBITS) && (section.size > 0) &&
+             (section.offset + section.size <= _image.size()) )
+        {
+          _sections.push_back(section);
+        }
+      }
+
+      return !_sections.empty();
+    }
+
+    std::vector<uint8_t>  _image;
+    std::vector<Section>  _sections;
+    bool                  _isAVR;
+};
+
+///////////////////////////////////////////
+
+class TISR_LogDecoder
+{
+  public:
+
+    explicit TISR_LogDecoder(const TISR_ElfStrings& strings) : _strings(strings)
+    {
+    }
+
+    // Same text as the direct TISR_LOGxxx macros, plus pass-through of the non-record bytes
+    std::string decode(const uint8_t* data, const size_t& length) const
+    {
+      std::string text;
+      size_t      pos = 0;
+
+      while (pos < length)
+      {
+        size_t used = 0;
+
+        if ( (data[pos] == TISR_DLOG_SYNC0) && (pos + 1 < length) && (data[pos + 1] == TISR_DLOG_SYNC1) )
+          used = decodeRecord(data + pos, length - pos, text);
+
+        if (used == 0)
+        {
+          text += (char) data[pos];
+          used = 1;
+        }
+
+        pos += used;
+      }
+
+      return text;
+    }
+
+  private:
+
+    // Returns the number of bytes used, 0 if this isn't a complete, valid record
+    size_t decodeRecord(const uint8_t* data, const size_t& length, std::string& text) const
+    {
+      if (length < 4)
+        return 0;
+
+      uint8_t level = data[2];
+      uint8_t nargs = data[3];
+
+      if ( (nargs > TISR_DLOG_MAX_ARGS) || (length < 4 + 5 * (size_t) nargs) )
+        return 0;
+
+      std::string line;
+      bool        raw = (level & TISR_DLOG_RAW);
+
+      if (level == TISR_DLOG_DROPPED)
+      {
+        line = "[TISR] Deferred log dropped " + std::to_string(readLE(data + 5)) + " records\n";
+        text += line;
+
+        return 4 + 5 * (size_t) nargs;
+      }
+
+      if (!raw)
+        line = "[TISR] ";
+
+      for (uint8_t i = 0; i < nargs; i++)
+      {
+        const uint8_t*  arg   = data + 4 + 5 * i;
+        uint32_t        value = readLE(arg + 1);
+
+        if (i > 0)
+          line += " ";
+
+        if (!formatArg(arg[0], value, line))
+          return 0;
+      }
+
+      if (!raw)
+        line += "\r\n";
+
+      text += line;
+
+      return 4 + 5 * (size_t) nargs;
+    }
+
+    bool formatArg(const uint8_t& tag, const uint32_t& value, std::string& line) const
+    {
+      char buffer[32];
+
+      switch (tag)
+      {
+        case TISR_DLOG_STR:
+        case TISR_DLOG_FSTR:
+        {
+          const char* s = _strings.lookup(value, tag);
+
+          if (s != NULL)
+            line += s;
+          else
+          {
+            snprintf(buffer, sizeof(buffer), "<str@0x%08X>", value);
+            line += buffer;
+          }
+
+          return true;
+        }
+
+        case TISR_DLOG_INT:
+          line += std::to_string( (int32_t) value );
+          return true;
+
+        case TISR_DLOG_UINT:
+          line += std::to_string(value);
+          return true;
+
+        case TISR_DLOG_FLOAT:
+        {
+          float f;
+
+          memcpy(&f, &value, sizeof(f));
+
+          // Print(float) default of 2 decimals
+          snprintf(buffer, sizeof(buffer), "%.2f", f);
+          line += buffer;
+          return true;
+        }
+
+        case TISR_DLOG_CHAR:
+          line += (char) value;
+          return true;
+
+        case TISR_DLOG_PTR:
+          // Print(unsigned long, HEX), no leading zeros
+          snprintf(buffer, sizeof(buffer), "0x%X", value);
+          line += buffer;
+          return true;
+
+        default:
+          return false;
+      }
+    }
+
+    static uint32_t readLE(const uint8_t* p)
+    {
+      return (uint32_t) p[0] | ( (uint32_t) p[1] << 8 ) | ( (uint32_t) p[2] << 16 ) | ( (uint32_t) p[3] << 24 );
+    }
+
+    const TISR_ElfStrings& _strings;
+};
+
+///////////////////////////////////////////
+
+#endif    // TISR_LOG_DECODE_H
@@ -0,0 +1,90 @@
+/****************************************************************************************************************************
+  tisr_profile.cpp
+  Symbolizes TimerInterrupt_Generic_Profiler.h dumps into a flat per-function profile
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Build and run from this directory :
+
+    g++ -O2 -std=gnu++11 tisr_profile.cpp -o tisr_profile
+    ./tisr_profile sketch.ino.elf capture.txt [-a]
+
+  sketch.ino.elf is the ELF file of the exact build that produced the capture (Arduino IDE : Sketch -> Export compiled
+  Binary, or the build folder). capture.txt is the serial output holding the dump. -a also lists every address range.
+*****************************************************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "tisr_profile_decode.h"
+
+int main(int argc, char** argv)
+{
+  if (argc < 3)
+  {
+    fprintf(stderr, "Usage: %s sketch.elf capture.txt [-a]\n", argv[0]);
+    return 1;
+  }
+
+  TISR_ElfSymbols symbols;
+
+  if (!symbols.load(argv[1]))
+  {
+    fprintf(stderr, "Can't load symbols from ELF file %s\n", argv[1]);
+    return 1;
+  }
+
+  FILE* in = fopen(argv[2], "rb");
+
+  if (in == NULL)
+  {
+    perror(argv[2]);
+    return 1;
+  }
+
+  std::string text;
+  char        buffer[4096];
+  size_t      numRead;
+
+  while ( (numRead = fread(buffer, 1, sizeof(buffer), in)) > 0 )
+    text.append(buffer, numRead);
+
+  fclose(in);
+
+  TISR_ProfileReport report;
+
+  if (!report.parse(text, symbols))
+  {
+    fprintf(stderr, "No TISR_PROFILE dump found in %s\n", argv[2]);
+    return 1;
+  }
+
+  uint64_t total = report.getNumSamples();
+
+  printf("%llu samples, %llu dropped\n\n", (unsigned long long) total, (unsigned long long) report.getNumDropped());
+  printf("%8s %7s  %s\n", "samples", "%", "function");
+
+  std::vector<TISR_ProfileReport::Entry> functions = report.getFunctions();
+
+  for (size_t i = 0; i < functions.size(); i++)
+  {
+    printf("%8llu %6.2f%%  %s\n", (unsigned long long) functions[i].samples,
+           (total == 0) ? 0.0 : 100.0 * functions[i].samples / total, functions[i].name.c_str());
+  }
+
+  if ( (argc > 3) && (strcmp(argv[3], "-a") == 0) )
+  {
+    printf("\n%10s %8s  %s\n", "address", "samples", "function");
+
+    const std::map<uint64_t, TISR_ProfileReport::Entry>& addresses = report.getAddresses();
+
+    for (std::map<uint64_t, TISR_ProfileReport::Entry>::const_iterator it = addresses.begin(); it != addresses.end(); ++it)
+    {
+      printf("0x%08llX %8llu  %s\n", (unsigned long long) it->first, (unsigned long long) it->second.samples,
+             it->second.name.c_str());
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,311 @@
+/****************************************************************************************************************************
+  tisr_profile_decode.h
+  Host-side symbolizer for the dumps of TimerInterrupt_Generic_Profiler.h
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Header-only, C++11, no dependency beyond the standard library. This file is not part of the Arduino library build
+  (extras/ is excluded by library.json).
+
+  TISR_ElfSymbols loads the function symbols (STT_FUNC) of the sketch's ELF file (32 or 64-bit, little-endian). The
+  Thumb bit of ARM symbols is cleared, and symbols without a size extend to the next symbol.
+
+  TISR_ProfileReport parses the text dump (any other line the sketch printed is skipped) and aggregates the sampled
+  address ranges per function. A range straddling two functions is attributed to the one holding its start address.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TISR_PROFILE_DECODE_H
+#define TISR_PROFILE_DECODE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__)
+  #include <cxxabi.h>
+#endif
+
+///////////////////////////////////////////
+
+class TISR_ElfSymbols
+{
+  public:
+
+    // Returns false if the file can't be read, isn't a little-endian ELF file or has no symbol table (stripped)
+    bool load(const char* path)
+    {
+      FILE* file = fopen(path, "rb");
+
+      if (file == NULL)
+        return false;
+
+      fseek(file, 0, SEEK_END);
+      _image.resize((size_t) ftell(file));
+      fseek(file, 0, SEEK_SET);
+
+      bool ok = ( fread(_image.data(), 1, _image.size(), file) == _image.size() );
+
+      fclose(file);
+
+      return ok && parse();
+    }
+
+    // Demangled name of the function holding address, NULL if none
+    const char* lookup(const uint64_t& address) const
+    {
+      // First symbol starting after address, the candidate is the one before it
+      std::vector<Symbol>::const_iterator it = std::upper_bound(_symbols.begin(), _symbols.end(), address,
+                                                                [](const uint64_t& a, const Symbol& s) { return a < s.address; });
+
+      if (it == _symbols.begin())
+        return NULL;
+
+      --it;
+
+      if ( (it->size != 0) && (address - it->address >= it->size) )
+        return NULL;
+
+      return it->name.c_str();
+    }
+
+  private:
+
+    struct Symbol
+    {
+      uint64_t    address;
+      uint64_t    size;
+      std::string name;
+
+      bool operator<(const Symbol& other) const
+      {
+        return address < other.address;
+      }
+    };
+
+    uint64_t read(const size_t& offset, const uint8_t& numBytes) const
+    {
+      uint64_t value = 0;
+
+      if (offset + numBytes > _image.size())
+        return 0;
+
+      for (uint8_t i = numBytes; i > 0; i--)
+        value = (value << 8) | _image[offset + i - 1];
+
+      return value;
+    }
+
+    static std::string demangle(const char* name)
+    {
+#if defined(__GNUC__)
+      int   status;
+      char* demangled = abi::__cxa_demangle(name, NULL, NULL, &status);
+
+      if (demangled != NULL)
+      {
+        std::string result(demangled);
+
+        free(demangled);
+
+        return result;
+      }
+#endif
+
+      return std::string(name);
+    }
+
+    bool parse()
+    {
+      const uint16_t EM_ARM       = 40;
+      const uint32_t SHT_SYMTAB   = 2;
+      const uint8_t  STT_FUNC     = 2;
+
+      if ( (_image.size() < 52) || (memcmp(_image.data(), "\x7F" "ELF", 4) != 0) || (_image[5] != 1) )
+        return false;
+
+      bool is64   = (_image[4] == 2);
+      bool isARM  = ( read(18, 2) == EM_ARM );
+
+      uint64_t shoff      = is64 ? read(40, 8) : read(32, 4);
+      uint16_t shentsize  = (uint16_t) read(is64 ? 58 : 46, 2);
+      uint16_t shnum      = (uint16_t) read(is64 ? 60 : 48, 2);
+
+      for (uint16_t i = 0; i < shnum; i++)
+      {
+        size_t header = (size_t) (shoff + (uint64_t) i * shentsize);
+
+        if ( (uint32_t) read(header + 4, 4) != SHT_SYMTAB )
+          continue;
+
+        uint64_t  offset    = is64 ? read(header + 24, 8) : read(header + 16, 4);
+        uint64_t  size      = is64 ? read(header + 32, 8) : read(header + 20, 4);
+        uint32_t  link      = (uint32_t) (is64 ? read(header + 40, 4) : read(header + 24, 4));
+        uint64_t  entsize   = is64 ? read(header + 56, 8) : read(header + 36, 4);
+
+        // Associated string table
+        size_t    strHeader = (size_t) (shoff + (uint64_t) link * shentsize);
+        uint64_t  strOffset = is64 ? read(strHeader + 24, 8) : read(strHeader + 16, 4);
+        uint64_t  strSize   = is64 ? read(strHeader + 32, 8) : read(strHeader + 20, 4);
+
+        if ( (entsize == 0) || (offset + size > _image.size()) || (strOffset + strSize > _image.size()) )
+          continue;
+
+        for (uint64_t entry = offset; entry + entsize <= offset + size; entry += entsize)
+        {
+          uint32_t  nameIndex = (uint32_t) read((size_t) entry, 4);
+          uint8_t   info      = (uint8_t) read((size_t) entry + (is64 ? 4 : 12), 1);
+          uint16_t  shndx     = (uint16_t) read((size_t) entry + (is64 ? 6 : 14), 2);
+          Symbol    symbol;
+
+          // Undefined (imported) functions have no address
+          if ( ( (info & 0x0F) != STT_FUNC ) || (shndx == 0) || (nameIndex >= strSize) )
+            continue;
+
+          symbol.address  = is64 ? read((size_t) entry + 8, 8)  : read((size_t) entry + 4, 4);
+          symbol.size     = is64 ? read((size_t) entry + 16, 8) : read((size_t) entry + 8, 4);
+
+          if (isARM)
+            symbol.address &= ~1ULL;
+
+          const char* name = (const char*) &_image[(size_t) (strOffset + nameIndex)];
+
+          if (memchr(name, 0, (size_t) (strSize - nameIndex)) == NULL)
+            continue;
+
+          symbol.name = demangle(name);
+
+          _symbols.push_back(symbol);
+        }
+      }
+
+      std::sort(_symbols.begin(), _symbols.end());
+
+      return !_symbols.empty();
+    }
+
+    std::vector<uint8_t>  _image;
+    std::vector<Symbol>   _symbols;
+};
+
+///////////////////////////////////////////
+
+class TISR_ProfileReport
+{
+  public:
+
+    struct Entry
+    {
+      std::string name;
+      uint64_t    samples;
+    };
+
+    TISR_ProfileReport() : _numSamples(0), _numDropped(0), _shift(0)
+    {
+    }
+
+    // Returns false if no "# TISR_PROFILE" header was found. With several dumps in the capture, the last one is used
+    bool parse(const std::string& text, const TISR_ElfSymbols& symbols)
+    {
+      bool    found = false;
+      size_t  start = 0;
+
+      while (start < text.size())
+      {
+        size_t      end   = text.find('\n', start);
+        std::string line  = text.substr(start, (end == std::string::npos) ? std::string::npos : end - start);
+
+        start = (end == std::string::npos) ? text.size() : end + 1;
+
+        unsigned  version, shift;
+        unsigned long long samples, dropped, address, count;
+
+        if (sscanf(line.c_str(), "# TISR_PROFILE version=%u shift=%u samples=%llu dropped=%llu",
+                   &version, &shift, &samples, &dropped) == 4)
+        {
+          found       = true;
+          _shift      = shift;
+          _numSamples = samples;
+          _numDropped = dropped;
+          _functions.clear();
+          _addresses.clear();
+        }
+        else if ( found && (sscanf(line.c_str(), "0x%llx %llu", &address, &count) == 2) )
+        {
+          const char* name = symbols.lookup(address);
+
+          _functions[ (name != NULL) ? name : "??" ] += count;
+
+          Entry entry;
+
+          entry.name    = (name != NULL) ? name : "??";
+          entry.samples = count;
+
+          _addresses[address] = entry;
+        }
+      }
+
+      return found;
+    }
+
+    // Per function, most sampled first
+    std::vector<Entry> getFunctions() const
+    {
+      std::vector<Entry> result;
+
+      for (std::map<std::string, uint64_t>::const_iterator it = _functions.begin(); it != _functions.end(); ++it)
+      {
+        Entry entry;
+
+        entry.name    = it->first;
+        entry.samples = it->second;
+
+        result.push_back(entry);
+      }
+
+      std::stable_sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) { return a.samples > b.samples; });
+
+      return result;
+    }
+
+    // Per address range, in address order
+    const std::map<uint64_t, Entry>& getAddresses() const
+    {
+      return _addresses;
+    }
+
+    uint64_t getNumSamples() const
+    {
+      return _numSamples;
+    }
+
+    uint64_t getNumDropped() const
+    {
+      return _numDropped;
+    }
+
+    unsigned getShift() const
+    {
+      return _shift;
+    }
+
+  private:
+
+    std::map<std::string, uint64_t>   _functions;
+    std::map<uint64_t, Entry>         _addresses;
+    uint64_t                          _numSamples;
+    uint64_t                          _numDropped;
+    unsigned                          _shift;
+};
+
+///////////////////////////////////////////
+
+#endif    // TISR_PROFILE_DECODE_H
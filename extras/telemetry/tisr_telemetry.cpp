@@ -0,0 +1,250 @@
+/****************************************************************************************************************************
+  tisr_telemetry.cpp
+  Live text dashboard of the TimerInterrupt_Generic_Telemetry.h binary stream
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Build and run from this directory :
+
+    g++ -O2 -std=gnu++11 tisr_telemetry.cpp -o tisr_telemetry
+    stty -F /dev/ttyUSB0 115200 raw -echo
+    ./tisr_telemetry /dev/ttyUSB0                     // live, redraws the dashboard after each STATUS record
+    ./tisr_telemetry capture.bin -t trace.bin         // offline, and reassembles the TRACE records into a TTRC dump
+
+  A trace.bin written with -t is in the TISR_Trace.dump() format, so extras/trace/tisr_trace2json converts it to
+  Chrome trace JSON. Text printed by the sketch around the frames is ignored.
+*****************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <map>
+#include <utility>
+
+#include "tisr_telemetry_decode.h"
+
+class Dashboard : public TISR_TelemetrySink
+{
+  public:
+
+    Dashboard(const bool& live) : _live(live), _haveStatus(false), _haveLoad(false), _numLost(0), _traceTotal(0), _traceHz(0)
+    {
+    }
+
+    void onStatus(const TISR_TelemetryStatus& status)
+    {
+      _status     = status;
+      _haveStatus = true;
+      _traceHz    = status.cyclesHz;
+
+      if (_live)
+        print();
+    }
+
+    void onConfig(const TISR_TelemetryConfig& config)
+    {
+      _configs[ std::make_pair(config.source, config.id) ] = config;
+    }
+
+    void onStats(const TISR_TelemetryStats& stats)
+    {
+      _stats[ std::make_pair(stats.source, stats.id) ] = stats;
+    }
+
+    void onLoad(const TISR_TelemetryLoad& load)
+    {
+      _load     = load;
+      _haveLoad = true;
+    }
+
+    void onTrace(const uint16_t& firstIndex, const uint16_t& totalEvents,
+                 const std::vector<TISR_TelemetryTraceEvent>& events)
+    {
+      // A new dump starts at index 0
+      if (firstIndex == 0)
+        _trace.clear();
+
+      if (firstIndex == _trace.size())
+        _trace.insert(_trace.end(), events.begin(), events.end());
+
+      _traceTotal = totalEvents;
+    }
+
+    void onLost(const uint8_t& numFrames)
+    {
+      _numLost += numFrames;
+    }
+
+    void print() const
+    {
+      if (_live)
+        printf("\033[H\033[2J");
+
+      if (_haveStatus)
+      {
+        printf("Device time %.3f s, %u bytes sent, %u frames dropped on device, %u lost on link\n",
+               _status.millis / 1000.0, _status.bytesSent, _status.framesDropped, _numLost);
+      }
+
+      if (_haveLoad)
+      {
+        printf("Window %u : CPU %.2f%%, HW timers %.2f%%, callbacks %.2f%%\n", _load.windowNumber,
+               _load.cpuLoad / 100.0, _load.hwTimerLoad / 100.0, _load.callbackLoad / 100.0);
+      }
+
+      printf("\n%-10s %3s %3s %10s %10s %8s %8s %8s %8s %8s %8s\n", "Source", "Id", "On", "Period ms", "Count",
+             "Missed", "durMin", "durAvg", "durMax", "lateMin", "lateMax");
+
+      // Rows for every timer seen in CONFIG or STATS records
+      std::map< std::pair<uint8_t, uint8_t>, bool > keys;
+
+      for (auto& config : _configs)
+        keys[config.first] = true;
+
+      for (auto& stats : _stats)
+        keys[stats.first] = true;
+
+      for (auto& key : keys)
+      {
+        auto config = _configs.find(key.first);
+        auto stats  = _stats.find(key.first);
+
+        printf("%-10s %3u ", (key.first.first == TISR_TELEMETRY_HW_TIMER) ? "HW Timer" : "ISR_Timer", key.first.second);
+
+        if (config != _configs.end())
+          printf("%3s %10.3f ", config->second.enabled ? "yes" : "no", config->second.periodMs);
+        else
+          printf("%3s %10s ", "?", "?");
+
+        if (stats != _stats.end())
+        {
+          const TISR_TelemetryStats& s = stats->second;
+
+          printf("%10u %8u %8u %8u %8u %8d %8d", s.count, s.missed, s.durMin, s.durAvg, s.durMax, s.lateMin, s.lateMax);
+        }
+
+        printf("\n");
+      }
+
+      if (_traceTotal > 0)
+        printf("\nTrace : %u / %u events received\n", (unsigned) _trace.size(), (unsigned) _traceTotal);
+
+      fflush(stdout);
+    }
+
+    // Writes the reassembled trace as a TTRC dump. Returns false if there is no complete trace
+    bool writeTrace(FILE* out) const
+    {
+      if ( (_traceTotal == 0) || (_trace.size() != _traceTotal) )
+        return false;
+
+      const uint8_t header[12] =
+      {
+        'T', 'T', 'R', 'C', 1, TISR_TELEMETRY_TRACE_EVENT_SIZE,
+        (uint8_t) _traceTotal, (uint8_t) (_traceTotal >> 8),
+        (uint8_t) _traceHz, (uint8_t) (_traceHz >> 8), (uint8_t) (_traceHz >> 16), (uint8_t) (_traceHz >> 24)
+      };
+
+      fwrite(header, 1, sizeof(header), out);
+
+      for (auto& event : _trace)
+      {
+        uint8_t data[TISR_TELEMETRY_TRACE_EVENT_SIZE] = { 0 };
+
+        for (uint8_t i = 0; i < 4; i++)
+        {
+          data[i]     = (uint8_t) (event.start >> (8 * i));
+          data[i + 4] = (uint8_t) (event.duration >> (8 * i));
+        }
+
+        data[8] = event.type;
+        data[9] = event.id;
+
+        fwrite(data, 1, sizeof(data), out);
+      }
+
+      return true;
+    }
+
+  private:
+
+    bool                                                      _live;
+
+    TISR_TelemetryStatus                                      _status;
+    bool                                                      _haveStatus;
+    TISR_TelemetryLoad                                        _load;
+    bool                                                      _haveLoad;
+
+    std::map< std::pair<uint8_t, uint8_t>, TISR_TelemetryConfig > _configs;
+    std::map< std::pair<uint8_t, uint8_t>, TISR_TelemetryStats >  _stats;
+
+    uint32_t                                                  _numLost;
+
+    std::vector<TISR_TelemetryTraceEvent>                     _trace;
+    uint16_t                                                  _traceTotal;
+    uint32_t                                                  _traceHz;
+};
+
+int main(int argc, char** argv)
+{
+  const char* tracePath = NULL;
+
+  if ( (argc != 2) && !( (argc == 4) && (strcmp(argv[2], "-t") == 0) ) )
+  {
+    fprintf(stderr, "Usage: %s <tty or capture.bin> [-t trace.bin]\n", argv[0]);
+    return 1;
+  }
+
+  if (argc == 4)
+    tracePath = argv[3];
+
+  int in = open(argv[1], O_RDONLY);
+
+  if (in < 0)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+
+  Dashboard             dashboard(isatty(in));
+  TISR_TelemetryParser  parser(dashboard);
+  uint8_t               buffer[4096];
+  ssize_t               numRead;
+
+  // read() returns whatever a tty has right now, so the dashboard stays live
+  while ( (numRead = read(in, buffer, sizeof(buffer))) > 0 )
+    parser.feed(buffer, numRead);
+
+  close(in);
+
+  dashboard.print();
+
+  fprintf(stderr, "%u frames, %u bad CRC\n", parser.getNumFrames(), parser.getNumBadCRC());
+
+  if (tracePath != NULL)
+  {
+    FILE* out = fopen(tracePath, "wb");
+
+    if (out == NULL)
+    {
+      perror(tracePath);
+      return 1;
+    }
+
+    bool complete = dashboard.writeTrace(out);
+
+    fclose(out);
+
+    if (!complete)
+    {
+      fprintf(stderr, "No complete trace in %s\n", argv[1]);
+      return 1;
+    }
+  }
+
+  return 0;
+}
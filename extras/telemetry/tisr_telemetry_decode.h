@@ -0,0 +1,318 @@
+/****************************************************************************************************************************
+  tisr_telemetry_decode.h
+  Host-side decoder for the binary stream of TimerInterrupt_Generic_Telemetry.h
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Header-only, C++11, no dependency beyond the standard library. This file is not part of the Arduino library build
+  (extras/ is excluded by library.json).
+
+  TISR_TelemetryParser is fed with raw bytes in chunks of any size, finds the frames (anything else the sketch printed
+  is skipped), checks their CRC and hands the decoded records to a TISR_TelemetrySink. A frame with a bad CRC is
+  skipped one byte at a time, so the parser resynchronizes on the next valid frame.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TISR_TELEMETRY_DECODE_H
+#define TISR_TELEMETRY_DECODE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+// Must match TimerInterrupt_Generic_Telemetry.h
+#define TISR_TELEMETRY_SYNC0            0xA7
+#define TISR_TELEMETRY_SYNC1            0x7A
+
+#define TISR_TELEMETRY_STATUS           0
+#define TISR_TELEMETRY_CONFIG           1
+#define TISR_TELEMETRY_STATS            2
+#define TISR_TELEMETRY_TRACE            3
+#define TISR_TELEMETRY_LOAD             4
+#define TISR_TELEMETRY_USER             5
+
+#define TISR_TELEMETRY_HW_TIMER         0
+#define TISR_TELEMETRY_ISR_TIMER        1
+
+#define TISR_TELEMETRY_OVERHEAD         7
+#define TISR_TELEMETRY_TRACE_EVENT_SIZE 12
+
+///////////////////////////////////////////
+
+struct TISR_TelemetryStatus
+{
+  uint32_t  millis;
+  uint32_t  framesDropped;
+  uint32_t  bytesSent;
+  uint32_t  cyclesHz;
+};
+
+struct TISR_TelemetryConfig
+{
+  uint8_t   source;
+  uint8_t   id;
+  bool      enabled;
+  float     periodMs;
+};
+
+struct TISR_TelemetryStats
+{
+  uint8_t   source;
+  uint8_t   id;
+  uint32_t  count;
+  uint32_t  missed;
+  uint32_t  durMin;
+  uint32_t  durAvg;
+  uint32_t  durMax;
+  int32_t   lateMin;
+  int32_t   lateMax;
+};
+
+struct TISR_TelemetryTraceEvent
+{
+  uint32_t  start;
+  uint32_t  duration;
+  uint8_t   type;
+  uint8_t   id;
+};
+
+struct TISR_TelemetryLoad
+{
+  uint32_t  windowNumber;
+  uint16_t  cpuLoad;
+  uint16_t  hwTimerLoad;
+  uint16_t  callbackLoad;
+};
+
+///////////////////////////////////////////
+
+class TISR_TelemetrySink
+{
+  public:
+
+    virtual ~TISR_TelemetrySink()
+    {
+    }
+
+    virtual void onStatus(const TISR_TelemetryStatus& status)                         { (void) status; }
+    virtual void onConfig(const TISR_TelemetryConfig& config)                         { (void) config; }
+    virtual void onStats(const TISR_TelemetryStats& stats)                            { (void) stats; }
+    virtual void onLoad(const TISR_TelemetryLoad& load)                               { (void) load; }
+    virtual void onUser(const uint8_t* data, const uint8_t& length)                   { (void) data; (void) length; }
+
+    // One TRACE record, events firstIndex .. firstIndex + events.size() - 1 of totalEvents
+    virtual void onTrace(const uint16_t& firstIndex, const uint16_t& totalEvents,
+                         const std::vector<TISR_TelemetryTraceEvent>& events)        { (void) firstIndex; (void) totalEvents; (void) events; }
+
+    // Gap in the sequence numbers : frames lost on the device (queue full) or on the link (bad CRC)
+    virtual void onLost(const uint8_t& numFrames)                                     { (void) numFrames; }
+};
+
+///////////////////////////////////////////
+
+class TISR_TelemetryParser
+{
+  public:
+
+    TISR_TelemetryParser(TISR_TelemetrySink& sink) : _sink(sink), _haveSequence(false), _nextSequence(0),
+      _numFrames(0), _numBadCRC(0)
+    {
+    }
+
+    void feed(const uint8_t* data, const size_t& length)
+    {
+      _buffer.insert(_buffer.end(), data, data + length);
+
+      size_t position = 0;
+
+      while (_buffer.size() - position >= TISR_TELEMETRY_OVERHEAD)
+      {
+        const uint8_t* frame = &_buffer[position];
+
+        if ( (frame[0] != TISR_TELEMETRY_SYNC0) || (frame[1] != TISR_TELEMETRY_SYNC1) )
+        {
+          position++;
+          continue;
+        }
+
+        size_t frameLength = TISR_TELEMETRY_OVERHEAD + frame[4];
+
+        // Wait for the rest of the frame
+        if (_buffer.size() - position < frameLength)
+          break;
+
+        uint16_t crc = 0xFFFF;
+
+        for (size_t i = 2; i < frameLength - 2; i++)
+          crc = updateCRC(crc, frame[i]);
+
+        if ( crc != (uint16_t) (frame[frameLength - 2] | (frame[frameLength - 1] << 8)) )
+        {
+          _numBadCRC++;
+          position++;
+          continue;
+        }
+
+        dispatch(frame[2], frame[3], &frame[5], frame[4]);
+
+        position += frameLength;
+      }
+
+      _buffer.erase(_buffer.begin(), _buffer.begin() + position);
+    }
+
+    uint32_t getNumFrames() const
+    {
+      return _numFrames;
+    }
+
+    uint32_t getNumBadCRC() const
+    {
+      return _numBadCRC;
+    }
+
+  private:
+
+    static uint16_t updateCRC(uint16_t crc, const uint8_t& value)
+    {
+      crc ^= (uint16_t) value << 8;
+
+      for (uint8_t bit = 0; bit < 8; bit++)
+        crc = (crc & 0x8000) ? ( (crc << 1) ^ 0x1021 ) : (crc << 1);
+
+      return crc;
+    }
+
+    static uint32_t getLE(const uint8_t* data, const uint8_t& numBytes)
+    {
+      uint32_t value = 0;
+
+      for (uint8_t i = numBytes; i > 0; i--)
+        value = (value << 8) | data[i - 1];
+
+      return value;
+    }
+
+    void dispatch(const uint8_t& type, const uint8_t& sequence, const uint8_t* payload, const uint8_t& length)
+    {
+      _numFrames++;
+
+      if (_haveSequence && (sequence != _nextSequence))
+        _sink.onLost( (uint8_t) (sequence - _nextSequence) );
+
+      _haveSequence = true;
+      _nextSequence = sequence + 1;
+
+      switch (type)
+      {
+        case TISR_TELEMETRY_STATUS:
+          if (length >= 16)
+          {
+            TISR_TelemetryStatus status;
+
+            status.millis         = getLE(&payload[0], 4);
+            status.framesDropped  = getLE(&payload[4], 4);
+            status.bytesSent      = getLE(&payload[8], 4);
+            status.cyclesHz       = getLE(&payload[12], 4);
+
+            _sink.onStatus(status);
+          }
+
+          break;
+
+        case TISR_TELEMETRY_CONFIG:
+          if (length >= 7)
+          {
+            TISR_TelemetryConfig  config;
+            uint32_t              periodBits = getLE(&payload[3], 4);
+
+            config.source   = payload[0];
+            config.id       = payload[1];
+            config.enabled  = (payload[2] != 0);
+            memcpy(&config.periodMs, &periodBits, sizeof(config.periodMs));
+
+            _sink.onConfig(config);
+          }
+
+          break;
+
+        case TISR_TELEMETRY_STATS:
+          if (length >= 30)
+          {
+            TISR_TelemetryStats stats;
+
+            stats.source    = payload[0];
+            stats.id        = payload[1];
+            stats.count     = getLE(&payload[2], 4);
+            stats.missed    = getLE(&payload[6], 4);
+            stats.durMin    = getLE(&payload[10], 4);
+            stats.durAvg    = getLE(&payload[14], 4);
+            stats.durMax    = getLE(&payload[18], 4);
+            stats.lateMin   = (int32_t) getLE(&payload[22], 4);
+            stats.lateMax   = (int32_t) getLE(&payload[26], 4);
+
+            _sink.onStats(stats);
+          }
+
+          break;
+
+        case TISR_TELEMETRY_TRACE:
+          if (length >= 4)
+          {
+            std::vector<TISR_TelemetryTraceEvent> events;
+
+            for (uint16_t offset = 4; offset + TISR_TELEMETRY_TRACE_EVENT_SIZE <= length; offset += TISR_TELEMETRY_TRACE_EVENT_SIZE)
+            {
+              TISR_TelemetryTraceEvent event;
+
+              event.start     = getLE(&payload[offset], 4);
+              event.duration  = getLE(&payload[offset + 4], 4);
+              event.type      = payload[offset + 8];
+              event.id        = payload[offset + 9];
+
+              events.push_back(event);
+            }
+
+            _sink.onTrace( (uint16_t) getLE(&payload[0], 2), (uint16_t) getLE(&payload[2], 2), events );
+          }
+
+          break;
+
+        case TISR_TELEMETRY_LOAD:
+          if (length >= 10)
+          {
+            TISR_TelemetryLoad load;
+
+            load.windowNumber = getLE(&payload[0], 4);
+            load.cpuLoad      = (uint16_t) getLE(&payload[4], 2);
+            load.hwTimerLoad  = (uint16_t) getLE(&payload[6], 2);
+            load.callbackLoad = (uint16_t) getLE(&payload[8], 2);
+
+            _sink.onLoad(load);
+          }
+
+          break;
+
+        case TISR_TELEMETRY_USER:
+          _sink.onUser(payload, length);
+          break;
+
+        default:
+          break;
+      }
+    }
+
+    TISR_TelemetrySink&   _sink;
+    std::vector<uint8_t>  _buffer;
+    bool                  _haveSequence;
+    uint8_t               _nextSequence;
+    uint32_t              _numFrames;
+    uint32_t              _numBadCRC;
+};
+
+///////////////////////////////////////////
+
+#endif    // TISR_TELEMETRY_DECODE_H
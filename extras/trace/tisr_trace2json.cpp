@@ -0,0 +1,73 @@
+/****************************************************************************************************************************
+  tisr_trace2json.cpp
+  Converts TimerInterrupt_Generic_Trace.h dumps to Chrome trace JSON
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Build and run from this directory :
+
+    g++ -O2 -std=gnu++11 tisr_trace2json.cpp -o tisr_trace2json
+    ./tisr_trace2json capture.bin trace.json       // then open trace.json in https://ui.perfetto.dev
+
+  capture.bin is the raw serial output of a sketch calling TISR_Trace.dump(Serial), e.g. captured with
+  "cat /dev/ttyUSB0 > capture.bin". Text printed around the dump is ignored.
+*****************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tisr_trace_decode.h"
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "Usage: %s capture.bin [trace.json]\n", argv[0]);
+    return 1;
+  }
+
+  FILE* in = fopen(argv[1], "rb");
+
+  if (in == NULL)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+
+  std::vector<uint8_t>  data;
+  uint8_t               buffer[4096];
+  size_t                numRead;
+
+  while ( (numRead = fread(buffer, 1, sizeof(buffer), in)) > 0 )
+    data.insert(data.end(), buffer, buffer + numRead);
+
+  fclose(in);
+
+  TISR_TraceDecoder decoder;
+
+  size_t numDumps = decoder.decode(data.data(), data.size());
+
+  if (numDumps == 0)
+  {
+    fprintf(stderr, "No trace dump found in %s\n", argv[1]);
+    return 1;
+  }
+
+  FILE* out = (argc > 2) ? fopen(argv[2], "w") : stdout;
+
+  if (out == NULL)
+  {
+    perror(argv[2]);
+    return 1;
+  }
+
+  decoder.writeChromeJSON(out);
+
+  if (out != stdout)
+    fclose(out);
+
+  fprintf(stderr, "%u dump(s), %u events\n", (unsigned) numDumps, (unsigned) decoder.events().size());
+
+  return 0;
+}
@@ -0,0 +1,234 @@
+/****************************************************************************************************************************
+  tisr_trace_decode.h
+  Host-side decoder for TimerInterrupt_Generic_Trace.h dumps
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Header-only, C++11, no dependency beyond the standard library. This file is not part of the Arduino library build
+  (extras/ is excluded by library.json).
+
+  TISR_TraceDecoder finds the "TTRC" dump(s) in a raw serial capture (anything else printed on the same port before
+  or after is skipped), unwraps the 32-bit timestamps and converts them to microseconds, then writes the events in
+  the Chrome trace event format ("X" complete events), which Perfetto and chrome://tracing open directly.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TISR_TRACE_DECODE_H
+#define TISR_TRACE_DECODE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+// Event types, must match TimerInterrupt_Generic_Trace.h
+#define TISR_TRACE_HW_TIMER         1
+#define TISR_TRACE_RUN              2
+#define TISR_TRACE_CALLBACK         3
+#define TISR_TRACE_USER             4
+
+///////////////////////////////////////////
+
+struct TISR_TraceEvent
+{
+  double    startUs;
+  double    durationUs;
+  uint8_t   type;
+  uint8_t   id;
+};
+
+///////////////////////////////////////////
+
+class TISR_TraceDecoder
+{
+  public:
+
+    // Decodes every dump found in 'data'. Returns the number of dumps decoded, events are appended to events()
+    size_t decode(const uint8_t* data, const size_t& length)
+    {
+      size_t numDumps = 0;
+      size_t pos      = 0;
+
+      while ( (pos = findMagic(data, length, pos)) < length )
+      {
+        size_t used = decodeOne(data + pos, length - pos);
+
+        if (used == 0)
+        {
+          // Truncated or corrupt, keep looking after this magic
+          pos += 4;
+          continue;
+        }
+
+        pos += used;
+        numDumps++;
+      }
+
+      return numDumps;
+    }
+
+    const std::vector<TISR_TraceEvent>& events() const
+    {
+      return _events;
+    }
+
+    ///////////////////////////////////////////
+
+    static std::string eventName(const TISR_TraceEvent& event)
+    {
+      char name[32];
+
+      switch (event.type)
+      {
+        case TISR_TRACE_HW_TIMER:
+          snprintf(name, sizeof(name), "HW Timer%u ISR", event.id);
+          break;
+
+        case TISR_TRACE_RUN:
+          snprintf(name, sizeof(name), "ISR_Timer::run");
+          break;
+
+        case TISR_TRACE_CALLBACK:
+          snprintf(name, sizeof(name), "ISR_Timer slot %u", event.id);
+          break;
+
+        case TISR_TRACE_USER:
+          snprintf(name, sizeof(name), "User %u", event.id);
+          break;
+
+        default:
+          snprintf(name, sizeof(name), "Type %u id %u", event.type, event.id);
+          break;
+      }
+
+      return std::string(name);
+    }
+
+    static const char* eventCategory(const TISR_TraceEvent& event)
+    {
+      switch (event.type)
+      {
+        case TISR_TRACE_HW_TIMER:
+          return "isr";
+
+        case TISR_TRACE_RUN:
+        case TISR_TRACE_CALLBACK:
+          return "isr_timer";
+
+        default:
+          return "user";
+      }
+    }
+
+    ///////////////////////////////////////////
+
+    // Chrome trace event format, https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+    // Timestamps are rebased so that the earliest event starts at 0
+    void writeChromeJSON(FILE* out) const
+    {
+      double origin = 0;
+
+      for (size_t i = 0; i < _events.size(); i++)
+      {
+        if ( (i == 0) || (_events[i].startUs < origin) )
+          origin = _events[i].startUs;
+      }
+
+      fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+      for (size_t i = 0; i < _events.size(); i++)
+      {
+        const TISR_TraceEvent& event = _events[i];
+
+        fprintf(out, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1,"
+                "\"args\":{\"type\":%u,\"id\":%u}}",
+                (i == 0) ? "" : ",\n", eventName(event).c_str(), eventCategory(event), event.startUs - origin, event.durationUs,
+                event.type, event.id);
+      }
+
+      fprintf(out, "\n]}\n");
+    }
+
+  private:
+
+    static size_t findMagic(const uint8_t* data, const size_t& length, size_t pos)
+    {
+      for ( ; pos + 4 <= length; pos++)
+      {
+        if (memcmp(data + pos, "TTRC", 4) == 0)
+          return pos;
+      }
+
+      return length;
+    }
+
+    static uint32_t readLE(const uint8_t* p, const uint8_t& numBytes)
+    {
+      uint32_t value = 0;
+
+      for (uint8_t i = numBytes; i > 0; i--)
+        value = (value << 8) | p[i - 1];
+
+      return value;
+    }
+
+    // Returns the number of bytes used, 0 if the dump is truncated or not understood
+    size_t decodeOne(const uint8_t* data, const size_t& length)
+    {
+      const size_t headerSize = 12;
+
+      if (length < headerSize)
+        return 0;
+
+      uint8_t  version    = data[4];
+      uint8_t  eventSize  = data[5];
+      uint16_t numEvents  = (uint16_t) readLE(data + 6, 2);
+      uint32_t hz         = readLE(data + 8, 4);
+
+      if ( (version != 1) || (eventSize < 10) || (hz == 0) || (length < headerSize + (size_t) numEvents * eventSize) )
+        return 0;
+
+      // Events are stored in completion order. Spans complete in order of their end time, so the end time is the
+      // monotonic quantity used to detect and unwrap 32-bit timestamp rollovers.
+      uint64_t  epoch   = 0;
+      uint32_t  lastEnd = 0;
+
+      for (uint16_t i = 0; i < numEvents; i++)
+      {
+        const uint8_t* p = data + headerSize + (size_t) i * eventSize;
+
+        uint32_t start    = readLE(p, 4);
+        uint32_t duration = readLE(p + 4, 4);
+        uint32_t end      = start + duration;
+
+        if ( (i > 0) && (end < lastEnd) && ( (lastEnd - end) > 0x80000000UL ) )
+          epoch += 0x100000000ULL;
+
+        lastEnd = end;
+
+        // Derived from the unwrapped end, so a span started before a rollover gets a start just before it
+        int64_t fullStart = (int64_t) (epoch + end) - (int64_t) duration;
+
+        TISR_TraceEvent event;
+
+        event.startUs     = (double) fullStart * 1e6 / hz;
+        event.durationUs  = (double) duration * 1e6 / hz;
+        event.type        = p[8];
+        event.id          = p[9];
+
+        _events.push_back(event);
+      }
+
+      return headerSize + (size_t) numEvents * eventSize;
+    }
+
+    std::vector<TISR_TraceEvent> _events;
+};
+
+///////////////////////////////////////////
+
+#endif    // TISR_TRACE_DECODE_H
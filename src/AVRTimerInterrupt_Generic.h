@@ -72,6 +72,7 @@
 #include "pins_arduino.h"
 
 #include "TimerInterrupt_Generic_Debug.h"
+#include "TimerInterrupt_Generic_Solvers.h"
 
 #define MAX_COUNT_8BIT            255
 #define MAX_COUNT_10BIT           1023
@@ -409,118 +410,54 @@ class TimerInterrupt
       //Timer0 and timer2 are 8 bit timers, meaning they can store a maximum counter value of 255.
       //Timer2 does not have the option of 1024 prescaler, only 1, 8, 32, 64  
       //Timer1 is a 16 bit timer, meaning it can store a maximum counter value of 65535.
-      int prescalerIndexStart;
-      
-      //Use smallest prescaler first, then increase until fits (<255)
+      // Smallest prescaler first, then increased until the OCRValue fits, see TimerInterrupt_Generic_Solvers.h
+      int prescalerIndex;
+
       if (_timer != 2)
-      {     
-        if (frequencyLimit > 64)
-          prescalerIndexStart = NO_PRESCALER;        
-        else if (frequencyLimit > 8)
-          prescalerIndexStart = PRESCALER_8;
-        else
-          prescalerIndexStart = PRESCALER_64;
+      {
+  #if TIMER_INTERRUPT_USING_ATMEGA_32U4
+        uint16_t maxCount = (_timer == 4) ? MAX_COUNT_8BIT : MAX_COUNT_16BIT;
+  #else
+        uint16_t maxCount = MAX_COUNT_16BIT;
+  #endif
 
-          
-        for (int prescalerIndex = prescalerIndexStart; prescalerIndex <= PRESCALER_1024; prescalerIndex++)
-        {
-          OCRValue = F_CPU / (frequency * prescalerDiv[prescalerIndex]) - 1;
-    
-          TISR_LOGWARN1(F("Freq * 1000 ="), frequency * 1000);
-          TISR_LOGWARN3(F("F_CPU ="), F_CPU, F(", preScalerDiv ="), prescalerDiv[prescalerIndex]);
-          TISR_LOGWARN3(F("OCR ="), OCRValue, F(", preScalerIndex ="), prescalerIndex);
+        prescalerIndex = tisr_solver_avr(F_CPU, frequency, prescalerDiv, tisr_solver_avr_first_index(frequencyLimit, false),
+                                         PRESCALER_1024, maxCount, OCRValue);
 
-          // We use very large _OCRValue now, and every time timer ISR activates, we deduct min(MAX_COUNT_16BIT, _OCRValueRemaining) from _OCRValueRemaining
-          // So that we can create very long timer, even if the counter is only 16-bit.
-          // Use very high frequency (OCRValue / MAX_COUNT_16BIT) around 16 * 1024 to achieve higher accuracy
-  #if TIMER_INTERRUPT_USING_ATMEGA_32U4
-          uint16_t MAX_COUNT_32U4 = (_timer == 4) ? MAX_COUNT_8BIT : MAX_COUNT_16BIT;
-         
-          if ( (OCRValue / MAX_COUNT_32U4) < 16384 )
-  #else        
-          if ( (OCRValue / MAX_COUNT_16BIT) < 16384 )
-  #endif        
-          {
-            _OCRValue           = OCRValue;
-            _OCRValueRemaining  = OCRValue;
-            _prescalerIndex = prescalerIndex;
-    
-            TISR_LOGWARN1(F("OK in loop => _OCR ="), _OCRValue);
-            TISR_LOGWARN3(F("_preScalerIndex ="), _prescalerIndex, F(", preScalerDiv ="), prescalerDiv[_prescalerIndex]);
-               
-            isSuccess = true;
-           
-            break;
-          }       
-        }
+        isSuccess       = (prescalerIndex >= 0);
 
-        if (!isSuccess)
-        {
-          // Always do this
-          _OCRValue           = OCRValue;
-          _OCRValueRemaining  = OCRValue;
-          _prescalerIndex = PRESCALER_1024;
-    
-          TISR_LOGWARN1(F("OK out loop => _OCR ="), _OCRValue);
-          TISR_LOGWARN3(F("_preScalerIndex ="), _prescalerIndex, F(", preScalerDiv ="), prescalerDiv[_prescalerIndex]);
-        }            
+        // Always do this
+        _prescalerIndex = isSuccess ? prescalerIndex : PRESCALER_1024;
+
+        TISR_LOGWARN3(F("F_CPU ="), F_CPU, F(", preScalerDiv ="), prescalerDiv[_prescalerIndex]);
       }
       else
       {
-        if (frequencyLimit > 64)
-          prescalerIndexStart = T2_NO_PRESCALER;        
-        else if (frequencyLimit > 8)
-          prescalerIndexStart = T2_PRESCALER_8;
-        else if (frequencyLimit > 2)
-          prescalerIndexStart = T2_PRESCALER_32;        
-        else
-          prescalerIndexStart = T2_PRESCALER_64;
-            
         // Page 206-207. ATmegal328
-        //8-bit Timer2 has more options up to 1024 prescaler, from 1, 8, 32, 64, 128, 256 and 1024  
-        for (int prescalerIndex = prescalerIndexStart; prescalerIndex <= T2_PRESCALER_1024; prescalerIndex++)
-        {
-          OCRValue = F_CPU / (frequency * prescalerDivT2[prescalerIndex]) - 1;
-    
-          TISR_LOGWARN3(F("F_CPU ="), F_CPU, F(", preScalerDiv ="), prescalerDivT2[prescalerIndex]);
-          TISR_LOGWARN3(F("OCR2 ="), OCRValue, F(", preScalerIndex ="), prescalerIndex);
+        //8-bit Timer2 has more options up to 1024 prescaler, from 1, 8, 32, 64, 128, 256 and 1024
+        prescalerIndex = tisr_solver_avr(F_CPU, frequency, prescalerDivT2, tisr_solver_avr_first_index(frequencyLimit, true),
+                                         T2_PRESCALER_1024, MAX_COUNT_8BIT, OCRValue);
 
-          // We use very large _OCRValue now, and every time timer ISR activates, we deduct min(MAX_COUNT_8BIT, _OCRValue) from _OCRValue
-          // to create very long timer, even if the counter is only 16-bit.
-          // Use very high frequency (OCRValue / MAX_COUNT_8BIT) around 16 * 1024 to achieve higher accuracy
-          if ( (OCRValue / MAX_COUNT_8BIT) < 16384 )
-          {
-            _OCRValue           = OCRValue;
-            _OCRValueRemaining  = OCRValue;
-            // same as prescalarbits
-            _prescalerIndex = prescalerIndex;
-    
-            TISR_LOGWARN1(F("OK in loop => _OCR ="), _OCRValue);
-            TISR_LOGWARN3(F("_preScalerIndex ="), _prescalerIndex, F(", preScalerDiv ="), prescalerDivT2[_prescalerIndex]);
-            
-            isSuccess = true;
-            
-            break;
-          }       
-        }
+        isSuccess       = (prescalerIndex >= 0);
 
-        if (!isSuccess)
-        {
-          // Always do this
-          _OCRValue           = OCRValue;
-          _OCRValueRemaining  = OCRValue;
-          // same as prescalarbits
-          _prescalerIndex = T2_PRESCALER_1024;
-    
-          TISR_LOGWARN1(F("OK out loop => _OCR ="), _OCRValue);
-          TISR_LOGWARN3(F("_preScalerIndex ="), _prescalerIndex, F(", preScalerDiv ="), prescalerDivT2[_prescalerIndex]);
-        } 
+        // Always do this. Same as prescalarbits
+        _prescalerIndex = isSuccess ? prescalerIndex : T2_PRESCALER_1024;
+
+        TISR_LOGWARN3(F("F_CPU ="), F_CPU, F(", preScalerDiv ="), prescalerDivT2[_prescalerIndex]);
       }
 
+      _OCRValue           = OCRValue;
+      _OCRValueRemaining  = OCRValue;
+
+      TISR_LOGWARN3(F("_OCR ="), _OCRValue, F(", _preScalerIndex ="), _prescalerIndex);
+
       //cli();//stop interrupts
       noInterrupts();
 
       _frequency = frequency;
+
+      TISR_STATS_HW_SET_FREQUENCY(_timer, frequency);
+
       _callback  = (void*) callback;
       _params    = reinterpret_cast<void*>(params);
 
@@ -1069,7 +1006,20 @@ class TimerInterrupt
           {
             TISR_LOGDEBUG3(("T1 callback, _OCRValueRemaining ="), ITimer1.get_OCRValueRemaining(), (", millis ="), millis());
             
-            ITimer1.callback();
+            TISR_TRACE_BEGIN(traceStart);
+            TISR_STATS_HW_BEGIN(1, statsStart);
+            TISR_LOAD_BEGIN(loadStart);
+            TISR_STACK_BEGIN(stackStart);
+            TISR_WATCHDOG_BEGIN(TISR_WATCHDOG_HW_TIMER(1), watchdogFrame);
+
+            if (!TISR_WATCHDOG_SKIPPED(TISR_WATCHDOG_HW_TIMER(1)))
+              ITimer1.callback();
+
+            TISR_WATCHDOG_END(TISR_WATCHDOG_HW_TIMER(1), watchdogFrame);
+            TISR_STACK_END(TISR_STACK_HW_TIMER(1), stackStart);
+            TISR_LOAD_END(TISR_LOAD_HW_TIMER, loadStart);
+            TISR_STATS_HW_END(1, statsStart);
+            TISR_TRACE_END(TISR_TRACE_HW_TIMER, 1, traceStart);
             
             // To reload _OCRValueRemaining as well as _OCR register to MAX_COUNT_16BIT if _OCRValueRemaining > MAX_COUNT_16BIT
             if (ITimer1.get_OCRValue() > MAX_COUNT_16BIT)
@@ -1117,7 +1067,20 @@ class TimerInterrupt
           {
             TISR_LOGDEBUG3(("T2 callback, _OCRValueRemaining ="), ITimer2.get_OCRValueRemaining(), (", millis ="), millis());
              
-            ITimer2.callback();
+            TISR_TRACE_BEGIN(traceStart);
+            TISR_STATS_HW_BEGIN(2, statsStart);
+            TISR_LOAD_BEGIN(loadStart);
+            TISR_STACK_BEGIN(stackStart);
+            TISR_WATCHDOG_BEGIN(TISR_WATCHDOG_HW_TIMER(2), watchdogFrame);
+
+            if (!TISR_WATCHDOG_SKIPPED(TISR_WATCHDOG_HW_TIMER(2)))
+              ITimer2.callback();
+
+            TISR_WATCHDOG_END(TISR_WATCHDOG_HW_TIMER(2), watchdogFrame);
+            TISR_STACK_END(TISR_STACK_HW_TIMER(2), stackStart);
+            TISR_LOAD_END(TISR_LOAD_HW_TIMER, loadStart);
+            TISR_STATS_HW_END(2, statsStart);
+            TISR_TRACE_END(TISR_TRACE_HW_TIMER, 2, traceStart);
             
             // To reload _OCRValue
             if (ITimer2.get_OCRValue() > MAX_COUNT_8BIT)
@@ -1168,7 +1131,20 @@ class TimerInterrupt
             { 
               TISR_LOGDEBUG3(("T3 callback, _OCRValueRemaining ="), ITimer3.get_OCRValueRemaining(), (", millis ="), millis());
               
-              ITimer3.callback();
+              TISR_TRACE_BEGIN(traceStart);
+              TISR_STATS_HW_BEGIN(3, statsStart);
+              TISR_LOAD_BEGIN(loadStart);
+              TISR_STACK_BEGIN(stackStart);
+              TISR_WATCHDOG_BEGIN(TISR_WATCHDOG_HW_TIMER(3), watchdogFrame);
+
+              if (!TISR_WATCHDOG_SKIPPED(TISR_WATCHDOG_HW_TIMER(3)))
+                ITimer3.callback();
+
+              TISR_WATCHDOG_END(TISR_WATCHDOG_HW_TIMER(3), watchdogFrame);
+              TISR_STACK_END(TISR_STACK_HW_TIMER(3), stackStart);
+              TISR_LOAD_END(TISR_LOAD_HW_TIMER, loadStart);
+              TISR_STATS_HW_END(3, statsStart);
+              TISR_TRACE_END(TISR_TRACE_HW_TIMER, 3, traceStart);
               
               // To reload _OCRValueRemaining as well as _OCR register to MAX_COUNT_16BIT
               if (ITimer3.get_OCRValue() > MAX_COUNT_16BIT)
@@ -1224,7 +1200,20 @@ class TimerInterrupt
             {  
               TISR_LOGDEBUG3(("T4 callback, _OCRValueRemaining ="), ITimer4.get_OCRValueRemaining(), (", millis ="), millis());
               
-              ITimer4.callback();
+              TISR_TRACE_BEGIN(traceStart);
+              TISR_STATS_HW_BEGIN(4, statsStart);
+              TISR_LOAD_BEGIN(loadStart);
+              TISR_STACK_BEGIN(stackStart);
+              TISR_WATCHDOG_BEGIN(TISR_WATCHDOG_HW_TIMER(4), watchdogFrame);
+
+              if (!TISR_WATCHDOG_SKIPPED(TISR_WATCHDOG_HW_TIMER(4)))
+                ITimer4.callback();
+
+              TISR_WATCHDOG_END(TISR_WATCHDOG_HW_TIMER(4), watchdogFrame);
+              TISR_STACK_END(TISR_STACK_HW_TIMER(4), stackStart);
+              TISR_LOAD_END(TISR_LOAD_HW_TIMER, loadStart);
+              TISR_STATS_HW_END(4, statsStart);
+              TISR_TRACE_END(TISR_TRACE_HW_TIMER, 4, traceStart);
               
               // To reload _OCRValueRemaining as well as _OCR register to MAX_COUNT_16BIT (Mega2560) or MAX_COUNT_8BIT (32u4)
               if (ITimer4.get_OCRValue() > MAX_COUNT_16BIT)
@@ -1278,7 +1267,20 @@ class TimerInterrupt
             {
               TISR_LOGDEBUG3(("T5 callback, _OCRValueRemaining ="), ITimer5.get_OCRValueRemaining(), (", millis ="), millis());
               
-              ITimer5.callback();
+              TISR_TRACE_BEGIN(traceStart);
+              TISR_STATS_HW_BEGIN(5, statsStart);
+              TISR_LOAD_BEGIN(loadStart);
+              TISR_STACK_BEGIN(stackStart);
+              TISR_WATCHDOG_BEGIN(TISR_WATCHDOG_HW_TIMER(5), watchdogFrame);
+
+              if (!TISR_WATCHDOG_SKIPPED(TISR_WATCHDOG_HW_TIMER(5)))
+                ITimer5.callback();
+
+              TISR_WATCHDOG_END(TISR_WATCHDOG_HW_TIMER(5), watchdogFrame);
+              TISR_STACK_END(TISR_STACK_HW_TIMER(5), stackStart);
+              TISR_LOAD_END(TISR_LOAD_HW_TIMER, loadStart);
+              TISR_STATS_HW_END(5, statsStart);
+              TISR_TRACE_END(TISR_TRACE_HW_TIMER, 5, traceStart);
               
               // To reload _OCRValueRemaining as well as _OCR register to MAX_COUNT_16BIT
               if (ITimer5.get_OCRValue() > MAX_COUNT_16BIT)
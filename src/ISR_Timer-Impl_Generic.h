@@ -80,6 +80,8 @@ void IRAM_ATTR_PREFIX ISR_Timer::run()
   uint8_t i;
   unsigned long current_millis;
 
+  TISR_TRACE_BEGIN(traceRunStart);
+
   // get current time
   current_millis = millis();
   
@@ -104,11 +106,24 @@ void IRAM_ATTR_PREFIX ISR_Timer::run()
       {
         unsigned long skipTimes = (current_millis - timer[i].prev_millis) / timer[i].delay;
         
-        // update time
-        timer[i].prev_millis += timer[i].delay * skipTimes;
+#if TISR_STATS_ENABLE
+        if (timer[i].enabled)
+        {
+          // ms between the due time and now, and the periods coalesced into this single call
+          stats[i].recordLateness( (int32_t) ( (current_millis - timer[i].prev_millis) - (unsigned long) timer[i].delay ),
+                                   skipTimes - 1 );
+        }
+#endif
 
-        // check if the timer callback has to be executed
-        if (timer[i].enabled) 
+        // update time. Whole ms in integer math : a float sum or product loses ms once over 2^24, e.g. prev_millis or
+        // a long catch up after restoreTimer(). Only the fraction of a fractional delay is scaled in float, below skipTimes
+        unsigned long delayMs = (unsigned long) timer[i].delay;
+
+        timer[i].prev_millis += delayMs * skipTimes + (unsigned long) ( (timer[i].delay - delayMs) * skipTimes );
+        timer[i].missed       = (skipTimes > 0xFFFF) ? 0xFFFF : (uint16_t) (skipTimes - 1);
+
+        // check if the timer callback has to be executed. Not while skipped after overrunning its TISR_WATCHDOG_SKIP budget
+        if (timer[i].enabled && !TISR_WATCHDOG_SKIPPED(TISR_WATCHDOG_CALLBACK(i))) 
         {
 
           // "run forever" timers must always be executed
@@ -138,11 +153,44 @@ void IRAM_ATTR_PREFIX ISR_Timer::run()
     if (timer[i].toBeCalled == TIMER_DEFCALL_DONTRUN)
       continue;
 
-    if (timer[i].hasParam)
+    TISR_TRACE_BEGIN(traceCallbackStart);
+    TISR_LOAD_BEGIN(loadCallbackStart);
+    TISR_STACK_BEGIN(stackCallbackStart);
+    TISR_WATCHDOG_BEGIN(TISR_WATCHDOG_CALLBACK(i), watchdogCallbackFrame);
+
+#if TISR_STATS_ENABLE
+    tisr_cycles_t statsStart = TISR_CYCLES();
+#endif
+
+    if (timer[i].callbackType == TIMER_CALLBACK_CONTEXT)
+    {
+      tisr_timer_context_t context;
+
+      context.numTimer        = i;
+      context.param           = timer[i].param;
+      context.scheduledMillis = timer[i].prev_millis;
+      context.currentMillis   = current_millis;
+      context.missed          = timer[i].missed;
+      context.interval        = timer[i].delay;
+      context.numRuns         = timer[i].numRuns;
+      context.entryCycles     = TISR_CYCLES();
+
+      (*(timerCallback_ctx)timer[i].callback)(context);
+    }
+    else if (timer[i].callbackType == TIMER_CALLBACK_PARAM)
       (*(timerCallback_p)timer[i].callback)(timer[i].param);
     else
       (*(timerCallback)timer[i].callback)();
 
+#if TISR_STATS_ENABLE
+    stats[i].recordRun( TISR_CYCLES_ELAPSED(statsStart, TISR_CYCLES()) );
+#endif
+
+    TISR_WATCHDOG_END(TISR_WATCHDOG_CALLBACK(i), watchdogCallbackFrame);
+    TISR_STACK_END(TISR_STACK_CALLBACK(i), stackCallbackStart);
+    TISR_LOAD_END(TISR_LOAD_CALLBACK, loadCallbackStart);
+    TISR_TRACE_END(TISR_TRACE_CALLBACK, i, traceCallbackStart);
+
     if (timer[i].toBeCalled == TIMER_DEFCALL_RUNANDDEL)
       deleteTimer(i);
   }
@@ -151,6 +199,8 @@ void IRAM_ATTR_PREFIX ISR_Timer::run()
   // ESP32 is a multi core / multi processing chip. It is mandatory to disable task switches during ISR
   portEXIT_CRITICAL_ISR(&timerMux);
 #endif
+
+  TISR_TRACE_END(TISR_TRACE_RUN, 0, traceRunStart);
 }
 
 ///////////////////////////////////////////
@@ -180,7 +230,7 @@ int IRAM_ATTR_PREFIX ISR_Timer::findFirstFreeSlot()
 
 ///////////////////////////////////////////
 
-int IRAM_ATTR_PREFIX ISR_Timer::setupTimer(const float& d, void* f, void* p, bool h, const uint32_t& n) 
+int IRAM_ATTR_PREFIX ISR_Timer::setupTimer(const float& d, void* f, void* p, const uint8_t& type, const uint32_t& n) 
 {
   int freeTimer;
 
@@ -200,13 +250,21 @@ int IRAM_ATTR_PREFIX ISR_Timer::setupTimer(const float& d, void* f, void* p, boo
     return -1;
   }
 
-  timer[freeTimer].delay       = d;
-  timer[freeTimer].callback    = f;
-  timer[freeTimer].param       = p;
-  timer[freeTimer].hasParam    = h;
-  timer[freeTimer].maxNumRuns  = n;
-  timer[freeTimer].enabled     = true;
-  timer[freeTimer].prev_millis = millis();
+  timer[freeTimer].delay        = d;
+  timer[freeTimer].callback     = f;
+  timer[freeTimer].param        = p;
+  timer[freeTimer].callbackType = type;
+  timer[freeTimer].maxNumRuns   = n;
+  timer[freeTimer].enabled      = true;
+  timer[freeTimer].prev_millis  = millis();
+
+#if TISR_STATS_ENABLE
+  stats[freeTimer].reset();
+#endif
+
+  // entryCycles of the context, and the stats durations
+  if ( TISR_STATS_ENABLE || (type == TIMER_CALLBACK_CONTEXT) )
+    tisr_cycles_init();
 
   numTimers++;
 
@@ -217,42 +275,63 @@ int IRAM_ATTR_PREFIX ISR_Timer::setupTimer(const float& d, void* f, void* p, boo
 
 int IRAM_ATTR_PREFIX ISR_Timer::setTimer(const float& d, timerCallback f, const uint32_t& n) 
 {
-  return setupTimer(d, (void *)f, NULL, false, n);
+  return setupTimer(d, (void *)f, NULL, TIMER_CALLBACK_NO_PARAM, n);
 }
 
 ///////////////////////////////////////////
 
 int IRAM_ATTR_PREFIX ISR_Timer::setTimer(const float& d, timerCallback_p f, void* p, const uint32_t& n) 
 {
-  return setupTimer(d, (void *)f, p, true, n);
+  return setupTimer(d, (void *)f, p, TIMER_CALLBACK_PARAM, n);
+}
+
+///////////////////////////////////////////
+
+int IRAM_ATTR_PREFIX ISR_Timer::setTimer(const float& d, timerCallback_ctx f, void* p, const uint32_t& n) 
+{
+  return setupTimer(d, (void *)f, p, TIMER_CALLBACK_CONTEXT, n);
 }
 
 ///////////////////////////////////////////
 
 int IRAM_ATTR_PREFIX ISR_Timer::setInterval(const float& d, timerCallback f) 
 {
-  return setupTimer(d, (void *)f, NULL, false, TIMER_RUN_FOREVER);
+  return setupTimer(d, (void *)f, NULL, TIMER_CALLBACK_NO_PARAM, TIMER_RUN_FOREVER);
 }
 
 ///////////////////////////////////////////
 
 int IRAM_ATTR_PREFIX ISR_Timer::setInterval(const float& d, timerCallback_p f, void* p) 
 {
-  return setupTimer(d, (void *)f, p, true, TIMER_RUN_FOREVER);
+  return setupTimer(d, (void *)f, p, TIMER_CALLBACK_PARAM, TIMER_RUN_FOREVER);
+}
+
+///////////////////////////////////////////
+
+int IRAM_ATTR_PREFIX ISR_Timer::setInterval(const float& d, timerCallback_ctx f, void* p) 
+{
+  return setupTimer(d, (void *)f, p, TIMER_CALLBACK_CONTEXT, TIMER_RUN_FOREVER);
 }
 
 ///////////////////////////////////////////
 
 int IRAM_ATTR_PREFIX ISR_Timer::setTimeout(const float& d, timerCallback f) 
 {
-  return setupTimer(d, (void *)f, NULL, false, TIMER_RUN_ONCE);
+  return setupTimer(d, (void *)f, NULL, TIMER_CALLBACK_NO_PARAM, TIMER_RUN_ONCE);
 }
 
 ///////////////////////////////////////////
 
 int IRAM_ATTR_PREFIX ISR_Timer::setTimeout(const float& d, timerCallback_p f, void* p) 
 {
-  return setupTimer(d, (void *)f, p, true, TIMER_RUN_ONCE);
+  return setupTimer(d, (void *)f, p, TIMER_CALLBACK_PARAM, TIMER_RUN_ONCE);
+}
+
+///////////////////////////////////////////
+
+int IRAM_ATTR_PREFIX ISR_Timer::setTimeout(const float& d, timerCallback_ctx f, void* p) 
+{
+  return setupTimer(d, (void *)f, p, TIMER_CALLBACK_CONTEXT, TIMER_RUN_ONCE);
 }
 
 ///////////////////////////////////////////
@@ -453,4 +532,133 @@ uint8_t IRAM_ATTR_PREFIX ISR_Timer::getNumTimers()
 
 ///////////////////////////////////////////
 
+bool ISR_Timer::getSchedule(const uint8_t& numTimer, tisr_timer_schedule_t& schedule)
+{
+  if ( (numTimer >= MAX_NUMBER_TIMERS) || (numTimers <= 0) )
+  {
+    return false;
+  }
+
+#if ( defined(ESP32) || ESP32 )
+  // ESP32 is a multi core / multi processing chip. run() may be updating the timer on the other core
+  portENTER_CRITICAL(&timerMux);
+#endif
+
+  schedule.callback     = timer[numTimer].callback;
+  schedule.param        = timer[numTimer].param;
+  schedule.callbackType = timer[numTimer].callbackType;
+  schedule.interval     = timer[numTimer].delay;
+  schedule.maxNumRuns   = timer[numTimer].maxNumRuns;
+  schedule.numRuns      = timer[numTimer].numRuns;
+  schedule.enabled      = timer[numTimer].enabled;
+  schedule.elapsed      = millis() - timer[numTimer].prev_millis;
+
+#if ( defined(ESP32) || ESP32 )
+  portEXIT_CRITICAL(&timerMux);
+#endif
+
+  return (schedule.callback != NULL);
+}
+
+///////////////////////////////////////////
+
+bool ISR_Timer::restoreTimer(const uint8_t& numTimer, const tisr_timer_schedule_t& schedule)
+{
+  if ( (numTimer >= MAX_NUMBER_TIMERS) || (schedule.callback == NULL) )
+  {
+    return false;
+  }
+
+  if (numTimers < 0) 
+  {
+    init();
+  }
+
+  if (timer[numTimer].callback != NULL)
+  {
+    return false;
+  }
+
+#if ( defined(ESP32) || ESP32 )
+  portENTER_CRITICAL(&timerMux);
+#endif
+
+  timer[numTimer].delay         = schedule.interval;
+  timer[numTimer].param         = schedule.param;
+  timer[numTimer].callbackType  = schedule.callbackType;
+  timer[numTimer].maxNumRuns    = schedule.maxNumRuns;
+  timer[numTimer].numRuns       = schedule.numRuns;
+  timer[numTimer].enabled       = schedule.enabled;
+
+  // Periods which ended meanwhile are run once by the next run(), as missed ones
+  timer[numTimer].prev_millis   = millis() - schedule.elapsed;
+
+#if TISR_STATS_ENABLE
+  stats[numTimer].reset();
+#endif
+
+  // Last, run() skips the slot until it has a callback
+  timer[numTimer].callback      = schedule.callback;
+
+  numTimers++;
+
+#if ( defined(ESP32) || ESP32 )
+  portEXIT_CRITICAL(&timerMux);
+#endif
+
+  if ( TISR_STATS_ENABLE || (schedule.callbackType == TIMER_CALLBACK_CONTEXT) )
+    tisr_cycles_init();
+
+  return true;
+}
+
+///////////////////////////////////////////
+
+#if TISR_STATS_ENABLE
+
+bool ISR_Timer::getStats(const uint8_t& numTimer, tisr_timer_stats_t& snapshot)
+{
+  if (numTimer >= MAX_NUMBER_TIMERS)
+  {
+    return false;
+  }
+
+#if ( defined(ESP32) || ESP32 )
+  // ESP32 is a multi core / multi processing chip. run() may be updating the stats on the other core
+  portENTER_CRITICAL(&timerMux);
+#endif
+
+  stats[numTimer].getSnapshot(snapshot);
+
+#if ( defined(ESP32) || ESP32 )
+  portEXIT_CRITICAL(&timerMux);
+#endif
+
+  return true;
+}
+
+///////////////////////////////////////////
+
+void ISR_Timer::resetStats(const uint8_t& numTimer)
+{
+  if (numTimer >= MAX_NUMBER_TIMERS)
+  {
+    return;
+  }
+
+#if ( defined(ESP32) || ESP32 )
+  portENTER_CRITICAL(&timerMux);
+#endif
+
+  stats[numTimer].reset();
+
+#if ( defined(ESP32) || ESP32 )
+  portEXIT_CRITICAL(&timerMux);
+#endif
+}
+
+#endif    // TISR_STATS_ENABLE
+
+///////////////////////////////////////////
+
 #endif    // ISR_TIMER_IMPL_GENERIC_H
@@ -96,11 +96,41 @@
 #endif
 
 #include "TimerInterrupt_Generic_Debug.h"
+#include "TimerInterrupt_Generic_Cycles.h"
 
 //#define ISR_Timer ISRTimer
 
+///////////////////////////////////////////
+
+// Dispatch context passed to the timerCallback_ctx callbacks, filled from what run() already knows
+typedef struct
+{
+  uint8_t         numTimer;           // timer number, as returned by setInterval() / setTimeout() / setTimer()
+  void*           param;              // user pointer given at setup, NULL if none
+  unsigned long   scheduledMillis;    // deadline served by this call, in millis()
+  unsigned long   currentMillis;      // millis() read when run() started
+  tisr_cycles_t   entryCycles;        // TISR_CYCLES() right before the callback was entered
+  uint16_t        missed;             // periods skipped since the previous call (saturated), 0 if on time
+  float           interval;           // timer interval in ms. Time since the previous call = interval * (missed + 1)
+  uint32_t        numRuns;            // calls so far, setTimer() / setTimeout() timers only
+} tisr_timer_context_t;
+
+// Schedule of one timer slot, to save it and set it up again later, e.g. across deep sleep (see getSchedule() / restoreTimer())
+typedef struct
+{
+  void*           callback;           // pointer to the callback function
+  void*           param;              // function parameter
+  uint8_t         callbackType;       // TIMER_CALLBACK_xxx
+  float           interval;           // timer interval in ms
+  uint32_t        maxNumRuns;         // number of runs to be executed, TIMER_RUN_FOREVER if none
+  uint32_t        numRuns;            // number of executed runs
+  bool            enabled;            // true if enabled
+  unsigned long   elapsed;            // ms since the start of the current period
+} tisr_timer_schedule_t;
+
 typedef void (*timerCallback)();
 typedef void (*timerCallback_p)(void *);
+typedef void (*timerCallback_ctx)(const tisr_timer_context_t&);
 
 ///////////////////////////////////////////
 
@@ -130,6 +160,11 @@ class ISR_Timer
     // -1 on failure (f == NULL) or no free timers
     int IRAM_ATTR_PREFIX setInterval(const float& d, timerCallback_p f, void* p);
 
+    // Timer will call function 'f' with a tisr_timer_context_t every 'd' milliseconds forever
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f == NULL) or no free timers
+    int IRAM_ATTR_PREFIX setInterval(const float& d, timerCallback_ctx f, void* p = NULL);
+
     // Timer will call function 'f' after 'd' milliseconds one time
     // returns the timer number (numTimer) on success or
     // -1 on failure (f == NULL) or no free timers
@@ -140,6 +175,11 @@ class ISR_Timer
     // -1 on failure (f == NULL) or no free timers
     int IRAM_ATTR_PREFIX setTimeout(const float& d, timerCallback_p f, void* p);
 
+    // Timer will call function 'f' with a tisr_timer_context_t after 'd' milliseconds one time
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f == NULL) or no free timers
+    int IRAM_ATTR_PREFIX setTimeout(const float& d, timerCallback_ctx f, void* p = NULL);
+
     // Timer will call function 'f' every 'd' milliseconds 'n' times
     // returns the timer number (numTimer) on success or
     // -1 on failure (f == NULL) or no free timers
@@ -150,6 +190,11 @@ class ISR_Timer
     // -1 on failure (f == NULL) or no free timers
     int IRAM_ATTR_PREFIX setTimer(const float& d, timerCallback_p f, void* p, const uint32_t& n);
 
+    // Timer will call function 'f' with a tisr_timer_context_t every 'd' milliseconds 'n' times
+    // returns the timer number (numTimer) on success or
+    // -1 on failure (f == NULL) or no free timers
+    int IRAM_ATTR_PREFIX setTimer(const float& d, timerCallback_ctx f, void* p, const uint32_t& n);
+
     // updates interval of the specified timer
     bool IRAM_ATTR_PREFIX changeInterval(const uint8_t& numTimer, const float& d);
 
@@ -188,6 +233,29 @@ class ISR_Timer
       return MAX_NUMBER_TIMERS - numTimers;
     };
 
+    ///////////////////////////////////////////
+
+    // copies the schedule of the specified timer, its phase as the ms elapsed in the current period
+    // returns false if numTimer is out of range or not used
+    bool getSchedule(const uint8_t& numTimer, tisr_timer_schedule_t& schedule);
+
+    // sets up the specified slot again from a saved schedule, keeping its number, run count and phase
+    // returns false if numTimer is out of range or already used, or schedule.callback == NULL
+    bool restoreTimer(const uint8_t& numTimer, const tisr_timer_schedule_t& schedule);
+
+#if TISR_STATS_ENABLE
+
+    ///////////////////////////////////////////
+
+    // copies the runtime statistics of the specified timer, safe to call from loop()
+    // returns false if numTimer is out of range
+    bool getStats(const uint8_t& numTimer, tisr_timer_stats_t& snapshot);
+
+    // clears the runtime statistics of the specified timer
+    void resetStats(const uint8_t& numTimer);
+
+#endif
+
     ///////////////////////////////////////////
     ///////////////////////////////////////////
 
@@ -197,10 +265,15 @@ class ISR_Timer
 #define TIMER_DEFCALL_RUNONLY   1       // call the callback function but don't delete the timer
 #define TIMER_DEFCALL_RUNANDDEL 2       // call the callback function and delete the timer
 
+    // callback types
+#define TIMER_CALLBACK_NO_PARAM 0       // timerCallback
+#define TIMER_CALLBACK_PARAM    1       // timerCallback_p
+#define TIMER_CALLBACK_CONTEXT  2       // timerCallback_ctx
+
     // low level function to initialize and enable a new timer
     // returns the timer number (numTimer) on success or
     // -1 on failure (f == NULL) or no free timers
-    int IRAM_ATTR_PREFIX setupTimer(const float& d, void* f, void* p, bool h, const uint32_t& n);
+    int IRAM_ATTR_PREFIX setupTimer(const float& d, void* f, void* p, const uint8_t& type, const uint32_t& n);
 
     // find the first available slot
     int IRAM_ATTR_PREFIX findFirstFreeSlot();
@@ -212,18 +285,24 @@ class ISR_Timer
       unsigned long prev_millis;        // value returned by the millis() function in the previous run() call
       void*         callback;           // pointer to the callback function
       void*         param;              // function parameter
-      bool          hasParam;           // true if callback takes a parameter
+      uint8_t       callbackType;       // TIMER_CALLBACK_xxx
       float         delay;              // delay value
       uint32_t      maxNumRuns;         // number of runs to be executed
       uint32_t      numRuns;            // number of executed runs
       bool          enabled;            // true if enabled
       unsigned      toBeCalled;         // deferred function call (sort of) - N.B.: only used in run()
+      uint16_t      missed;             // periods skipped before the pending call - N.B.: only used in run()
     } timer_t;
 
     ///////////////////////////////////////////
 
     volatile timer_t timer[MAX_NUMBER_TIMERS];
 
+#if TISR_STATS_ENABLE
+    // runtime statistics, per slot. Cleared when a new timer is set up in the slot
+    TISR_TimerStats stats[MAX_NUMBER_TIMERS];
+#endif
+
     // actual number of timers in use (-1 means uninitialized)
     volatile int numTimers;
 };
@@ -200,6 +200,7 @@
 ///////////////////////////////////////////
 
 #include "TimerInterrupt_Generic_Debug.h"
+#include "TimerInterrupt_Generic_Solvers.h"
 
 #define TIMER_HZ      48000000L
 
@@ -480,51 +481,15 @@ class SAMDTimerInterrupt
       TC3->COUNT16.CTRLA.reg &= ~TC_CTRLA_PRESCALER_DIV1;
       TC3_wait_for_sync();
 
-      if (period > 300000) 
-      {
-        TC_CTRLA_PRESCALER_DIVN = TC_CTRLA_PRESCALER_DIV1024;
-        _prescaler = 1024;
-      } 
-      else if (80000 < period && period <= 300000) 
-      {
-        TC_CTRLA_PRESCALER_DIVN = TC_CTRLA_PRESCALER_DIV256;
-        _prescaler = 256;
-      } 
-      else if (20000 < period && period <= 80000) 
-      {
-        TC_CTRLA_PRESCALER_DIVN = TC_CTRLA_PRESCALER_DIV64;
-        _prescaler = 64;
-      } 
-      else if (10000 < period && period <= 20000) 
-      {
-        TC_CTRLA_PRESCALER_DIVN = TC_CTRLA_PRESCALER_DIV16;
-        _prescaler = 16;
-      } 
-      else if (5000 < period && period <= 10000) 
-      {
-        TC_CTRLA_PRESCALER_DIVN = TC_CTRLA_PRESCALER_DIV8;
-        _prescaler = 8;
-      } 
-      else if (2500 < period && period <= 5000) 
-      {
-        TC_CTRLA_PRESCALER_DIVN = TC_CTRLA_PRESCALER_DIV4;
-        _prescaler = 4;
-      } 
-      else if (1000 < period && period <= 2500) {
-        TC_CTRLA_PRESCALER_DIVN = TC_CTRLA_PRESCALER_DIV2;
-        _prescaler = 2;
-      } 
-      else if (period <= 1000) 
-      {
-        TC_CTRLA_PRESCALER_DIVN = TC_CTRLA_PRESCALER_DIV1;
-        _prescaler = 1;
-      }
-      
+      // See TimerInterrupt_Generic_Solvers.h
+      uint8_t prescalerField;
+
+      _prescaler              = tisr_solver_samd(TIMER_HZ, period, prescalerField, _compareValue);
+      TC_CTRLA_PRESCALER_DIVN = TC_CTRLA_PRESCALER(prescalerField);
+
       TC3->COUNT16.CTRLA.reg |= TC_CTRLA_PRESCALER_DIVN;
       TC3_wait_for_sync();
 
-      _compareValue = (int)(TIMER_HZ / (_prescaler/(period / 1000000.0))) - 1;
-
       // Make sure the count is in a proportional position to where it was
       // to prevent any jitter or disconnect when changing the compare value.
       TC3->COUNT16.COUNT.reg = map(TC3->COUNT16.COUNT.reg, 0,
@@ -1064,58 +1029,14 @@ class SAMDTimerInterrupt
       
       while (_Timer->STATUS.bit.SYNCBUSY == 1);
       
-      if (period > 300000) 
-      {
-        // Set prescaler to 1024
-        _Timer->CTRLA.reg |= TC_CTRLA_PRESCALER_DIV1024;
-        _prescaler = 1024;
-      } 
-      else if (80000 < period && period <= 300000) 
-      {
-        // Set prescaler to 256
-        _Timer->CTRLA.reg |= TC_CTRLA_PRESCALER_DIV256;
-        _prescaler = 256;
-      } 
-      else if (20000 < period && period <= 80000) 
-      {
-        // Set prescaler to 64
-        _Timer->CTRLA.reg |= TC_CTRLA_PRESCALER_DIV64;
-        _prescaler = 64;
-      } 
-      else if (10000 < period && period <= 20000) 
-      {
-        // Set prescaler to 16
-        _Timer->CTRLA.reg |= TC_CTRLA_PRESCALER_DIV16;
-        _prescaler = 16;
-      } 
-      else if (5000 < period && period <= 10000) 
-      {
-        // Set prescaler to 8
-        _Timer->CTRLA.reg |= TC_CTRLA_PRESCALER_DIV8;
-        _prescaler = 8;
-      } 
-      else if (2500 < period && period <= 5000) 
-      {
-        // Set prescaler to 4
-        _Timer->CTRLA.reg |= TC_CTRLA_PRESCALER_DIV4;
-        _prescaler = 4;
-      } 
-      else if (1000 < period && period <= 2500) 
-      {
-        // Set prescaler to 2
-        _Timer->CTRLA.reg |= TC_CTRLA_PRESCALER_DIV2;
-        _prescaler = 2;
-      } 
-      else if (period <= 1000) 
-      {
-        // Set prescaler to 1
-        _Timer->CTRLA.reg |= TC_CTRLA_PRESCALER_DIV1;
-        _prescaler = 1;
-      }
-      
-      while (_Timer->STATUS.bit.SYNCBUSY == 1);
+      // See TimerInterrupt_Generic_Solvers.h
+      uint8_t prescalerField;
+
+      _prescaler = tisr_solver_samd(TIMER_HZ, period, prescalerField, _compareValue);
 
-      _compareValue = (int)(TIMER_HZ / (_prescaler / (period / 1000000.0))) - 1;
+      _Timer->CTRLA.reg |= TC_CTRLA_PRESCALER(prescalerField);
+
+      while (_Timer->STATUS.bit.SYNCBUSY == 1);
 
       
       // Make sure the count is in a proportional position to where it was
@@ -1152,56 +1073,12 @@ class SAMDTimerInterrupt
       
       while (_Timer->SYNCBUSY.bit.ENABLE == 1);
       
-      if (period > 300000) 
-      {
-        // Set prescaler to 1024
-        _Timer->CTRLA.reg |= TCC_CTRLA_PRESCALER_DIV1024;
-        _prescaler = 1024;
-      } 
-      else if (80000 < period && period <= 300000) 
-      {
-        // Set prescaler to 256
-        _Timer->CTRLA.reg |= TCC_CTRLA_PRESCALER_DIV256;
-        _prescaler = 256;
-      } 
-      else if (20000 < period && period <= 80000) 
-      {
-        // Set prescaler to 64
-        _Timer->CTRLA.reg |= TCC_CTRLA_PRESCALER_DIV64;
-        _prescaler = 64;
-      } 
-      else if (10000 < period && period <= 20000) 
-      {
-        // Set prescaler to 16
-        _Timer->CTRLA.reg |= TCC_CTRLA_PRESCALER_DIV16;
-        _prescaler = 16;
-      } 
-      else if (5000 < period && period <= 10000) 
-      {
-        // Set prescaler to 8
-        _Timer->CTRLA.reg |= TCC_CTRLA_PRESCALER_DIV8;
-        _prescaler = 8;
-      } 
-      else if (2500 < period && period <= 5000) 
-      {
-        // Set prescaler to 4
-        _Timer->CTRLA.reg |= TCC_CTRLA_PRESCALER_DIV4;
-        _prescaler = 4;
-      } 
-      else if (1000 < period && period <= 2500) 
-      {
-        // Set prescaler to 2
-        _Timer->CTRLA.reg |= TCC_CTRLA_PRESCALER_DIV2;
-        _prescaler = 2;
-      } 
-      else if (period <= 1000) 
-      {
-        // Set prescaler to 1
-        _Timer->CTRLA.reg |= TCC_CTRLA_PRESCALER_DIV1;
-        _prescaler = 1;
-      }
-      
-      _compareValue = (int)(TIMER_HZ / (_prescaler / (period / 1000000))) - 1;
+      // See TimerInterrupt_Generic_Solvers.h
+      uint8_t prescalerField;
+
+      _prescaler = tisr_solver_samd(TIMER_HZ, period, prescalerField, _compareValue);
+
+      _Timer->CTRLA.reg |= TCC_CTRLA_PRESCALER(prescalerField);
 
       _Timer->PER.reg = _compareValue; 
       
@@ -66,6 +66,7 @@
 #endif
 
 #include "TimerInterrupt_Generic_Debug.h"
+#include "TimerInterrupt_Generic_Solvers.h"
 
 #ifdef BOARD_NAME
   #undef BOARD_NAME
@@ -295,7 +296,7 @@ class DueTimerInterrupt
       return stopTimer();
     }
 
-    // Picks the best clock to lower the error
+    // Picks the best clock to lower the error, see TimerInterrupt_Generic_Solvers.h
     static uint8_t bestClock(const double& frequency, uint32_t& retRC)
     {
       /*
@@ -307,41 +308,12 @@ class DueTimerInterrupt
         TIMER_CLOCK3  MCK / 32
         TIMER_CLOCK4  MCK /128
       */
-      const struct
+      static const uint8_t clockFlags[] =
       {
-        uint8_t flag;
-        uint8_t divisor;
-      } clockConfig[] =
-      {
-        { TC_CMR_TCCLKS_TIMER_CLOCK1,   2 },
-        { TC_CMR_TCCLKS_TIMER_CLOCK2,   8 },
-        { TC_CMR_TCCLKS_TIMER_CLOCK3,  32 },
-        { TC_CMR_TCCLKS_TIMER_CLOCK4, 128 }
+        TC_CMR_TCCLKS_TIMER_CLOCK1, TC_CMR_TCCLKS_TIMER_CLOCK2, TC_CMR_TCCLKS_TIMER_CLOCK3, TC_CMR_TCCLKS_TIMER_CLOCK4
       };
 
-      float ticks;
-      float error;
-      int clkId       = 3;
-      int bestClock   = 3;
-      float bestError = 9.999e99;
-
-      do
-      {
-        ticks = (float) SystemCoreClock / frequency / (float) clockConfig[clkId].divisor;
-        // error = abs(ticks - round(ticks));
-        error = clockConfig[clkId].divisor * abs(ticks - round(ticks)); // Error comparison needs scaling
-
-        if (error < bestError)
-        {
-          bestClock = clkId;
-          bestError = error;
-        }
-      } while (clkId-- > 0);
-
-      ticks = (float) SystemCoreClock / frequency / (float) clockConfig[bestClock].divisor;
-      retRC = (uint32_t) round(ticks);
-
-      return clockConfig[bestClock].flag;
+      return clockFlags[tisr_solver_due(SystemCoreClock, frequency, retRC)];
     }
 
 
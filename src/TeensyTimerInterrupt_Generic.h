@@ -63,6 +63,7 @@
 #endif
 
 #include "TimerInterrupt_Generic_Debug.h"
+#include "TimerInterrupt_Generic_Solvers.h"
 
 //////////////////////////////////////////////////////////
 
@@ -185,20 +186,9 @@ class TeensyTimerInterrupt
           return false;
       }
       
-      uint32_t period = ((float) F_BUS_ACTUAL / 2000000) * (float) interval;
-      uint32_t prescale = 0;
-
-      while (period > 32767)
-      {
-        period = period >> 1;
-
-        if (++prescale > 7)
-        {
-          prescale = 7;   
-          period = 32767; 
-          break;
-        }
-      }
+      // See TimerInterrupt_Generic_Solvers.h
+      uint32_t prescale;
+      uint32_t period = tisr_solver_teensy4((uint32_t) F_BUS_ACTUAL, (float) interval, prescale);
       
       // when F_BUS is 150 MHz, longest period (_realPeriod) is 55922.3467 us (~17.881939 Hz)
       // 55922.3467 us = (32767 * 2000000) / (150000000 >> 7)
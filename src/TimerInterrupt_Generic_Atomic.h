@@ -0,0 +1,105 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Atomic.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Short critical sections shared by the ISR-safe helpers (trace ring, deferred logger, ...).
+
+  TISR_ATOMIC_ENTER() / TISR_ATOMIC_EXIT() mask interrupts for a few instructions and restore the previous state
+  afterwards, so they can be nested inside ISRs and other critical sections. On ESP32 a portMUX spinlock is used,
+  which also serializes the two cores. Declare the portMUX with TISR_ATOMIC_MUX(name) and pass its name to
+  TISR_ATOMIC_ENTER(name) / TISR_ATOMIC_EXIT(name). It is ignored on the other platforms.
+
+  Only one TISR_ATOMIC_ENTER() is allowed per scope.
+
+  TISR_MEMORY_BARRIER() orders the memory accesses before it against the ones after it, for the compiler and for the
+  other core / bus masters (DMB on ARM, MEMW on Xtensa, FENCE on RISC-V). It doesn't mask interrupts.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_ATOMIC_H
+#define TIMERINTERRUPT_GENERIC_ATOMIC_H
+
+#if defined(ARDUINO)
+  #if ARDUINO >= 100
+    #include <Arduino.h>
+  #else
+    #include <WProgram.h>
+  #endif
+#endif
+
+///////////////////////////////////////////
+
+#if ( defined(ESP8266) || ESP8266 ) || ( defined(ESP32) || ESP32 )
+  #define TISR_ATOMIC_IRAM_ATTR         IRAM_ATTR
+#else
+  #define TISR_ATOMIC_IRAM_ATTR
+#endif
+
+///////////////////////////////////////////
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+
+  #define TISR_ATOMIC_MUX(mux)
+  #define TISR_ATOMIC_MUX_INIT(mux)
+
+  #define TISR_ATOMIC_ENTER(mux)        uint8_t _tisrAtomicState = SREG; cli()
+  #define TISR_ATOMIC_EXIT(mux)         SREG = _tisrAtomicState
+
+#elif ( defined(ESP32) || ESP32 )
+
+  #define TISR_ATOMIC_MUX(mux)          portMUX_TYPE mux
+  #define TISR_ATOMIC_MUX_INIT(mux)     mux = portMUX_INITIALIZER_UNLOCKED
+
+  #define TISR_ATOMIC_ENTER(mux)        portENTER_CRITICAL_SAFE(&mux)
+  #define TISR_ATOMIC_EXIT(mux)         portEXIT_CRITICAL_SAFE(&mux)
+
+#elif ( defined(ESP8266) || ESP8266 )
+
+  #define TISR_ATOMIC_MUX(mux)
+  #define TISR_ATOMIC_MUX_INIT(mux)
+
+  #define TISR_ATOMIC_ENTER(mux)        uint32_t _tisrAtomicState = xt_rsil(15)
+  #define TISR_ATOMIC_EXIT(mux)         xt_wsr_ps(_tisrAtomicState)
+
+#elif defined(__arm__)
+
+  #define TISR_ATOMIC_MUX(mux)
+  #define TISR_ATOMIC_MUX_INIT(mux)
+
+  // Restores PRIMASK instead of blindly re-enabling interrupts
+  #define TISR_ATOMIC_ENTER(mux)        uint32_t _tisrAtomicState; \
+                                        __asm__ volatile ("mrs %0, primask\n cpsid i" : "=r" (_tisrAtomicState) :: "memory")
+  #define TISR_ATOMIC_EXIT(mux)         __asm__ volatile ("msr primask, %0" :: "r" (_tisrAtomicState) : "memory")
+
+#else
+
+  #define TISR_ATOMIC_MUX(mux)
+  #define TISR_ATOMIC_MUX_INIT(mux)
+
+  #define TISR_ATOMIC_ENTER(mux)        noInterrupts()
+  #define TISR_ATOMIC_EXIT(mux)         interrupts()
+
+#endif
+
+///////////////////////////////////////////
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+  // Single core, in-order, no cache : only the compiler can reorder
+  #define TISR_MEMORY_BARRIER()         __asm__ volatile ("" ::: "memory")
+#elif defined(__arm__)
+  #define TISR_MEMORY_BARRIER()         __asm__ volatile ("dmb 0xF" ::: "memory")
+#elif defined(__XTENSA__)
+  #define TISR_MEMORY_BARRIER()         __asm__ volatile ("memw" ::: "memory")
+#elif defined(__riscv)
+  #define TISR_MEMORY_BARRIER()         __asm__ volatile ("fence rw, rw" ::: "memory")
+#else
+  #define TISR_MEMORY_BARRIER()         __sync_synchronize()
+#endif
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_ATOMIC_H
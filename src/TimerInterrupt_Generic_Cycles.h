@@ -0,0 +1,318 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Cycles.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Free-running, high resolution timestamp counter for timing ISR entry, callbacks and code sections.
+
+  TISR_CYCLES() returns a tisr_cycles_t counting at TISR_CYCLES_HZ, mapped to the best counter of each target :
+
+  1) Cortex-M3/M4/M7/M33 (SAM DUE, SAMD51, Teensy 3.x/4.x, STM32F1/F2/F3/F4/F7/L4/H7/G4/WB, nRF52, Nano-33-BLE) : DWT CYCCNT
+  2) ESP32, ESP32_S2, ESP32_S3, ESP32_C3, ESP8266 : CPU cycle counter (CCOUNT on Xtensa)
+  3) RP2040 (arduino-pico and Mbed cores) : 1MHz timer_hw->timerawl
+     or, with TISR_CYCLES_RP2040_USE_SYSTICK true, the 24-bit SysTick of the calling core, free-running at the CPU clock
+  4) Cortex-M0/M0+ (SAMD21, STM32F0/L0/G0, Teensy LC) : CPU clock, from the 1ms core SysTick and millis()
+  5) AVR : micros()
+     or, with TISR_CYCLES_AVR_USE_TIMER1 true, the 16-bit TCNT1 at F_CPU. Timer1 is then owned by TISR_CYCLES(), so
+     ITimer1, Servo, etc. can't be used
+  6) Others (megaAVR, ...) : micros()
+
+  Call tisr_cycles_init() once in setup() before using TISR_CYCLES(). It is idempotent.
+
+  Counters narrower than 32 bits wrap at TISR_CYCLES_MASK : TISR_CYCLES_ELAPSED() stays correct for spans shorter than
+  one wrap (4.1ms for the 16MHz AVR Timer1, 134ms for the 125MHz RP2040 SysTick).
+
+  To time a code section :
+
+    tisr_cycles_t elapsed;
+
+    {
+      TISR_CYCLES_PROBE(elapsed);
+      ...
+    }
+
+    Serial.println(tisr_cycles_to_ns(elapsed));
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_CYCLES_H
+#define TIMERINTERRUPT_GENERIC_CYCLES_H
+
+#include <inttypes.h>
+
+#if defined(ARDUINO)
+  #if ARDUINO >= 100
+    #include <Arduino.h>
+  #else
+    #include <WProgram.h>
+  #endif
+#endif
+
+#ifndef TISR_CYCLES_RP2040_USE_SYSTICK
+  #define TISR_CYCLES_RP2040_USE_SYSTICK    false
+#endif
+
+#ifndef TISR_CYCLES_AVR_USE_TIMER1
+  #define TISR_CYCLES_AVR_USE_TIMER1        false
+#endif
+
+typedef uint32_t tisr_cycles_t;
+
+///////////////////////////////////////////
+
+#if ( defined(ESP32) || ESP32 ) || ( defined(ESP8266) || ESP8266 )
+
+  #define TISR_CYCLES_USING_CPU_COUNTER     true
+
+  #define TISR_CYCLES()                     ( (tisr_cycles_t) ESP.getCycleCount() )
+
+  #if ( defined(ESP32) || ESP32 )
+    #define TISR_CYCLES_HZ                  ( (uint32_t) getCpuFrequencyMhz() * 1000000UL )
+  #else
+    #define TISR_CYCLES_HZ                  ( (uint32_t) ESP.getCpuFreqMHz() * 1000000UL )
+  #endif
+
+  static inline void tisr_cycles_init()
+  {
+  }
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) || defined(ARDUINO_NANO_RP2040_CONNECT) )
+
+  #if TISR_CYCLES_RP2040_USE_SYSTICK
+
+    #define TISR_CYCLES_USING_SYSTICK         true
+
+    #define TISR_SYST_CSR                     ( *(volatile uint32_t *) 0xE000E010UL )
+    #define TISR_SYST_RVR                     ( *(volatile uint32_t *) 0xE000E014UL )
+    #define TISR_SYST_CVR                     ( *(volatile uint32_t *) 0xE000E018UL )
+
+    // SysTick counts down, invert it to get a counter going up
+    #define TISR_CYCLES()                     ( (tisr_cycles_t) ( ~TISR_SYST_CVR & 0x00FFFFFFUL ) )
+    #define TISR_CYCLES_HZ                    ( (uint32_t) F_CPU )
+    #define TISR_CYCLES_MASK                  ( 0x00FFFFFFUL )
+
+    // SysTick is per core, call it from every core using TISR_CYCLES(). Left alone if already running (e.g. FreeRTOS)
+    static inline void tisr_cycles_init()
+    {
+      if ( (TISR_SYST_CSR & 0x01) == 0 )
+      {
+        TISR_SYST_RVR = 0x00FFFFFFUL;
+        TISR_SYST_CVR = 0;
+
+        // CLKSOURCE = processor clock, no interrupt, ENABLE
+        TISR_SYST_CSR = 0x05;
+      }
+    }
+
+  #else
+
+    #include "hardware/timer.h"
+    #include "hardware/structs/timer.h"
+
+    #define TISR_CYCLES_USING_RP2040_TIMER    true
+
+    // Lower 32 bits of the 64-bit 1MHz system timer. Reading TIMERAWL doesn't latch TIMEHR, so it's safe from any core / ISR
+    #define TISR_CYCLES()                     ( (tisr_cycles_t) timer_hw->timerawl )
+    #define TISR_CYCLES_HZ                    ( 1000000UL )
+
+    static inline void tisr_cycles_init()
+    {
+    }
+
+  #endif
+
+#elif ( defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__) )
+
+  #define TISR_CYCLES_USING_DWT             true
+
+  #define TISR_DWT_CTRL                     ( *(volatile uint32_t *) 0xE0001000UL )
+  #define TISR_DWT_CYCCNT                   ( *(volatile uint32_t *) 0xE0001004UL )
+  #define TISR_DWT_LAR                      ( *(volatile uint32_t *) 0xE0001FB0UL )
+  #define TISR_CORE_DEMCR                   ( *(volatile uint32_t *) 0xE000EDFCUL )
+
+  #define TISR_DEMCR_TRCENA                 ( 1UL << 24 )
+  #define TISR_DWT_CTRL_CYCCNTENA           ( 1UL <<  0 )
+
+  #define TISR_CYCLES()                     ( (tisr_cycles_t) TISR_DWT_CYCCNT )
+
+  #if defined(F_CPU_ACTUAL)
+    // Teensy 4.x can change its clock at runtime
+    #define TISR_CYCLES_HZ                  ( (uint32_t) F_CPU_ACTUAL )
+  #else
+    #define TISR_CYCLES_HZ                  ( (uint32_t) F_CPU )
+  #endif
+
+  static inline void tisr_cycles_init()
+  {
+    if ( (TISR_DWT_CTRL & TISR_DWT_CTRL_CYCCNTENA) == 0 )
+    {
+      TISR_CORE_DEMCR |= TISR_DEMCR_TRCENA;
+
+#if ( defined(__CORTEX_M) && (__CORTEX_M == 7) )
+      // Cortex-M7 DWT is write-locked after reset
+      TISR_DWT_LAR     = 0xC5ACCE55UL;
+#endif
+
+      TISR_DWT_CYCCNT  = 0;
+      TISR_DWT_CTRL   |= TISR_DWT_CTRL_CYCCNTENA;
+    }
+  }
+
+#elif defined(__ARM_ARCH_6M__)
+
+  // No DWT CYCCNT on Cortex-M0/M0+. The cores run SysTick as their 1ms tick and count it in millis(), so
+  // millis() * (reload + 1) + elapsed SysTick counts is the CPU cycle count, modulo 2^32
+  #define TISR_CYCLES_USING_SYSTICK         true
+
+  #define TISR_SYST_RVR                     ( *(volatile uint32_t *) 0xE000E014UL )
+  #define TISR_SYST_CVR                     ( *(volatile uint32_t *) 0xE000E018UL )
+  #define TISR_SCB_ICSR                     ( *(volatile uint32_t *) 0xE000ED04UL )
+
+  #define TISR_SCB_ICSR_PENDSTSET           ( 1UL << 26 )
+
+  #define TISR_CYCLES()                     tisr_cycles_systick()
+  #define TISR_CYCLES_HZ                    ( (TISR_SYST_RVR + 1) * 1000UL )
+
+  // No critical section : retried if the SysTick ISR ran in between. When called with interrupts masked or from a
+  // higher priority ISR, a pending SysTick means the reload already happened but millis() hasn't been incremented yet
+  static inline tisr_cycles_t tisr_cycles_systick()
+  {
+    uint32_t ms;
+    uint32_t count;
+    uint32_t reload = TISR_SYST_RVR;
+
+    do
+    {
+      ms    = millis();
+      count = TISR_SYST_CVR;
+    } while (ms != millis());
+
+    if ( (TISR_SCB_ICSR & TISR_SCB_ICSR_PENDSTSET) && (count > (reload >> 1)) )
+      ms++;
+
+    return (tisr_cycles_t) ( ms * (reload + 1) + (reload - count) );
+  }
+
+  static inline void tisr_cycles_init()
+  {
+  }
+
+#elif ( defined(__AVR__) && TISR_CYCLES_AVR_USE_TIMER1 )
+
+  #define TISR_CYCLES_USING_AVR_TIMER1      true
+
+  #define TISR_CYCLES()                     tisr_cycles_timer1()
+  #define TISR_CYCLES_HZ                    ( (uint32_t) F_CPU )
+  #define TISR_CYCLES_MASK                  ( 0xFFFFUL )
+
+  // The 16-bit read goes through the TEMP register shared with the ISRs, so it's done with interrupts masked
+  static inline tisr_cycles_t tisr_cycles_timer1()
+  {
+    uint8_t   sreg = SREG;
+
+    cli();
+
+    uint16_t  count = TCNT1;
+
+    SREG = sreg;
+
+    return (tisr_cycles_t) count;
+  }
+
+  // Normal mode, no prescaler, no interrupt
+  static inline void tisr_cycles_init()
+  {
+    if (TCCR1B != _BV(CS10))
+    {
+      TIMSK1  = 0;
+      TCCR1A  = 0;
+      TCCR1B  = _BV(CS10);
+    }
+  }
+
+#else
+
+  #define TISR_CYCLES_USING_MICROS          true
+
+  #define TISR_CYCLES()                     ( (tisr_cycles_t) micros() )
+  #define TISR_CYCLES_HZ                    ( 1000000UL )
+
+  static inline void tisr_cycles_init()
+  {
+  }
+
+#endif
+
+#ifndef TISR_CYCLES_MASK
+  #define TISR_CYCLES_MASK                  ( 0xFFFFFFFFUL )
+#endif
+
+///////////////////////////////////////////
+
+// Elapsed counts between two TISR_CYCLES() readings. Unsigned arithmetic makes it correct across one counter wrap
+#define TISR_CYCLES_ELAPSED(start, end)     ( (tisr_cycles_t) ( ( (tisr_cycles_t) (end) - (tisr_cycles_t) (start) ) & TISR_CYCLES_MASK ) )
+
+///////////////////////////////////////////
+
+// Counts to time. 64-bit intermediate, so spans up to one full counter wrap convert without overflow
+static inline uint32_t tisr_cycles_to_ns(const tisr_cycles_t& cycles)
+{
+  return (uint32_t) ( ( (uint64_t) cycles * 1000000000ULL ) / TISR_CYCLES_HZ );
+}
+
+static inline uint32_t tisr_cycles_to_us(const tisr_cycles_t& cycles)
+{
+  return (uint32_t) ( ( (uint64_t) cycles * 1000000ULL ) / TISR_CYCLES_HZ );
+}
+
+// Cost of one TISR_CYCLES() reading, to be subtracted from very short measurements
+static inline tisr_cycles_t tisr_cycles_overhead()
+{
+  tisr_cycles_t best = TISR_CYCLES_MASK;
+
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    tisr_cycles_t start   = TISR_CYCLES();
+    tisr_cycles_t elapsed = TISR_CYCLES_ELAPSED(start, TISR_CYCLES());
+
+    if (elapsed < best)
+      best = elapsed;
+  }
+
+  return best;
+}
+
+///////////////////////////////////////////
+
+// Scoped probe : writes the counts spent between its construction and the end of the enclosing scope into elapsed
+class TISR_CyclesProbe
+{
+  public:
+
+    TISR_CyclesProbe(tisr_cycles_t& elapsed) : _elapsed(elapsed), _start(TISR_CYCLES())
+    {
+    }
+
+    ~TISR_CyclesProbe()
+    {
+      _elapsed = TISR_CYCLES_ELAPSED(_start, TISR_CYCLES());
+    }
+
+  private:
+
+    tisr_cycles_t&  _elapsed;
+    tisr_cycles_t   _start;
+};
+
+#define TISR_CYCLES_CONCAT_(a, b)           a##b
+#define TISR_CYCLES_CONCAT(a, b)            TISR_CYCLES_CONCAT_(a, b)
+
+#define TISR_CYCLES_PROBE(elapsed)          TISR_CyclesProbe TISR_CYCLES_CONCAT(_tisrCyclesProbe, __LINE__) (elapsed)
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_CYCLES_H
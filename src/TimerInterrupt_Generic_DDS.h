@@ -0,0 +1,435 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_DDS.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Direct digital synthesis of waveforms, one sample per timer tick. Include it explicitly, after
+  "TimerInterrupt_Generic.h".
+
+  Each voice has a 32-bit phase accumulator, advanced by its phase increment on every tick : f = inc * sampleHz / 2^32,
+  i.e. a frequency resolution of ~0.00001Hz at 44.1kHz. The top 8 bits of the phase index a 256 entries wavetable
+  in flash (the built-in sine or any 16-bit signed table), interpolated linearly with the next 8 bits. The voices are
+  scaled by their amplitude and summed. A sample costs a few 16 x 16 bits multiplies per voice, no division and no
+  floating point. Changing the frequency only changes the increment, so the waveform stays phase-continuous, and
+  setChirp() sweeps the increment itself on every tick.
+
+  The sample is given to a write function, at the start of the next tick so it goes out with no jitter :
+  - writeDac() : the DAC, on SAMD21 (A0, 10 bits), SAMD51 (A0, 12 bits), Due (DAC0, 12 bits), ESP32 / ESP32_S2
+    (GPIO25 / GPIO17, 8 bits) and Teensy 3.2 / 3.5 / 3.6 / LC (12 bits). See beginDac()
+  - writePwm() : on AVR, Timer2 fast PWM at F_CPU / 256 (62.5kHz at 16MHz), 8 bits on OC2B, D3 on 328(P), D9 on Mega,
+    to be low-pass filtered. Don't use ITimer2 (USE_TIMER_2) then. See beginPwm()
+  - or the sketch's own function, e.g. an external SPI / I2S DAC
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_DDS_H
+#define TIMERINTERRUPT_GENERIC_DDS_H
+
+#include <math.h>
+
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#if defined(__AVR__)
+  #include <avr/pgmspace.h>
+
+  #define TISR_DDS_READ_TABLE(table, index)     ( (int16_t) pgm_read_word( &(table)[index] ) )
+#else
+  #define TISR_DDS_READ_TABLE(table, index)     ( (table)[index] )
+#endif
+
+// Wavetables have 2^TISR_DDS_TABLE_BITS entries
+#define TISR_DDS_TABLE_BITS           8
+#define TISR_DDS_TABLE_SIZE           ( 1 << TISR_DDS_TABLE_BITS )
+
+// Full scale amplitude, Q15
+#define TISR_DDS_AMPLITUDE_MAX        32767
+
+// Writes an unsigned sample, 0 .. 2^bits - 1. Called from the timer ISR
+typedef void (*tisr_dds_write_t)(const uint16_t& value);
+
+// One sine period, full scale
+static const int16_t tisr_dds_sine[TISR_DDS_TABLE_SIZE] PROGMEM =
+{
+       0,    804,   1608,   2410,   3212,   4011,   4808,   5602,   6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+   12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,  18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+   23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,  27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+   30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,  32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+   32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,  32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,
+   30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683,  27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+   23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,  18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279,
+   12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,   6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,
+       0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602,  -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+  -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530, -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+  -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790, -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+  -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971, -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+  -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285, -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+  -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683, -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+  -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868, -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+  -12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,  -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804
+};
+
+///////////////////////////////////////////
+
+#if TIMER_INTERRUPT_USING_SAMD21
+  #define TISR_DDS_DAC_BITS           10
+  #define TISR_DDS_DAC_PIN            A0
+#elif defined(__SAMD51__)
+  #define TISR_DDS_DAC_BITS           12
+  #define TISR_DDS_DAC_PIN            A0
+#elif TIMER_INTERRUPT_USING_SAMDUE
+  #define TISR_DDS_DAC_BITS           12
+  #define TISR_DDS_DAC_PIN            DAC0
+#elif defined(ESP32) && ( CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2 )
+  #define TISR_DDS_DAC_BITS           8
+  #if CONFIG_IDF_TARGET_ESP32S2
+    #define TISR_DDS_DAC_PIN          17
+  #else
+    #define TISR_DDS_DAC_PIN          25
+  #endif
+#elif defined(__MK20DX256__)
+  #define TISR_DDS_DAC_BITS           12
+  #define TISR_DDS_DAC_PIN            A14
+#elif defined(__MK64FX512__) || defined(__MK66FX1M0__)
+  #define TISR_DDS_DAC_BITS           12
+  #define TISR_DDS_DAC_PIN            A21
+#elif defined(__MKL26Z64__)
+  #define TISR_DDS_DAC_BITS           12
+  #define TISR_DDS_DAC_PIN            A12
+#endif
+
+#if defined(TISR_DDS_DAC_BITS)
+
+// Enables the DAC through the core, at mid-scale
+inline void tisr_dds_begin_dac()
+{
+#if defined(ESP32)
+  dacWrite(TISR_DDS_DAC_PIN, 1 << (TISR_DDS_DAC_BITS - 1));
+#else
+  analogWriteResolution(TISR_DDS_DAC_BITS);
+  analogWrite(TISR_DDS_DAC_PIN, 1 << (TISR_DDS_DAC_BITS - 1));
+#endif
+}
+
+// Then writes the data register directly, analogWrite() is too slow for an ISR
+inline void TISR_ATOMIC_IRAM_ATTR tisr_dds_write_dac(const uint16_t& value)
+{
+#if TIMER_INTERRUPT_USING_SAMD21
+  while (DAC->STATUS.bit.SYNCBUSY);
+
+  DAC->DATA.reg = value;
+#elif defined(__SAMD51__)
+  while (DAC->SYNCBUSY.bit.DATA0);
+
+  DAC->DATA[0].reg = value;
+#elif TIMER_INTERRUPT_USING_SAMDUE
+  DACC->DACC_CDR = value;
+#elif defined(ESP32)
+  dacWrite(TISR_DDS_DAC_PIN, value);
+#else
+  *(volatile int16_t *) &(DAC0_DAT0L) = value;
+#endif
+}
+
+#endif    // TISR_DDS_DAC_BITS
+
+#if defined(__AVR__) && defined(OCR2B) && !USE_TIMER_2
+  #define TISR_DDS_PWM_BITS           8
+
+  #if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+    #define TISR_DDS_PWM_PIN          9
+  #else
+    #define TISR_DDS_PWM_PIN          3
+  #endif
+
+// Timer2 in fast PWM mode, no prescaler, output on OC2B at mid-scale
+inline void tisr_dds_begin_pwm()
+{
+  pinMode(TISR_DDS_PWM_PIN, OUTPUT);
+
+  TCCR2A  = _BV(COM2B1) | _BV(WGM21) | _BV(WGM20);
+  TCCR2B  = _BV(CS20);
+  OCR2B   = 1 << (TISR_DDS_PWM_BITS - 1);
+}
+
+inline void tisr_dds_write_pwm(const uint16_t& value)
+{
+  OCR2B = (uint8_t) value;
+}
+
+#endif    // TISR_DDS_PWM_BITS
+
+///////////////////////////////////////////
+
+template <uint8_t NUM_VOICES = 1>
+class TISR_DDS
+{
+  public:
+
+    TISR_DDS() : _write(NULL), _sampleHz(1), _shift(8), _sample(128)
+    {
+      TISR_ATOMIC_MUX_INIT(_mux);
+
+      for (uint8_t voice = 0; voice < NUM_VOICES; voice++)
+      {
+        _voices[voice].phase      = 0;
+        _voices[voice].increment  = 0;
+        _voices[voice].sweeping   = false;
+        _voices[voice].amplitude  = 0;
+        _voices[voice].table      = tisr_dds_sine;
+      }
+    }
+
+    // Before the timer starts calling update() sampleHz times / s. bits : of the values given to write, 1 - 16
+    void begin(const uint32_t& sampleHz, tisr_dds_write_t write, const uint8_t& bits)
+    {
+      _sampleHz = sampleHz;
+      _shift    = 16 - bits;
+      _sample   = 1 << (bits - 1);
+      _write    = write;
+    }
+
+#if defined(TISR_DDS_DAC_BITS)
+    void beginDac(const uint32_t& sampleHz)
+    {
+      tisr_dds_begin_dac();
+      begin(sampleHz, tisr_dds_write_dac, TISR_DDS_DAC_BITS);
+    }
+#endif
+
+#if defined(TISR_DDS_PWM_BITS)
+    void beginPwm(const uint32_t& sampleHz)
+    {
+      tisr_dds_begin_pwm();
+      begin(sampleHz, tisr_dds_write_pwm, TISR_DDS_PWM_BITS);
+    }
+#endif
+
+    ///////////////////////////////////////////
+
+    // Phase-continuous, stops any chirp. Up to sampleHz / 2
+    void setFrequency(const uint8_t& voice, const float& hz)
+    {
+      setPhaseIncrement(voice, toIncrement(hz));
+    }
+
+    void setPhaseIncrement(const uint8_t& voice, const uint32_t& increment)
+    {
+      if (voice >= NUM_VOICES)
+        return;
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      _voices[voice].increment  = increment;
+      _voices[voice].sweeping   = false;
+
+      TISR_ATOMIC_EXIT(_mux);
+    }
+
+    // Linear sweep from startHz to endHz over durationMs, then again from startHz if repeat, else stays at endHz.
+    // The step per tick is kept in 16.16 fixed point, so slow sweeps still last durationMs
+    void setChirp(const uint8_t& voice, const float& startHz, const float& endHz, const uint32_t& durationMs,
+                  const bool& repeat = true)
+    {
+      if (voice >= NUM_VOICES)
+        return;
+
+      uint32_t  start       = toIncrement(startHz);
+      uint32_t  end         = toIncrement(endHz);
+      float     numSamples  = (float) durationMs * _sampleHz / 1000.0f;
+      float     step        = ( (float) end - (float) start ) / ( (numSamples >= 1.0f) ? numSamples : 1.0f );
+
+      // Whole part rounded down, so the fraction is always added, 0 - 65535
+      int32_t   sweep         = (int32_t) floorf(step);
+      uint16_t  sweepFraction = (uint16_t) ( (step - (float) sweep) * 65536.0f );
+
+      // At least 1 / 65536 per tick when end != start
+      if ( (sweep == 0) && (sweepFraction == 0) && (end > start) )
+        sweepFraction = 1;
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      _voices[voice].increment        = start;
+      _voices[voice].sweepStart       = start;
+      _voices[voice].sweepEnd         = end;
+      _voices[voice].sweep            = sweep;
+      _voices[voice].sweepFraction    = sweepFraction;
+      _voices[voice].sweepAccumulator = 0;
+      _voices[voice].sweepRepeat      = repeat;
+      _voices[voice].sweeping         = (end != start);
+
+      TISR_ATOMIC_EXIT(_mux);
+    }
+
+    // Q15, 0 - TISR_DDS_AMPLITUDE_MAX. The voices are summed, and clipped if the sum goes over full scale
+    void setAmplitude(const uint8_t& voice, const int16_t& amplitude)
+    {
+      if (voice >= NUM_VOICES)
+        return;
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      _voices[voice].amplitude = amplitude;
+
+      TISR_ATOMIC_EXIT(_mux);
+    }
+
+    // TISR_DDS_TABLE_SIZE entries, in PROGMEM on AVR. tisr_dds_sine by default
+    void setWaveform(const uint8_t& voice, const int16_t* table)
+    {
+      if (voice >= NUM_VOICES)
+        return;
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      _voices[voice].table = table;
+
+      TISR_ATOMIC_EXIT(_mux);
+    }
+
+    // 0 - 2^32 for 0 - 360 degrees, e.g. to restart voices in phase
+    void setPhase(const uint8_t& voice, const uint32_t& phase)
+    {
+      if (voice >= NUM_VOICES)
+        return;
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      _voices[voice].phase = phase;
+
+      TISR_ATOMIC_EXIT(_mux);
+    }
+
+    ///////////////////////////////////////////
+
+    // Call from the timer ISR, every 1 / sampleHz s
+    void TISR_ATOMIC_IRAM_ATTR update()
+    {
+      if (_write == NULL)
+        return;
+
+      // Sample computed by the previous tick first, with a constant latency
+      _write(_sample);
+
+      int32_t sum = 0;
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      for (uint8_t voice = 0; voice < NUM_VOICES; voice++)
+      {
+        voice_t& v = _voices[voice];
+
+        if (v.amplitude == 0)
+          continue;
+
+        uint32_t  phase   = v.phase;
+        uint8_t   index   = (uint8_t) (phase >> (32 - TISR_DDS_TABLE_BITS));
+        uint8_t   frac    = (uint8_t) (phase >> (24 - TISR_DDS_TABLE_BITS));
+
+        int16_t   y0      = TISR_DDS_READ_TABLE(v.table, index);
+        int16_t   y1      = TISR_DDS_READ_TABLE(v.table, (uint8_t) (index + 1));
+        int16_t   y       = y0 + (int16_t) ( ( (int32_t) (y1 - y0) * frac ) >> 8 );
+
+        sum += ( (int32_t) y * v.amplitude ) >> 15;
+
+        v.phase = phase + v.increment;
+
+        if (v.sweeping)
+          advanceSweep(v);
+      }
+
+      TISR_ATOMIC_EXIT(_mux);
+
+      // Signed full scale to the unsigned output range
+      sum += 32768L;
+
+      if (sum < 0)
+        sum = 0;
+      else if (sum > 65535L)
+        sum = 65535L;
+
+      _sample = (uint16_t) sum >> _shift;
+    }
+
+    ///////////////////////////////////////////
+
+    uint32_t getPhaseIncrement(const uint8_t& voice) const
+    {
+      return (voice < NUM_VOICES) ? _voices[voice].increment : 0;
+    }
+
+    float getFrequency(const uint8_t& voice) const
+    {
+      return getPhaseIncrement(voice) * (float) _sampleHz / 4294967296.0f;
+    }
+
+    uint32_t getSampleHz() const
+    {
+      return _sampleHz;
+    }
+
+  private:
+
+    typedef struct
+    {
+      uint32_t        phase;
+      uint32_t        increment;
+      int32_t         sweep;            // added to increment on every tick, whole part rounded down
+      uint16_t        sweepFraction;    // plus sweepFraction / 65536
+      uint16_t        sweepAccumulator; // fractions not added yet
+      uint32_t        sweepStart;
+      uint32_t        sweepEnd;
+      bool            sweepRepeat;
+      bool            sweeping;         // false : fixed frequency
+      int16_t         amplitude;        // Q15
+      const int16_t*  table;
+    } voice_t;
+
+    uint32_t toIncrement(const float& hz) const
+    {
+      float increment = hz * 4294967296.0f / _sampleHz;
+
+      return (increment < 2147483648.0f) ? (uint32_t) increment : 0x7FFFFFFFUL;
+    }
+
+    void TISR_ATOMIC_IRAM_ATTR advanceSweep(voice_t& v)
+    {
+      uint32_t fraction = (uint32_t) v.sweepAccumulator + v.sweepFraction;
+
+      v.sweepAccumulator = (uint16_t) fraction;
+
+      // Increments stay under 2^31 (sampleHz / 2) : the sum doesn't overflow as unsigned going up, nor as signed going
+      // down, where it may go below 0
+      uint32_t increment = v.increment + (uint32_t) v.sweep + (fraction >> 16);
+
+      if ( (v.sweepEnd > v.sweepStart) ? (increment < v.sweepEnd) : ( (int32_t) increment > (int32_t) v.sweepEnd ) )
+      {
+        v.increment = increment;
+      }
+      else if (v.sweepRepeat)
+      {
+        v.increment         = v.sweepStart;
+        v.sweepAccumulator  = 0;
+      }
+      else
+      {
+        v.increment = v.sweepEnd;
+        v.sweeping  = false;
+      }
+    }
+
+    tisr_dds_write_t volatile   _write;
+    uint32_t                    _sampleHz;
+    uint8_t                     _shift;
+    uint16_t                    _sample;          // ISR only
+
+    voice_t                     _voices[NUM_VOICES];
+
+    TISR_ATOMIC_MUX(_mux);
+};
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_DDS_H
@@ -0,0 +1,175 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Debounce.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Debouncer for many inputs at once, driven by any hardware timer or ISR_Timer callback. Include it explicitly, after
+  "TimerInterrupt_Generic.h" / "ISR_Timer_Generic.h".
+
+  Each tick samples whole GPIO ports (up to 32 pins per port, as packed by the sketch's read function) and debounces
+  all their bits in parallel with vertical counters : bit n of the two counter words is the 2-bit counter of pin n.
+  A pin changes state after 4 ticks in a row at the new level, e.g. 20ms with a 5ms tick. The cost is ~10 bitwise
+  operations per port and per tick, the same for 1 pin or 32.
+
+  Press / release edges are queued in a TISR_SpscRing (see TimerInterrupt_Generic_Exchange.h), one event per tick
+  and port with changes, read from loop() with getEvent().
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_DEBOUNCE_H
+#define TIMERINTERRUPT_GENERIC_DEBOUNCE_H
+
+#include "TimerInterrupt_Generic_Exchange.h"
+
+// Returns the current level of the pins of port, bit n for pin n. Called from the timer ISR
+typedef uint32_t (*tisr_debounce_read_t)(const uint8_t& port);
+
+typedef struct
+{
+  uint8_t   port;
+  uint32_t  pressed;      // pins which became active on this tick
+  uint32_t  released;     // pins which became inactive on this tick
+  uint32_t  millis;       // millis() of the tick
+} tisr_debounce_event_t;
+
+///////////////////////////////////////////
+
+template <uint8_t NUM_PORTS = 1, uint32_t QUEUE_SIZE = 16>
+class TISR_Debouncer
+{
+  public:
+
+    TISR_Debouncer() : _read(NULL)
+    {
+      for (uint8_t port = 0; port < NUM_PORTS; port++)
+      {
+        _ports[port].state      = 0;
+        _ports[port].count0     = 0;
+        _ports[port].count1     = 0;
+        _ports[port].activeLow  = 0;
+        _ports[port].mask       = 0xFFFFFFFFUL;
+      }
+    }
+
+    // Call after setActiveLow(), before the timer starts calling update(). The current levels are taken as stable
+    void begin(tisr_debounce_read_t read)
+    {
+      for (uint8_t port = 0; port < NUM_PORTS; port++)
+      {
+        _ports[port].state  = read(port) ^ _ports[port].activeLow;
+        _ports[port].count0 = 0;
+        _ports[port].count1 = 0;
+      }
+
+      _read = read;
+    }
+
+    // Pins of port which are active when LOW, e.g. switches to GND with INPUT_PULLUP
+    void setActiveLow(const uint8_t& port, const uint32_t& pins)
+    {
+      if (port < NUM_PORTS)
+        _ports[port].activeLow = pins;
+    }
+
+    // Pins of port which generate events, all by default
+    void setMask(const uint8_t& port, const uint32_t& pins)
+    {
+      if (port < NUM_PORTS)
+        _ports[port].mask = pins;
+    }
+
+    ///////////////////////////////////////////
+
+    // Call from the timer ISR / callback, every 2 - 10ms
+    void TISR_ATOMIC_IRAM_ATTR update()
+    {
+      if (_read == NULL)
+        return;
+
+      for (uint8_t port = 0; port < NUM_PORTS; port++)
+      {
+        port_t&   p       = _ports[port];
+        uint32_t  sample  = _read(port) ^ p.activeLow;
+
+        // Pins whose sample differs from the debounced state count 1, 2, 3, the others are reset to 0
+        uint32_t  delta   = sample ^ p.state;
+
+        p.count1  = (p.count1 ^ p.count0) & delta;
+        p.count0  = ~p.count0 & delta;
+
+        // Wrapped back to 0 : 4 samples in a row at the new level
+        uint32_t  toggle  = delta & ~(p.count0 | p.count1);
+
+        if (toggle == 0)
+          continue;
+
+        p.state ^= toggle;
+        toggle  &= p.mask;
+
+        if (toggle != 0)
+        {
+          tisr_debounce_event_t event;
+
+          event.port      = port;
+          event.pressed   = toggle & p.state;
+          event.released  = toggle & ~p.state;
+          event.millis    = millis();
+
+          _events.push(event);
+        }
+      }
+    }
+
+    ///////////////////////////////////////////
+
+    // Next queued edges, from loop(). false if none
+    bool getEvent(tisr_debounce_event_t& event)
+    {
+      return _events.pop(event);
+    }
+
+    // Debounced state of port, bit set for active pins. Read twice until stable, a 32-bit load isn't atomic on AVR
+    uint32_t getState(const uint8_t& port) const
+    {
+      if (port >= NUM_PORTS)
+        return 0;
+
+      uint32_t state;
+
+      do
+      {
+        state = _ports[port].state;
+      } while (state != _ports[port].state);
+
+      return state;
+    }
+
+    // Events lost because loop() didn't read them in time. getState() stays right
+    uint32_t getNumDropped() const
+    {
+      return _events.getNumDropped();
+    }
+
+  private:
+
+    typedef struct
+    {
+      volatile uint32_t state;      // debounced, 1 = active
+      uint32_t          count0;     // vertical counter, low bits
+      uint32_t          count1;     // vertical counter, high bits
+      uint32_t          activeLow;
+      uint32_t          mask;
+    } port_t;
+
+    tisr_debounce_read_t volatile                   _read;
+    port_t                                          _ports[NUM_PORTS];
+
+    TISR_SpscRing<tisr_debounce_event_t, QUEUE_SIZE>  _events;
+};
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_DEBOUNCE_H
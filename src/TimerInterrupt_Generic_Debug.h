@@ -75,6 +75,60 @@ const char TISR_SP[]    = " ";
 
 ///////////////////////////////////////
 
+#ifndef TISR_LOG_DEFERRED
+  #define TISR_LOG_DEFERRED       false
+#endif
+
+#if TISR_LOG_DEFERRED
+
+  // ISR-safe : records are queued in a ring and printed later from loop() by TISR_LOG_FLUSH()
+  #include "TimerInterrupt_Generic_DeferredLog.h"
+
+  #define TISR_LOG_FLUSH()        TISR_DeferredLog.flush(TISR_DBG_PORT)
+
+  ///////////////////////////////////////
+
+  #define TISR_LOGERROR(x)          if(_TIMERINTERRUPT_LOGLEVEL_>0) { TISR_DeferredLog.log(1, x); }
+  #define TISR_LOGERROR0(x)         if(_TIMERINTERRUPT_LOGLEVEL_>0) { TISR_DeferredLog.log(1 | TISR_DLOG_RAW, x); }
+  #define TISR_LOGERROR1(x,y)       if(_TIMERINTERRUPT_LOGLEVEL_>0) { TISR_DeferredLog.log(1, x, y); }
+  #define TISR_LOGERROR2(x,y,z)     if(_TIMERINTERRUPT_LOGLEVEL_>0) { TISR_DeferredLog.log(1, x, y, z); }
+  #define TISR_LOGERROR3(x,y,z,w)   if(_TIMERINTERRUPT_LOGLEVEL_>0) { TISR_DeferredLog.log(1, x, y, z, w); }
+  #define TISR_LOGERROR5(x,y,z,w, xx, yy)  if(_TIMERINTERRUPT_LOGLEVEL_>0) { TISR_DeferredLog.log(1, x, y, z, w, xx, yy); }
+
+  ///////////////////////////////////////
+
+  #define TISR_LOGWARN(x)           if(_TIMERINTERRUPT_LOGLEVEL_>1) { TISR_DeferredLog.log(2, x); }
+  #define TISR_LOGWARN0(x)          if(_TIMERINTERRUPT_LOGLEVEL_>1) { TISR_DeferredLog.log(2 | TISR_DLOG_RAW, x); }
+  #define TISR_LOGWARN1(x,y)        if(_TIMERINTERRUPT_LOGLEVEL_>1) { TISR_DeferredLog.log(2, x, y); }
+  #define TISR_LOGWARN2(x,y,z)      if(_TIMERINTERRUPT_LOGLEVEL_>1) { TISR_DeferredLog.log(2, x, y, z); }
+  #define TISR_LOGWARN3(x,y,z,w)    if(_TIMERINTERRUPT_LOGLEVEL_>1) { TISR_DeferredLog.log(2, x, y, z, w); }
+  #define TISR_LOGWARN5(x,y,z,w, xx, yy)  if(_TIMERINTERRUPT_LOGLEVEL_>1) { TISR_DeferredLog.log(2, x, y, z, w, xx, yy); }
+
+  ///////////////////////////////////////
+
+  #define TISR_LOGINFO(x)           if(_TIMERINTERRUPT_LOGLEVEL_>2) { TISR_DeferredLog.log(3, x); }
+  #define TISR_LOGINFO0(x)          if(_TIMERINTERRUPT_LOGLEVEL_>2) { TISR_DeferredLog.log(3 | TISR_DLOG_RAW, x); }
+  #define TISR_LOGINFO1(x,y)        if(_TIMERINTERRUPT_LOGLEVEL_>2) { TISR_DeferredLog.log(3, x, y); }
+  #define TISR_LOGINFO2(x,y,z)      if(_TIMERINTERRUPT_LOGLEVEL_>2) { TISR_DeferredLog.log(3, x, y, z); }
+  #define TISR_LOGINFO3(x,y,z,w)    if(_TIMERINTERRUPT_LOGLEVEL_>2) { TISR_DeferredLog.log(3, x, y, z, w); }
+  #define TISR_LOGINFO5(x,y,z,w, xx, yy)  if(_TIMERINTERRUPT_LOGLEVEL_>2) { TISR_DeferredLog.log(3, x, y, z, w, xx, yy); }
+
+  ///////////////////////////////////////
+
+  #define TISR_LOGDEBUG(x)          if(_TIMERINTERRUPT_LOGLEVEL_>3) { TISR_DeferredLog.log(4, x); }
+  #define TISR_LOGDEBUG0(x)         if(_TIMERINTERRUPT_LOGLEVEL_>3) { TISR_DeferredLog.log(4 | TISR_DLOG_RAW, x); }
+  #define TISR_LOGDEBUG1(x,y)       if(_TIMERINTERRUPT_LOGLEVEL_>3) { TISR_DeferredLog.log(4, x, y); }
+  #define TISR_LOGDEBUG2(x,y,z)     if(_TIMERINTERRUPT_LOGLEVEL_>3) { TISR_DeferredLog.log(4, x, y, z); }
+  #define TISR_LOGDEBUG3(x,y,z,w)   if(_TIMERINTERRUPT_LOGLEVEL_>3) { TISR_DeferredLog.log(4, x, y, z, w); }
+  #define TISR_LOGDEBUG5(x,y,z,w, xx, yy)  if(_TIMERINTERRUPT_LOGLEVEL_>3) { TISR_DeferredLog.log(4, x, y, z, w, xx, yy); }
+
+#else
+
+  // Nothing is queued, TISR_LOG_FLUSH() is a no-op so that sketches can call it unconditionally
+  #define TISR_LOG_FLUSH()
+
+///////////////////////////////////////
+
 #define TISR_LOGERROR(x)         if(_TIMERINTERRUPT_LOGLEVEL_>0) { TISR_PRINT_MARK; TISR_PRINTLN(x); }
 #define TISR_LOGERROR0(x)        if(_TIMERINTERRUPT_LOGLEVEL_>0) { TISR_PRINT(x); }
 #define TISR_LOGERROR1(x,y)      if(_TIMERINTERRUPT_LOGLEVEL_>0) { TISR_PRINT_MARK; TISR_PRINT(x); TISR_PRINT_SP; TISR_PRINTLN(y); }
@@ -109,6 +163,25 @@ const char TISR_SP[]    = " ";
 #define TISR_LOGDEBUG3(x,y,z,w)  if(_TIMERINTERRUPT_LOGLEVEL_>3) { TISR_PRINT_MARK; TISR_PRINT(x); TISR_PRINT_SP; TISR_PRINT(y); TISR_PRINT_SP; TISR_PRINT(z); TISR_PRINT_SP; TISR_PRINTLN(w); }
 #define TISR_LOGDEBUG5(x,y,z,w, xx, yy)  if(_TIMERINTERRUPT_LOGLEVEL_>3) { TISR_PRINT_MARK; TISR_PRINT(x); TISR_PRINT_SP; TISR_PRINT(y); TISR_PRINT_SP; TISR_PRINT(z); TISR_PRINT_SP; TISR_PRINT(w); TISR_PRINT_SP; TISR_PRINT(xx); TISR_PRINT_SP; TISR_PRINTLN(yy); }
 
+#endif    // TISR_LOG_DEFERRED
+
+///////////////////////////////////////
+
+// Optional binary event tracing, compiled in only with TISR_TRACE_ENABLE
+#include "TimerInterrupt_Generic_Trace.h"
+
+// Optional per-timer runtime statistics, compiled in only with TISR_STATS_ENABLE
+#include "TimerInterrupt_Generic_Stats.h"
+
+// Optional CPU utilization meter, compiled in only with TISR_LOAD_ENABLE
+#include "TimerInterrupt_Generic_Load.h"
+
+// Optional interrupt stack depth watermarking, compiled in only with TISR_STACK_ENABLE
+#include "TimerInterrupt_Generic_Stack.h"
+
+// Optional execution-budget watchdog, compiled in only with TISR_WATCHDOG_ENABLE
+#include "TimerInterrupt_Generic_Watchdog.h"
+
 ///////////////////////////////////////
 
 #endif    //TIMERINTERRUPT_GENERIC_DEBUG_H
@@ -0,0 +1,301 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Decimator.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Fixed-point filter and decimation stages for oversampled signals. Include it explicitly, after
+  "TimerInterrupt_Generic.h".
+
+  Each stage takes a block of samples and writes its outputs, at 1 / RATIO of the input rate, into a block, returning
+  their number : process(in, count, out). The stages are chained on the blocks of TISR_BlockSampler (see
+  TimerInterrupt_Generic_Sampler.h), typically in its block callback called from the ISR, and the last one pushes its
+  block into a TISR_SpscRing (see TimerInterrupt_Generic_Exchange.h). loop() only reads the low rate output and can
+  stall for as long as the ring lasts without losing a sample. Integers only, no float.
+
+  1) TISR_CicDecimator<ORDER, RATIO> : cascaded integrator-comb, no multiply. Large ratios at the first, high rate
+     stage. Its sinc response droops in the passband and lets some aliasing through, hence a FIR after it
+  2) TISR_FirDecimator<NUM_TAPS, RATIO> : FIR low-pass with Q15 coefficients. Only the output samples kept are
+     computed, i.e. NUM_TAPS / RATIO multiply-accumulates per input sample, as a polyphase filter. On Cortex-M4 / M7
+     (STM32F3/F4/F7/G4/L4/H7, SAMD51, nRF52, Teensy 3.x / 4.x) 2 taps per SMLAD instruction
+  3) TISR_MovingAverage<LENGTH, RATIO> : running sum over LENGTH samples, output every RATIO samples
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_DECIMATOR_H
+#define TIMERINTERRUPT_GENERIC_DECIMATOR_H
+
+#include "TimerInterrupt_Generic_Exchange.h"
+
+// Dual 16-bit multiply-accumulate of the Cortex-M DSP extension. Elsewhere (AVR, Cortex-M0+, Xtensa, RISC-V) the
+// compiler does plain 32-bit multiply-accumulates
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+  #define TISR_DECIMATOR_USING_SMLAD      true
+
+  static inline int32_t tisr_decimator_smlad(const uint32_t& x, const uint32_t& y, const int32_t& accumulator)
+  {
+    int32_t result;
+
+    __asm__ ("smlad %0, %1, %2, %3" : "=r" (result) : "r" (x), "r" (y), "r" (accumulator));
+
+    return result;
+  }
+#else
+  #define TISR_DECIMATOR_USING_SMLAD      false
+#endif
+
+///////////////////////////////////////////
+
+// Gain RATIO ^ ORDER, scaled back by a shift : unity when RATIO is a power of 2, a bit less otherwise.
+// The integrators wrap around, which the combs undo, as long as the input bits + ORDER * log2(RATIO) fit in 32 bits,
+// e.g. 16-bit samples with ORDER 4 and RATIO 16
+template <uint8_t ORDER, uint16_t RATIO>
+class TISR_CicDecimator
+{
+  static_assert( (ORDER >= 1) && (RATIO >= 1), "TISR_CicDecimator ORDER and RATIO must be at least 1" );
+
+  public:
+
+    TISR_CicDecimator() : _shift(0)
+    {
+      uint64_t gain = 1;
+
+      for (uint8_t stage = 0; stage < ORDER; stage++)
+        gain *= RATIO;
+
+      while ( (1ULL << _shift) < gain )
+        _shift++;
+
+      reset();
+    }
+
+    void reset()
+    {
+      for (uint8_t stage = 0; stage < ORDER; stage++)
+      {
+        _integrators[stage] = 0;
+        _combs[stage]       = 0;
+      }
+
+      _phase = 0;
+    }
+
+    // count samples from in, count / RATIO of them (+ 1) to out. Returns the number of out samples
+    template <typename Tin, typename Tout>
+    uint16_t TISR_ATOMIC_IRAM_ATTR process(const Tin* in, const uint16_t& count, Tout* out)
+    {
+      uint16_t numOut = 0;
+
+      for (uint16_t i = 0; i < count; i++)
+      {
+        // Unsigned : wrapping around is defined
+        uint32_t value = (uint32_t) (int32_t) in[i];
+
+        for (uint8_t stage = 0; stage < ORDER; stage++)
+        {
+          value               += _integrators[stage];
+          _integrators[stage]  = value;
+        }
+
+        if (++_phase < RATIO)
+          continue;
+
+        _phase = 0;
+
+        for (uint8_t stage = 0; stage < ORDER; stage++)
+        {
+          uint32_t previous = _combs[stage];
+
+          _combs[stage]  = value;
+          value         -= previous;
+        }
+
+        out[numOut++] = (Tout) ( (int32_t) value >> _shift );
+      }
+
+      return numOut;
+    }
+
+    uint8_t getShift() const
+    {
+      return _shift;
+    }
+
+  private:
+
+    uint32_t  _integrators[ORDER];
+    uint32_t  _combs[ORDER];
+    uint16_t  _phase;
+    uint8_t   _shift;
+};
+
+///////////////////////////////////////////
+
+// coefficients in Q15 (32768 = 1.0). The accumulator is 32-bit : keep the sum of their absolute values below 2.0
+template <uint16_t NUM_TAPS, uint16_t RATIO = 1>
+class TISR_FirDecimator
+{
+  static_assert( (NUM_TAPS >= 1) && (RATIO >= 1), "TISR_FirDecimator NUM_TAPS and RATIO must be at least 1" );
+
+  public:
+
+    TISR_FirDecimator()
+    {
+      for (uint16_t tap = 0; tap < NUM_TAPS; tap++)
+        _coefficients[tap] = 0;
+
+      reset();
+    }
+
+    // Copied. coefficients[0] applies to the newest sample, which makes no difference for the usual symmetric filters
+    void begin(const int16_t* coefficients)
+    {
+      for (uint16_t tap = 0; tap < NUM_TAPS; tap++)
+        _coefficients[tap] = coefficients[tap];
+
+      reset();
+    }
+
+    void reset()
+    {
+      for (uint16_t tap = 0; tap < 2 * NUM_TAPS; tap++)
+        _delay[tap] = 0;
+
+      _position = 0;
+      _phase    = 0;
+    }
+
+    // 16-bit samples. count samples from in, count / RATIO of them (+ 1) to out. Returns the number of out samples
+    template <typename Tin, typename Tout>
+    uint16_t TISR_ATOMIC_IRAM_ATTR process(const Tin* in, const uint16_t& count, Tout* out)
+    {
+      uint16_t numOut = 0;
+
+      for (uint16_t i = 0; i < count; i++)
+      {
+        // Stored twice, so the NUM_TAPS samples from _position on are always contiguous, newest first
+        _position = ( (_position == 0) ? NUM_TAPS : _position ) - 1;
+
+        _delay[_position]             = (int16_t) in[i];
+        _delay[_position + NUM_TAPS]  = (int16_t) in[i];
+
+        if (++_phase < RATIO)
+          continue;
+
+        _phase = 0;
+
+        out[numOut++] = (Tout) filter(&_delay[_position]);
+      }
+
+      return numOut;
+    }
+
+  private:
+
+    int16_t TISR_ATOMIC_IRAM_ATTR filter(const int16_t* samples) const
+    {
+      int32_t   accumulator = 0;
+      uint16_t  tap         = 0;
+
+#if TISR_DECIMATOR_USING_SMLAD
+      for ( ; tap + 1 < NUM_TAPS; tap += 2)
+      {
+        uint32_t samplePair;
+        uint32_t coefficientPair;
+
+        // Unaligned 32-bit loads are fine on Cortex-M4 / M7
+        memcpy(&samplePair,       &samples[tap],        sizeof(samplePair));
+        memcpy(&coefficientPair,  &_coefficients[tap],  sizeof(coefficientPair));
+
+        accumulator = tisr_decimator_smlad(samplePair, coefficientPair, accumulator);
+      }
+#endif
+
+      for ( ; tap < NUM_TAPS; tap++)
+        accumulator += (int32_t) samples[tap] * _coefficients[tap];
+
+      // Rounded back to Q15, saturated
+      accumulator = (accumulator + 0x4000) >> 15;
+
+      if (accumulator > 32767)
+        return 32767;
+
+      if (accumulator < -32768)
+        return -32768;
+
+      return (int16_t) accumulator;
+    }
+
+    int16_t   _coefficients[NUM_TAPS];
+    int16_t   _delay[2 * NUM_TAPS];
+    uint16_t  _position;
+    uint16_t  _phase;
+};
+
+///////////////////////////////////////////
+
+// Mean of the last LENGTH samples, every RATIO samples. RATIO = LENGTH : mean of each block of LENGTH samples.
+// The samples kept are of type T, the sum is 32-bit
+template <uint16_t LENGTH, uint16_t RATIO = LENGTH, typename T = int16_t>
+class TISR_MovingAverage
+{
+  static_assert( (LENGTH >= 1) && (RATIO >= 1), "TISR_MovingAverage LENGTH and RATIO must be at least 1" );
+
+  public:
+
+    TISR_MovingAverage()
+    {
+      reset();
+    }
+
+    void reset()
+    {
+      for (uint16_t i = 0; i < LENGTH; i++)
+        _history[i] = 0;
+
+      _sum      = 0;
+      _position = 0;
+      _phase    = 0;
+    }
+
+    // count samples from in, count / RATIO of them (+ 1) to out. Returns the number of out samples
+    template <typename Tin, typename Tout>
+    uint16_t TISR_ATOMIC_IRAM_ATTR process(const Tin* in, const uint16_t& count, Tout* out)
+    {
+      uint16_t numOut = 0;
+
+      for (uint16_t i = 0; i < count; i++)
+      {
+        T sample = (T) in[i];
+
+        _sum               += (int32_t) sample - _history[_position];
+        _history[_position] = sample;
+
+        if (++_position == LENGTH)
+          _position = 0;
+
+        if (++_phase < RATIO)
+          continue;
+
+        _phase = 0;
+
+        // A shift when LENGTH is a power of 2
+        out[numOut++] = (Tout) (_sum / (int32_t) LENGTH);
+      }
+
+      return numOut;
+    }
+
+  private:
+
+    T         _history[LENGTH];
+    int32_t   _sum;
+    uint16_t  _position;
+    uint16_t  _phase;
+};
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_DECIMATOR_H
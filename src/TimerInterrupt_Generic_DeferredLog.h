@@ -0,0 +1,371 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_DeferredLog.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Deferred, ISR-safe backend for the TISR_LOGxxx macros, selected with TISR_LOG_DEFERRED true.
+
+  Instead of printing, each TISR_LOGxxx call stores the addresses of its string arguments (string literals, F() strings)
+  and the raw values of the others into a fixed-size ring, which costs tens of cycles and never blocks. loop() calls
+  TISR_LOG_FLUSH() to print the pending records :
+
+  1) Text mode (default)   : the exact same "[TISR] ..." lines the direct TISR_LOGxxx macros would print
+  2) Binary mode           : TISR_LOG_DEFERRED_BINARY true. Only addresses and raw values are sent, 2 + 2 + 5 * nargs bytes
+                             per record. extras/log/tisr_log_decode resolves the string addresses with the sketch's ELF file
+
+  When the ring is full, new records are dropped and counted, the count is reported at the next flush.
+
+  Only string literals, F() strings and static / global char arrays can be logged : the string is read at the flush,
+  a buffer on the stack is long gone or overwritten by then. Other pointers are logged as their address, in hex.
+
+  Binary record format : 0xA5, 0x5A, uint8_t level / flags, uint8_t nargs, nargs * { uint8_t tag, uint32_t value (LE) }
+  A record with level TISR_DLOG_DROPPED carries the number of dropped records as its single argument.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_DEFERREDLOG_H
+#define TIMERINTERRUPT_GENERIC_DEFERREDLOG_H
+
+#include <string.h>
+
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#ifndef TISR_LOG_DEFERRED_BINARY
+  #define TISR_LOG_DEFERRED_BINARY      false
+#endif
+
+#ifndef TISR_DLOG_BUFFER_SIZE
+  #if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+    // 8 * 32 = 256 bytes of RAM
+    #define TISR_DLOG_BUFFER_SIZE       8
+  #else
+    // 64 * 32 = 2KB of RAM
+    #define TISR_DLOG_BUFFER_SIZE       64
+  #endif
+#endif
+
+#if ( (TISR_DLOG_BUFFER_SIZE & (TISR_DLOG_BUFFER_SIZE - 1)) != 0 ) || (TISR_DLOG_BUFFER_SIZE > 128)
+  #error TISR_DLOG_BUFFER_SIZE must be a power of 2, up to 128
+#endif
+
+// Arguments per record, TISR_LOGxxx5 has 6
+#define TISR_DLOG_MAX_ARGS              6
+
+// Record level / flags, shared with the host decoder
+#define TISR_DLOG_LEVEL_MASK            0x0F
+#define TISR_DLOG_RAW                   0x80      // TISR_LOGxxx0 : no "[TISR] " mark and no newline
+#define TISR_DLOG_DROPPED               0x7F      // Records dropped because the ring was full
+
+// Argument tags, shared with the host decoder
+#define TISR_DLOG_NONE                  0
+#define TISR_DLOG_STR                   1         // Address of a string in RAM (AVR) or in the address space (others)
+#define TISR_DLOG_FSTR                  2         // Address of an F() / PROGMEM string
+#define TISR_DLOG_INT                   3
+#define TISR_DLOG_UINT                  4
+#define TISR_DLOG_FLOAT                 5         // IEEE754 single precision bits
+#define TISR_DLOG_CHAR                  6
+#define TISR_DLOG_PTR                   7         // Any other pointer, printed as its address in hex
+
+#define TISR_DLOG_SYNC0                 0xA5
+#define TISR_DLOG_SYNC1                 0x5A
+
+///////////////////////////////////////////
+
+// Wide enough for a pointer and a 32-bit value. Binary records always carry the lower 32 bits
+#if ( UINTPTR_MAX > 0xFFFFFFFFUL )
+  typedef uint64_t  tisr_dlog_value_t;
+#else
+  typedef uint32_t  tisr_dlog_value_t;
+#endif
+
+// One captured argument. The converting constructors pick the tag, so the TISR_LOGxxx call sites are unchanged.
+// 64-bit integers are truncated to their lower 32 bits
+class TISR_DLogArg
+{
+  public:
+
+    TISR_DLogArg()                                  : tag(TISR_DLOG_NONE),  value(0) {}
+
+    TISR_DLogArg(const char* s)                     : tag(TISR_DLOG_STR),   value((uintptr_t) s) {}
+    TISR_DLogArg(const __FlashStringHelper* s)      : tag(TISR_DLOG_FSTR),  value((uintptr_t) s) {}
+
+    // Else the pointers would convert to bool
+    TISR_DLogArg(const void* p)                     : tag(TISR_DLOG_PTR),   value((uintptr_t) p) {}
+
+    TISR_DLogArg(char c)                            : tag(TISR_DLOG_CHAR),  value((uint8_t) c) {}
+    TISR_DLogArg(bool b)                            : tag(TISR_DLOG_UINT),  value(b ? 1 : 0) {}
+
+    TISR_DLogArg(int v)                             : tag(TISR_DLOG_INT),   value((uint32_t) v) {}
+    TISR_DLogArg(long v)                            : tag(TISR_DLOG_INT),   value((uint32_t) v) {}
+    TISR_DLogArg(long long v)                       : tag(TISR_DLOG_INT),   value((uint32_t) v) {}
+
+    TISR_DLogArg(unsigned char v)                   : tag(TISR_DLOG_UINT),  value(v) {}
+    TISR_DLogArg(unsigned short v)                  : tag(TISR_DLOG_UINT),  value(v) {}
+    TISR_DLogArg(unsigned int v)                    : tag(TISR_DLOG_UINT),  value((uint32_t) v) {}
+    TISR_DLogArg(unsigned long v)                   : tag(TISR_DLOG_UINT),  value((uint32_t) v) {}
+    TISR_DLogArg(unsigned long long v)              : tag(TISR_DLOG_UINT),  value((uint32_t) v) {}
+
+    TISR_DLogArg(double v) : tag(TISR_DLOG_FLOAT), value(0)
+    {
+      float f = (float) v;
+      memcpy(&value, &f, sizeof(f));
+    }
+
+    uint8_t             tag;
+    tisr_dlog_value_t   value;
+};
+
+///////////////////////////////////////////
+
+typedef struct
+{
+  volatile uint8_t  committed;            // Set by the producer once the record is complete
+  uint8_t           level;                // 1 (ERROR) - 4 (DEBUG), | TISR_DLOG_RAW
+  uint8_t           nargs;
+  uint8_t           tags  [TISR_DLOG_MAX_ARGS];
+  tisr_dlog_value_t values[TISR_DLOG_MAX_ARGS];
+} tisr_dlog_record_t;
+
+///////////////////////////////////////////
+
+class TISR_DeferredLogger
+{
+  public:
+
+    TISR_DeferredLogger() : _head(0), _tail(0), _dropped(0)
+    {
+      TISR_ATOMIC_MUX_INIT(_lock);
+    }
+
+    ///////////////////////////////////////////
+
+    // Called by the TISR_LOGxxx macros. Safe from any ISR, never blocks
+    void TISR_ATOMIC_IRAM_ATTR log(const uint8_t& level,
+                                   const TISR_DLogArg& a0,                  const TISR_DLogArg& a1 = TISR_DLogArg(),
+                                   const TISR_DLogArg& a2 = TISR_DLogArg(), const TISR_DLogArg& a3 = TISR_DLogArg(),
+                                   const TISR_DLogArg& a4 = TISR_DLogArg(), const TISR_DLogArg& a5 = TISR_DLogArg())
+    {
+      uint8_t index = 0;
+
+      {
+        TISR_ATOMIC_ENTER(_lock);
+
+        bool full = ( (uint8_t) (_head - _tail) >= TISR_DLOG_BUFFER_SIZE );
+
+        if (full)
+          _dropped++;
+        else
+          index = _head++;
+
+        TISR_ATOMIC_EXIT(_lock);
+
+        if (full)
+          return;
+      }
+
+      // The record is owned by this producer now, fill it with interrupts enabled
+      tisr_dlog_record_t* record = &_records[index & (TISR_DLOG_BUFFER_SIZE - 1)];
+
+      const TISR_DLogArg* args[TISR_DLOG_MAX_ARGS] = { &a0, &a1, &a2, &a3, &a4, &a5 };
+
+      uint8_t nargs = 0;
+
+      while ( (nargs < TISR_DLOG_MAX_ARGS) && (args[nargs]->tag != TISR_DLOG_NONE) )
+      {
+        record->tags  [nargs] = args[nargs]->tag;
+        record->values[nargs] = args[nargs]->value;
+        nargs++;
+      }
+
+      record->level = level;
+      record->nargs = nargs;
+
+      // The fields before the flag, for flush() on the other core
+      TISR_MEMORY_BARRIER();
+
+      record->committed = 1;
+    }
+
+    ///////////////////////////////////////////
+
+    // Call from loop() only. Prints up to maxRecords pending records, returns the number printed.
+    // Stops at the first record still being written by an interrupted producer, it will be printed next time
+    uint16_t flush(Print& out, const uint16_t& maxRecords = 0xFFFF)
+    {
+      uint16_t numFlushed = 0;
+
+      flushDropped(out);
+
+      while ( (numFlushed < maxRecords) && (_tail != _head) )
+      {
+        tisr_dlog_record_t* record = &_records[_tail & (TISR_DLOG_BUFFER_SIZE - 1)];
+
+        if (!record->committed)
+          break;
+
+        // The flag before the fields
+        TISR_MEMORY_BARRIER();
+
+#if TISR_LOG_DEFERRED_BINARY
+        writeBinary(out, record->level, record->nargs, record->tags, record->values);
+#else
+        printText(out, record);
+#endif
+
+        // Done with the record before giving it back
+        TISR_MEMORY_BARRIER();
+
+        record->committed = 0;
+
+        // Single byte write, atomic on all supported cores. Frees the slot for the producers
+        _tail = _tail + 1;
+
+        numFlushed++;
+      }
+
+      return numFlushed;
+    }
+
+    uint8_t getNumPending() const
+    {
+      return (uint8_t) (_head - _tail);
+    }
+
+  private:
+
+    void flushDropped(Print& out)
+    {
+      tisr_dlog_value_t dropped;
+
+      {
+        TISR_ATOMIC_ENTER(_lock);
+
+        dropped   = _dropped;
+        _dropped  = 0;
+
+        TISR_ATOMIC_EXIT(_lock);
+      }
+
+      if (dropped == 0)
+        return;
+
+#if TISR_LOG_DEFERRED_BINARY
+      uint8_t tag = TISR_DLOG_UINT;
+
+      writeBinary(out, TISR_DLOG_DROPPED, 1, &tag, &dropped);
+#else
+      out.print(F("[TISR] Deferred log dropped "));
+      out.print((unsigned long) dropped);
+      out.println(F(" records"));
+#endif
+    }
+
+    ///////////////////////////////////////////
+
+    static void printArg(Print& out, const uint8_t& tag, const tisr_dlog_value_t& value)
+    {
+      switch (tag)
+      {
+        case TISR_DLOG_STR:
+          out.print((const char*) (uintptr_t) value);
+          break;
+
+        case TISR_DLOG_FSTR:
+          out.print((const __FlashStringHelper*) (uintptr_t) value);
+          break;
+
+        case TISR_DLOG_INT:
+          out.print((long) (int32_t) (uint32_t) value);
+          break;
+
+        case TISR_DLOG_FLOAT:
+        {
+          float f;
+
+          memcpy(&f, &value, sizeof(f));
+          out.print(f);
+          break;
+        }
+
+        case TISR_DLOG_CHAR:
+          out.print((char) value);
+          break;
+
+        case TISR_DLOG_PTR:
+          out.print(F("0x"));
+          out.print((unsigned long) value, HEX);
+          break;
+
+        default:
+          out.print((unsigned long) (uint32_t) value);
+          break;
+      }
+    }
+
+    // Same output as the direct TISR_LOGxxx macros
+    static void printText(Print& out, const tisr_dlog_record_t* record)
+    {
+      bool raw = (record->level & TISR_DLOG_RAW);
+
+      if (!raw)
+        out.print(TISR_MARK);
+
+      for (uint8_t i = 0; i < record->nargs; i++)
+      {
+        if (i > 0)
+          out.print(TISR_SP);
+
+        printArg(out, record->tags[i], record->values[i]);
+      }
+
+      if (!raw)
+        out.println();
+    }
+
+    static void writeBinary(Print& out, const uint8_t& level, const uint8_t& nargs, const uint8_t* tags, const tisr_dlog_value_t* values)
+    {
+      out.write((uint8_t) TISR_DLOG_SYNC0);
+      out.write((uint8_t) TISR_DLOG_SYNC1);
+      out.write(level);
+      out.write(nargs);
+
+      for (uint8_t i = 0; i < nargs; i++)
+      {
+        uint32_t value = (uint32_t) values[i];
+
+        out.write(tags[i]);
+
+        for (uint8_t j = 0; j < 4; j++)
+        {
+          out.write((uint8_t) value);
+          value >>= 8;
+        }
+      }
+    }
+
+    ///////////////////////////////////////////
+
+    tisr_dlog_record_t  _records[TISR_DLOG_BUFFER_SIZE];
+
+    // Free-running, the ring index is the lower bits
+    volatile uint8_t    _head;
+    volatile uint8_t    _tail;
+    volatile uint32_t   _dropped;
+
+    TISR_ATOMIC_MUX(_lock);
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_DLOG_INSTANTIATED
+  // To force pre-instatiate only once
+  #define TISR_DLOG_INSTANTIATED
+  TISR_DeferredLogger TISR_DeferredLog;
+#endif
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_DEFERREDLOG_H
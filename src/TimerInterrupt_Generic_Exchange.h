@@ -0,0 +1,325 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Exchange.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Lock-free primitives to pass data from the timer ISRs / callbacks to loop(), without masking interrupts and without
+  torn multi-byte values. Include it explicitly, after "TimerInterrupt_Generic.h" / "ISR_Timer_Generic.h".
+
+  1) TISR_SeqLock<T>         : latest value, copied in place by the writer. The reader retries the copy if a write
+                               happened meanwhile. Smallest RAM (one T), best for small T written often
+  2) TISR_TripleBuffer<T>    : latest value, written into a free buffer then published. Neither side ever waits nor
+                               retries a copy, the reader can use the value in place. 3 * T of RAM, best for big T
+  3) TISR_SpscRing<T, SIZE>  : FIFO of events, nothing lost as long as the reader keeps up. Full : push() fails and
+                               the drop is counted. push() / pop() also move blocks of items, with one index update
+
+  Each primitive has exactly one writer and one reader, typically a timer ISR and loop(). The reader must not have
+  a higher priority than the writer : read() of TISR_SeqLock would spin forever, use tryRead() from an ISR instead.
+  Both can run on different cores (ESP32, RP2040). Only plain loads, stores and TISR_MEMORY_BARRIER() are used, no
+  read-modify-write atomics, so they also work on AVR and Cortex-M0 (no LDREX / STREX).
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_EXCHANGE_H
+#define TIMERINTERRUPT_GENERIC_EXCHANGE_H
+
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+  // Largest type loaded / stored in one instruction
+  typedef uint8_t   tisr_exchange_index_t;
+
+  #define TISR_EXCHANGE_MAX_RING_SIZE   256
+#else
+  typedef uint32_t  tisr_exchange_index_t;
+
+  #define TISR_EXCHANGE_MAX_RING_SIZE   65536
+#endif
+
+///////////////////////////////////////////
+
+template <typename T>
+class TISR_SeqLock
+{
+  public:
+
+    TISR_SeqLock() : _sequence(0), _value()
+    {
+    }
+
+    // Writer side
+    void TISR_ATOMIC_IRAM_ATTR write(const T& value)
+    {
+      // Odd while the value is being written
+      _sequence = _sequence + 1;
+      TISR_MEMORY_BARRIER();
+
+      _value = value;
+
+      TISR_MEMORY_BARRIER();
+      _sequence = _sequence + 1;
+    }
+
+    // Reader side. Retries until it got a copy no write overlapped
+    void read(T& value) const
+    {
+      while (!tryRead(value));
+    }
+
+    // Single attempt, false if a write overlapped and value is torn
+    bool TISR_ATOMIC_IRAM_ATTR tryRead(T& value) const
+    {
+      tisr_exchange_index_t sequence = _sequence;
+
+      TISR_MEMORY_BARRIER();
+
+      if (sequence & 0x01)
+        return false;
+
+      value = _value;
+
+      TISR_MEMORY_BARRIER();
+
+      return (sequence == _sequence);
+    }
+
+    // Changes by 2 on every write()
+    tisr_exchange_index_t getVersion() const
+    {
+      return _sequence;
+    }
+
+  private:
+
+    volatile tisr_exchange_index_t  _sequence;
+    T                               _value;
+};
+
+///////////////////////////////////////////
+
+template <typename T>
+class TISR_TripleBuffer
+{
+  public:
+
+    TISR_TripleBuffer() : _latest(0), _reading(0), _writing(1), _front(0)
+    {
+    }
+
+    // Writer side : fill getWriteBuffer(), then publish() it
+    T& getWriteBuffer()
+    {
+      return _buffers[_writing];
+    }
+
+    void TISR_ATOMIC_IRAM_ATTR publish()
+    {
+      // The buffer content before the index
+      TISR_MEMORY_BARRIER();
+
+      uint8_t latest = _writing;
+
+      _latest = latest;
+
+      // The new index before looking at which buffer the reader holds
+      TISR_MEMORY_BARRIER();
+
+      uint8_t reading = _reading;
+
+      // Next buffer is neither the latest nor the one being read
+      _writing = (latest != reading) ? (3 - latest - reading) : ( (latest + 1) % 3 );
+    }
+
+    void TISR_ATOMIC_IRAM_ATTR write(const T& value)
+    {
+      _buffers[_writing] = value;
+      publish();
+    }
+
+    ///////////////////////////////////////////
+
+    // Reader side : takes the latest published buffer. Returns true if it is newer than the previous one
+    bool update()
+    {
+      uint8_t latest;
+
+      // Claim the latest buffer, and make sure it was still the latest once the claim is visible to the writer
+      do
+      {
+        latest    = _latest;
+        _reading  = latest;
+
+        TISR_MEMORY_BARRIER();
+      } while (latest != _latest);
+
+      bool isNew = (latest != _front);
+
+      _front = latest;
+
+      return isNew;
+    }
+
+    // Buffer taken by the last update(), stable until the next one
+    const T& get() const
+    {
+      return _buffers[_front];
+    }
+
+    bool read(T& value)
+    {
+      bool isNew = update();
+
+      value = _buffers[_front];
+
+      return isNew;
+    }
+
+  private:
+
+    T                 _buffers[3];
+
+    volatile uint8_t  _latest;      // Written by the writer only
+    volatile uint8_t  _reading;     // Written by the reader only
+    uint8_t           _writing;     // Writer private
+    uint8_t           _front;       // Reader private
+};
+
+///////////////////////////////////////////
+
+template <typename T, uint32_t SIZE>
+class TISR_SpscRing
+{
+  static_assert( (SIZE >= 2) && ( (SIZE & (SIZE - 1)) == 0 ) && (SIZE <= TISR_EXCHANGE_MAX_RING_SIZE),
+                 "TISR_SpscRing SIZE must be a power of 2, up to 256 on AVR" );
+
+  public:
+
+    TISR_SpscRing() : _head(0), _tail(0), _numDropped(0)
+    {
+    }
+
+    // Writer side. One slot is kept empty, so SIZE - 1 items fit
+    bool TISR_ATOMIC_IRAM_ATTR push(const T& item)
+    {
+      tisr_exchange_index_t head = _head;
+      tisr_exchange_index_t next = (head + 1) & (SIZE - 1);
+
+      if (next == _tail)
+      {
+        _numDropped = _numDropped + 1;
+        return false;
+      }
+
+      _items[head] = item;
+
+      // The item before the index
+      TISR_MEMORY_BARRIER();
+
+      _head = next;
+
+      return true;
+    }
+
+    // Block of count items, published at once. Returns the number pushed, the others are counted as dropped
+    uint32_t TISR_ATOMIC_IRAM_ATTR push(const T* items, const uint32_t& count)
+    {
+      tisr_exchange_index_t head    = _head;
+      uint32_t              numFree = (_tail - head - 1) & (SIZE - 1);
+      uint32_t              numPush = (count < numFree) ? count : numFree;
+
+      for (uint32_t i = 0; i < numPush; i++)
+        _items[(head + i) & (SIZE - 1)] = items[i];
+
+      if (numPush < count)
+        _numDropped = _numDropped + (count - numPush);
+
+      // The items before the index
+      TISR_MEMORY_BARRIER();
+
+      _head = (head + numPush) & (SIZE - 1);
+
+      return numPush;
+    }
+
+    ///////////////////////////////////////////
+
+    // Reader side
+    bool TISR_ATOMIC_IRAM_ATTR pop(T& item)
+    {
+      tisr_exchange_index_t tail = _tail;
+
+      if (tail == _head)
+        return false;
+
+      // The index before the item
+      TISR_MEMORY_BARRIER();
+
+      item = _items[tail];
+
+      // Done with the slot before handing it back
+      TISR_MEMORY_BARRIER();
+
+      _tail = (tail + 1) & (SIZE - 1);
+
+      return true;
+    }
+
+    // Up to maxCount items at once. Returns the number popped
+    uint32_t pop(T* items, const uint32_t& maxCount)
+    {
+      tisr_exchange_index_t tail      = _tail;
+      uint32_t              numQueued = (_head - tail) & (SIZE - 1);
+      uint32_t              numPop    = (maxCount < numQueued) ? maxCount : numQueued;
+
+      // The index before the items
+      TISR_MEMORY_BARRIER();
+
+      for (uint32_t i = 0; i < numPop; i++)
+        items[i] = _items[(tail + i) & (SIZE - 1)];
+
+      // Done with the slots before handing them back
+      TISR_MEMORY_BARRIER();
+
+      _tail = (tail + numPop) & (SIZE - 1);
+
+      return numPop;
+    }
+
+    uint32_t getNumQueued() const
+    {
+      return (_head - _tail) & (SIZE - 1);
+    }
+
+    bool isEmpty() const
+    {
+      return (_head == _tail);
+    }
+
+    // Written by the writer only. Read twice until stable, a multi-byte counter can't be loaded atomically on AVR
+    uint32_t getNumDropped() const
+    {
+      uint32_t numDropped;
+
+      do
+      {
+        numDropped = _numDropped;
+      } while (numDropped != _numDropped);
+
+      return numDropped;
+    }
+
+  private:
+
+    T                               _items[SIZE];
+
+    volatile tisr_exchange_index_t  _head;          // Written by the writer only
+    volatile tisr_exchange_index_t  _tail;          // Written by the reader only
+    volatile uint32_t               _numDropped;
+};
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_EXCHANGE_H
@@ -0,0 +1,899 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_IR.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  IR remote receiver and sender, driven by the edges of the signal instead of a 50us polling timer. Include it
+  explicitly, after "TimerInterrupt_Generic.h".
+
+  1) TISR_IrReceiver : the edges of the IR receiver module's output are timestamped by a timer input capture, and the
+     mark / space durations queued in a TISR_SpscRing (see TimerInterrupt_Generic_Exchange.h). 2 interrupts per IR
+     pulse, plus at most 2 Timer1 overflows (AVR) after the last edge, then none while there is no signal
+     - AVR : Timer1 input capture, on ICP1 : D8 on 328(P), D4 on 32u4
+     - STM32 : HardwareTimer input capture, on any pin of a timer channel
+     - other boards and pins : pin change interrupt with micros()
+  2) decode(), from loop() or any task : runs the durations through the state machine of each protocol of a table
+     (tisr_ir_protocols : NEC, Sony SIRC, RC5). A protocol is only data : header, bit timings, number of bits,
+     pulse distance / width or Manchester encoding, so others are added to the table without code
+  3) TISR_IrSender : the same tables, encoded into marks and spaces. On AVR, Timer2 makes the carrier on OC2B (D3 on
+     328(P), D9 on Mega), switched on and off by the Timer1 compare B interrupt, once per mark or space
+
+  The AVR receiver and sender run Timer1 free at F_CPU / 8, so ITimer1 (USE_TIMER_1) and ITimer2 (USE_TIMER_2, sender
+  only) can't be used then, nor TimerInterrupt_Generic_SoftSerial.h / _Stepper.h.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_IR_H
+#define TIMERINTERRUPT_GENERIC_IR_H
+
+#include "TimerInterrupt_Generic_Exchange.h"
+
+#if defined(__AVR__) && USE_TIMER_1
+  #error TimerInterrupt_Generic_IR.h uses Timer1, USE_TIMER_1 must not be defined
+#endif
+
+// Marks / spaces queued between the capture ISR and decode(), a NEC frame is 68 of them
+#ifndef TISR_IR_QUEUE_SIZE
+  #define TISR_IR_QUEUE_SIZE          128
+#endif
+
+// IR receiver modules lengthen the marks and shorten the spaces by about this much
+#ifndef TISR_IR_MARK_EXCESS_US
+  #define TISR_IR_MARK_EXCESS_US      50
+#endif
+
+// A space this long ends a frame
+#ifndef TISR_IR_GAP_US
+  #define TISR_IR_GAP_US              6000
+#endif
+
+// Size of the state machine table in TISR_IrReceiver
+#ifndef TISR_IR_MAX_PROTOCOLS
+  #define TISR_IR_MAX_PROTOCOLS       4
+#endif
+
+// Durations are queued in 15 bits, bit 15 set for a mark
+#define TISR_IR_MARK                  0x8000
+#define TISR_IR_MAX_US                0x7FFF
+
+#define TISR_IR_PULSE                 0       // pulse distance (NEC) or pulse width (Sony)
+#define TISR_IR_MANCHESTER            1       // bi-phase (RC5)
+
+typedef struct
+{
+  const char*   name;
+  uint8_t       encoding;           // TISR_IR_PULSE or TISR_IR_MANCHESTER
+  uint8_t       numBits;
+  bool          msbFirst;
+  uint8_t       carrierKHz;
+  uint16_t      headerMark;         // us, 0 : none
+  uint16_t      headerSpace;
+  uint16_t      repeatSpace;        // header space of a repeat frame, 0 : none
+  uint16_t      zeroMark;           // Manchester : half bit
+  uint16_t      zeroSpace;
+  uint16_t      oneMark;
+  uint16_t      oneSpace;
+  uint16_t      stopMark;           // 0 : none, the last bit then ends on its mark
+  uint8_t       tolerance;          // %
+} tisr_ir_protocol_t;
+
+typedef struct
+{
+  const tisr_ir_protocol_t* protocol;
+  uint32_t                  data;           // in the order received, bit 0 first for LSB first protocols
+  uint8_t                   numBits;
+  bool                      repeat;         // repeat frame (NEC), data is the one of the last full frame
+} tisr_ir_result_t;
+
+// RC5 data : the 14 bits with the 2 start bits, toggle, address and command, e.g. 0x3000 | (toggle << 11) | ...
+static const tisr_ir_protocol_t tisr_ir_protocols[] =
+{
+  //  name    encoding            bits  msb    kHz  hMark hSpace rSpace 0Mark 0Space 1Mark 1Space stop  tol
+  { "NEC",    TISR_IR_PULSE,      32,   false, 38,  9000, 4500,  2250,  560,  560,   560,  1690,  560,  25 },
+  { "Sony",   TISR_IR_PULSE,      12,   false, 40,  2400, 600,   0,     600,  600,   1200, 600,   0,    25 },
+  { "RC5",    TISR_IR_MANCHESTER, 14,   true,  36,  0,    0,     0,     889,  889,   889,  889,   0,    25 },
+};
+
+#define TISR_IR_NUM_PROTOCOLS         ( sizeof(tisr_ir_protocols) / sizeof(tisr_ir_protocols[0]) )
+
+///////////////////////////////////////////
+
+// Table-driven decoder of one protocol, fed one mark or space at a time
+class TISR_IrStateMachine
+{
+  public:
+
+    void begin(const tisr_ir_protocol_t* protocol)
+    {
+      _protocol = protocol;
+      _lastData = 0;
+      reset();
+    }
+
+    // true when a frame is complete, in result
+    bool feed(const uint16_t& pulse, tisr_ir_result_t& result)
+    {
+      bool      isMark    = pulse & TISR_IR_MARK;
+      uint16_t  duration  = pulse & TISR_IR_MAX_US;
+
+      // Receiver bias
+      if (isMark)
+        duration = (duration > TISR_IR_MARK_EXCESS_US) ? (duration - TISR_IR_MARK_EXCESS_US) : 0;
+      else if (duration < TISR_IR_MAX_US - TISR_IR_MARK_EXCESS_US)
+        duration += TISR_IR_MARK_EXCESS_US;
+
+      bool done = (_protocol->encoding == TISR_IR_MANCHESTER) ? feedManchester(isMark, duration)
+                  : feedPulse(isMark, duration);
+
+      if (!done)
+        return false;
+
+      result.protocol = _protocol;
+      result.data     = _repeat ? _lastData : _data;
+      result.numBits  = _protocol->numBits;
+      result.repeat   = _repeat;
+
+      if (!_repeat)
+        _lastData = _data;
+
+      reset();
+
+      return true;
+    }
+
+    void reset()
+    {
+      _state    = STATE_IDLE;
+      _numBits  = 0;
+      _data     = 0;
+      _repeat   = false;
+      _halfMark = false;
+      _halfFull = false;
+    }
+
+  private:
+
+    enum
+    {
+      STATE_IDLE,
+      STATE_HEADER_SPACE,
+      STATE_MARK,
+      STATE_SPACE,
+      STATE_STOP
+    };
+
+    bool match(const uint16_t& duration, const uint16_t& expected) const
+    {
+      uint16_t tolerance = (uint32_t) expected * _protocol->tolerance / 100;
+
+      return (duration + tolerance >= expected) && (duration <= expected + tolerance);
+    }
+
+    void addBit(const bool& one)
+    {
+      if (_protocol->msbFirst)
+        _data = (_data << 1) | (one ? 1 : 0);
+      else if (one)
+        _data |= (1UL << _numBits);
+
+      _numBits++;
+    }
+
+    // Restarts on a mismatch, the pulse may be the header of a new frame
+    bool restart(const bool& isMark, const uint16_t& duration)
+    {
+      reset();
+
+      if (isMark && (_protocol->headerMark != 0) && match(duration, _protocol->headerMark))
+        _state = STATE_HEADER_SPACE;
+
+      return false;
+    }
+
+    bool feedPulse(const bool& isMark, const uint16_t& duration)
+    {
+      const tisr_ir_protocol_t* p = _protocol;
+
+      switch (_state)
+      {
+        case STATE_IDLE:
+          return restart(isMark, duration);
+
+        case STATE_HEADER_SPACE:
+          if (isMark)
+            return restart(isMark, duration);
+
+          if (match(duration, p->headerSpace))
+          {
+            _state = STATE_MARK;
+          }
+          else if ( (p->repeatSpace != 0) && match(duration, p->repeatSpace) )
+          {
+            _repeat = true;
+            _state  = STATE_STOP;
+          }
+          else
+            reset();
+
+          return false;
+
+        case STATE_MARK:
+          if (!isMark)
+          {
+            reset();
+            return false;
+          }
+
+          _mark = duration;
+
+          // Pulse width without stop mark : the last bit ends on its mark, its space is the gap
+          if ( (p->stopMark == 0) && (_numBits == p->numBits - 1) )
+          {
+            if (match(duration, p->oneMark) && (p->oneMark != p->zeroMark))
+              addBit(true);
+            else if (match(duration, p->zeroMark))
+              addBit(false);
+            else
+              return restart(isMark, duration);
+
+            return true;
+          }
+
+          _state = STATE_SPACE;
+
+          return false;
+
+        case STATE_SPACE:
+          if (isMark)
+            return restart(isMark, duration);
+
+          if (match(_mark, p->oneMark) && match(duration, p->oneSpace))
+            addBit(true);
+          else if (match(_mark, p->zeroMark) && match(duration, p->zeroSpace))
+            addBit(false);
+          else
+          {
+            reset();
+            return false;
+          }
+
+          _state = (_numBits == p->numBits) ? STATE_STOP : STATE_MARK;
+
+          return false;
+
+        case STATE_STOP:
+          if (isMark && match(duration, p->stopMark))
+            return true;
+
+          return restart(isMark, duration);
+      }
+
+      return false;
+    }
+
+    // One or two half bits per mark / space. Bit 1 : space then mark, bit 0 : mark then space
+    bool feedManchester(const bool& isMark, const uint16_t& duration)
+    {
+      const tisr_ir_protocol_t* p = _protocol;
+
+      uint8_t halfBits;
+
+      if (match(duration, p->zeroMark))
+        halfBits = 1;
+      else if (match(duration, 2 * p->zeroMark))
+        halfBits = 2;
+      else
+      {
+        // A gap after the first half of a last 0 bit (mark) completes the frame
+        bool done = !isMark && (duration > 2 * p->zeroMark) && (_state == STATE_MARK) && (_numBits == p->numBits - 1)
+                    && _halfFull && _halfMark;
+
+        if (done)
+          addBit(false);
+        else
+          reset();
+
+        return done;
+      }
+
+      if (_state == STATE_IDLE)
+      {
+        // The first half of the first start bit is a space, merged into the idle line
+        if (!isMark)
+          return false;
+
+        _state    = STATE_MARK;
+        _halfMark = false;
+        _halfFull = true;
+      }
+
+      for (uint8_t i = 0; i < halfBits; i++)
+      {
+        if (_halfFull)
+        {
+          // Second half of a bit : must differ from the first
+          if (isMark == _halfMark)
+          {
+            reset();
+            return false;
+          }
+
+          addBit(isMark);
+          _halfFull = false;
+
+          if (_numBits == p->numBits)
+            return true;
+        }
+        else
+        {
+          _halfMark = isMark;
+          _halfFull = true;
+        }
+      }
+
+      return false;
+    }
+
+    const tisr_ir_protocol_t* _protocol;
+    uint8_t                   _state;
+    uint8_t                   _numBits;
+    uint32_t                  _data;
+    uint32_t                  _lastData;
+    uint16_t                  _mark;
+    bool                      _repeat;
+    bool                      _halfMark;      // Manchester : level of the pending first half bit
+    bool                      _halfFull;
+};
+
+///////////////////////////////////////////
+
+#if defined(__AVR__) && defined(TCCR1A)
+  #if defined(__AVR_ATmega32U4__)
+    #define TISR_IR_ICP_PIN           4
+  #elif !( defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__) )
+    // ICP1 isn't on the Mega headers
+    #define TISR_IR_ICP_PIN           8
+  #endif
+
+  // Timer1 ticks / us
+  #define TISR_IR_TICKS_PER_US        ( F_CPU / 8000000UL )
+
+// Free running at F_CPU / 8, normal mode, shared by TISR_IrReceiver and TISR_IrSender
+inline void tisr_ir_begin_timer1()
+{
+  if ( (TCCR1A != 0) || ( (TCCR1B & 0x1F) != _BV(CS11) ) )
+  {
+    TCCR1A  = 0;
+    TCCR1B  = (TCCR1B & _BV(ICES1)) | _BV(CS11);
+  }
+}
+#endif
+
+class TISR_IrReceiver;
+
+// The receiver, for the capture / pin ISR
+extern TISR_IrReceiver* TISR_IrReceiverActive;
+
+#if defined(TISR_IR_ICP_PIN)
+  // Timer1 overflows since the last capture, 2 and more : gap saturated
+  extern volatile uint8_t TISR_IrOverflows;
+#endif
+
+class TISR_IrReceiver
+{
+  public:
+
+    TISR_IrReceiver() : _pin(0xFF), _lastMicros(0), _idle(true), _lastTicks(0), _numProtocols(0)
+    {
+      TISR_ATOMIC_MUX_INIT(_mux);
+    }
+
+    // pin : IR receiver module output, LOW during marks. protocols : table of numProtocols, tisr_ir_protocols by
+    // default. For the hardware capture : ICP1 on AVR, a pin on a timer channel on STM32
+    void begin(const uint8_t& pin, const tisr_ir_protocol_t* protocols = tisr_ir_protocols,
+               const uint8_t& numProtocols = TISR_IR_NUM_PROTOCOLS)
+    {
+      _pin          = pin;
+      _numProtocols = (numProtocols < TISR_IR_MAX_PROTOCOLS) ? numProtocols : TISR_IR_MAX_PROTOCOLS;
+
+      for (uint8_t i = 0; i < _numProtocols; i++)
+        _machines[i].begin(&protocols[i]);
+
+      pinMode(_pin, INPUT_PULLUP);
+
+      _lastMicros           = micros();
+      _idle                 = true;
+      TISR_IrReceiverActive = this;
+
+#if defined(TISR_IR_ICP_PIN)
+      if (_pin == TISR_IR_ICP_PIN)
+      {
+        uint8_t sreg = SREG;
+        cli();
+
+        tisr_ir_begin_timer1();
+
+        // Falling edge first : the start of a mark
+        TCCR1B &= ~_BV(ICES1);
+        TIFR1   = _BV(ICF1) | _BV(TOV1);
+        TIMSK1 |= _BV(ICIE1);
+
+        // Idle : the overflow interrupt is enabled by the first edge
+        _lastTicks        = TCNT1;
+        TISR_IrOverflows  = 2;
+
+        SREG = sreg;
+
+        return;
+      }
+#elif TIMER_INTERRUPT_USING_STM32
+      TIM_TypeDef* instance = (TIM_TypeDef*) pinmap_peripheral(digitalPinToPinName(_pin), PinMap_TIM);
+
+      if (instance != NULL)
+      {
+        _channel  = STM_PIN_CHANNEL( pinmap_function( digitalPinToPinName(_pin), PinMap_TIM ) );
+        _hwTimer  = new HardwareTimer(instance);
+
+        // 1MHz, free running over 16 bits
+        _hwTimer->setMode(_channel, TIMER_INPUT_CAPTURE_BOTHEDGE, _pin);
+        _hwTimer->setPrescaleFactor(_hwTimer->getTimerClkFreq() / 1000000);
+        _hwTimer->setOverflow(0x10000, TICK_FORMAT);
+        _hwTimer->attachInterrupt(_channel, onCapture);
+        _hwTimer->resume();
+
+        _lastTicks = _hwTimer->getCaptureCompare(_channel);
+
+        return;
+      }
+#endif
+
+      attachInterrupt(digitalPinToInterrupt(_pin), onPinChange, CHANGE);
+    }
+
+    ///////////////////////////////////////////
+
+    // From loop() or a task. Runs the queued marks / spaces through the protocols, true with the first frame decoded
+    bool decode(tisr_ir_result_t& result)
+    {
+      uint16_t pulse;
+
+      while (_pulses.pop(pulse))
+      {
+        if (feed(pulse, result))
+          return true;
+      }
+
+      // No edge for a while after a mark : feed the gap once, it completes the frames which end on a mark
+      uint32_t  lastMicros;
+      bool      idle;
+
+      {
+        TISR_ATOMIC_ENTER(_mux);
+
+        lastMicros  = _lastMicros;
+        idle        = _idle;
+
+        TISR_ATOMIC_EXIT(_mux);
+      }
+
+      if (idle || (micros() - lastMicros <= TISR_IR_GAP_US) || (digitalRead(_pin) != HIGH))
+        return false;
+
+      bool gap;
+
+      {
+        TISR_ATOMIC_ENTER(_mux);
+
+        // Unless an edge just got in
+        gap = (lastMicros == _lastMicros) && _pulses.isEmpty();
+
+        if (gap)
+          _idle = true;
+
+        TISR_ATOMIC_EXIT(_mux);
+      }
+
+      return gap && feed(TISR_IR_MAX_US, result);
+    }
+
+    // Marks / spaces lost because decode() wasn't called in time
+    uint32_t getNumDropped() const
+    {
+      return _pulses.getNumDropped();
+    }
+
+    ///////////////////////////////////////////
+
+    // Edge of the receiver output at now (micros()), duration in us since the previous one. From the ISRs
+    void TISR_ATOMIC_IRAM_ATTR onEdge(const uint32_t& duration, const uint8_t& level, const uint32_t& now)
+    {
+      // The output is LOW during marks : a rising edge ends a mark
+      uint16_t pulse = (duration < TISR_IR_MAX_US) ? duration : TISR_IR_MAX_US;
+
+      if (level)
+        pulse |= TISR_IR_MARK;
+
+      // The idle line before the first mark isn't part of a frame
+      if (!_idle || level)
+        _pulses.push(pulse);
+
+      _idle       = false;
+      _lastMicros = now;
+    }
+
+    static void TISR_ATOMIC_IRAM_ATTR onPinChange()
+    {
+      TISR_IrReceiver*  receiver  = TISR_IrReceiverActive;
+      uint32_t          now       = micros();
+
+      if (receiver)
+        receiver->onEdge(now - receiver->_lastMicros, digitalRead(receiver->_pin), now);
+    }
+
+#if defined(TISR_IR_ICP_PIN)
+    // From TIMER1_CAPT_vect : captured Timer1 ticks, overflows since the previous capture, level after the edge
+    void onCapture(const uint16_t& ticks, const uint8_t& numOverflows, const uint8_t& level)
+    {
+      // 2 overflows or more : longer than a gap anyway
+      uint32_t elapsed = (numOverflows >= 2) ? 0xFFFFFFFFUL : ( ( (uint32_t) numOverflows << 16 ) + ticks - _lastTicks );
+
+      _lastTicks = ticks;
+
+      onEdge(elapsed / TISR_IR_TICKS_PER_US, level, micros());
+    }
+#elif TIMER_INTERRUPT_USING_STM32
+    static void onCapture()
+    {
+      TISR_IrReceiver* receiver = TISR_IrReceiverActive;
+
+      if (receiver == NULL)
+        return;
+
+      uint16_t  ticks   = receiver->_hwTimer->getCaptureCompare(receiver->_channel);
+      uint32_t  now     = micros();
+
+      // The 1MHz counter wraps every 65ms : micros() tells the long spaces
+      uint32_t  elapsed = (now - receiver->_lastMicros > 60000UL) ? 0xFFFFFFFFUL : (uint16_t) (ticks - receiver->_lastTicks);
+
+      receiver->_lastTicks = ticks;
+      receiver->onEdge(elapsed, digitalRead(receiver->_pin), now);
+    }
+#endif
+
+  private:
+
+    bool feed(const uint16_t& pulse, tisr_ir_result_t& result)
+    {
+      bool decoded = false;
+
+      // Every machine sees every pulse, the first complete frame wins
+      for (uint8_t i = 0; i < _numProtocols; i++)
+      {
+        if (!decoded && _machines[i].feed(pulse, result))
+          decoded = true;
+      }
+
+      if (decoded)
+      {
+        for (uint8_t i = 0; i < _numProtocols; i++)
+          _machines[i].reset();
+      }
+
+      return decoded;
+    }
+
+    uint8_t                     _pin;
+    volatile uint32_t           _lastMicros;
+    volatile bool               _idle;
+    uint16_t                    _lastTicks;
+
+#if TIMER_INTERRUPT_USING_STM32
+    HardwareTimer*              _hwTimer;
+    uint32_t                    _channel;
+#endif
+
+    uint8_t                     _numProtocols;
+    TISR_IrStateMachine         _machines[TISR_IR_MAX_PROTOCOLS];
+
+    TISR_SpscRing<uint16_t, TISR_IR_QUEUE_SIZE> _pulses;
+
+    TISR_ATOMIC_MUX(_mux);
+};
+
+///////////////////////////////////////////
+
+#if defined(__AVR__) && defined(TCCR1A) && defined(OCR2B)
+
+#define TISR_IR_SENDER                true
+
+#if USE_TIMER_2
+  #error TISR_IrSender uses Timer2, USE_TIMER_2 must not be defined
+#endif
+
+#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+  #define TISR_IR_SEND_PIN            9
+#else
+  #define TISR_IR_SEND_PIN            3
+#endif
+
+// Marks and spaces of the longest frame : header, 32 bits, stop mark
+#ifndef TISR_IR_SEND_MAX_PULSES
+  #define TISR_IR_SEND_MAX_PULSES     72
+#endif
+
+class TISR_IrSender;
+
+// The sender, for TIMER1_COMPB_vect
+extern TISR_IrSender* TISR_IrSenderActive;
+
+class TISR_IrSender
+{
+  public:
+
+    TISR_IrSender() : _numPulses(0), _index(0), _busy(false)
+    {
+    }
+
+    // Carrier on TISR_IR_SEND_PIN, to the IR LED driver
+    void begin()
+    {
+      digitalWrite(TISR_IR_SEND_PIN, LOW);
+      pinMode(TISR_IR_SEND_PIN, OUTPUT);
+
+      uint8_t sreg = SREG;
+      cli();
+
+      tisr_ir_begin_timer1();
+
+      // Timer2 CTC, no prescaler. OC2B disconnected until a mark
+      TCCR2A  = _BV(WGM21);
+      TCCR2B  = _BV(CS20);
+      OCR2B   = 0;
+
+      TISR_IrSenderActive = this;
+
+      SREG = sreg;
+    }
+
+    // Encodes data with protocol and sends it. repeat : repeat frame, if the protocol has one. false if still busy
+    bool send(const tisr_ir_protocol_t& protocol, const uint32_t& data, const bool& repeat = false)
+    {
+      if (_busy)
+        return false;
+
+      _numPulses = 0;
+
+      if (protocol.encoding == TISR_IR_MANCHESTER)
+        encodeManchester(protocol, data);
+      else
+        encodePulse(protocol, data, repeat && (protocol.repeatSpace != 0));
+
+      return start(protocol.carrierKHz);
+    }
+
+    // Marks (TISR_IR_MARK | us) and spaces (us), starting with a mark. false if still busy
+    bool sendRaw(const uint16_t* pulses, const uint8_t& numPulses, const uint8_t& carrierKHz)
+    {
+      if (_busy)
+        return false;
+
+      _numPulses = 0;
+
+      for (uint8_t i = 0; i < numPulses; i++)
+        add(pulses[i]);
+
+      return start(carrierKHz);
+    }
+
+    bool isBusy() const
+    {
+      return _busy;
+    }
+
+    ///////////////////////////////////////////
+
+    // Compare B of Timer1 : the current mark or space is over
+    void onCompare()
+    {
+      if (_index >= _numPulses)
+      {
+        carrier(false);
+
+        TIMSK1 &= ~_BV(OCIE1B);
+        _busy   = false;
+
+        return;
+      }
+
+      uint16_t pulse = _pulses[_index++];
+
+      carrier(pulse & TISR_IR_MARK);
+
+      OCR1B += (pulse & TISR_IR_MAX_US) * TISR_IR_TICKS_PER_US;
+    }
+
+  private:
+
+    void add(const uint16_t& pulse)
+    {
+      if (_numPulses < TISR_IR_SEND_MAX_PULSES)
+        _pulses[_numPulses++] = pulse;
+    }
+
+    void encodePulse(const tisr_ir_protocol_t& p, const uint32_t& data, const bool& repeat)
+    {
+      if (p.headerMark != 0)
+      {
+        add(TISR_IR_MARK | p.headerMark);
+
+        if (repeat)
+        {
+          add(p.repeatSpace);
+          add(TISR_IR_MARK | p.stopMark);
+
+          return;
+        }
+
+        add(p.headerSpace);
+      }
+
+      for (uint8_t i = 0; i < p.numBits; i++)
+      {
+        bool one = (data >> (p.msbFirst ? (p.numBits - 1 - i) : i)) & 1;
+
+        add(TISR_IR_MARK | (one ? p.oneMark : p.zeroMark));
+
+        // Without stop mark, the space of the last bit is the gap
+        if ( (i < p.numBits - 1) || (p.stopMark != 0) )
+          add(one ? p.oneSpace : p.zeroSpace);
+      }
+
+      if (p.stopMark != 0)
+        add(TISR_IR_MARK | p.stopMark);
+    }
+
+    // Half bits, 1 : space then mark, 0 : mark then space. Same levels merged, leading and trailing spaces dropped
+    void encodeManchester(const tisr_ir_protocol_t& p, const uint32_t& data)
+    {
+      uint8_t   halves  = 0;
+      bool      mark    = false;
+
+      for (uint8_t i = 0; i < 2 * p.numBits; i++)
+      {
+        uint8_t bit       = i / 2;
+        bool    one       = (data >> (p.msbFirst ? (p.numBits - 1 - bit) : bit)) & 1;
+        bool    halfMark  = (i & 1) ? one : !one;
+
+        if ( (halves != 0) && (halfMark != mark) )
+        {
+          if (mark || (_numPulses != 0))
+            add( (mark ? TISR_IR_MARK : 0) | (halves * p.zeroMark) );
+
+          halves = 0;
+        }
+
+        mark = halfMark;
+        halves++;
+      }
+
+      if (mark)
+        add(TISR_IR_MARK | (halves * p.zeroMark));
+    }
+
+    bool start(const uint8_t& carrierKHz)
+    {
+      if ( (_numPulses == 0) || (carrierKHz == 0) )
+        return false;
+
+      uint8_t sreg = SREG;
+      cli();
+
+      // Toggled on each match : F_CPU / (2 * (OCR2A + 1))
+      OCR2A = (uint8_t) ( (F_CPU / 2000UL + carrierKHz / 2) / carrierKHz - 1 );
+
+      _index  = 0;
+      _busy   = true;
+
+      // First mark right away
+      OCR1B   = TCNT1 + 4 * TISR_IR_TICKS_PER_US;
+      TIFR1   = _BV(OCF1B);
+      TIMSK1 |= _BV(OCIE1B);
+
+      SREG = sreg;
+
+      return true;
+    }
+
+    void carrier(const bool& on)
+    {
+      if (on)
+      {
+        TCNT2   = 0;
+        TCCR2A  = _BV(COM2B0) | _BV(WGM21);
+      }
+      else
+      {
+        // Disconnected, the pin is LOW
+        TCCR2A  = _BV(WGM21);
+      }
+    }
+
+    uint16_t          _pulses[TISR_IR_SEND_MAX_PULSES];
+    uint8_t           _numPulses;
+    volatile uint8_t  _index;
+    volatile bool     _busy;
+};
+
+#endif    // TISR_IR_SENDER
+
+///////////////////////////////////////////
+
+#ifndef TISR_IR_INSTANTIATED
+#define TISR_IR_INSTANTIATED          // To force pre-instatiate only once
+
+  TISR_IrReceiver* TISR_IrReceiverActive = NULL;
+
+  #if defined(TISR_IR_ICP_PIN)
+    volatile uint8_t TISR_IrOverflows = 0;
+
+    // Only enabled during a frame : from 2 overflows on the gap is saturated anyway, off until the next edge
+    ISR(TIMER1_OVF_vect)
+    {
+      if (++TISR_IrOverflows >= 2)
+        TIMSK1 &= ~_BV(TOIE1);
+    }
+
+    ISR(TIMER1_CAPT_vect)
+    {
+      uint16_t  captured      = ICR1;
+      uint8_t   numOverflows  = TISR_IrOverflows;
+      uint8_t   level         = (TCCR1B & _BV(ICES1)) ? HIGH : LOW;
+
+      if (numOverflows >= 2)
+      {
+        // First edge after a gap, the overflow interrupt was off : TOV1 is stale, unless the timer wrapped since the
+        // capture
+        uint8_t wrapped = (TCNT1 < captured) ? 1 : 0;
+
+        TIFR1             = _BV(TOV1);
+        TISR_IrOverflows  = wrapped;
+        TIMSK1           |= _BV(TOIE1);
+      }
+      else if ( (TIFR1 & _BV(TOV1)) && (captured < 0x8000) )
+      {
+        // Overflowed before the capture, but its ISR didn't run yet : counted here, not again there
+        numOverflows++;
+
+        TIFR1             = _BV(TOV1);
+        TISR_IrOverflows  = 0;
+      }
+      else
+        TISR_IrOverflows = 0;
+
+      // Other edge next, the flag cleared after changing the edge
+      TCCR1B ^= _BV(ICES1);
+      TIFR1   = _BV(ICF1);
+
+      if (TISR_IrReceiverActive)
+        TISR_IrReceiverActive->onCapture(captured, numOverflows, level);
+    }
+  #endif
+
+  #if defined(TISR_IR_SENDER)
+    TISR_IrSender* TISR_IrSenderActive = NULL;
+
+    ISR(TIMER1_COMPB_vect)
+    {
+      if (TISR_IrSenderActive)
+        TISR_IrSenderActive->onCompare();
+    }
+  #endif
+
+#endif    // TISR_IR_INSTANTIATED
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_IR_H
@@ -0,0 +1,327 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Interpolator.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Coordinated multi-axis stepping from one timer, with a DDA (Bresenham) interpolator. Include it explicitly, after
+  "TimerInterrupt_Generic.h".
+
+  The planner in loop() splits the motion into short linear segments : the steps of each axis and the number of
+  timer ticks the segment lasts. Acceleration is done by the planner, with segments of changing length, e.g. ~5ms each.
+  The segments are queued in a TISR_SpscRing (see TimerInterrupt_Generic_Exchange.h), and the timer ISR runs them :
+  on every tick, each axis adds its step count to its accumulator and steps once it reaches the segment ticks. All
+  the axes share the one time base and end each segment together, whatever their number of steps.
+
+  The step pins of all the axes are on one port, as packed by the sketch's write function : bit n of the step bits
+  drives the step pin of the axis attached to bit n. Each tick makes one masked port write, at the very start of the
+  ISR, with the bits computed by the previous tick, so the pulses have no computing jitter. A pulse lasts one tick,
+  hence at most one step every 2 ticks per axis. Integers only : ~10 cycles per axis and per tick, 100kHz and more
+  on Teensy 3.x / 4.x and STM32.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_INTERPOLATOR_H
+#define TIMERINTERRUPT_GENERIC_INTERPOLATOR_H
+
+#include "TimerInterrupt_Generic_Exchange.h"
+
+// Writes the step or direction bits to the pins, bit set for HIGH. Called from the timer ISR. E.g. for pins on GPIOA of
+// STM32 : GPIOA->BSRR = bits | ( (PINS_MASK & ~bits) << 16 );
+typedef void (*tisr_interpolator_write_t)(const uint32_t& bits);
+
+///////////////////////////////////////////
+
+template <uint8_t NUM_AXES>
+struct TISR_InterpolatorSegment
+{
+  uint32_t  ticks;                  // duration, in timer ticks
+  uint32_t  steps[NUM_AXES];        // per axis, at most ticks / 2
+  uint32_t  dirBits;                // direction pins, for writeDirs
+  uint32_t  negativeAxes;           // bit n set if axis n moves backward
+  bool      continued;              // more segments of the same motion follow
+};
+
+///////////////////////////////////////////
+
+template <uint8_t NUM_AXES = 3, uint32_t QUEUE_SIZE = 16>
+class TISR_Interpolator
+{
+  public:
+
+    TISR_Interpolator() : _writeSteps(NULL), _writeDirs(NULL), _tickHz(0), _ticksLeft(0), _pendingBits(0),
+      _dirBits(0), _loaded(false), _continued(false), _abort(false), _numStarved(0)
+    {
+      for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+      {
+        _stepBit[axis]      = 0;
+        _dirBit[axis]       = 0;
+        _invertDir[axis]    = false;
+        _position[axis]     = 0;
+        _accumulator[axis]  = 0;
+      }
+    }
+
+    // Bits of the step and direction pins of axis, in the words given to writeSteps / writeDirs
+    void attach(const uint8_t& axis, const uint32_t& stepBit, const uint32_t& dirBit, const bool& invertDir = false)
+    {
+      if (axis < NUM_AXES)
+      {
+        _stepBit[axis]    = stepBit;
+        _dirBit[axis]     = dirBit;
+        _invertDir[axis]  = invertDir;
+      }
+    }
+
+    // After attach(), before the timer starts calling update() every 1 / tickHz s
+    void begin(tisr_interpolator_write_t writeSteps, tisr_interpolator_write_t writeDirs, const uint32_t& tickHz)
+    {
+      _tickHz     = tickHz;
+      _writeDirs  = writeDirs;
+      _writeSteps = writeSteps;
+
+      _writeSteps(0);
+      _writeDirs(_dirBits);
+    }
+
+    ///////////////////////////////////////////
+
+    // Planner side, from loop(). Queues a segment of steps (signed) per axis over ticks. false if the queue is full, or
+    // if an axis would step faster than once every 2 ticks. continued : more segments of this motion follow, so the
+    // queue running empty after this one counts in getNumStarved(). Also false while an abort() is pending
+    bool addSegment(const int32_t (&steps)[NUM_AXES], const uint32_t& ticks, const bool& continued = false)
+    {
+      segment_t segment;
+
+      // The ISR would drop it with the others
+      if ( (ticks == 0) || _abort )
+        return false;
+
+      segment.ticks         = ticks;
+      segment.dirBits       = 0;
+      segment.negativeAxes  = 0;
+      segment.continued     = continued;
+
+      for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+      {
+        uint32_t numSteps = (steps[axis] >= 0) ? steps[axis] : -steps[axis];
+
+        if (numSteps > ticks / 2)
+          return false;
+
+        segment.steps[axis] = numSteps;
+
+        if (steps[axis] < 0)
+          segment.negativeAxes |= (1UL << axis);
+
+        if ( (steps[axis] < 0) != _invertDir[axis] )
+          segment.dirBits |= _dirBit[axis];
+      }
+
+      return _segments.push(segment);
+    }
+
+    // Same, with the duration in us
+    bool addSegmentMicros(const int32_t (&steps)[NUM_AXES], const uint32_t& durationMicros, const bool& continued = false)
+    {
+      return addSegment(steps, (uint32_t) ( (uint64_t) durationMicros * _tickHz / 1000000 ), continued);
+    }
+
+    // Segments which can still be queued
+    uint32_t getNumFree() const
+    {
+      return QUEUE_SIZE - 1 - _segments.getNumQueued();
+    }
+
+    // Stops at the next tick, dropping the queued segments. Then wait for isIdle() before adding new ones
+    void abort()
+    {
+      _abort = true;
+    }
+
+    ///////////////////////////////////////////
+
+    // Call from the timer ISR, every tick
+    void TISR_ATOMIC_IRAM_ATTR update()
+    {
+      if (_writeSteps == NULL)
+        return;
+
+      // Pulses computed by the previous tick first, with a constant latency. Step pins not in the bits go back LOW
+      uint32_t writtenBits = _pendingBits;
+
+      _writeSteps(writtenBits);
+      _pendingBits = 0;
+
+      if (_abort)
+      {
+        segment_t segment;
+
+        while (_segments.pop(segment));
+
+        _ticksLeft  = 0;
+        _loaded     = false;
+        _continued  = false;
+        _abort      = false;
+
+        return;
+      }
+
+      if (_ticksLeft == 0)
+      {
+        if (!_loaded)
+        {
+          if (!_segments.pop(_segment))
+          {
+            if (_continued)
+            {
+              // Ran out of segments in the middle of a motion : the planner in loop() is late
+              _continued  = false;
+              _numStarved = _numStarved + 1;
+            }
+
+            return;
+          }
+
+          _loaded = true;
+        }
+
+        // Direction hold time after a pulse edge : wait one tick before reversing
+        if ( (_segment.dirBits != _dirBits) && (writtenBits != 0) )
+          return;
+
+        startSegment();
+      }
+
+      uint32_t stepBits = 0;
+      uint32_t ticks    = _segment.ticks;
+
+      for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+      {
+        uint32_t accumulator = _accumulator[axis] + _segment.steps[axis];
+
+        if (accumulator >= ticks)
+        {
+          accumulator -= ticks;
+          stepBits    |= _stepBit[axis];
+          _position[axis] += _direction[axis];
+        }
+
+        _accumulator[axis] = accumulator;
+      }
+
+      _pendingBits = stepBits;
+
+      if (--_ticksLeft == 0)
+      {
+        _loaded     = false;
+        _continued  = _segment.continued;
+      }
+    }
+
+    ///////////////////////////////////////////
+
+    // Steps issued on axis. Read twice until stable, a 32-bit load isn't atomic on AVR
+    int32_t getPosition(const uint8_t& axis) const
+    {
+      if (axis >= NUM_AXES)
+        return 0;
+
+      int32_t position;
+
+      do
+      {
+        position = _position[axis];
+      } while (position != _position[axis]);
+
+      return position;
+    }
+
+    // Only while isIdle()
+    void setPosition(const uint8_t& axis, const int32_t& position)
+    {
+      if (axis < NUM_AXES)
+        _position[axis] = position;
+    }
+
+    // No segment running nor queued, and no abort() pending
+    bool isIdle() const
+    {
+      return !_abort && !_loaded && _segments.isEmpty();
+    }
+
+    uint32_t getNumQueued() const
+    {
+      return _segments.getNumQueued();
+    }
+
+    // Times the queue ran empty in the middle of a motion, i.e. the planner didn't keep up
+    uint32_t getNumStarved() const
+    {
+      uint32_t numStarved;
+
+      do
+      {
+        numStarved = _numStarved;
+      } while (numStarved != _numStarved);
+
+      return numStarved;
+    }
+
+    uint32_t getTickHz() const
+    {
+      return _tickHz;
+    }
+
+  private:
+
+    typedef TISR_InterpolatorSegment<NUM_AXES> segment_t;
+
+    void TISR_ATOMIC_IRAM_ATTR startSegment()
+    {
+      if (_segment.dirBits != _dirBits)
+      {
+        _dirBits = _segment.dirBits;
+        _writeDirs(_dirBits);
+      }
+
+      for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+      {
+        // Half a step ahead : the steps are centered in the segment, and exactly steps[axis] of them are issued
+        _accumulator[axis]  = _segment.ticks / 2;
+        _direction[axis]    = (_segment.negativeAxes & (1UL << axis)) ? -1 : 1;
+      }
+
+      _ticksLeft  = _segment.ticks;
+    }
+
+    tisr_interpolator_write_t volatile  _writeSteps;
+    tisr_interpolator_write_t           _writeDirs;
+    uint32_t                            _tickHz;
+
+    uint32_t                            _stepBit[NUM_AXES];
+    uint32_t                            _dirBit[NUM_AXES];
+    bool                                _invertDir[NUM_AXES];
+
+    // ISR state
+    segment_t                           _segment;
+    volatile uint32_t                   _ticksLeft;
+    uint32_t                            _accumulator[NUM_AXES];
+    int8_t                              _direction[NUM_AXES];
+    volatile int32_t                    _position[NUM_AXES];
+    uint32_t                            _pendingBits;
+    uint32_t                            _dirBits;
+    volatile bool                       _loaded;          // _segment popped, running or waiting to start
+    bool                                _continued;       // the last segment ended had more queued after it
+
+    volatile bool                       _abort;
+    volatile uint32_t                   _numStarved;
+
+    TISR_SpscRing<segment_t, QUEUE_SIZE> _segments;
+};
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_INTERPOLATOR_H
@@ -0,0 +1,318 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Latency.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Compact log-bucketed (HDR-style) histogram and ISR latency / period jitter recorder, shared by the
+  TimerLatencyBenchmark examples of every platform.
+
+  Values are bucketed by their power of two, each power of two split into 2^TISR_HIST_SUB_BUCKET_BITS linear
+  sub-buckets, so the relative error of any reported percentile is bounded by 1 / 2^TISR_HIST_SUB_BUCKET_BITS
+  while recording stays O(1) and needs no floating point.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_LATENCY_H
+#define TIMERINTERRUPT_GENERIC_LATENCY_H
+
+#include <string.h>
+
+#include "TimerInterrupt_Generic_Cycles.h"
+
+///////////////////////////////////////////
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+  // Keep RAM usage small on 8-bit AVR : 2 sub-bucket bits, up to 2^16 counts => 60 buckets * 2 bytes
+  #ifndef TISR_HIST_SUB_BUCKET_BITS
+    #define TISR_HIST_SUB_BUCKET_BITS       2
+  #endif
+
+  #ifndef TISR_HIST_MAX_VALUE_BITS
+    #define TISR_HIST_MAX_VALUE_BITS        16
+  #endif
+
+  typedef uint16_t  tisr_hist_count_t;
+  typedef uint32_t  tisr_hist_sum_t;
+#else
+  // 3 sub-bucket bits => 12.5% resolution, up to 2^26 counts (~280ms at 240MHz) => 192 buckets * 4 bytes
+  #ifndef TISR_HIST_SUB_BUCKET_BITS
+    #define TISR_HIST_SUB_BUCKET_BITS       3
+  #endif
+
+  #ifndef TISR_HIST_MAX_VALUE_BITS
+    #define TISR_HIST_MAX_VALUE_BITS        26
+  #endif
+
+  typedef uint32_t  tisr_hist_count_t;
+  typedef uint64_t  tisr_hist_sum_t;
+#endif
+
+#define TISR_HIST_SUB_BUCKETS           ( 1 << TISR_HIST_SUB_BUCKET_BITS )
+#define TISR_HIST_NUM_BUCKETS           ( ( TISR_HIST_MAX_VALUE_BITS - TISR_HIST_SUB_BUCKET_BITS + 1 ) << TISR_HIST_SUB_BUCKET_BITS )
+
+///////////////////////////////////////////
+
+class TISR_Histogram
+{
+  public:
+
+    TISR_Histogram()
+    {
+      reset();
+    }
+
+    void reset()
+    {
+      memset((void*) _buckets, 0, sizeof(_buckets));
+
+      _count    = 0;
+      _overflow = 0;
+      _sum      = 0;
+      _min      = 0xFFFFFFFFUL;
+      _max      = 0;
+    }
+
+    ///////////////////////////////////////////
+
+    // O(1), safe to call from ISR. Values >= 2^TISR_HIST_MAX_VALUE_BITS are counted in the last bucket
+    void record(const uint32_t& value)
+    {
+      uint16_t index = bucketIndex(value);
+
+      if (index >= TISR_HIST_NUM_BUCKETS)
+      {
+        index = TISR_HIST_NUM_BUCKETS - 1;
+        _overflow++;
+      }
+
+      // Saturate instead of wrapping the (16-bit on AVR) bucket counts
+      if (_buckets[index] != (tisr_hist_count_t) ~0)
+        _buckets[index]++;
+
+      _count++;
+      _sum += value;
+
+      if (value < _min)
+        _min = value;
+
+      if (value > _max)
+        _max = value;
+    }
+
+    ///////////////////////////////////////////
+
+    // Value at the given percentile (0.0 - 100.0), reported as the upper bound of the bucket holding it
+    uint32_t percentile(const float& percent) const
+    {
+      if (_count == 0)
+        return 0;
+
+      if (percent >= 100.0f)
+        return _max;
+
+      uint32_t target   = (uint32_t) ( (percent / 100.0f) * _count + 0.5f );
+      uint32_t runTotal = 0;
+
+      if (target == 0)
+        target = 1;
+
+      for (uint16_t i = 0; i < TISR_HIST_NUM_BUCKETS; i++)
+      {
+        runTotal += _buckets[i];
+
+        if (runTotal >= target)
+        {
+          uint32_t upper = bucketUpperBound(i);
+
+          return (upper < _max) ? upper : _max;
+        }
+      }
+
+      return _max;
+    }
+
+    ///////////////////////////////////////////
+
+    uint32_t getCount() const
+    {
+      return _count;
+    }
+
+    uint32_t getOverflow() const
+    {
+      return _overflow;
+    }
+
+    uint32_t getMin() const
+    {
+      return (_count == 0) ? 0 : _min;
+    }
+
+    uint32_t getMax() const
+    {
+      return _max;
+    }
+
+    uint32_t getMean() const
+    {
+      return (_count == 0) ? 0 : (uint32_t) (_sum / _count);
+    }
+
+    ///////////////////////////////////////////
+
+    static uint16_t bucketIndex(const uint32_t& value)
+    {
+      if (value < TISR_HIST_SUB_BUCKETS)
+        return (uint16_t) value;
+
+      // Position of the highest set bit, >= TISR_HIST_SUB_BUCKET_BITS here
+      uint8_t msb = (sizeof(unsigned long) * 8 - 1) - __builtin_clzl((unsigned long) value);
+      uint8_t shift = msb - TISR_HIST_SUB_BUCKET_BITS;
+
+      return (uint16_t) ( ( (uint16_t) (shift + 1) << TISR_HIST_SUB_BUCKET_BITS ) |
+                          ( (value >> shift) & (TISR_HIST_SUB_BUCKETS - 1) ) );
+    }
+
+    static uint32_t bucketUpperBound(const uint16_t& index)
+    {
+      if (index < TISR_HIST_SUB_BUCKETS)
+        return index;
+
+      uint8_t  shift  = (index >> TISR_HIST_SUB_BUCKET_BITS) - 1;
+      uint32_t lower  = ( (uint32_t) ( TISR_HIST_SUB_BUCKETS | (index & (TISR_HIST_SUB_BUCKETS - 1)) ) ) << shift;
+
+      return lower + ( (1UL << shift) - 1 );
+    }
+
+    ///////////////////////////////////////////
+
+    // One JSON object per line, values converted from counts at 'hz' to nanoseconds, e.g.
+    // {"name":"T1","mode":"serial","unit":"ns","n":5000,"min":250,"p50":312,"p99":437,"p99.9":500,"max":562,"overflow":0}
+    void printJSON(Print& out, const char* name, const char* mode, const uint32_t& hz) const
+    {
+      out.print(F("{\"name\":\""));     out.print(name);
+      out.print(F("\",\"mode\":\""));   out.print(mode);
+      out.print(F("\",\"unit\":\"ns\",\"n\":")); out.print(getCount());
+      out.print(F(",\"min\":"));        out.print(toNs(getMin(), hz));
+      out.print(F(",\"mean\":"));       out.print(toNs(getMean(), hz));
+      out.print(F(",\"p50\":"));        out.print(toNs(percentile(50.0f), hz));
+      out.print(F(",\"p99\":"));        out.print(toNs(percentile(99.0f), hz));
+      out.print(F(",\"p99.9\":"));      out.print(toNs(percentile(99.9f), hz));
+      out.print(F(",\"max\":"));        out.print(toNs(getMax(), hz));
+      out.print(F(",\"overflow\":"));   out.print(getOverflow());
+      out.println(F("}"));
+    }
+
+    static uint32_t toNs(const uint32_t& counts, const uint32_t& hz)
+    {
+      return (uint32_t) ( ( (uint64_t) counts * 1000000000ULL ) / hz );
+    }
+
+  private:
+
+    volatile tisr_hist_count_t  _buckets[TISR_HIST_NUM_BUCKETS];
+    volatile uint32_t           _count;
+    volatile uint32_t           _overflow;
+    volatile tisr_hist_sum_t    _sum;
+    volatile uint32_t           _min;
+    volatile uint32_t           _max;
+};
+
+///////////////////////////////////////////
+
+// Records, from a periodic timer ISR :
+// 1) Period jitter : | actual period between two ISR entries - expected period |, from TISR_CYCLES()
+// 2) Entry latency : counts from the hardware event to ISR entry, when the backend can read it (e.g. TCNT1 in CTC mode)
+//
+// Two sets of histograms are used. The ISR records into the active set, loop() calls swap() and then reads the
+// inactive set at leisure, so there is no need to disable interrupts around the (long) percentile computation and printing.
+class TISR_LatencyRecorder
+{
+  public:
+
+    TISR_LatencyRecorder() : _active(0), _expected(0), _lastEntry(0), _started(false)
+    {
+    }
+
+    // expectedPeriod and all recorded values are in TISR_CYCLES() counts
+    void begin(const uint32_t& expectedPeriod)
+    {
+      tisr_cycles_init();
+
+      _expected = expectedPeriod;
+      _started  = false;
+
+      for (uint8_t i = 0; i < 2; i++)
+      {
+        _jitter[i].reset();
+        _latency[i].reset();
+      }
+    }
+
+    ///////////////////////////////////////////
+
+    // Call first thing in the timer ISR
+    void onISREntry()
+    {
+      tisr_cycles_t now = TISR_CYCLES();
+
+      if (_started)
+      {
+        tisr_cycles_t period = TISR_CYCLES_ELAPSED(_lastEntry, now);
+
+        _jitter[_active].record( (period > _expected) ? (period - _expected) : (_expected - period) );
+      }
+
+      _lastEntry  = now;
+      _started    = true;
+    }
+
+    // Optional, when the ISR can measure the delay since the hardware event itself
+    void recordLatency(const uint32_t& latency)
+    {
+      _latency[_active].record(latency);
+    }
+
+    ///////////////////////////////////////////
+
+    // Call from loop(). Returns the index of the histograms that just became inactive and can be read
+    uint8_t swap()
+    {
+      uint8_t previous = _active;
+
+      _latency[previous ^ 1].reset();
+      _jitter [previous ^ 1].reset();
+
+      // Single byte write, atomic on all supported cores
+      _active = previous ^ 1;
+
+      return previous;
+    }
+
+    const TISR_Histogram& jitter(const uint8_t& index) const
+    {
+      return _jitter[index & 1];
+    }
+
+    const TISR_Histogram& latency(const uint8_t& index) const
+    {
+      return _latency[index & 1];
+    }
+
+  private:
+
+    TISR_Histogram          _jitter[2];
+    TISR_Histogram          _latency[2];
+
+    volatile uint8_t        _active;
+    uint32_t                _expected;
+    volatile tisr_cycles_t  _lastEntry;
+    volatile bool           _started;
+};
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_LATENCY_H
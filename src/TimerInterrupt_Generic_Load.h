@@ -0,0 +1,350 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Load.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Optional CPU utilization meter, with the share taken by the hardware timer ISRs and by the ISR_Timer callbacks.
+
+  Define TISR_LOAD_ENABLE true before #include "TimerInterrupt_Generic.h" / "ISR_Timer_Generic.h" to compile it in.
+  Otherwise all TISR_LOAD_xxx macros are empty and there is no RAM or cycle cost.
+
+  Idle time is measured with one of :
+  1) Idle counting  : call TISR_LoadMeter.idle() whenever loop() has nothing to do. The cost of one idle() iteration is
+                      calibrated at boot with calibrate(), while nothing but the timer ISRs runs
+  2) Sleeping       : call TISR_LoadMeter.sleep() instead (AVR idle sleep mode, WFI on ARM). The time asleep is measured
+                      with TISR_CYCLES(), minus the instrumented ISRs that ran before sleep() returned. No calibration
+
+  Windows are delimited by calling TISR_LoadMeter.onWindow() from a hardware timer or ISR_Timer callback, e.g. every
+  second. A window must be shorter than one TISR_CYCLES() wrap (17s at 240MHz, 4ms with TISR_CYCLES_AVR_USE_TIMER1).
+
+  ISR time is measured inside the AVR / megaAVR timer ISRs and around every ISR_Timer callback. For the other
+  backends, surround the body of the hardware timer callbacks with TISR_LOAD_BEGIN(start) / TISR_LOAD_END(TISR_LOAD_HW_TIMER, start).
+  The interrupt entry / exit overhead and the non-timer ISRs (Serial, SysTick, ...) show up as main code load.
+
+  getWindow() returns the last completed window, loads in 1/100 % (0 - 10000).
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_LOAD_H
+#define TIMERINTERRUPT_GENERIC_LOAD_H
+
+#ifndef TISR_LOAD_ENABLE
+  #define TISR_LOAD_ENABLE      false
+#endif
+
+#define TISR_LOAD_HW_TIMER        0
+#define TISR_LOAD_CALLBACK        1
+
+///////////////////////////////////////////
+
+#if TISR_LOAD_ENABLE
+
+#include <string.h>
+
+#include "TimerInterrupt_Generic_Cycles.h"
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+  #include <avr/sleep.h>
+
+  #define TISR_LOAD_CAN_SLEEP       true
+#elif defined(__arm__)
+  #define TISR_LOAD_CAN_SLEEP       true
+#else
+  #define TISR_LOAD_CAN_SLEEP       false
+#endif
+
+///////////////////////////////////////////
+
+typedef struct
+{
+  uint32_t  windowNumber;         // Incremented by every onWindow()
+  uint32_t  windowCycles;         // Window length, in TISR_CYCLES() counts
+  uint32_t  idleCount;            // idle() calls
+  uint32_t  idleCycles;           // Estimated (idle counting) or measured (sleeping) idle time
+  uint32_t  hwTimerCycles;        // In the instrumented hardware timer ISRs, ISR_Timer callbacks they run included
+  uint32_t  callbackCycles;       // In the ISR_Timer callbacks
+  uint16_t  cpuLoad;              // Everything but idle, 1/100 %
+  uint16_t  hwTimerLoad;
+  uint16_t  callbackLoad;
+} tisr_load_window_t;
+
+///////////////////////////////////////////
+
+class TISR_CpuLoadMeter
+{
+  public:
+
+    TISR_CpuLoadMeter() : _idleCostQ8(0)
+    {
+      TISR_ATOMIC_MUX_INIT(_lock);
+
+      memset((void*) &_totals, 0, sizeof(_totals));
+      memset((void*) &_latched, 0, sizeof(_latched));
+      memset((void*) &_window, 0, sizeof(_window));
+
+      _windowNumber = 0;
+      _readNumber   = 0;
+    }
+
+    // Starts the first window
+    void begin()
+    {
+      tisr_cycles_init();
+
+      TISR_ATOMIC_ENTER(_lock);
+
+      _windowStart  = TISR_CYCLES();
+      latchTotals(_latched);
+
+      TISR_ATOMIC_EXIT(_lock);
+    }
+
+    ///////////////////////////////////////////
+
+    // Busy-loops on idle() for durationMs to measure the cost of one iteration. Call from setup(), with the timers running
+    // but before any other load starts
+    void calibrate(const uint16_t& durationMs)
+    {
+      tisr_load_totals_t  before;
+      tisr_load_totals_t  after;
+      uint32_t            numLoops  = 0;
+
+      tisr_cycles_init();
+
+      {
+        TISR_ATOMIC_ENTER(_lock);
+        latchTotals(before);
+        TISR_ATOMIC_EXIT(_lock);
+      }
+
+      uint32_t startMs = millis();
+
+      // millis() is checked every 64 iterations only, so the loop costs about the same as the application's idle loop
+      do
+      {
+        idle();
+      } while ( ( (++numLoops & 63) != 0 ) || (millis() - startMs < durationMs) );
+
+      uint32_t elapsedMs = millis() - startMs;
+
+      {
+        TISR_ATOMIC_ENTER(_lock);
+        latchTotals(after);
+        TISR_ATOMIC_EXIT(_lock);
+      }
+
+      uint64_t  elapsed   = ( (uint64_t) elapsedMs * TISR_CYCLES_HZ ) / 1000;
+      uint32_t  isr       = isrCycles(after.hwTimerCycles - before.hwTimerCycles, after.callbackCycles - before.callbackCycles);
+      uint32_t  count     = after.idleCount - before.idleCount;
+
+      if ( (count > 0) && (elapsed > isr) )
+        _idleCostQ8 = (uint32_t) ( ( (elapsed - isr) << 8 ) / count );
+    }
+
+    // Cost of one idle() iteration, in 1/256 TISR_CYCLES() counts. Can be stored and restored instead of calibrating
+    uint32_t getIdleCost() const
+    {
+      return _idleCostQ8;
+    }
+
+    void setIdleCost(const uint32_t& idleCostQ8)
+    {
+      _idleCostQ8 = idleCostQ8;
+    }
+
+    ///////////////////////////////////////////
+
+    // Idle counting, from loop() whenever there's nothing to do
+    void idle()
+    {
+      TISR_ATOMIC_ENTER(_lock);
+
+      _totals.idleCount++;
+
+      TISR_ATOMIC_EXIT(_lock);
+    }
+
+#if TISR_LOAD_CAN_SLEEP
+    // Sleeps until the next interrupt, from loop() whenever there's nothing to do
+    void sleep()
+    {
+      tisr_cycles_t start;
+      uint32_t      isrStart;
+
+      {
+        TISR_ATOMIC_ENTER(_lock);
+
+        start     = TISR_CYCLES();
+        isrStart  = isrCycles(_totals.hwTimerCycles, _totals.callbackCycles);
+
+        TISR_ATOMIC_EXIT(_lock);
+      }
+
+  #if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+      set_sleep_mode(SLEEP_MODE_IDLE);
+      sleep_enable();
+      sleep_cpu();
+      sleep_disable();
+  #else
+      __asm__ volatile ("wfi");
+  #endif
+
+      TISR_ATOMIC_ENTER(_lock);
+
+      uint32_t asleep = TISR_CYCLES_ELAPSED(start, TISR_CYCLES());
+      uint32_t isr    = isrCycles(_totals.hwTimerCycles, _totals.callbackCycles) - isrStart;
+
+      // The ISR that woke us up ran before sleep() got control back
+      _totals.idleCycles += (asleep > isr) ? (asleep - isr) : 0;
+
+      TISR_ATOMIC_EXIT(_lock);
+    }
+#endif
+
+    ///////////////////////////////////////////
+
+    // From the instrumented ISRs, through TISR_LOAD_END()
+    void TISR_ATOMIC_IRAM_ATTR recordISR(const uint8_t& kind, const tisr_cycles_t& start)
+    {
+      uint32_t duration = TISR_CYCLES_ELAPSED(start, TISR_CYCLES());
+
+      TISR_ATOMIC_ENTER(_lock);
+
+      if (kind == TISR_LOAD_HW_TIMER)
+        _totals.hwTimerCycles += duration;
+      else
+        _totals.callbackCycles += duration;
+
+      TISR_ATOMIC_EXIT(_lock);
+    }
+
+    // Ends the current window and starts the next one. Call from a timer callback
+    void TISR_ATOMIC_IRAM_ATTR onWindow()
+    {
+      TISR_ATOMIC_ENTER(_lock);
+
+      tisr_cycles_t       now = TISR_CYCLES();
+      tisr_load_totals_t  totals;
+
+      latchTotals(totals);
+
+      _window.windowCycles    = TISR_CYCLES_ELAPSED(_windowStart, now);
+      _window.idleCount       = totals.idleCount      - _latched.idleCount;
+      _window.idleCycles      = totals.idleCycles     - _latched.idleCycles;
+      _window.hwTimerCycles   = totals.hwTimerCycles  - _latched.hwTimerCycles;
+      _window.callbackCycles  = totals.callbackCycles - _latched.callbackCycles;
+
+      _latched      = totals;
+      _windowStart  = now;
+      _windowNumber++;
+
+      TISR_ATOMIC_EXIT(_lock);
+    }
+
+    ///////////////////////////////////////////
+
+    // Last completed window. Returns false if there's none, or if it was already returned
+    bool getWindow(tisr_load_window_t& window)
+    {
+      {
+        TISR_ATOMIC_ENTER(_lock);
+
+        window.windowNumber   = _windowNumber;
+        window.windowCycles   = _window.windowCycles;
+        window.idleCount      = _window.idleCount;
+        window.idleCycles     = _window.idleCycles;
+        window.hwTimerCycles  = _window.hwTimerCycles;
+        window.callbackCycles = _window.callbackCycles;
+
+        TISR_ATOMIC_EXIT(_lock);
+      }
+
+      if ( (window.windowNumber == 0) || (window.windowNumber == _readNumber) )
+        return false;
+
+      _readNumber = window.windowNumber;
+
+      // Idle counting and sleeping can be mixed, the estimates add up
+      uint64_t idle = window.idleCycles + ( ( (uint64_t) window.idleCount * _idleCostQ8 ) >> 8 );
+
+      window.idleCycles   = (idle > window.windowCycles) ? window.windowCycles : (uint32_t) idle;
+
+      window.cpuLoad      = toLoad(window.windowCycles - window.idleCycles, window.windowCycles);
+      window.hwTimerLoad  = toLoad(window.hwTimerCycles, window.windowCycles);
+      window.callbackLoad = toLoad(window.callbackCycles, window.windowCycles);
+
+      return true;
+    }
+
+  private:
+
+    typedef struct
+    {
+      uint32_t  idleCount;
+      uint32_t  idleCycles;
+      uint32_t  hwTimerCycles;
+      uint32_t  callbackCycles;
+    } tisr_load_totals_t;
+
+    // Caller holds _lock
+    void TISR_ATOMIC_IRAM_ATTR latchTotals(tisr_load_totals_t& totals)
+    {
+      totals.idleCount      = _totals.idleCount;
+      totals.idleCycles     = _totals.idleCycles;
+      totals.hwTimerCycles  = _totals.hwTimerCycles;
+      totals.callbackCycles = _totals.callbackCycles;
+    }
+
+    // The ISR_Timer callbacks normally run inside a hardware timer ISR. They're only counted on their own if the
+    // hardware timer ISRs aren't instrumented
+    static uint32_t TISR_ATOMIC_IRAM_ATTR isrCycles(const uint32_t& hwTimerCycles, const uint32_t& callbackCycles)
+    {
+      return (hwTimerCycles > callbackCycles) ? hwTimerCycles : callbackCycles;
+    }
+
+    static uint16_t toLoad(const uint32_t& cycles, const uint32_t& windowCycles)
+    {
+      if ( (windowCycles == 0) || (cycles >= windowCycles) )
+        return (windowCycles == 0) ? 0 : 10000;
+
+      return (uint16_t) ( ( (uint64_t) cycles * 10000 ) / windowCycles );
+    }
+
+    volatile tisr_load_totals_t   _totals;
+    tisr_load_totals_t            _latched;
+    volatile tisr_load_window_t   _window;
+    volatile tisr_cycles_t        _windowStart;
+    volatile uint32_t             _windowNumber;
+    uint32_t                      _readNumber;
+    uint32_t                      _idleCostQ8;
+
+    TISR_ATOMIC_MUX(_lock);
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_LOAD_INSTANTIATED
+  // To force pre-instatiate only once
+  #define TISR_LOAD_INSTANTIATED
+  TISR_CpuLoadMeter TISR_LoadMeter;
+#endif
+
+///////////////////////////////////////////
+
+#define TISR_LOAD_BEGIN(start)          tisr_cycles_t start = TISR_CYCLES()
+#define TISR_LOAD_END(kind, start)      TISR_LoadMeter.recordISR((kind), (start))
+
+#else   // TISR_LOAD_ENABLE
+
+#define TISR_LOAD_BEGIN(start)
+#define TISR_LOAD_END(kind, start)
+
+#endif  // TISR_LOAD_ENABLE
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_LOAD_H
@@ -0,0 +1,358 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Logger.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Data logger for timer-sampled records, to SD, LittleFS, SPI flash or any Print. Include it explicitly, after
+  "TimerInterrupt_Generic.h".
+
+  A write() to flash blocks for tens of ms while a sector is erased, hundreds of samples at kHz rates. The logger
+  splits the path in two :
+  1) write(), from the timer ISR / callback : copies the record into a RAM buffer of NUM_BLOCKS blocks and returns. No
+     lock, no wait : if the record doesn't fit, it is dropped and counted in getNumDropped()
+  2) run(), from loop() or a task : writes the filled blocks, whole and in order, to a TISR_LogDevice. It may block as
+     long as the free blocks last
+
+  Records are packed back to back, across the blocks, so the log is the plain sequence of the records written.
+  Erase-aware sizing : BLOCK_SIZE must be a multiple of the device's erase size (e.g. 512 for SD, 4096 for SPI flash),
+  so each block write covers whole sectors. NUM_BLOCKS - 1 blocks must hold the records of the longest write :
+  getMaxWriteMicros() and getMaxBlocksQueued() measure it while logging.
+
+  One writer : records from ISRs of different priorities must be written inside TISR_ATOMIC_ENTER() / _EXIT().
+  Built without ARDUINO, e.g. for native tests on Linux, TISR_LogFileDevice writes to a stdio FILE.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_LOGGER_H
+#define TIMERINTERRUPT_GENERIC_LOGGER_H
+
+#include <string.h>
+
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#if defined(ARDUINO)
+  #define TISR_LOGGER_MICROS()          micros()
+#else
+  #include <stdint.h>
+  #include <stdio.h>
+  #include <time.h>
+
+  inline uint32_t tisr_logger_micros()
+  {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint32_t) ( (uint64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000 );
+  }
+
+  #define TISR_LOGGER_MICROS()          tisr_logger_micros()
+#endif
+
+///////////////////////////////////////////
+
+// Where the blocks go. writeBlock() is only called from run() / end(), it may block
+class TISR_LogDevice
+{
+  public:
+
+    virtual ~TISR_LogDevice()
+    {
+    }
+
+    // size bytes, a whole block except the last one from end(). true on success
+    virtual bool writeBlock(const uint8_t* data, const uint32_t& size) = 0;
+
+    // Bytes erased at once, 0 : no constraint
+    virtual uint32_t getEraseSize() const
+    {
+      return 0;
+    }
+
+    // Commits what was written, e.g. file size and FAT for SD
+    virtual void sync()
+    {
+    }
+};
+
+///////////////////////////////////////////
+
+#if defined(ARDUINO)
+
+// Any Print : SD / SdFat / LittleFS / SPIFFS File, Serial, ...
+class TISR_LogPrintDevice : public TISR_LogDevice
+{
+  public:
+
+    TISR_LogPrintDevice(Print& output, const uint32_t& eraseSize = 0) : _output(output), _eraseSize(eraseSize)
+    {
+    }
+
+    bool writeBlock(const uint8_t* data, const uint32_t& size)
+    {
+      return (_output.write(data, size) == size);
+    }
+
+    uint32_t getEraseSize() const
+    {
+      return _eraseSize;
+    }
+
+    void sync()
+    {
+      _output.flush();
+    }
+
+  private:
+
+    Print&    _output;
+    uint32_t  _eraseSize;
+};
+
+#else
+
+// stdio FILE, opened "wb" by the caller
+class TISR_LogFileDevice : public TISR_LogDevice
+{
+  public:
+
+    TISR_LogFileDevice(FILE* file, const uint32_t& eraseSize = 0) : _file(file), _eraseSize(eraseSize)
+    {
+    }
+
+    bool writeBlock(const uint8_t* data, const uint32_t& size)
+    {
+      return (fwrite(data, 1, size, _file) == size);
+    }
+
+    uint32_t getEraseSize() const
+    {
+      return _eraseSize;
+    }
+
+    void sync()
+    {
+      fflush(_file);
+    }
+
+  private:
+
+    FILE*     _file;
+    uint32_t  _eraseSize;
+};
+
+#endif
+
+///////////////////////////////////////////
+
+template <uint16_t BLOCK_SIZE = 512, uint8_t NUM_BLOCKS = 4>
+class TISR_BlockLogger
+{
+  static_assert( (NUM_BLOCKS >= 2) && (NUM_BLOCKS <= 128) && ( (NUM_BLOCKS & (NUM_BLOCKS - 1)) == 0 ),
+                 "TISR_BlockLogger NUM_BLOCKS must be a power of 2, from 2 to 128" );
+
+  public:
+
+    TISR_BlockLogger() : _device(NULL), _offset(0), _head(0), _tail(0), _numDropped(0), _numRecords(0),
+      _numWriteErrors(0), _maxWriteMicros(0), _maxBlocksQueued(0)
+    {
+    }
+
+    // false if BLOCK_SIZE isn't a multiple of the device's erase size
+    bool begin(TISR_LogDevice* device)
+    {
+      uint32_t eraseSize = device->getEraseSize();
+
+      if ( (eraseSize > 1) && ( (BLOCK_SIZE % eraseSize) != 0 ) )
+        return false;
+
+      _device = device;
+
+      _offset = 0;
+      _head   = 0;
+      _tail   = 0;
+
+      return true;
+    }
+
+    ///////////////////////////////////////////
+
+    // Writer side, from the timer ISR / callback. false if the record was dropped
+    bool TISR_ATOMIC_IRAM_ATTR write(const void* record, const uint16_t& size)
+    {
+      if (size == 0)
+        return true;
+
+      uint8_t   head    = _head;
+      uint16_t  offset  = _offset;
+
+      // The current block, plus the next ones the record spills into, must be free
+      uint32_t  numBlocks = 1 + ( (uint32_t) offset + size - 1 ) / BLOCK_SIZE;
+
+      if ( (uint8_t) (head - _tail) + numBlocks > NUM_BLOCKS )
+      {
+        _numDropped = _numDropped + 1;
+
+        return false;
+      }
+
+      const uint8_t*  data      = (const uint8_t*) record;
+      uint16_t        remaining = size;
+
+      while (remaining > 0)
+      {
+        uint16_t length = BLOCK_SIZE - offset;
+
+        if (length > remaining)
+          length = remaining;
+
+        memcpy(&_blocks[head & (NUM_BLOCKS - 1)][offset], data, length);
+
+        data      += length;
+        remaining -= length;
+        offset    += length;
+
+        if (offset == BLOCK_SIZE)
+        {
+          // The block content before handing it over
+          TISR_MEMORY_BARRIER();
+
+          _head   = ++head;
+          offset  = 0;
+        }
+      }
+
+      _offset     = offset;
+      _numRecords = _numRecords + 1;
+
+      return true;
+    }
+
+    template <typename T>
+    bool TISR_ATOMIC_IRAM_ATTR write(const T& record)
+    {
+      return write(&record, sizeof(record));
+    }
+
+    ///////////////////////////////////////////
+
+    // Reader side, from loop() or a task. Writes the filled blocks to the device. Returns the number written
+    uint8_t run()
+    {
+      uint8_t numWritten = 0;
+      uint8_t tail       = _tail;
+      uint8_t queued;
+
+      while ( (queued = (uint8_t) (_head - tail)) != 0 )
+      {
+        if (queued > _maxBlocksQueued)
+          _maxBlocksQueued = queued;
+
+        // The index before the block content
+        TISR_MEMORY_BARRIER();
+
+        uint32_t start = TISR_LOGGER_MICROS();
+
+        if (!_device->writeBlock(_blocks[tail & (NUM_BLOCKS - 1)], BLOCK_SIZE))
+          _numWriteErrors++;
+
+        uint32_t elapsed = TISR_LOGGER_MICROS() - start;
+
+        if (elapsed > _maxWriteMicros)
+          _maxWriteMicros = elapsed;
+
+        // Done with the block before giving it back
+        TISR_MEMORY_BARRIER();
+
+        _tail = ++tail;
+        numWritten++;
+      }
+
+      return numWritten;
+    }
+
+    // Stop the writer first (timer detached). Writes the remaining blocks and the partial last one, then syncs
+    void end()
+    {
+      run();
+
+      if (_offset > 0)
+      {
+        if (!_device->writeBlock(_blocks[_head & (NUM_BLOCKS - 1)], _offset))
+          _numWriteErrors++;
+
+        _offset = 0;
+      }
+
+      _device->sync();
+    }
+
+    ///////////////////////////////////////////
+
+    // Records dropped because the buffer was full. Read twice until stable, a 32-bit load isn't atomic on AVR
+    uint32_t getNumDropped() const
+    {
+      uint32_t numDropped;
+
+      do
+      {
+        numDropped = _numDropped;
+      } while (numDropped != _numDropped);
+
+      return numDropped;
+    }
+
+    uint32_t getNumRecords() const
+    {
+      uint32_t numRecords;
+
+      do
+      {
+        numRecords = _numRecords;
+      } while (numRecords != _numRecords);
+
+      return numRecords;
+    }
+
+    uint32_t getNumWriteErrors() const
+    {
+      return _numWriteErrors;
+    }
+
+    // Longest writeBlock(), e.g. with a flash erase
+    uint32_t getMaxWriteMicros() const
+    {
+      return _maxWriteMicros;
+    }
+
+    // Most blocks found waiting by run(), NUM_BLOCKS - 1 means some records may have been dropped
+    uint8_t getMaxBlocksQueued() const
+    {
+      return _maxBlocksQueued;
+    }
+
+  private:
+
+    TISR_LogDevice*     _device;
+
+    uint8_t             _blocks[NUM_BLOCKS][BLOCK_SIZE];
+
+    uint16_t            _offset;              // Writer private, in the block _head
+    volatile uint8_t    _head;                // Blocks filled, written by the writer only
+    volatile uint8_t    _tail;                // Blocks written to the device, written by the reader only
+
+    volatile uint32_t   _numDropped;
+    volatile uint32_t   _numRecords;
+
+    // Reader private
+    uint32_t            _numWriteErrors;
+    uint32_t            _maxWriteMicros;
+    uint8_t             _maxBlocksQueued;
+};
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_LOGGER_H
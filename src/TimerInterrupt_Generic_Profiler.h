@@ -0,0 +1,431 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Profiler.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Statistical sampling profiler for loop() and everything else running outside the sampling ISR.
+
+  A spare hardware timer interrupts the code at a few kHz, and each sample takes the address of the interrupted
+  instruction :
+
+  1) Cortex-M (SAMD, SAM DUE, STM32, nRF52, Teensy, RP2040) : stacked PC of the exception frame. Call
+     TISR_PROFILER_SAMPLE() from the callback of any hardware timer of this library. The frame is found by scanning the
+     handler stack up from SP for the first EXC_RETURN value, pushed by the innermost handler, i.e. the timer's own
+     (or read from PSP when the interrupted code runs on the process stack, e.g. under FreeRTOS / Mbed). The sample is
+     the code that handler interrupted, loop() or a lower priority ISR
+  2) ESP32, ESP32_S2, ESP32_S3, ESP8266 (Xtensa) : EPC1. Call TISR_PROFILER_SAMPLE() first thing in the timer callback.
+     Window exceptions taken by the interrupt dispatcher also write EPC1, and such samples are attributed to the
+     dispatcher
+  3) ESP32_C3 (RISC-V) : mepc, same usage as Xtensa
+  4) AVR with Timer2 (328P, 2560, 1284, ...) : return address on the stack, from a dedicated naked Timer2 ISR started by
+     begin(). Timer2 can't be used by ITimer2 / tone() meanwhile
+
+  Addresses are bucketed into 2^TISR_PROFILER_SHIFT byte ranges, counted in a small open-addressing hash table.
+  Samples that don't find a bucket within TISR_PROFILER_MAX_PROBES probes are counted as dropped.
+
+  dump() prints (address, count) pairs as text. extras/profile/tisr_profile symbolizes them with the sketch's ELF file :
+
+    # TISR_PROFILE version=1 shift=4 samples=12345 dropped=0
+    0x00000A30 4021
+    ...
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_PROFILER_H
+#define TIMERINTERRUPT_GENERIC_PROFILER_H
+
+#if defined(ARDUINO)
+  #if ARDUINO >= 100
+    #include <Arduino.h>
+  #else
+    #include <WProgram.h>
+  #endif
+#endif
+
+#include <string.h>
+
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#define TISR_PROFILER_VERSION           1
+
+#ifndef TISR_PROFILER_SHIFT
+  // 16-byte address ranges
+  #define TISR_PROFILER_SHIFT           4
+#endif
+
+#ifndef TISR_PROFILER_NUM_BUCKETS
+  #if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+    // 64 * 6 = 384 bytes of RAM
+    #define TISR_PROFILER_NUM_BUCKETS   64
+  #else
+    // 512 * 8 = 4KB of RAM
+    #define TISR_PROFILER_NUM_BUCKETS   512
+  #endif
+#endif
+
+#if ( (TISR_PROFILER_NUM_BUCKETS & (TISR_PROFILER_NUM_BUCKETS - 1)) != 0 )
+  #error TISR_PROFILER_NUM_BUCKETS must be a power of 2
+#endif
+
+#ifndef TISR_PROFILER_MAX_PROBES
+  #define TISR_PROFILER_MAX_PROBES      8
+#endif
+
+#ifndef TISR_PROFILER_STACK_SCAN
+  // Words of handler stack searched for EXC_RETURN on Cortex-M
+  #define TISR_PROFILER_STACK_SCAN      128
+#endif
+
+#ifndef TISR_PROFILER_AVR_HZ
+  #define TISR_PROFILER_AVR_HZ          1000
+#endif
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+  typedef uint16_t  tisr_profiler_count_t;
+  #define TISR_PROFILER_COUNT_MAX       0xFFFFU
+#else
+  typedef uint32_t  tisr_profiler_count_t;
+  #define TISR_PROFILER_COUNT_MAX       0xFFFFFFFFUL
+#endif
+
+///////////////////////////////////////////
+
+typedef struct
+{
+  uint32_t                key;        // (address >> TISR_PROFILER_SHIFT) + 1, 0 = empty
+  tisr_profiler_count_t   count;
+} tisr_profiler_bucket_t;
+
+///////////////////////////////////////////
+
+#if defined(__arm__)
+
+  #define TISR_PROFILER_CAN_SAMPLE      true
+
+  // Address of the instruction interrupted by the innermost active exception, the timer's one, 0 if not found
+  static inline uint32_t tisr_profiler_interrupted_pc()
+  {
+    uint32_t* sp;
+    uint32_t  vtor      = *(volatile uint32_t *) 0xE000ED08UL;
+
+    // Initial MSP, first word of the vector table. VTOR reads 0 on Cortex-M0, where the table is at 0 anyway
+    uint32_t* stackTop  = (uint32_t *) *(volatile uint32_t *) vtor;
+
+    __asm__ volatile ("mov %0, sp" : "=r" (sp));
+
+    // Stacks outside the main one (e.g. RP2040 core1) are only bounded by TISR_PROFILER_STACK_SCAN
+    bool      bounded   = (sp < stackTop);
+
+    for (uint16_t i = 0; (i < TISR_PROFILER_STACK_SCAN) && ( !bounded || (&sp[i + 8] < stackTop) ); i++)
+    {
+      uint32_t value = sp[i];
+
+      // EXC_RETURN : 0xFFFFFFE1 / E9 / ED (FPU frame) or 0xFFFFFFF1 / F9 / FD
+      if ( ( (value & 0xFFFFFFE0UL) != 0xFFFFFFE0UL ) ||
+           ( ( (value & 0x0F) != 0x01 ) && ( (value & 0x0F) != 0x09 ) && ( (value & 0x0F) != 0x0D ) ) )
+        continue;
+
+      uint32_t* frame;
+
+      if (value & 0x04)
+      {
+        __asm__ volatile ("mrs %0, psp" : "=r" (frame));
+      }
+      else
+      {
+        // The innermost handler pushed LR last in its prologue, its exception frame is right above it
+        frame = &sp[i + 1];
+      }
+
+      // Stacked xPSR must have the Thumb bit, otherwise it's a data word that looked like EXC_RETURN
+      if (frame[7] & (1UL << 24))
+        return frame[6];
+    }
+
+    return 0;
+  }
+
+#elif ( defined(ESP32) || ESP32 ) || ( defined(ESP8266) || ESP8266 )
+
+  #define TISR_PROFILER_CAN_SAMPLE      true
+
+  static inline uint32_t TISR_ATOMIC_IRAM_ATTR tisr_profiler_interrupted_pc()
+  {
+    uint32_t pc;
+
+  #if defined(__riscv)
+    __asm__ volatile ("csrr %0, mepc" : "=r" (pc));
+  #else
+    __asm__ volatile ("rsr %0, epc1" : "=r" (pc));
+  #endif
+
+    return pc;
+  }
+
+#else
+
+  // AVR uses its own Timer2 ISR, other platforms can still feed record() with addresses obtained elsewhere
+  #define TISR_PROFILER_CAN_SAMPLE      false
+
+#endif
+
+///////////////////////////////////////////
+
+class TISR_SamplingProfiler
+{
+  public:
+
+    TISR_SamplingProfiler() : _numSamples(0), _numDropped(0), _paused(true)
+    {
+      memset((void*) _buckets, 0, sizeof(_buckets));
+    }
+
+    // Clears the table and starts sampling. On AVR, also starts the Timer2 sampling interrupt
+    void begin()
+    {
+      clear();
+
+#if ( defined(__AVR__) && defined(TIMER2_COMPA_vect) )
+      uint32_t compare = ( F_CPU / 128UL / TISR_PROFILER_AVR_HZ ) - 1;
+
+      uint8_t sreg = SREG;
+
+      cli();
+
+      // CTC mode, prescaler 128, interrupt on compare match A
+      TCCR2A  = _BV(WGM21);
+      TCCR2B  = _BV(CS22) | _BV(CS20);
+      OCR2A   = (compare > 255) ? 255 : (uint8_t) compare;
+      TCNT2   = 0;
+      TIMSK2  = _BV(OCIE2A);
+
+      SREG = sreg;
+#endif
+
+      _paused = false;
+    }
+
+    void end()
+    {
+      _paused = true;
+
+#if ( defined(__AVR__) && defined(TIMER2_COMPA_vect) )
+      TIMSK2  = 0;
+#endif
+    }
+
+    void pause()
+    {
+      _paused = true;
+    }
+
+    void resume()
+    {
+      _paused = false;
+    }
+
+    void clear()
+    {
+      bool wasPaused = _paused;
+
+      _paused = true;
+
+      memset((void*) _buckets, 0, sizeof(_buckets));
+      _numSamples = 0;
+      _numDropped = 0;
+
+      _paused = wasPaused;
+    }
+
+    ///////////////////////////////////////////
+
+#if TISR_PROFILER_CAN_SAMPLE
+    // Call from a hardware timer callback
+    void TISR_ATOMIC_IRAM_ATTR sample()
+    {
+      record(tisr_profiler_interrupted_pc());
+    }
+#endif
+
+    // Only one sampling ISR may call record()
+    void TISR_ATOMIC_IRAM_ATTR record(const uint32_t& address)
+    {
+      if (_paused || (address == 0))
+        return;
+
+      _numSamples++;
+
+      uint32_t key    = (address >> TISR_PROFILER_SHIFT) + 1;
+      uint16_t index  = (uint16_t) ( key ^ (key >> 7) ) & (TISR_PROFILER_NUM_BUCKETS - 1);
+
+      for (uint8_t probe = 0; probe < TISR_PROFILER_MAX_PROBES; probe++)
+      {
+        volatile tisr_profiler_bucket_t* bucket = &_buckets[index];
+
+        if (bucket->key == key)
+        {
+          if (bucket->count < TISR_PROFILER_COUNT_MAX)
+            bucket->count++;
+
+          return;
+        }
+
+        if (bucket->key == 0)
+        {
+          bucket->key   = key;
+          bucket->count = 1;
+
+          return;
+        }
+
+        index = (index + 1) & (TISR_PROFILER_NUM_BUCKETS - 1);
+      }
+
+      _numDropped++;
+    }
+
+    uint32_t getNumSamples() const
+    {
+      return _numSamples;
+    }
+
+    uint32_t getNumDropped() const
+    {
+      return _numDropped;
+    }
+
+    ///////////////////////////////////////////
+
+    // Prints the header and one "0xADDRESS count" line per used bucket. Sampling is paused meanwhile
+    void dump(Print& out)
+    {
+      bool wasPaused = _paused;
+
+      _paused = true;
+
+      out.print(F("# TISR_PROFILE version="));  out.print(TISR_PROFILER_VERSION);
+      out.print(F(" shift="));                  out.print(TISR_PROFILER_SHIFT);
+      out.print(F(" samples="));                out.print(_numSamples);
+      out.print(F(" dropped="));                out.println(_numDropped);
+
+      for (uint16_t i = 0; i < TISR_PROFILER_NUM_BUCKETS; i++)
+      {
+        const volatile tisr_profiler_bucket_t* bucket = &_buckets[i];
+
+        if (bucket->key == 0)
+          continue;
+
+        uint32_t address = (bucket->key - 1) << TISR_PROFILER_SHIFT;
+
+        out.print(F("0x"));
+
+        for (int8_t shift = 28; shift >= 0; shift -= 4)
+          out.print( (uint8_t) ( (address >> shift) & 0x0F ), HEX);
+
+        out.print(' ');
+        out.println(bucket->count);
+      }
+
+      _paused = wasPaused;
+    }
+
+  private:
+
+    volatile tisr_profiler_bucket_t   _buckets[TISR_PROFILER_NUM_BUCKETS];
+    volatile uint32_t                 _numSamples;
+    volatile uint32_t                 _numDropped;
+    volatile bool                     _paused;
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_PROFILER_INSTANTIATED
+  // To force pre-instatiate only once
+  #define TISR_PROFILER_INSTANTIATED
+  TISR_SamplingProfiler TISR_Profiler;
+
+  #if ( defined(__AVR__) && defined(TIMER2_COMPA_vect) )
+
+    #if ( defined(USE_TIMER_2) && USE_TIMER_2 )
+      #error TimerInterrupt_Generic_Profiler.h uses Timer2 on AVR, set USE_TIMER_2 false
+    #endif
+
+    // Word address of the interrupted instruction, from the naked ISR below
+    extern "C" void tisr_profiler_avr_sample(uint32_t wordAddress) __attribute__((used));
+
+    extern "C" void tisr_profiler_avr_sample(uint32_t wordAddress)
+    {
+      TISR_Profiler.record(wordAddress << 1);
+    }
+
+    // Naked, so the return address is at a known offset : SP + 1 + the 15 bytes pushed here
+    ISR(TIMER2_COMPA_vect, ISR_NAKED)
+    {
+      __asm__ volatile (
+        "push r0              \n"
+        "in   r0, __SREG__    \n"
+        "push r0              \n"
+        "push r1              \n"
+        "clr  r1              \n"
+        "push r18             \n"
+        "push r19             \n"
+        "push r20             \n"
+        "push r21             \n"
+        "push r22             \n"
+        "push r23             \n"
+        "push r24             \n"
+        "push r25             \n"
+        "push r26             \n"
+        "push r27             \n"
+        "push r30             \n"
+        "push r31             \n"
+        "in   r30, __SP_L__   \n"
+        "in   r31, __SP_H__   \n"
+#if defined(__AVR_3_BYTE_PC__)
+        "ldd  r24, Z+16       \n"
+        "ldd  r23, Z+17       \n"
+        "ldd  r22, Z+18       \n"
+#else
+        "clr  r24             \n"
+        "ldd  r23, Z+16       \n"
+        "ldd  r22, Z+17       \n"
+#endif
+        "clr  r25             \n"
+        "call tisr_profiler_avr_sample \n"
+        "pop  r31             \n"
+        "pop  r30             \n"
+        "pop  r27             \n"
+        "pop  r26             \n"
+        "pop  r25             \n"
+        "pop  r24             \n"
+        "pop  r23             \n"
+        "pop  r22             \n"
+        "pop  r21             \n"
+        "pop  r20             \n"
+        "pop  r19             \n"
+        "pop  r18             \n"
+        "pop  r1              \n"
+        "pop  r0              \n"
+        "out  __SREG__, r0    \n"
+        "pop  r0              \n"
+        "reti                 \n"
+      );
+    }
+
+  #endif
+#endif
+
+///////////////////////////////////////////
+
+#if TISR_PROFILER_CAN_SAMPLE
+  #define TISR_PROFILER_SAMPLE()        TISR_Profiler.sample()
+#else
+  #define TISR_PROFILER_SAMPLE()
+#endif
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_PROFILER_H
@@ -0,0 +1,494 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Quadrature.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Quadrature encoder decoding at a fixed CPU cost, set by the sampling rate instead of by the shaft speed. Include it
+  explicitly, after "TimerInterrupt_Generic.h" / "ISR_Timer_Generic.h".
+
+  1) TISR_QuadratureDecoder<NUM_CHANNELS, NUM_PORTS> : software decoder, update() called from a timer ISR / callback.
+     Each tick reads every port once (up to 32 pins, packed by the sketch's read function). Ports whose encoder pins
+     didn't change are skipped with one compare for all their channels, the others go through a 16 entry transition
+     table per channel. Both pins changing in one tick is an illegal transition : counted, the position is kept.
+     Sample at least 4 times faster than the highest edge rate of one pin, or counts are lost
+  2) TISR_HardwareQuadrature : hardware quadrature decoder, update() called from a timer ISR / callback only to extend
+     its counter to 32 bits. No CPU cost per edge
+     - nRF52 : the QDEC peripheral, one instance. Its accumulator saturates at 1024 counts, poll at least that often
+     - STM32 : a general purpose timer in encoder mode, pins on its channels 1 and 2
+     - Teensy 3.x : FTM1 in quadrature decoder mode, pins 3 and 4 (FTM1_QD_PHA / PHB)
+
+  Both count 4 per encoder cycle (x4), and give the velocity in counts / s over a window of update() ticks.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_QUADRATURE_H
+#define TIMERINTERRUPT_GENERIC_QUADRATURE_H
+
+#include "TimerInterrupt_Generic_Atomic.h"
+
+// Returns the current level of the pins of port, bit n for pin n. Called from the timer ISR
+typedef uint32_t (*tisr_quadrature_read_t)(const uint8_t& port);
+
+#define TISR_QUADRATURE_ILLEGAL       2
+
+// Indexed by (previous AB << 2) | current AB. A leading B counts up : AB 00 -> 01 -> 11 -> 10 -> 00
+static const int8_t tisr_quadrature_table[16] =
+{
+   0, +1, -1, TISR_QUADRATURE_ILLEGAL,
+  -1,  0, TISR_QUADRATURE_ILLEGAL, +1,
+  +1, TISR_QUADRATURE_ILLEGAL,  0, -1,
+  TISR_QUADRATURE_ILLEGAL, -1, +1,  0
+};
+
+///////////////////////////////////////////
+
+// Position and velocity window of one channel. Not locked, the owner holds its mux
+class TISR_QuadratureCounter
+{
+  public:
+
+    TISR_QuadratureCounter() : _position(0), _windowStart(0), _windowDelta(0)
+    {
+    }
+
+    void add(const int32_t& delta)
+    {
+      _position += delta;
+    }
+
+    // End of a velocity window
+    void closeWindow()
+    {
+      _windowDelta  = _position - _windowStart;
+      _windowStart  = _position;
+    }
+
+    int32_t getPosition() const
+    {
+      return _position;
+    }
+
+    void setPosition(const int32_t& position)
+    {
+      // Keeps the velocity of the current window
+      _windowStart += position - _position;
+      _position     = position;
+    }
+
+    int32_t getWindowDelta() const
+    {
+      return _windowDelta;
+    }
+
+  private:
+
+    int32_t   _position;
+    int32_t   _windowStart;
+    int32_t   _windowDelta;
+};
+
+///////////////////////////////////////////
+
+template <uint8_t NUM_CHANNELS = 2, uint8_t NUM_PORTS = 1>
+class TISR_QuadratureDecoder
+{
+  static_assert( (NUM_PORTS >= 1) && (NUM_PORTS <= 8), "TISR_QuadratureDecoder NUM_PORTS must be 1 to 8" );
+
+  public:
+
+    TISR_QuadratureDecoder() : _read(NULL), _tickMicros(1000), _windowTicks(100), _ticks(0)
+    {
+      TISR_ATOMIC_MUX_INIT(_mux);
+
+      for (uint8_t port = 0; port < NUM_PORTS; port++)
+      {
+        _portMasks[port]  = 0;
+        _lastWords[port]  = 0;
+      }
+
+      for (uint8_t channel = 0; channel < NUM_CHANNELS; channel++)
+      {
+        _channels[channel].port       = NUM_PORTS;
+        _channels[channel].numIllegal = 0;
+      }
+    }
+
+    // Encoder of channel on bits pinA and pinB of port. Before begin(). Returns false if out of range
+    bool attach(const uint8_t& channel, const uint8_t& port, const uint8_t& pinA, const uint8_t& pinB)
+    {
+      if ( (channel >= NUM_CHANNELS) || (port >= NUM_PORTS) || (pinA > 31) || (pinB > 31) )
+        return false;
+
+      _channels[channel].port = port;
+      _channels[channel].pinA = pinA;
+      _channels[channel].pinB = pinB;
+
+      _portMasks[port] |= (1UL << pinA) | (1UL << pinB);
+
+      return true;
+    }
+
+    // tickMicros : update() period. Velocity over windowTicks ticks. Before the timer starts calling update()
+    void begin(tisr_quadrature_read_t read, const uint32_t& tickMicros, const uint16_t& windowTicks = 100)
+    {
+      _tickMicros   = tickMicros;
+      _windowTicks  = (windowTicks > 0) ? windowTicks : 1;
+      _ticks        = 0;
+
+      for (uint8_t port = 0; port < NUM_PORTS; port++)
+        _lastWords[port] = read(port);
+
+      for (uint8_t channel = 0; channel < NUM_CHANNELS; channel++)
+      {
+        if (_channels[channel].port < NUM_PORTS)
+          _channels[channel].state = getAB(_channels[channel], _lastWords[_channels[channel].port]);
+      }
+
+      _read = read;
+    }
+
+    ///////////////////////////////////////////
+
+    // Call from the timer ISR / callback, every tickMicros
+    void TISR_ATOMIC_IRAM_ATTR update()
+    {
+      if (_read == NULL)
+        return;
+
+      uint32_t  words[NUM_PORTS];
+      uint8_t   changedPorts = 0;
+
+      // All the encoder pins of a port at once
+      for (uint8_t port = 0; port < NUM_PORTS; port++)
+      {
+        words[port] = _read(port);
+
+        if ( (words[port] ^ _lastWords[port]) & _portMasks[port] )
+          changedPorts |= (1 << port);
+
+        _lastWords[port] = words[port];
+      }
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      if (changedPorts != 0)
+      {
+        for (uint8_t channel = 0; channel < NUM_CHANNELS; channel++)
+        {
+          channel_t& ch = _channels[channel];
+
+          if ( (ch.port >= NUM_PORTS) || !(changedPorts & (1 << ch.port)) )
+            continue;
+
+          uint8_t state = getAB(ch, words[ch.port]);
+          int8_t  delta = tisr_quadrature_table[ (ch.state << 2) | state ];
+
+          ch.state = state;
+
+          if (delta == TISR_QUADRATURE_ILLEGAL)
+            ch.numIllegal++;
+          else
+            ch.counter.add(delta);
+        }
+      }
+
+      if (++_ticks >= _windowTicks)
+      {
+        _ticks = 0;
+
+        for (uint8_t channel = 0; channel < NUM_CHANNELS; channel++)
+          _channels[channel].counter.closeWindow();
+      }
+
+      TISR_ATOMIC_EXIT(_mux);
+    }
+
+    ///////////////////////////////////////////
+
+    int32_t getPosition(const uint8_t& channel)
+    {
+      if (channel >= NUM_CHANNELS)
+        return 0;
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      int32_t position = _channels[channel].counter.getPosition();
+
+      TISR_ATOMIC_EXIT(_mux);
+
+      return position;
+    }
+
+    void setPosition(const uint8_t& channel, const int32_t& position)
+    {
+      if (channel >= NUM_CHANNELS)
+        return;
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      _channels[channel].counter.setPosition(position);
+
+      TISR_ATOMIC_EXIT(_mux);
+    }
+
+    // counts / s over the last complete window
+    float getVelocity(const uint8_t& channel)
+    {
+      if (channel >= NUM_CHANNELS)
+        return 0;
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      int32_t delta = _channels[channel].counter.getWindowDelta();
+
+      TISR_ATOMIC_EXIT(_mux);
+
+      return delta * 1000000.0f / ( (float) _tickMicros * _windowTicks );
+    }
+
+    // Samples where both pins changed : noise, or sampling too slow for the shaft speed
+    uint32_t getNumIllegal(const uint8_t& channel)
+    {
+      if (channel >= NUM_CHANNELS)
+        return 0;
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      uint32_t numIllegal = _channels[channel].numIllegal;
+
+      TISR_ATOMIC_EXIT(_mux);
+
+      return numIllegal;
+    }
+
+  private:
+
+    typedef struct
+    {
+      uint8_t                 port;           // NUM_PORTS if not attached
+      uint8_t                 pinA;
+      uint8_t                 pinB;
+      uint8_t                 state;          // last AB
+      uint32_t                numIllegal;
+      TISR_QuadratureCounter  counter;
+    } channel_t;
+
+    static uint8_t getAB(const channel_t& ch, const uint32_t& word)
+    {
+      return ( ( (word >> ch.pinA) & 0x01 ) << 1 ) | ( (word >> ch.pinB) & 0x01 );
+    }
+
+    tisr_quadrature_read_t volatile   _read;
+    uint32_t                          _tickMicros;
+    uint16_t                          _windowTicks;
+    uint16_t                          _ticks;
+
+    uint32_t                          _portMasks[NUM_PORTS];
+    uint32_t                          _lastWords[NUM_PORTS];
+
+    channel_t                         _channels[NUM_CHANNELS];
+
+    TISR_ATOMIC_MUX(_mux);
+};
+
+///////////////////////////////////////////
+
+#if ( TIMER_INTERRUPT_USING_NRF52 || TIMER_INTERRUPT_USING_NANO33BLE || TIMER_INTERRUPT_USING_STM32 || \
+      ( TIMER_INTERRUPT_USING_TEENSY && ( defined(__MK20DX128__) || defined(__MK20DX256__) || defined(__MK64FX512__) || \
+                                          defined(__MK66FX1M0__) ) ) )
+
+#define TISR_QUADRATURE_HARDWARE      true
+
+#if TIMER_INTERRUPT_USING_NANO33BLE
+  #define TISR_QUADRATURE_NRF_PIN(pin)    ( (uint32_t) digitalPinToPinName(pin) )
+#elif TIMER_INTERRUPT_USING_NRF52
+  #define TISR_QUADRATURE_NRF_PIN(pin)    ( g_ADigitalPinMap[pin] )
+#endif
+
+class TISR_HardwareQuadrature
+{
+  public:
+
+    TISR_HardwareQuadrature() : _tickMicros(1000), _windowTicks(100), _ticks(0), _lastCount(0)
+    {
+      TISR_ATOMIC_MUX_INIT(_mux);
+    }
+
+#if ( TIMER_INTERRUPT_USING_NRF52 || TIMER_INTERRUPT_USING_NANO33BLE )
+
+    // QDEC sampling every 128us, with its debounce filter
+    void begin(const uint8_t& pinA, const uint8_t& pinB, const uint32_t& tickMicros, const uint16_t& windowTicks = 100)
+    {
+      setTiming(tickMicros, windowTicks);
+
+      pinMode(pinA, INPUT_PULLUP);
+      pinMode(pinB, INPUT_PULLUP);
+
+      NRF_QDEC->ENABLE      = 0;
+      NRF_QDEC->PSEL.A      = TISR_QUADRATURE_NRF_PIN(pinA);
+      NRF_QDEC->PSEL.B      = TISR_QUADRATURE_NRF_PIN(pinB);
+      NRF_QDEC->PSEL.LED    = 0xFFFFFFFFUL;
+      NRF_QDEC->SAMPLEPER   = QDEC_SAMPLEPER_SAMPLEPER_128us;
+      NRF_QDEC->DBFEN       = 1;
+      NRF_QDEC->SHORTS      = 0;
+      NRF_QDEC->ENABLE      = 1;
+      NRF_QDEC->TASKS_START = 1;
+    }
+
+#elif TIMER_INTERRUPT_USING_STM32
+
+    // timer : TIM2, TIM3, ... with pinA on its CH1 and pinB on its CH2. Filtered over 8 clocks
+    void begin(TIM_TypeDef* timer, const uint8_t& pinA, const uint8_t& pinB, const uint32_t& tickMicros,
+               const uint16_t& windowTicks = 100)
+    {
+      setTiming(tickMicros, windowTicks);
+
+      // Enables the timer clock
+      _hwTimer = new HardwareTimer(timer);
+      _timer   = timer;
+
+      pinmap_pinout(digitalPinToPinName(pinA), PinMap_TIM);
+      pinmap_pinout(digitalPinToPinName(pinB), PinMap_TIM);
+
+      _timer->CR1   = 0;
+      _timer->SMCR  = TIM_SMCR_SMS_0 | TIM_SMCR_SMS_1;      // Encoder mode 3, both edges of both inputs
+      _timer->CCMR1 = TIM_CCMR1_CC1S_0 | TIM_CCMR1_CC2S_0 | TIM_CCMR1_IC1F_0 | TIM_CCMR1_IC1F_1 |
+                      TIM_CCMR1_IC2F_0 | TIM_CCMR1_IC2F_1;
+      _timer->CCER  = 0;
+      _timer->ARR   = 0xFFFF;
+      _timer->CNT   = 0;
+      _timer->CR1   = TIM_CR1_CEN;
+    }
+
+#else
+
+    // FTM1, pins 3 and 4 only
+    void begin(const uint32_t& tickMicros, const uint16_t& windowTicks = 100)
+    {
+      setTiming(tickMicros, windowTicks);
+
+      // PTA12 / PTA13, ALT7
+      CORE_PIN3_CONFIG  = PORT_PCR_MUX(7);
+      CORE_PIN4_CONFIG  = PORT_PCR_MUX(7);
+
+      FTM1_MODE         = FTM_MODE_WPDIS;
+      FTM1_MODE        |= FTM_MODE_FTMEN;
+      FTM1_SC           = 0;
+      FTM1_CNTIN        = 0;
+      FTM1_MOD          = 0xFFFF;
+      FTM1_CNT          = 0;
+      FTM1_QDCTRL       = FTM_QDCTRL_QUADEN;
+      FTM1_SC           = FTM_SC_CLKS(1);
+    }
+
+#endif
+
+    ///////////////////////////////////////////
+
+    // Call from the timer ISR / callback, every tickMicros
+    void TISR_ATOMIC_IRAM_ATTR update()
+    {
+      int32_t delta = readDelta();
+
+      TISR_ATOMIC_ENTER(_mux);
+
+      _counter.add(delta);
+
+      if (++_ticks >= _windowTicks)
+      {
+        _ticks = 0;
+        _counter.closeWindow();
+      }
+
+      TISR_ATOMIC_EXIT(_mux);
+    }
+
+    int32_t getPosition()
+    {
+      TISR_ATOMIC_ENTER(_mux);
+
+      int32_t position = _counter.getPosition();
+
+      TISR_ATOMIC_EXIT(_mux);
+
+      return position;
+    }
+
+    void setPosition(const int32_t& position)
+    {
+      TISR_ATOMIC_ENTER(_mux);
+
+      _counter.setPosition(position);
+
+      TISR_ATOMIC_EXIT(_mux);
+    }
+
+    // counts / s over the last complete window
+    float getVelocity()
+    {
+      TISR_ATOMIC_ENTER(_mux);
+
+      int32_t delta = _counter.getWindowDelta();
+
+      TISR_ATOMIC_EXIT(_mux);
+
+      return delta * 1000000.0f / ( (float) _tickMicros * _windowTicks );
+    }
+
+  private:
+
+    void setTiming(const uint32_t& tickMicros, const uint16_t& windowTicks)
+    {
+      _tickMicros   = tickMicros;
+      _windowTicks  = (windowTicks > 0) ? windowTicks : 1;
+      _ticks        = 0;
+      _lastCount    = 0;
+    }
+
+    // Counts since the previous call
+    int32_t readDelta()
+    {
+#if ( TIMER_INTERRUPT_USING_NRF52 || TIMER_INTERRUPT_USING_NANO33BLE )
+      // Accumulator read and cleared at once. Double transitions (ACCDBL) aren't in it
+      NRF_QDEC->TASKS_READCLRACC = 1;
+
+      return (int32_t) NRF_QDEC->ACCREAD;
+#else
+  #if TIMER_INTERRUPT_USING_STM32
+      uint16_t count  = (uint16_t) _timer->CNT;
+  #else
+      uint16_t count  = (uint16_t) FTM1_CNT;
+  #endif
+
+      // 16-bit counter, right as long as it moves less than 32768 counts between calls
+      int16_t  delta  = (int16_t) (count - _lastCount);
+
+      _lastCount = count;
+
+      return delta;
+#endif
+    }
+
+#if TIMER_INTERRUPT_USING_STM32
+    HardwareTimer*          _hwTimer;
+    TIM_TypeDef*            _timer;
+#endif
+
+    uint32_t                _tickMicros;
+    uint16_t                _windowTicks;
+    uint16_t                _ticks;
+    uint16_t                _lastCount;
+
+    TISR_QuadratureCounter  _counter;
+
+    TISR_ATOMIC_MUX(_mux);
+};
+
+#endif    // TISR_QUADRATURE_HARDWARE
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_QUADRATURE_H
@@ -0,0 +1,200 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Sampler.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Block sampling at high rates. Include it explicitly, after "TimerInterrupt_Generic.h".
+
+  With one callback per sample, e.g. an ISR_Timer timer at 20kHz, the dispatch costs more than the analogRead() or
+  port read itself. TISR_BlockSampler splits the work in two :
+  1) the timer ISR only runs the sample step : the SAMPLE function, a template parameter so the compiler inlines it,
+     and a store into one of 2 buffers of BLOCK_SIZE samples (ping-pong)
+  2) once a buffer is full, it is handed over and the ISR goes on in the other one. The block callback, from run() in
+     loop() or a task, gets the whole block at once, with the micros() of its first sample : sample i was taken at
+     baseMicros + i * period. It must be done before the other buffer is full, else that block is dropped and counted
+     in getNumOverruns()
+     With begin(callback, true), the callback is called by the ISR itself instead, once per block : nothing is lost
+     when loop() stalls, as long as the callback is shorter than a sample period. E.g. the decimation stages of
+     TimerInterrupt_Generic_Decimator.h, which leave a low rate output in a ring for loop()
+
+  The processing then works on contiguous arrays, e.g. min / max / mean, filters or FFT, instead of per-sample calls.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_SAMPLER_H
+#define TIMERINTERRUPT_GENERIC_SAMPLER_H
+
+#include "TimerInterrupt_Generic_Atomic.h"
+
+///////////////////////////////////////////
+
+// SAMPLE : returns one sample, called in the timer ISR. NULL to pass the samples to add() instead
+template <typename T, uint16_t BLOCK_SIZE, T (*SAMPLE)() = (T (*)()) NULL>
+class TISR_BlockSampler
+{
+  static_assert(BLOCK_SIZE >= 1, "TISR_BlockSampler BLOCK_SIZE must be at least 1");
+
+  public:
+
+    // Called by run(), or by the ISR, with each full block
+    typedef void (*block_callback_t)(const T* samples, const uint16_t& numSamples, const uint32_t& baseMicros);
+
+    TISR_BlockSampler() : _callback(NULL), _fromIsr(false), _writing(0), _index(0), _ready(NO_BLOCK), _numBlocks(0), _numOverruns(0)
+    {
+    }
+
+    // fromIsr : callback called from update() / add(), in the timer ISR, instead of run()
+    void begin(block_callback_t callback, const bool& fromIsr = false)
+    {
+      _callback = callback;
+      _fromIsr  = fromIsr;
+
+      reset();
+    }
+
+    // Drops the samples of the current block and the block not run yet. Not while the timer calls update() / add()
+    void reset()
+    {
+      _index    = 0;
+      _ready    = NO_BLOCK;
+    }
+
+    ///////////////////////////////////////////
+
+    // Timer ISR side, every sample period
+    inline void TISR_ATOMIC_IRAM_ATTR update()
+    {
+      add(SAMPLE());
+    }
+
+    inline void TISR_ATOMIC_IRAM_ATTR add(const T& sample)
+    {
+      uint8_t   writing = _writing;
+      uint16_t  index   = _index;
+
+      if (index == 0)
+        _baseMicros[writing] = micros();
+
+      _buffers[writing][index++] = sample;
+
+      if (index < BLOCK_SIZE)
+      {
+        _index = index;
+
+        return;
+      }
+
+      _index = 0;
+
+      if (_fromIsr)
+      {
+        // Done with the buffer on return, it can be filled again
+        if (_callback)
+          _callback(_buffers[writing], BLOCK_SIZE, _baseMicros[writing]);
+
+        _numBlocks = _numBlocks + 1;
+
+        return;
+      }
+
+      if (_ready != NO_BLOCK)
+      {
+        // The previous block is still being processed : this one is overwritten
+        _numOverruns = _numOverruns + 1;
+
+        return;
+      }
+
+      // The samples before the hand over
+      TISR_MEMORY_BARRIER();
+
+      _ready    = writing;
+      _writing  = writing ^ 1;
+    }
+
+    ///////////////////////////////////////////
+
+    // From loop() or a task. Calls the block callback with the block filled, if any. true if it did
+    bool run()
+    {
+      uint8_t ready = _ready;
+
+      if (ready == NO_BLOCK)
+        return false;
+
+      TISR_MEMORY_BARRIER();
+
+      if (_callback)
+        _callback(_buffers[ready], BLOCK_SIZE, _baseMicros[ready]);
+
+      _numBlocks = _numBlocks + 1;
+
+      // Done with the buffer before giving it back
+      TISR_MEMORY_BARRIER();
+
+      _ready = NO_BLOCK;
+
+      return true;
+    }
+
+    // A full block waits for run()
+    bool isReady() const
+    {
+      return (_ready != NO_BLOCK);
+    }
+
+    // Blocks processed. Read twice until stable, a 32-bit load isn't atomic on AVR
+    uint32_t getNumBlocks() const
+    {
+      uint32_t numBlocks;
+
+      do
+      {
+        numBlocks = _numBlocks;
+      } while (numBlocks != _numBlocks);
+
+      return numBlocks;
+    }
+
+    // Blocks dropped because run() was late
+    uint32_t getNumOverruns() const
+    {
+      uint32_t numOverruns;
+
+      do
+      {
+        numOverruns = _numOverruns;
+      } while (numOverruns != _numOverruns);
+
+      return numOverruns;
+    }
+
+  private:
+
+    enum
+    {
+      NO_BLOCK = 0xFF
+    };
+
+    block_callback_t  _callback;
+    bool              _fromIsr;
+
+    T                 _buffers[2][BLOCK_SIZE];
+    uint32_t          _baseMicros[2];
+
+    // ISR private
+    uint8_t           _writing;
+    uint16_t          _index;
+
+    volatile uint8_t  _ready;           // Set by the ISR, cleared by run()
+
+    volatile uint32_t _numBlocks;
+    volatile uint32_t _numOverruns;
+};
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_SAMPLER_H
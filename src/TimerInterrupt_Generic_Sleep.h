@@ -0,0 +1,307 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Sleep.h
+  For ESP32, ESP32_S2, ESP32_S3, ESP32_C3 boards with ESP32 core v2.0.0+
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Keeps the ISR_Timer schedule across deep sleep, in RTC slow memory. Include it explicitly, after "ISR_Timer_Generic.h".
+
+  Without it, setup() rebuilds the timer table after every wake and each timer restarts its period from zero, so a
+  10 minutes interval drifts by the sleep and boot time on every cycle. With it :
+  1) setup() binds every callback (with its parameter) to an ID which doesn't change between builds : bind()
+  2) restore() sets up all the timers again, in their former slots, with their enabled flags, run counts and phase.
+     It returns false after a power-on or if the snapshot doesn't match the bindings : set up the timers as usual then
+  3) save() before esp_deep_sleep_start(). getMicrosToNextDeadline() is the sleep time until the first enabled timer
+     is due, for esp_sleep_enable_timer_wakeup()
+
+  The phase is kept against the RTC timer (TISR_SLEEP_RTC_MICROS()), which keeps counting during deep sleep, unlike
+  millis(). Timer periods which ended during the sleep are run once by the first run(), with their missed count.
+  Only function pointers and parameters which are the same after the wake can be bound, i.e. globals and statics.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_SLEEP_H
+#define TIMERINTERRUPT_GENERIC_SLEEP_H
+
+#if !( defined(ESP32) || ESP32 )
+  #error TimerInterrupt_Generic_Sleep.h is only for ESP32 boards
+#endif
+
+#include <stddef.h>
+
+#include "ISR_Timer_Generic.h"
+
+#include "esp_attr.h"
+
+// RTC timer in us, counting since power-on, also during deep sleep
+#ifndef TISR_SLEEP_RTC_MICROS
+  extern "C" uint64_t esp_rtc_get_time_us(void);
+
+  #define TISR_SLEEP_RTC_MICROS()     esp_rtc_get_time_us()
+#endif
+
+// Callback IDs, 0 .. TISR_SLEEP_MAX_IDS - 1
+#ifndef TISR_SLEEP_MAX_IDS
+  #define TISR_SLEEP_MAX_IDS          16
+#endif
+
+#define TISR_SLEEP_NO_ID              0xFF
+
+#define TISR_SLEEP_MAGIC              0x54534C50UL      // "TSLP"
+
+///////////////////////////////////////////
+
+typedef struct
+{
+  uint8_t         callbackId;         // TISR_SLEEP_NO_ID if the slot is free
+  bool            enabled;
+  float           interval;           // ms
+  uint32_t        maxNumRuns;
+  uint32_t        numRuns;
+  uint32_t        elapsed;            // ms since the start of the current period, when saved
+} tisr_sleep_slot_t;
+
+typedef struct
+{
+  uint32_t          magic;            // TISR_SLEEP_MAGIC while valid
+  uint32_t          checksum;         // of everything below
+  uint32_t          numSleeps;        // save() calls since power-on
+  uint64_t          savedMicros;      // TISR_SLEEP_RTC_MICROS() when saved
+  tisr_sleep_slot_t slots[MAX_NUMBER_TIMERS];
+} tisr_sleep_snapshot_t;
+
+// In RTC slow memory, cleared at power-on only
+extern tisr_sleep_snapshot_t TISR_SleepSnapshot;
+
+///////////////////////////////////////////
+
+class TISR_SleepSchedule
+{
+  public:
+
+    TISR_SleepSchedule()
+    {
+      for (uint8_t id = 0; id < TISR_SLEEP_MAX_IDS; id++)
+        _bindings[id].callback = NULL;
+    }
+
+    // Binds a callback to a stable ID, before restore() / save(). Returns false if id is out of range
+    bool bind(const uint8_t& id, timerCallback f)
+    {
+      return setBinding(id, (void *) f, NULL, TIMER_CALLBACK_NO_PARAM);
+    }
+
+    bool bind(const uint8_t& id, timerCallback_p f, void* p)
+    {
+      return setBinding(id, (void *) f, p, TIMER_CALLBACK_PARAM);
+    }
+
+    bool bind(const uint8_t& id, timerCallback_ctx f, void* p = NULL)
+    {
+      return setBinding(id, (void *) f, p, TIMER_CALLBACK_CONTEXT);
+    }
+
+    ///////////////////////////////////////////
+
+    // Snapshots all the timers of isrTimer. Returns false if a used timer has no bound callback, it isn't saved
+    bool save(ISR_Timer& isrTimer)
+    {
+      bool allBound = true;
+
+      for (uint8_t i = 0; i < MAX_NUMBER_TIMERS; i++)
+      {
+        tisr_timer_schedule_t schedule;
+        tisr_sleep_slot_t&    slot = TISR_SleepSnapshot.slots[i];
+
+        slot.callbackId = TISR_SLEEP_NO_ID;
+
+        if (!isrTimer.getSchedule(i, schedule))
+          continue;
+
+        slot.callbackId = findBinding(schedule);
+
+        if (slot.callbackId == TISR_SLEEP_NO_ID)
+        {
+          allBound = false;
+          continue;
+        }
+
+        slot.enabled    = schedule.enabled;
+        slot.interval   = schedule.interval;
+        slot.maxNumRuns = schedule.maxNumRuns;
+        slot.numRuns    = schedule.numRuns;
+        slot.elapsed    = schedule.elapsed;
+      }
+
+      TISR_SleepSnapshot.savedMicros  = TISR_SLEEP_RTC_MICROS();
+      TISR_SleepSnapshot.numSleeps    = (TISR_SleepSnapshot.magic == TISR_SLEEP_MAGIC) ? TISR_SleepSnapshot.numSleeps + 1 : 1;
+      TISR_SleepSnapshot.checksum     = getChecksum();
+      TISR_SleepSnapshot.magic        = TISR_SLEEP_MAGIC;
+
+      return allBound;
+    }
+
+    ///////////////////////////////////////////
+
+    // Sets up the saved timers in isrTimer, which must have none yet. All or nothing : returns false, and sets up
+    // nothing, without a valid snapshot (power-on, never saved) or if a saved callback ID isn't bound anymore.
+    // The snapshot is used up, a later reset without save() doesn't restore it again
+    bool restore(ISR_Timer& isrTimer)
+    {
+      if (!isValid())
+        return false;
+
+      TISR_SleepSnapshot.magic = 0;
+
+      for (uint8_t i = 0; i < MAX_NUMBER_TIMERS; i++)
+      {
+        uint8_t id = TISR_SleepSnapshot.slots[i].callbackId;
+
+        if ( (id != TISR_SLEEP_NO_ID) && ( (id >= TISR_SLEEP_MAX_IDS) || (_bindings[id].callback == NULL) ) )
+          return false;
+      }
+
+      // Saturated at ~49 days, as millis()
+      uint64_t  sleptMillis = (TISR_SLEEP_RTC_MICROS() - TISR_SleepSnapshot.savedMicros) / 1000;
+      bool      restored    = true;
+
+      for (uint8_t i = 0; i < MAX_NUMBER_TIMERS; i++)
+      {
+        const tisr_sleep_slot_t& slot = TISR_SleepSnapshot.slots[i];
+
+        if (slot.callbackId == TISR_SLEEP_NO_ID)
+          continue;
+
+        tisr_timer_schedule_t schedule;
+        uint64_t              elapsed = slot.elapsed + sleptMillis;
+
+        schedule.callback     = _bindings[slot.callbackId].callback;
+        schedule.param        = _bindings[slot.callbackId].param;
+        schedule.callbackType = _bindings[slot.callbackId].callbackType;
+        schedule.interval     = slot.interval;
+        schedule.maxNumRuns   = slot.maxNumRuns;
+        schedule.numRuns      = slot.numRuns;
+        schedule.enabled      = slot.enabled;
+        schedule.elapsed      = (elapsed > 0xFFFFFFFFUL) ? 0xFFFFFFFFUL : (unsigned long) elapsed;
+
+        restored &= isrTimer.restoreTimer(i, schedule);
+      }
+
+      return restored;
+    }
+
+    ///////////////////////////////////////////
+
+    // us from now until the first enabled timer of the last save() is due, 0 if overdue, UINT64_MAX if none
+    uint64_t getMicrosToNextDeadline() const
+    {
+      if (!isValid())
+        return UINT64_MAX;
+
+      uint64_t now          = TISR_SLEEP_RTC_MICROS();
+      uint64_t nextDeadline = UINT64_MAX;
+
+      for (uint8_t i = 0; i < MAX_NUMBER_TIMERS; i++)
+      {
+        const tisr_sleep_slot_t& slot = TISR_SleepSnapshot.slots[i];
+
+        if ( (slot.callbackId == TISR_SLEEP_NO_ID) || !slot.enabled )
+          continue;
+
+        // Period start, then the first deadline after the snapshot
+        uint64_t periodStart  = TISR_SleepSnapshot.savedMicros - (uint64_t) slot.elapsed * 1000;
+        uint64_t interval     = (uint64_t) (slot.interval * 1000.0f);
+        uint64_t deadline     = periodStart + interval;
+
+        if (deadline < nextDeadline)
+          nextDeadline = deadline;
+      }
+
+      if (nextDeadline == UINT64_MAX)
+        return UINT64_MAX;
+
+      return (nextDeadline > now) ? (nextDeadline - now) : 0;
+    }
+
+    // save() calls since power-on, 0 after a power-on
+    uint32_t getNumSleeps() const
+    {
+      return isValid() ? TISR_SleepSnapshot.numSleeps : 0;
+    }
+
+    // true if there is a snapshot to restore()
+    bool isValid() const
+    {
+      return (TISR_SleepSnapshot.magic == TISR_SLEEP_MAGIC) && (TISR_SleepSnapshot.checksum == getChecksum())
+             && (TISR_SLEEP_RTC_MICROS() >= TISR_SleepSnapshot.savedMicros);
+    }
+
+    ///////////////////////////////////////////
+
+  private:
+
+    typedef struct
+    {
+      void*     callback;
+      void*     param;
+      uint8_t   callbackType;
+    } binding_t;
+
+    bool setBinding(const uint8_t& id, void* f, void* p, const uint8_t& type)
+    {
+      if ( (id >= TISR_SLEEP_MAX_IDS) || (f == NULL) )
+        return false;
+
+      _bindings[id].callback      = f;
+      _bindings[id].param         = p;
+      _bindings[id].callbackType  = type;
+
+      return true;
+    }
+
+    uint8_t findBinding(const tisr_timer_schedule_t& schedule) const
+    {
+      for (uint8_t id = 0; id < TISR_SLEEP_MAX_IDS; id++)
+      {
+        if ( (_bindings[id].callback == schedule.callback) && (_bindings[id].param == schedule.param) &&
+             (_bindings[id].callbackType == schedule.callbackType) )
+          return id;
+      }
+
+      return TISR_SLEEP_NO_ID;
+    }
+
+    // Fletcher-32 over the snapshot after the checksum, so RTC memory garbage isn't restored
+    static uint32_t getChecksum()
+    {
+      const uint8_t*  data    = (const uint8_t*) &TISR_SleepSnapshot + offsetof(tisr_sleep_snapshot_t, numSleeps);
+      size_t          length  = sizeof(tisr_sleep_snapshot_t) - offsetof(tisr_sleep_snapshot_t, numSleeps);
+      uint32_t        sum1    = 0xFFFF;
+      uint32_t        sum2    = 0xFFFF;
+
+      for (size_t i = 0; i < length; i++)
+      {
+        sum1 = (sum1 + data[i]) % 65535;
+        sum2 = (sum2 + sum1) % 65535;
+      }
+
+      return (sum2 << 16) | sum1;
+    }
+
+    binding_t   _bindings[TISR_SLEEP_MAX_IDS];
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_SLEEP_INSTANTIATED
+#define TISR_SLEEP_INSTANTIATED     // To force pre-instatiate only once
+
+  RTC_DATA_ATTR tisr_sleep_snapshot_t TISR_SleepSnapshot;
+
+  TISR_SleepSchedule TISR_Sleep;
+
+#endif    // TISR_SLEEP_INSTANTIATED
+
+#endif    // TIMERINTERRUPT_GENERIC_SLEEP_H
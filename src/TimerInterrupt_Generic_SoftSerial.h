@@ -0,0 +1,698 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_SoftSerial.h
+  For Arduino and Adadruit AVR 328(P), 32u4 and Mega boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Software UARTs (8N1) on Timer1, which keep the other interrupts running. Include it explicitly, after
+  "TimerInterrupt_Generic.h". Timer1 runs free at F_CPU / 8 as the time base, so ITimer1 (USE_TIMER_1) and the PWM of
+  its pins can't be used then.
+
+  Unlike SoftwareSerial, no ISR lasts a whole byte or even a bit :
+  - TX : each port has a Timer1 compare channel (A, B, and C on 32u4 / Mega), whose interrupt comes once per edge of
+    the line, not per bit, and schedules the next edge. On the channel's own OC1x pin (D9 / D10 on 328(P), D9 / D10 /
+    D11 on 32u4, D11 / D12 / D13 on Mega), the compare unit itself switches the pin, exactly on time
+  - RX : edges are timestamped by the input capture unit on the ICP1 pin (D8 on 328(P), D4 on 32u4), or on other pins
+    by a pin change interrupt reading Timer1 (on 32u4 only D8 - D11 and the SPI pins, on Mega D10 - D15, A8 - A15 and
+    D50 - D53 have one, begin() fails on the others). Each edge ISR decodes the bits it ends from the edge time, so the bits
+    are never sampled by busy-waiting. The last bits of a byte ending in 1s have no edge after them : they are
+    completed by the next start bit, or by available() / read() once the frame is over
+
+  Up to 2 full-duplex ports (3 on 32u4 / Mega), one per compare channel, at 57600 baud. 600 - 57600 baud, 115200 on one
+  port with the TX on its OC1x pin and the RX on ICP1. The ISR(PCINTx_vect) are defined here, so SoftwareSerial and
+  other libraries using pin change interrupts can't be used at the same time.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_SOFTSERIAL_H
+#define TIMERINTERRUPT_GENERIC_SOFTSERIAL_H
+
+#if !( defined(__AVR__) && defined(TCCR1A) && defined(OCR1B) )
+  #error TimerInterrupt_Generic_SoftSerial.h is only for AVR boards with Timer1
+#endif
+
+#if USE_TIMER_1
+  #error TimerInterrupt_Generic_SoftSerial.h uses Timer1, USE_TIMER_1 must not be defined
+#endif
+
+#include "TimerInterrupt_Generic_Exchange.h"
+
+#ifndef TISR_SOFTSERIAL_RX_BUFFER_SIZE
+  #define TISR_SOFTSERIAL_RX_BUFFER_SIZE    32
+#endif
+
+#ifndef TISR_SOFTSERIAL_TX_BUFFER_SIZE
+  #define TISR_SOFTSERIAL_TX_BUFFER_SIZE    32
+#endif
+
+#define TISR_SOFTSERIAL_NO_PIN              0xFF
+
+// Timer1 ticks / s, prescaler 8
+#define TISR_SOFTSERIAL_TICK_HZ             ( F_CPU / 8 )
+
+// Ticks from write() on an idle port to its start bit
+#define TISR_SOFTSERIAL_TX_LEAD_TICKS       16
+
+#if defined(OCR1C)
+  #define TISR_SOFTSERIAL_MAX_PORTS         3
+#else
+  #define TISR_SOFTSERIAL_MAX_PORTS         2
+#endif
+
+#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+  // ICP1 isn't on the Mega headers
+  #define TISR_SOFTSERIAL_OC1A_PIN          11
+  #define TISR_SOFTSERIAL_OC1B_PIN          12
+  #define TISR_SOFTSERIAL_OC1C_PIN          13
+#elif defined(__AVR_ATmega32U4__)
+  #define TISR_SOFTSERIAL_OC1A_PIN          9
+  #define TISR_SOFTSERIAL_OC1B_PIN          10
+  #define TISR_SOFTSERIAL_OC1C_PIN          11
+  #define TISR_SOFTSERIAL_ICP_PIN           4
+#else
+  #define TISR_SOFTSERIAL_OC1A_PIN          9
+  #define TISR_SOFTSERIAL_OC1B_PIN          10
+  #define TISR_SOFTSERIAL_ICP_PIN           8
+#endif
+
+class TISR_SoftSerial;
+
+// Port of each compare channel, for the ISRs
+extern TISR_SoftSerial* TISR_SoftSerialPorts[TISR_SOFTSERIAL_MAX_PORTS];
+
+// Timer1 overflows, the high 16 bits of the 32-bit time base
+extern volatile uint16_t TISR_SoftSerialOverflows;
+
+///////////////////////////////////////////
+
+class TISR_SoftSerial : public Stream
+{
+  public:
+
+    // rxPin or txPin can be TISR_SOFTSERIAL_NO_PIN for a one-way port
+    TISR_SoftSerial(const uint8_t& rxPin, const uint8_t& txPin) : _rxPin(rxPin), _txPin(txPin), _channel(0xFF),
+      _bitTicks8(0), _rxCapture(false), _receiving(false), _rxLevel(1), _numFramingErrors(0), _peeked(-1),
+      _txActive(false)
+    {
+    }
+
+    // false if all the compare channels are used, baud is out of range, or the RX pin is neither ICP1 nor a
+    // pin-change interrupt pin
+    bool begin(const uint32_t& baud)
+    {
+      if ( (baud < 600) || (baud > 115200) )
+        return false;
+
+      if ( (_rxPin != TISR_SOFTSERIAL_NO_PIN) && !isRxPinUsable() )
+        return false;
+
+      end();
+
+      for (uint8_t channel = 0; channel < TISR_SOFTSERIAL_MAX_PORTS; channel++)
+      {
+        if (TISR_SoftSerialPorts[channel] == NULL)
+        {
+          _channel = channel;
+          break;
+        }
+      }
+
+      if (_channel == 0xFF)
+        return false;
+
+      // Bit time in ticks, Q8, e.g. 34.72 ticks at 57600 baud and 16MHz
+      _bitTicks8 = ( (uint32_t) TISR_SOFTSERIAL_TICK_HZ * 256 + baud / 2 ) / baud;
+
+      beginTimer();
+
+      _ocr        = (_channel == 0) ? &OCR1A : &OCR1B;
+      _comShift   = (_channel == 0) ? COM1A0 : COM1B0;
+      _ocBit      = (_channel == 0) ? OCIE1A : OCIE1B;
+      _txHardware = (_txPin == ( (_channel == 0) ? TISR_SOFTSERIAL_OC1A_PIN : TISR_SOFTSERIAL_OC1B_PIN ));
+
+#if defined(OCR1C)
+      if (_channel == 2)
+      {
+        _ocr        = &OCR1C;
+        _comShift   = COM1C0;
+        _ocBit      = OCIE1C;
+        _txHardware = (_txPin == TISR_SOFTSERIAL_OC1C_PIN);
+      }
+#endif
+
+      if (_txPin != TISR_SOFTSERIAL_NO_PIN)
+        beginTx();
+
+      if (_rxPin != TISR_SOFTSERIAL_NO_PIN)
+        beginRx();
+
+      TISR_SoftSerialPorts[_channel] = this;
+
+      return true;
+    }
+
+    void end()
+    {
+      if (_channel == 0xFF)
+        return;
+
+      flush();
+
+      uint8_t sreg = SREG;
+      cli();
+
+      TIMSK1 &= ~_BV(_ocBit);
+      TCCR1A &= ~(3 << _comShift);
+
+      if (_rxCapture)
+        TIMSK1 &= ~_BV(ICIE1);
+      else if ( (_rxPin != TISR_SOFTSERIAL_NO_PIN) && (digitalPinToPCMSK(_rxPin) != NULL) )
+        *digitalPinToPCMSK(_rxPin) &= ~_BV(digitalPinToPCMSKbit(_rxPin));
+
+      TISR_SoftSerialPorts[_channel] = NULL;
+
+      SREG = sreg;
+
+      _channel    = 0xFF;
+      _rxCapture  = false;
+    }
+
+    ///////////////////////////////////////////
+
+    virtual int available()
+    {
+      checkFrameEnd();
+
+      return _rxBuffer.getNumQueued() + ( (_peeked >= 0) ? 1 : 0 );
+    }
+
+    virtual int read()
+    {
+      uint8_t data;
+
+      if (_peeked >= 0)
+      {
+        data    = _peeked;
+        _peeked = -1;
+
+        return data;
+      }
+
+      checkFrameEnd();
+
+      return _rxBuffer.pop(data) ? data : -1;
+    }
+
+    virtual int peek()
+    {
+      if (_peeked < 0)
+        _peeked = read();
+
+      return _peeked;
+    }
+
+    // Waits while the TX buffer is full
+    virtual size_t write(uint8_t data)
+    {
+      if (_txPin == TISR_SOFTSERIAL_NO_PIN)
+        return 0;
+
+      while (_txBuffer.getNumQueued() >= TISR_SOFTSERIAL_TX_BUFFER_SIZE - 1);
+
+      _txBuffer.push(data);
+
+      uint8_t sreg = SREG;
+      cli();
+
+      if (!_txActive)
+        startTx();
+
+      SREG = sreg;
+
+      return 1;
+    }
+
+    // Waits until the last stop bit is out
+    virtual void flush()
+    {
+      while (_txActive);
+    }
+
+    using Print::write;
+
+    // Bytes whose stop bit was LOW, i.e. wrong baud rate or noise. They are dropped
+    uint32_t getNumFramingErrors() const
+    {
+      uint32_t numFramingErrors;
+
+      do
+      {
+        numFramingErrors = _numFramingErrors;
+      } while (numFramingErrors != _numFramingErrors);
+
+      return numFramingErrors;
+    }
+
+    // Bytes lost because the RX buffer was full
+    uint32_t getNumOverruns() const
+    {
+      return _rxBuffer.getNumDropped();
+    }
+
+    // TX switched by the compare unit, RX timestamped by the capture unit
+    bool isTxHardware() const
+    {
+      return _txHardware && (_txPin != TISR_SOFTSERIAL_NO_PIN);
+    }
+
+    bool isRxCapture() const
+    {
+      return _rxCapture;
+    }
+
+    ///////////////////////////////////////////
+
+    // 32-bit Timer1 time base, in ticks. With interrupts disabled, e.g. from an ISR
+    static uint32_t getTicksNoInterrupts()
+    {
+      uint16_t ticks      = TCNT1;
+      uint16_t overflows  = TISR_SoftSerialOverflows;
+
+      // Overflowed, but its ISR didn't run yet
+      if ( (TIFR1 & _BV(TOV1)) && (ticks < 0x8000) )
+        overflows++;
+
+      return ( (uint32_t) overflows << 16) | ticks;
+    }
+
+    static uint32_t getTicks()
+    {
+      uint8_t sreg = SREG;
+      cli();
+
+      uint32_t ticks = getTicksNoInterrupts();
+
+      SREG = sreg;
+
+      return ticks;
+    }
+
+    ///////////////////////////////////////////
+
+    // Compare match of the channel : an edge of the TX line was just output
+    void onCompare()
+    {
+      if (!_txHardware)
+      {
+        if (_txLevel)
+          *_txPort |= _txMask;
+        else
+          *_txPort &= ~_txMask;
+      }
+
+      uint8_t bit;
+
+      if (_txBit >= 10)
+      {
+        // End of a stop bit with nothing queued when it started
+        uint8_t data;
+
+        if (!_txBuffer.pop(data))
+        {
+          TIMSK1 &= ~_BV(_ocBit);
+          _txActive = false;
+
+          return;
+        }
+
+        _txFrame  = ( (uint16_t) data << 1 ) | 0x200;
+        _txStart8 = (uint32_t) ( (uint16_t) (TCNT1 + TISR_SOFTSERIAL_TX_LEAD_TICKS) ) << 8;
+        bit       = 0;
+      }
+      else
+      {
+        // Next bit at another level, one interrupt per edge
+        bit = _txBit;
+
+        do
+        {
+          bit++;
+        } while ( (bit < 10) && ( ( (_txFrame >> bit) & 1 ) == _txLevel ) );
+
+        if (bit == 10)
+        {
+          uint8_t data;
+
+          _txStart8 += 10 * _bitTicks8;
+
+          if (_txBuffer.pop(data))
+          {
+            // Back to back, the start bit right after the stop bit
+            _txFrame  = ( (uint16_t) data << 1 ) | 0x200;
+            bit       = 0;
+          }
+        }
+      }
+
+      _txBit    = bit;
+      _txLevel  = (bit >= 10) ? 1 : ( (_txFrame >> bit) & 1 );
+
+      *_ocr = (uint16_t) ( ( _txStart8 + ( (bit >= 10) ? 0 : bit * _bitTicks8 ) ) >> 8 );
+
+      if (_txHardware)
+        TCCR1A = (TCCR1A & ~(3 << _comShift)) | ( (_txLevel ? 3 : 2) << _comShift );
+    }
+
+    // Edge on the RX line at ticks, level after the edge
+    void onEdge(const uint32_t& ticks, const uint8_t& level)
+    {
+      if (_receiving)
+      {
+        // Bits whose middle is before this edge had the level before it
+        uint32_t elapsed8 = getElapsed8(ticks);
+
+        while (elapsed8 > _rxNextMiddle8)
+        {
+          receiveBit(_rxLevel);
+
+          if (!_receiving)
+            break;
+        }
+      }
+
+      if (!_receiving && (level == 0))
+      {
+        // Start bit
+        _receiving      = true;
+        _rxStart        = ticks;
+        _rxBit          = 1;
+        _rxData         = 0;
+        _rxNextMiddle8  = _bitTicks8 + _bitTicks8 / 2;
+      }
+
+      _rxLevel = level;
+    }
+
+    // Pin change interrupt of the RX pin's group, at ticks
+    void onPinChange(const uint32_t& ticks)
+    {
+      uint8_t level = (*_rxPort & _rxMask) ? 1 : 0;
+
+      if (level != _rxLevel)
+        onEdge(ticks, level);
+    }
+
+    uint8_t getRxPin() const
+    {
+      return _rxPin;
+    }
+
+    ///////////////////////////////////////////
+
+  private:
+
+    static void beginTimer()
+    {
+      for (uint8_t channel = 0; channel < TISR_SOFTSERIAL_MAX_PORTS; channel++)
+      {
+        if (TISR_SoftSerialPorts[channel] != NULL)
+          return;
+      }
+
+      uint8_t sreg = SREG;
+      cli();
+
+      // Normal mode, free running at F_CPU / 8
+      TCCR1A  = 0;
+      TCCR1B  = _BV(CS11);
+      TIFR1   = _BV(TOV1);
+      TIMSK1  = _BV(TOIE1);
+
+      SREG = sreg;
+    }
+
+    void beginTx()
+    {
+      _txPort   = portOutputRegister(digitalPinToPort(_txPin));
+      _txMask   = digitalPinToBitMask(_txPin);
+      _txBit    = 10;
+      _txLevel  = 1;
+
+      digitalWrite(_txPin, HIGH);
+      pinMode(_txPin, OUTPUT);
+
+      if (_txHardware)
+      {
+        // Set on match, forced once : the compare unit drives the pin, idle HIGH
+        TCCR1A |= (3 << _comShift);
+        TCCR1C  = _BV(FOC1A - (COM1A0 - _comShift) / 2);
+      }
+    }
+
+    // Most pins of the 32u4 and the Mega have no pin-change interrupt : digitalPinToPCICR() is then NULL
+    bool isRxPinUsable() const
+    {
+#if defined(TISR_SOFTSERIAL_ICP_PIN)
+      // ICP1 free, or already ours
+      if ( (_rxPin == TISR_SOFTSERIAL_ICP_PIN) && ( _rxCapture || !(TIMSK1 & _BV(ICIE1)) ) )
+        return true;
+#endif
+
+      return (digitalPinToPCICR(_rxPin) != NULL) && (digitalPinToPCMSK(_rxPin) != NULL);
+    }
+
+    void beginRx()
+    {
+      pinMode(_rxPin, INPUT_PULLUP);
+
+      _rxPort   = portInputRegister(digitalPinToPort(_rxPin));
+      _rxMask   = digitalPinToBitMask(_rxPin);
+      _rxLevel  = (*_rxPort & _rxMask) ? 1 : 0;
+
+      uint8_t sreg = SREG;
+      cli();
+
+#if defined(TISR_SOFTSERIAL_ICP_PIN)
+      if ( (_rxPin == TISR_SOFTSERIAL_ICP_PIN) && !(TIMSK1 & _BV(ICIE1)) )
+      {
+        _rxCapture  = true;
+
+        // Next edge to capture is the opposite of the current level
+        if (_rxLevel)
+          TCCR1B &= ~_BV(ICES1);
+        else
+          TCCR1B |= _BV(ICES1);
+
+        TIFR1   = _BV(ICF1);
+        TIMSK1 |= _BV(ICIE1);
+      }
+      else
+#endif
+      {
+        *digitalPinToPCICR(_rxPin) |= _BV(digitalPinToPCICRbit(_rxPin));
+        *digitalPinToPCMSK(_rxPin) |= _BV(digitalPinToPCMSKbit(_rxPin));
+      }
+
+      SREG = sreg;
+    }
+
+    // With interrupts disabled
+    void startTx()
+    {
+      uint8_t data;
+
+      if (!_txBuffer.pop(data))
+        return;
+
+      _txFrame  = ( (uint16_t) data << 1 ) | 0x200;
+      _txBit    = 0;
+      _txLevel  = 0;
+      _txStart8 = (uint32_t) ( (uint16_t) (TCNT1 + TISR_SOFTSERIAL_TX_LEAD_TICKS) ) << 8;
+
+      *_ocr = (uint16_t) (_txStart8 >> 8);
+
+      // Clear on match for the start bit
+      if (_txHardware)
+        TCCR1A = (TCCR1A & ~(3 << _comShift)) | (2 << _comShift);
+
+      TIFR1     = _BV(_ocBit);
+      TIMSK1   |= _BV(_ocBit);
+      _txActive = true;
+    }
+
+    // Data bits 1 - 8, LSB first, then the stop bit 9
+    void receiveBit(const uint8_t& level)
+    {
+      if (_rxBit <= 8)
+      {
+        _rxData >>= 1;
+
+        if (level)
+          _rxData |= 0x80;
+      }
+      else
+      {
+        if (level)
+          _rxBuffer.push(_rxData);
+        else
+          _numFramingErrors = _numFramingErrors + 1;
+
+        _receiving = false;
+      }
+
+      _rxBit++;
+      _rxNextMiddle8 += _bitTicks8;
+    }
+
+    // Q8 ticks since the start bit, saturated
+    uint32_t getElapsed8(const uint32_t& ticks) const
+    {
+      uint32_t elapsed = ticks - _rxStart;
+
+      return (elapsed < 0x10000UL) ? (elapsed << 8) : 0xFFFFFFFFUL;
+    }
+
+    // The bits after the last edge of a frame, once its stop bit is over
+    void checkFrameEnd()
+    {
+      uint8_t sreg = SREG;
+      cli();
+
+      // Past the middle of the stop bit
+      if (_receiving && ( getElapsed8(getTicksNoInterrupts()) > 9 * _bitTicks8 + _bitTicks8 / 2 ) )
+      {
+        while (_receiving)
+          receiveBit(_rxLevel);
+      }
+
+      SREG = sreg;
+    }
+
+    uint8_t                 _rxPin;
+    uint8_t                 _txPin;
+    uint8_t                 _channel;
+    uint32_t                _bitTicks8;       // Q8
+
+    // RX, written by the edge ISR
+    volatile uint8_t*       _rxPort;
+    uint8_t                 _rxMask;
+    bool                    _rxCapture;
+    volatile bool           _receiving;
+    uint8_t                 _rxLevel;
+    uint8_t                 _rxBit;
+    uint8_t                 _rxData;
+    uint32_t                _rxStart;
+    uint32_t                _rxNextMiddle8;   // Q8, from _rxStart
+    volatile uint32_t       _numFramingErrors;
+    int16_t                 _peeked;
+
+    TISR_SpscRing<uint8_t, TISR_SOFTSERIAL_RX_BUFFER_SIZE>  _rxBuffer;
+
+    // TX, written by the compare ISR
+    volatile uint16_t*      _ocr;
+    uint8_t                 _comShift;
+    uint8_t                 _ocBit;
+    bool                    _txHardware;
+    volatile uint8_t*       _txPort;
+    uint8_t                 _txMask;
+    uint16_t                _txFrame;         // start bit 0, data 1 - 8, stop bit 9
+    uint8_t                 _txBit;           // bit of the edge scheduled in the compare register, 10 : frame end
+    uint8_t                 _txLevel;         // level of that edge
+    uint32_t                _txStart8;        // Q8 ticks of the frame start, modulo 2^16 ticks
+    volatile bool           _txActive;
+
+    TISR_SpscRing<uint8_t, TISR_SOFTSERIAL_TX_BUFFER_SIZE>  _txBuffer;
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_SOFTSERIAL_INSTANTIATED
+#define TISR_SOFTSERIAL_INSTANTIATED      // To force pre-instatiate only once
+
+  TISR_SoftSerial*  TISR_SoftSerialPorts[TISR_SOFTSERIAL_MAX_PORTS] = { NULL };
+  volatile uint16_t TISR_SoftSerialOverflows = 0;
+
+  ISR(TIMER1_OVF_vect)
+  {
+    TISR_SoftSerialOverflows++;
+  }
+
+  ISR(TIMER1_COMPA_vect)
+  {
+    if (TISR_SoftSerialPorts[0])
+      TISR_SoftSerialPorts[0]->onCompare();
+  }
+
+  ISR(TIMER1_COMPB_vect)
+  {
+    if (TISR_SoftSerialPorts[1])
+      TISR_SoftSerialPorts[1]->onCompare();
+  }
+
+  #if defined(OCR1C)
+    ISR(TIMER1_COMPC_vect)
+    {
+      if (TISR_SoftSerialPorts[2])
+        TISR_SoftSerialPorts[2]->onCompare();
+    }
+  #endif
+
+  #if defined(TISR_SOFTSERIAL_ICP_PIN)
+    ISR(TIMER1_CAPT_vect)
+    {
+      uint16_t  captured  = ICR1;
+      uint16_t  overflows = TISR_SoftSerialOverflows;
+      uint8_t   level     = (TCCR1B & _BV(ICES1)) ? 1 : 0;
+
+      if ( (TIFR1 & _BV(TOV1)) && (captured < 0x8000) )
+        overflows++;
+
+      // Other edge next, the flag cleared after changing the edge
+      TCCR1B ^= _BV(ICES1);
+      TIFR1   = _BV(ICF1);
+
+      for (uint8_t channel = 0; channel < TISR_SOFTSERIAL_MAX_PORTS; channel++)
+      {
+        TISR_SoftSerial* port = TISR_SoftSerialPorts[channel];
+
+        if (port && port->isRxCapture())
+          port->onEdge( ( (uint32_t) overflows << 16 ) | captured, level );
+      }
+    }
+  #endif
+
+  // Time first, then every RX port of the group checks its pin
+  #define TISR_SOFTSERIAL_PCINT_ISR(vector, group)                                          \
+    ISR(vector)                                                                             \
+    {                                                                                       \
+      uint32_t ticks = TISR_SoftSerial::getTicksNoInterrupts();                             \
+                                                                                            \
+      for (uint8_t channel = 0; channel < TISR_SOFTSERIAL_MAX_PORTS; channel++)             \
+      {                                                                                     \
+        TISR_SoftSerial* port = TISR_SoftSerialPorts[channel];                              \
+                                                                                            \
+        if ( port && !port->isRxCapture() && (port->getRxPin() != TISR_SOFTSERIAL_NO_PIN)   \
+             && (digitalPinToPCICRbit(port->getRxPin()) == group) )                         \
+          port->onPinChange(ticks);                                                         \
+      }                                                                                     \
+    }
+
+  #if defined(PCINT0_vect)
+    TISR_SOFTSERIAL_PCINT_ISR(PCINT0_vect, 0)
+  #endif
+
+  #if defined(PCINT1_vect)
+    TISR_SOFTSERIAL_PCINT_ISR(PCINT1_vect, 1)
+  #endif
+
+  #if defined(PCINT2_vect)
+    TISR_SOFTSERIAL_PCINT_ISR(PCINT2_vect, 2)
+  #endif
+
+#endif    // TISR_SOFTSERIAL_INSTANTIATED
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_SOFTSERIAL_H
@@ -0,0 +1,153 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Solvers.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Prescaler / compare value solvers of the hardware timer backends, as plain functions of the timer clock and of the
+  requested frequency or period. Included by the backends, which then program the registers with the results.
+
+  No register, no Arduino dependency : extras/benchmark/ISR_Timer_Benchmark.cpp compiles these very functions on the
+  host to measure them.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_SOLVERS_H
+#define TIMERINTERRUPT_GENERIC_SOLVERS_H
+
+#include <stdint.h>
+#include <math.h>
+
+///////////////////////////////////////////
+
+// AVR, TimerInterrupt::setFrequency(). Indexes in the prescaler tables of AVRTimerInterrupt_Generic.h :
+// { -, 1, 8, 64, 256, 1024 }, and { -, 1, 8, 32, 64, 128, 256, 1024 } for the 8-bit Timer2.
+// First index tried, from frequencyLimit = frequency * 17179.840
+inline int tisr_solver_avr_first_index(const float& frequencyLimit, const bool& isTimer2)
+{
+  if (frequencyLimit > 64)
+    return 1;
+
+  if (frequencyLimit > 8)
+    return 2;
+
+  if (isTimer2 && (frequencyLimit > 2))
+    return 3;
+
+  return isTimer2 ? 4 : 3;
+}
+
+// Smallest prescaler, from firstIndex to lastIndex, whose OCRValue is less than 16384 rounds of a maxCount counter.
+// Returns its index, -1 if none fits : OCRValue is then the one of lastIndex
+inline int tisr_solver_avr(const uint32_t& cpuHz, const float& frequency, const unsigned int* prescalerDiv,
+                           const int& firstIndex, const int& lastIndex, const uint16_t& maxCount, unsigned long& OCRValue)
+{
+  for (int prescalerIndex = firstIndex; prescalerIndex <= lastIndex; prescalerIndex++)
+  {
+    OCRValue = cpuHz / (frequency * prescalerDiv[prescalerIndex]) - 1;
+
+    // Very large OCRValue, counted down by min(maxCount, remaining) at every ISR, for long timers on small counters.
+    // Around 16 * 1024 rounds at most, for accuracy
+    if ( (OCRValue / maxCount) < 16384 )
+      return prescalerIndex;
+  }
+
+  return -1;
+}
+
+///////////////////////////////////////////
+
+// SAMD, SAMDTimerInterrupt::setPeriod_TIMER_xxx(), period in us. Returns the prescaler, 1 to 1024, prescalerField
+// its TC / TCC CTRLA.PRESCALER value, 0 to 7
+inline uint16_t tisr_solver_samd(const uint32_t& timerHz, const float& period, uint8_t& prescalerField, int& compareValue)
+{
+  static const uint16_t prescalers[8] = { 1, 2, 4, 8, 16, 64, 256, 1024 };
+
+  if (period > 300000)
+    prescalerField = 7;
+  else if (period > 80000)
+    prescalerField = 6;
+  else if (period > 20000)
+    prescalerField = 5;
+  else if (period > 10000)
+    prescalerField = 4;
+  else if (period > 5000)
+    prescalerField = 3;
+  else if (period > 2500)
+    prescalerField = 2;
+  else if (period > 1000)
+    prescalerField = 1;
+  else
+    prescalerField = 0;
+
+  uint16_t prescaler = prescalers[prescalerField];
+
+  compareValue = (int) (timerHz / (prescaler / (period / 1000000.0))) - 1;
+
+  return prescaler;
+}
+
+///////////////////////////////////////////
+
+// SAM DUE, DueTimerInterrupt::bestClock(), thanks to Ogle Basil Hall. Index 0 to 3 of the MCK divisors
+// { 2, 8, 32, 128 } (TIMER_CLOCK1 to 4) with the least error, retRC its compare value
+inline uint8_t tisr_solver_due(const uint32_t& masterHz, const double& frequency, uint32_t& retRC)
+{
+  static const uint8_t divisors[4] = { 2, 8, 32, 128 };
+
+  float ticks;
+  float error;
+  int clkId       = 3;
+  int bestClock   = 3;
+  float bestError = 9.999e99;
+
+  do
+  {
+    ticks = (float) masterHz / frequency / (float) divisors[clkId];
+
+    // Error comparison needs scaling
+    error = divisors[clkId] * fabsf(ticks - roundf(ticks));
+
+    if (error < bestError)
+    {
+      bestClock = clkId;
+      bestError = error;
+    }
+  } while (clkId-- > 0);
+
+  ticks = (float) masterHz / frequency / (float) divisors[bestClock];
+  retRC = (uint32_t) roundf(ticks);
+
+  return (uint8_t) bestClock;
+}
+
+///////////////////////////////////////////
+
+// Teensy 4.x FlexPWM, TeensyTimerInterrupt::setInterval(), interval in us. Returns the count, prescale the clock
+// shift, 0 to 7. Past 32767 << 7, the longest period is used
+inline uint32_t tisr_solver_teensy4(const uint32_t& busHz, const float& interval, uint32_t& prescale)
+{
+  uint32_t period = ( (float) busHz / 2000000 ) * interval;
+
+  prescale = 0;
+
+  while (period > 32767)
+  {
+    period = period >> 1;
+
+    if (++prescale > 7)
+    {
+      prescale  = 7;
+      period    = 32767;
+      break;
+    }
+  }
+
+  return period;
+}
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_SOLVERS_H
@@ -0,0 +1,321 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Stack.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Optional interrupt stack depth watermarking, per timer source.
+
+  Define TISR_STACK_ENABLE true before #include "TimerInterrupt_Generic.h" / "ISR_Timer_Generic.h" to compile it in.
+  Otherwise all TISR_STACK_xxx macros are empty and there is no RAM or cycle cost.
+
+  1) Per source depth   : on entry to a dispatch, the SP is sampled and the TISR_STACK_MAX_DEPTH bytes below it are
+                          painted. On exit, the painted area is scanned from the bottom up, and the deepest overwritten
+                          byte gives the stack depth used by the callback. The worst depth is kept per source :
+                          hardware timer ISRs (AVR / megaAVR automatically, TISR_STACK_HW_TIMER(n)) and ISR_Timer slots
+                          (TISR_STACK_CALLBACK(n)). Depths of TISR_STACK_MAX_DEPTH mean the callback went deeper than
+                          the painted area
+  2) Whole stack        : paint() fills the free interrupt stack once at boot, getUnusedBytes() returns how much of it
+                          was never touched since, by anything. The interrupt stack is the main stack on AVR and on
+                          Cortex-M without RTOS, the MSP on Cortex-M with RTOS (PSP in use), and the ISR stack of the
+                          calling core on ESP32 (Xtensa). Not available on the other platforms
+
+  Painting costs time in every instrumented dispatch, this is a development tool. The per source painting stops at the
+  area of paint(), so as not to erase its watermark, and on AVR at the heap end : a dispatch whose SP is already close
+  to or inside that area gets a depth of 0, or the depth down to its start. On the other platforms, the
+  TISR_STACK_MAX_DEPTH bytes below the SP must be free stack, not heap. Nested higher priority ISRs are accounted to
+  the source they interrupted.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_STACK_H
+#define TIMERINTERRUPT_GENERIC_STACK_H
+
+#ifndef TISR_STACK_ENABLE
+  #define TISR_STACK_ENABLE     false
+#endif
+
+#define TISR_STACK_MAX_HW_TIMERS        8
+#define TISR_STACK_MAX_CALLBACKS        16
+
+#define TISR_STACK_HW_TIMER(timerNo)    ( (timerNo) % TISR_STACK_MAX_HW_TIMERS )
+#define TISR_STACK_CALLBACK(numTimer)   ( TISR_STACK_MAX_HW_TIMERS + ( (numTimer) % TISR_STACK_MAX_CALLBACKS ) )
+
+#define TISR_STACK_NUM_SOURCES          ( TISR_STACK_MAX_HW_TIMERS + TISR_STACK_MAX_CALLBACKS )
+
+///////////////////////////////////////////
+
+#if TISR_STACK_ENABLE
+
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#define TISR_STACK_PATTERN              0xA5
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+
+  #ifndef TISR_STACK_MAX_DEPTH
+    #define TISR_STACK_MAX_DEPTH        128
+  #endif
+
+  // Bytes right below the SP left unpainted, so depths under it read as 0
+  #define TISR_STACK_MARGIN             2
+
+  typedef uint8_t   tisr_stack_word_t;
+
+  #define TISR_STACK_PATTERN_WORD       ( (tisr_stack_word_t) TISR_STACK_PATTERN )
+
+  extern char* __brkval;
+  extern char  __heap_start;
+
+  static inline __attribute__((always_inline)) uintptr_t tisr_stack_pointer()
+  {
+    return (uintptr_t) SP;
+  }
+
+#else
+
+  #ifndef TISR_STACK_MAX_DEPTH
+    #define TISR_STACK_MAX_DEPTH        1024
+  #endif
+
+  #if defined(__XTENSA__)
+    // Register window spills of the caller go to the 16 bytes below its SP at any time
+    #define TISR_STACK_MARGIN           16
+  #elif defined(__x86_64__)
+    // Red zone
+    #define TISR_STACK_MARGIN           128
+  #else
+    #define TISR_STACK_MARGIN           8
+  #endif
+
+  typedef uint32_t  tisr_stack_word_t;
+
+  #define TISR_STACK_PATTERN_WORD       ( (tisr_stack_word_t) 0xA5A5A5A5UL )
+
+  static inline __attribute__((always_inline)) uintptr_t tisr_stack_pointer()
+  {
+    uintptr_t sp;
+
+  #if defined(__arm__)
+    __asm__ volatile ("mov %0, sp" : "=r" (sp));
+  #elif defined(__XTENSA__)
+    __asm__ volatile ("mov %0, a1" : "=r" (sp));
+  #elif defined(__riscv)
+    __asm__ volatile ("mv %0, sp" : "=r" (sp));
+  #elif defined(__x86_64__)
+    // Host builds
+    __asm__ volatile ("mov %%rsp, %0" : "=r" (sp));
+  #else
+    #error TISR_STACK_ENABLE is not supported on this platform
+  #endif
+
+    return sp & ~(uintptr_t) (sizeof(tisr_stack_word_t) - 1);
+  }
+
+#endif
+
+#if defined(__arm__)
+  // Current heap end, from the newlib syscalls of the core
+  extern "C" void* _sbrk(int);
+#endif
+
+#if ( defined(ESP32) || ESP32 ) && defined(__XTENSA__)
+  // ISR stacks of both cores, from the FreeRTOS port. Weak, so an ESP-IDF version without it just disables paint()
+  extern "C" uint8_t port_IntStack[] __attribute__((weak));
+#endif
+
+///////////////////////////////////////////
+
+class TISR_StackWatermark
+{
+  public:
+
+    TISR_StackWatermark() : _paintBottom(0), _paintTop(0)
+    {
+      reset();
+    }
+
+    void reset()
+    {
+      for (uint8_t i = 0; i < TISR_STACK_NUM_SOURCES; i++)
+        _maxDepth[i] = 0;
+    }
+
+    ///////////////////////////////////////////
+
+    // Called by TISR_STACK_BEGIN, must be inlined so the SP is the one of the dispatching code
+    inline __attribute__((always_inline)) uintptr_t onEntry()
+    {
+      uintptr_t sp = tisr_stack_pointer();
+
+      volatile tisr_stack_word_t* word = (volatile tisr_stack_word_t*) getDepthBottom(sp);
+      volatile tisr_stack_word_t* end  = (volatile tisr_stack_word_t*) (sp - TISR_STACK_MARGIN);
+
+      // volatile, so the compiler can't turn it into a memset() call, whose frame would be in the painted area
+      while (word < end)
+        *word++ = TISR_STACK_PATTERN_WORD;
+
+      return sp;
+    }
+
+    void TISR_ATOMIC_IRAM_ATTR onExit(const uint8_t& source, const uintptr_t& sp)
+    {
+      const volatile tisr_stack_word_t* word = (const volatile tisr_stack_word_t*) getDepthBottom(sp);
+      const volatile tisr_stack_word_t* end  = (const volatile tisr_stack_word_t*) (sp - TISR_STACK_MARGIN);
+
+      while ( (word < end) && (*word == TISR_STACK_PATTERN_WORD) )
+        word++;
+
+      uint16_t depth = (word < end) ? (uint16_t) (sp - (uintptr_t) word) : 0;
+
+      if ( (source < TISR_STACK_NUM_SOURCES) && (depth > _maxDepth[source]) )
+        _maxDepth[source] = depth;
+    }
+
+    ///////////////////////////////////////////
+
+    // Worst stack depth, in bytes, used by one source since boot / reset()
+    uint16_t getMaxDepth(const uint8_t& source) const
+    {
+      return (source < TISR_STACK_NUM_SOURCES) ? _maxDepth[source] : 0;
+    }
+
+    // Worst over all sources
+    uint16_t getMaxDepth() const
+    {
+      uint16_t depth = 0;
+
+      for (uint8_t i = 0; i < TISR_STACK_NUM_SOURCES; i++)
+      {
+        if (_maxDepth[i] > depth)
+          depth = _maxDepth[i];
+      }
+
+      return depth;
+    }
+
+    ///////////////////////////////////////////
+
+    // Paints the free part of the interrupt stack. Call once from setup(), after the big heap allocations.
+    // Returns the number of bytes painted, 0 if not supported
+    uint32_t paint()
+    {
+      uintptr_t bottom  = 0;
+      uintptr_t top     = 0;
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+
+      bottom  = (__brkval == 0) ? (uintptr_t) &__heap_start : (uintptr_t) __brkval;
+      top     = tisr_stack_pointer() - TISR_STACK_MAX_DEPTH;
+
+#elif defined(__arm__)
+
+      uint32_t control;
+
+      __asm__ volatile ("mrs %0, control" : "=r" (control));
+
+      if (control & 0x02)
+      {
+        // PSP in use (RTOS), the MSP only serves the ISRs. Without its limit from the linker, stay on the safe side
+        uintptr_t msp;
+
+        __asm__ volatile ("mrs %0, msp" : "=r" (msp));
+
+        top     = msp - TISR_STACK_MARGIN;
+        bottom  = (msp > TISR_STACK_MAX_DEPTH) ? (msp - TISR_STACK_MAX_DEPTH) : 0;
+      }
+      else
+      {
+        // Main stack, grows down towards the heap
+        bottom  = (uintptr_t) _sbrk(0);
+        top     = tisr_stack_pointer() - TISR_STACK_MAX_DEPTH;
+      }
+
+#elif ( defined(ESP32) || ESP32 ) && defined(__XTENSA__) && defined(configISR_STACK_SIZE)
+
+      if (port_IntStack != NULL)
+      {
+        bottom  = (uintptr_t) &port_IntStack[xPortGetCoreID() * configISR_STACK_SIZE];
+        top     = bottom + configISR_STACK_SIZE - TISR_STACK_MARGIN;
+      }
+
+#endif
+
+      bottom  = (bottom + sizeof(tisr_stack_word_t) - 1) & ~(uintptr_t) (sizeof(tisr_stack_word_t) - 1);
+      top    &= ~(uintptr_t) (sizeof(tisr_stack_word_t) - 1);
+
+      if (top <= bottom)
+        return 0;
+
+      // No need to mask interrupts : when this runs, no ISR of this core is using the area
+      for (volatile tisr_stack_word_t* word = (volatile tisr_stack_word_t*) bottom; word < (tisr_stack_word_t*) top; word++)
+        *word = TISR_STACK_PATTERN_WORD;
+
+      _paintBottom  = bottom;
+      _paintTop     = top;
+
+      return (uint32_t) (top - bottom);
+    }
+
+    // Bytes of the area painted by paint() never touched since. 0 if paint() wasn't called or isn't supported
+    uint32_t getUnusedBytes() const
+    {
+      const volatile tisr_stack_word_t* word = (const volatile tisr_stack_word_t*) _paintBottom;
+
+      while ( ( (uintptr_t) word < _paintTop ) && (*word == TISR_STACK_PATTERN_WORD) )
+        word++;
+
+      return (uint32_t) ( (uintptr_t) word - _paintBottom );
+    }
+
+  private:
+
+    // Start of the area painted below sp by onEntry() : not inside the one of paint(), nor the heap on AVR
+    inline __attribute__((always_inline)) uintptr_t getDepthBottom(const uintptr_t& sp) const
+    {
+      uintptr_t bottom = (sp > TISR_STACK_MAX_DEPTH) ? (sp - TISR_STACK_MAX_DEPTH) : 0;
+
+      if ( (bottom < _paintTop) && (sp > _paintBottom) )
+        bottom = _paintTop;
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+      uintptr_t heapEnd = (__brkval == 0) ? (uintptr_t) &__heap_start : (uintptr_t) __brkval;
+
+      if (bottom < heapEnd)
+        bottom = heapEnd;
+#endif
+
+      return bottom;
+    }
+
+    volatile uint16_t   _maxDepth[TISR_STACK_NUM_SOURCES];
+
+    uintptr_t           _paintBottom;
+    uintptr_t           _paintTop;
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_STACK_INSTANTIATED
+  // To force pre-instatiate only once
+  #define TISR_STACK_INSTANTIATED
+  TISR_StackWatermark TISR_Stack;
+#endif
+
+///////////////////////////////////////////
+
+#define TISR_STACK_BEGIN(sp)                uintptr_t sp = TISR_Stack.onEntry()
+#define TISR_STACK_END(source, sp)          TISR_Stack.onExit((source), (sp))
+
+#else   // TISR_STACK_ENABLE
+
+#define TISR_STACK_BEGIN(sp)
+#define TISR_STACK_END(source, sp)
+
+#endif  // TISR_STACK_ENABLE
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_STACK_H
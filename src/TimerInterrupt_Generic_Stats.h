@@ -0,0 +1,249 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Stats.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Optional per-timer runtime statistics, for the hardware timers and for every ISR_Timer slot.
+
+  Define TISR_STATS_ENABLE true before #include "TimerInterrupt_Generic.h" / "ISR_Timer_Generic.h" to compile them in.
+  Otherwise all TISR_STATS_xxx macros are empty and there is no RAM or cycle cost.
+
+  Each stats block keeps, with O(1) update cost :
+  1) count              : number of callback invocations
+  2) missed             : periods missed or coalesced into one invocation
+  3) durMin/Max/Sum     : callback duration, in TISR_CYCLES() counts (TISR_CYCLES_HZ)
+  4) lateMin/Max        : lateness of the invocation
+                          ISR_Timer slots   : ms between the due time and the run() that served it
+                          Hardware timers   : TISR_CYCLES() counts between the measured and the expected period.
+                                              Recorded only once the expected period is known (set by the AVR / megaAVR
+                                              backends, or with TISR_HwStats[n].setExpectedPeriod() for the others)
+
+  Read with getSnapshot() from loop(). The copy is taken with interrupts masked, so it's always consistent.
+
+  TISR_CYCLES() is started by tisr_cycles_init() (e.g. the DWT cycle counter of Cortex-M3 and up), else all durations
+  and latenesses read 0. The ISR_Timer slots and TISR_STATS_HW_SET_FREQUENCY() call it. With setExpectedPeriod() only,
+  call it in setup().
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_STATS_H
+#define TIMERINTERRUPT_GENERIC_STATS_H
+
+#ifndef TISR_STATS_ENABLE
+  #define TISR_STATS_ENABLE     false
+#endif
+
+///////////////////////////////////////////
+
+#if TISR_STATS_ENABLE
+
+#include <string.h>
+
+#include "TimerInterrupt_Generic_Cycles.h"
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#ifndef TISR_STATS_MAX_HW_TIMERS
+  // Hardware timer numbers 0 - 7
+  #define TISR_STATS_MAX_HW_TIMERS      8
+#endif
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+  typedef uint32_t  tisr_stats_sum_t;
+#else
+  typedef uint64_t  tisr_stats_sum_t;
+#endif
+
+///////////////////////////////////////////
+
+typedef struct
+{
+  uint32_t          count;
+  uint32_t          missed;
+  uint32_t          durMin;
+  uint32_t          durMax;
+  tisr_stats_sum_t  durSum;
+  int32_t           lateMin;
+  int32_t           lateMax;
+} tisr_timer_stats_t;
+
+///////////////////////////////////////////
+
+class TISR_TimerStats
+{
+  public:
+
+    TISR_TimerStats()
+    {
+      TISR_ATOMIC_MUX_INIT(_lock);
+
+      reset();
+    }
+
+    void TISR_ATOMIC_IRAM_ATTR reset()
+    {
+      TISR_ATOMIC_ENTER(_lock);
+
+      _stats.count    = 0;
+      _stats.missed   = 0;
+      _stats.durMin   = 0xFFFFFFFFUL;
+      _stats.durMax   = 0;
+      _stats.durSum   = 0;
+      _stats.lateMin  = INT32_MAX;
+      _stats.lateMax  = INT32_MIN;
+
+      TISR_ATOMIC_EXIT(_lock);
+    }
+
+    ///////////////////////////////////////////
+
+    // Called from the timer ISR once the callback returned
+    void TISR_ATOMIC_IRAM_ATTR recordRun(const uint32_t& duration)
+    {
+      _stats.count++;
+      _stats.durSum += duration;
+
+      if (duration < _stats.durMin)
+        _stats.durMin = duration;
+
+      if (duration > _stats.durMax)
+        _stats.durMax = duration;
+    }
+
+    // Called from the timer ISR when an invocation is due
+    void TISR_ATOMIC_IRAM_ATTR recordLateness(const int32_t& lateness, const uint32_t& missed)
+    {
+      _stats.missed += missed;
+
+      if (lateness < _stats.lateMin)
+        _stats.lateMin = lateness;
+
+      if (lateness > _stats.lateMax)
+        _stats.lateMax = lateness;
+    }
+
+    ///////////////////////////////////////////
+
+    // Consistent copy, safe to call from loop(). Fields never updated read as 0
+    void getSnapshot(tisr_timer_stats_t& snapshot)
+    {
+      {
+        TISR_ATOMIC_ENTER(_lock);
+
+        memcpy(&snapshot, (const void*) &_stats, sizeof(snapshot));
+
+        TISR_ATOMIC_EXIT(_lock);
+      }
+
+      if (snapshot.count == 0)
+      {
+        snapshot.durMin = 0;
+      }
+
+      if (snapshot.lateMin > snapshot.lateMax)
+      {
+        snapshot.lateMin = 0;
+        snapshot.lateMax = 0;
+      }
+    }
+
+    static uint32_t getAvgDuration(const tisr_timer_stats_t& snapshot)
+    {
+      return (snapshot.count == 0) ? 0 : (uint32_t) (snapshot.durSum / snapshot.count);
+    }
+
+  protected:
+
+    volatile tisr_timer_stats_t   _stats;
+
+    TISR_ATOMIC_MUX(_lock);
+};
+
+///////////////////////////////////////////
+
+// Hardware timer stats, the lateness and missed periods come from the time between two callback invocations
+class TISR_HwTimerStats : public TISR_TimerStats
+{
+  public:
+
+    TISR_HwTimerStats() : _expected(0), _lastEntry(0), _started(false)
+    {
+    }
+
+    // Expected period between two callbacks, in TISR_CYCLES() counts. 0 disables the lateness and missed counting
+    void TISR_ATOMIC_IRAM_ATTR setExpectedPeriod(const uint32_t& expected)
+    {
+      _expected = expected;
+      _started  = false;
+    }
+
+    uint32_t getExpectedPeriod() const
+    {
+      return _expected;
+    }
+
+    ///////////////////////////////////////////
+
+    tisr_cycles_t TISR_ATOMIC_IRAM_ATTR onEntry()
+    {
+      tisr_cycles_t now = TISR_CYCLES();
+
+      if (_started && (_expected != 0))
+      {
+        uint32_t  period  = TISR_CYCLES_ELAPSED(_lastEntry, now);
+        uint32_t  missed  = (period + _expected / 2) / _expected;
+
+        // Lateness is relative to the nearest expected firing, missed periods are counted separately
+        missed = (missed > 0) ? (missed - 1) : 0;
+
+        recordLateness( (int32_t) (period - (missed + 1) * _expected), missed );
+      }
+
+      _lastEntry  = now;
+      _started    = true;
+
+      return now;
+    }
+
+    void TISR_ATOMIC_IRAM_ATTR onExit(const tisr_cycles_t& start)
+    {
+      recordRun( TISR_CYCLES_ELAPSED(start, TISR_CYCLES()) );
+    }
+
+  private:
+
+    volatile uint32_t       _expected;
+    volatile tisr_cycles_t  _lastEntry;
+    volatile bool           _started;
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_STATS_INSTANTIATED
+  // To force pre-instatiate only once
+  #define TISR_STATS_INSTANTIATED
+  TISR_HwTimerStats TISR_HwStats[TISR_STATS_MAX_HW_TIMERS];
+#endif
+
+///////////////////////////////////////////
+
+#define TISR_STATS_HW_BEGIN(timerNo, start)         tisr_cycles_t start = TISR_HwStats[(timerNo) % TISR_STATS_MAX_HW_TIMERS].onEntry()
+#define TISR_STATS_HW_END(timerNo, start)           TISR_HwStats[(timerNo) % TISR_STATS_MAX_HW_TIMERS].onExit(start)
+#define TISR_STATS_HW_SET_FREQUENCY(timerNo, freq)  do { tisr_cycles_init();                                          \
+                                                      TISR_HwStats[(timerNo) % TISR_STATS_MAX_HW_TIMERS].setExpectedPeriod( \
+                                                        ( (freq) > 0 ) ? (uint32_t) ( TISR_CYCLES_HZ / (freq) ) : 0 ); \
+                                                    } while (0)
+
+#else   // TISR_STATS_ENABLE
+
+#define TISR_STATS_HW_BEGIN(timerNo, start)
+#define TISR_STATS_HW_END(timerNo, start)
+#define TISR_STATS_HW_SET_FREQUENCY(timerNo, freq)
+
+#endif  // TISR_STATS_ENABLE
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_STATS_H
@@ -0,0 +1,763 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Stepper.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Stepper motor pulse generation with acceleration ramps computed in the ISR, one step at a time. Include it
+  explicitly, after "TimerInterrupt_Generic.h".
+
+  1) TISR_StepperRamp : the ramp engine, independent of any timer. move() plans a relative move from loop(), then
+     nextInterval(), called once per step from the timer ISR, returns the timer period (in timer ticks) until the
+     following step, 0 once all the steps are issued. With a constant acceleration a, the speed v after each step
+     follows v'^2 = v^2 + 2a, so the period c = F / v (F = timer ticks / s) follows c' = c * (1 + 2Kc^2)^-1/2,
+     K = a / F^2. Once Kc^2 < 1/16, i.e. except for the first slow steps, c' = c - Kc^3 is accurate enough and is
+     computed in integers, with 16x16 bits multiplies and no division (AVR446 style). Deceleration is the same with
+     a negative a. Trapezoidal profile by default, or S-curve with setSCurve() : the acceleration then ramps in and
+     out linearly over a number of steps, instead of jumping
+  2) TISR_Stepper : the engine on a hardware timer in PWM mode, which outputs the step pulses itself. The ISR only
+     loads the period after next, so the pulses have no ISR jitter
+     - AVR : Timer1 (fast PWM, TOP = OCR1A), step pulse on OC1B : D10 on 328(P) / 32u4, D12 on Mega. Don't use
+       ITimer1 (USE_TIMER_1) then. ~40kHz at 16MHz
+     - STM32 : any timer with a PWM channel, through HardwareTimer. 200kHz and more
+
+  Periods are at most 65535 ticks : choose the timer frequency so that 65535 ticks is longer than the slowest step.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_STEPPER_H
+#define TIMERINTERRUPT_GENERIC_STEPPER_H
+
+#include <math.h>
+
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#define TISR_STEPPER_STOPPED          0
+#define TISR_STEPPER_ACCEL            1
+#define TISR_STEPPER_RUN              2
+#define TISR_STEPPER_DECEL            3
+
+// Step pulse width, in us
+#ifndef TISR_STEPPER_PULSE_US
+  #define TISR_STEPPER_PULSE_US       2
+#endif
+
+// S-curve acceleration factor at the start of a ramp, Q16. A ramp in from 0 would make the first steps endless
+#ifndef TISR_STEPPER_SCURVE_MIN
+  #define TISR_STEPPER_SCURVE_MIN     16384UL
+#endif
+
+///////////////////////////////////////////
+
+class TISR_StepperRamp
+{
+  public:
+
+    TISR_StepperRamp() : _timerHz(1000000), _minTicks(1), _maxTicks(0xFFFF), _accel(1000), _decel(1000),
+      _maxSpeed(1000), _jerkSteps(0), _state(TISR_STEPPER_STOPPED), _position(0), _remaining(0)
+    {
+    }
+
+    // timerHz : timer ticks / s. Periods are clamped to minTicks .. maxTicks (at most 65535)
+    void begin(const uint32_t& timerHz, const uint16_t& minTicks = 1, const uint16_t& maxTicks = 0xFFFF)
+    {
+      _timerHz  = timerHz;
+      _minTicks = (minTicks > 0) ? minTicks : 1;
+      _maxTicks = maxTicks;
+    }
+
+    // steps / s^2. Used by the next move()
+    void setAcceleration(const float& accel, const float& decel)
+    {
+      _accel = accel;
+      _decel = decel;
+    }
+
+    void setAcceleration(const float& accel)
+    {
+      setAcceleration(accel, accel);
+    }
+
+    // steps / s. Used by the next move()
+    void setMaxSpeed(const float& speed)
+    {
+      _maxSpeed = speed;
+    }
+
+    // Acceleration ramped in / out over jerkSteps steps at both ends of the acceleration and deceleration. 0 : trapezoid
+    void setSCurve(const uint16_t& jerkSteps)
+    {
+      _jerkSteps = jerkSteps;
+    }
+
+    ///////////////////////////////////////////
+
+    // Plans a move of steps (signed) from standstill, from loop(). false if still moving
+    bool move(const int32_t& steps)
+    {
+      if (_state != TISR_STEPPER_STOPPED)
+        return false;
+
+      if ( (steps == 0) || (_accel <= 0) || (_decel <= 0) || (_maxSpeed <= 0) )
+        return true;
+
+      _direction  = (steps > 0) ? 1 : -1;
+      _total      = (steps > 0) ? steps : -steps;
+
+      // S-curve ramps of each phase : in and out, so at most a quarter of the move each
+      _jerk = (uint16_t) ( (_jerkSteps < _total / 4) ? _jerkSteps : (_total / 4) );
+
+      float speed2;
+      float accelSteps;
+      float decelSteps;
+
+      for (uint8_t pass = 0; pass < 2; pass++)
+      {
+        _jerkInc = (_jerk > 0) ? ( (65536UL - TISR_STEPPER_SCURVE_MIN) / _jerk ) : 0;
+
+        // Each step changes v^2 by 2a * factor : v^2 = 2a(n - overhead), overhead being the steps the ramps lose
+        float overhead  = getSCurveOverhead();
+
+        speed2      = _maxSpeed * _maxSpeed;
+        accelSteps  = speed2 / (2 * _accel) + overhead;
+        decelSteps  = speed2 / (2 * _decel) + overhead;
+
+        // Too short to reach it : triangle, at the speed both phases fit in
+        if (accelSteps + decelSteps > _total)
+        {
+          speed2 = (_total - 2 * overhead) * 2 * _accel * _decel / (_accel + _decel);
+
+          if (speed2 < 0)
+            speed2 = 0;
+
+          accelSteps  = speed2 / (2 * _accel) + overhead;
+          decelSteps  = _total - accelSteps;
+        }
+
+        // The ramps in and out of the shorter phase mustn't overlap : 2 * jerk <= n + overhead, about n + 0.75 * jerk
+        float maxJerk = speed2 / ( 2 * ( (_accel > _decel) ? _accel : _decel ) )
+                        * 65536.0f / (65536.0f + TISR_STEPPER_SCURVE_MIN);
+
+        if (_jerk <= maxJerk)
+          break;
+
+        _jerk = (uint16_t) maxJerk;
+      }
+
+      _accelSteps   = (accelSteps >= 1) ? (uint32_t) accelSteps : 1;
+      _decelSteps   = (decelSteps >= 1) ? (uint32_t) (decelSteps + 0.5f) : 1;
+      _decelStart   = (_total > _decelSteps) ? (_total - _decelSteps) : 0;
+
+      float timerHz = (float) _timerHz;
+
+      toMiniFloat(_accel / (timerHz * timerHz), _accelK, _accelShift);
+      toMiniFloat(_decel / (timerHz * timerHz), _decelK, _decelShift);
+
+      _jerkInc    = (_jerk > 0) ? ( (65536UL - TISR_STEPPER_SCURVE_MIN) / _jerk ) : 0;
+      _factor     = (_jerk > 0) ? (TISR_STEPPER_SCURVE_MIN + _jerkInc) : 65536UL;
+
+      // First period, AVR446 : 0.676 * F * sqrt(2 / a), a as ramped in by the S-curve
+      float c0    = 0.676f * timerHz * sqrtf( 2.0f / ( _accel * _factor / 65536.0f ) );
+
+      _cMin       = toQ16(timerHz / _maxSpeed);
+      _c          = toQ16(c0);
+
+      if (_c < _cMin)
+        _c = _cMin;
+
+      // Slowest period of the deceleration : the move ends about as slow as it started
+      _cStop      = _c;
+
+      _issued     = 0;
+      _phaseSteps = 0;
+      _remaining  = _total;
+      _state      = TISR_STEPPER_ACCEL;
+
+      return true;
+    }
+
+    ///////////////////////////////////////////
+
+    // Call once per step from the timer ISR. Period in ticks until the next step, 0 when all the steps are issued
+    uint16_t TISR_ATOMIC_IRAM_ATTR nextInterval()
+    {
+      if (_state == TISR_STEPPER_STOPPED)
+        return 0;
+
+      // The period of this step was computed by the previous call
+      uint32_t c = _c;
+
+      _issued++;
+      _remaining  = _total - _issued;
+      _position  += _direction;
+
+      if (_issued >= _total)
+      {
+        _state = TISR_STEPPER_STOPPED;
+      }
+      else
+      {
+        if ( (_state != TISR_STEPPER_DECEL) && (_issued >= _decelStart) )
+        {
+          _state      = TISR_STEPPER_DECEL;
+          _phaseSteps = 0;
+          _factor     = (_jerk > 0) ? TISR_STEPPER_SCURVE_MIN : 65536UL;
+        }
+
+        _phaseSteps++;
+
+        if (_state == TISR_STEPPER_ACCEL)
+        {
+          updateFactor(_phaseSteps, _accelSteps - _phaseSteps);
+
+          _c = accelerate(_c);
+
+          if (_c <= _cMin)
+          {
+            _c      = _cMin;
+            _state  = TISR_STEPPER_RUN;
+          }
+        }
+        else if (_state == TISR_STEPPER_DECEL)
+        {
+          updateFactor(_phaseSteps, _total - _issued);
+
+          _c = decelerate(_c);
+        }
+      }
+
+      return clampTicks(c);
+    }
+
+    ///////////////////////////////////////////
+
+    uint8_t getState() const
+    {
+      return _state;
+    }
+
+    bool isRunning() const
+    {
+      return (_state != TISR_STEPPER_STOPPED);
+    }
+
+    // Steps issued by nextInterval(). Read twice until stable, a 32-bit load isn't atomic on AVR
+    int32_t getPosition() const
+    {
+      int32_t position;
+
+      do
+      {
+        position = _position;
+      } while (position != _position);
+
+      return position;
+    }
+
+    void setPosition(const int32_t& position)
+    {
+      _position = position;
+    }
+
+    int32_t getRemaining() const
+    {
+      return (_state == TISR_STEPPER_STOPPED) ? 0 : (int32_t) _remaining * _direction;
+    }
+
+    // steps / s of the next step
+    float getSpeed() const
+    {
+      return (_state == TISR_STEPPER_STOPPED) ? 0 : (float) _timerHz * 65536.0f / _c;
+    }
+
+    // Current direction, 1 or -1, for the direction pin
+    int8_t getDirection() const
+    {
+      return _direction;
+    }
+
+    uint32_t getTimerHz() const
+    {
+      return _timerHz;
+    }
+
+    ///////////////////////////////////////////
+
+  private:
+
+    // value = mantissa / 2^shift, mantissa in 32768 .. 65535
+    static void toMiniFloat(float value, uint16_t& mantissa, int8_t& shift)
+    {
+      shift = 0;
+
+      if (value <= 0)
+      {
+        mantissa = 0;
+        return;
+      }
+
+      while (value < 32768.0f)
+      {
+        value *= 2;
+        shift++;
+      }
+
+      while (value >= 65536.0f)
+      {
+        value /= 2;
+        shift--;
+      }
+
+      mantissa = (uint16_t) value;
+    }
+
+    // Steps lost by the S-curve ramps in and out of one phase : sum of (1 - factor), as updateFactor() steps it
+    float getSCurveOverhead() const
+    {
+      float overhead = 0;
+
+      for (uint16_t step = 1; step <= _jerk; step++)
+      {
+        uint32_t factor = TISR_STEPPER_SCURVE_MIN + step * _jerkInc;
+
+        // Ramp in, then ramp out over the last _jerk - 1 steps
+        overhead += 1.0f - ( (factor < 65536UL) ? factor : 65536UL ) / 65536.0f;
+
+        if (step < _jerk)
+          overhead += (float) step * _jerkInc / 65536.0f;
+      }
+
+      return overhead;
+    }
+
+    // Keeps the 16 most significant bits of value, and adds the right shift it took to shift
+    static uint16_t normalize(uint32_t value, uint8_t& shift)
+    {
+      if (value >= 0x1000000UL)
+      {
+        value >>= 16;
+        shift  += 16;
+      }
+      else if (value >= 0x10000UL)
+      {
+        value >>= 8;
+        shift  += 8;
+      }
+
+      while (value > 0xFFFF)
+      {
+        value >>= 1;
+        shift++;
+      }
+
+      return (uint16_t) value;
+    }
+
+    uint32_t toQ16(const float& ticks) const
+    {
+      float maxTicks = _maxTicks;
+
+      return (uint32_t) ( ( (ticks < maxTicks) ? ticks : maxTicks ) * 65536.0f );
+    }
+
+    uint16_t clampTicks(const uint32_t& c) const
+    {
+      uint16_t ticks = (uint16_t) (c >> 16);
+
+      return (ticks < _minTicks) ? _minTicks : ( (ticks > _maxTicks) ? _maxTicks : ticks );
+    }
+
+    // S-curve : acceleration factor up over the first jerk steps of the phase, down over its last ones
+    void updateFactor(const uint32_t& phaseSteps, const uint32_t& stepsLeft)
+    {
+      if (_jerk == 0)
+        return;
+
+      if ( (stepsLeft < _jerk) && (_factor >= TISR_STEPPER_SCURVE_MIN + _jerkInc) )
+        _factor -= _jerkInc;
+      else if ( (phaseSteps <= _jerk) && (_factor < 65536UL) )
+        _factor += _jerkInc;
+
+      if (_factor > 65536UL)
+        _factor = 65536UL;
+    }
+
+    // Period change of one step : Kc^3 in Q16, or UINT32_MAX if Kc^2 >= 1/16 and the exact formula is needed
+    uint32_t getDelta(const uint32_t& c, const uint16_t& k, const int8_t& kShift) const
+    {
+      uint8_t   s0    = 0;
+      uint8_t   s1    = 0;
+      uint8_t   s2    = 0;
+
+      // K with the S-curve factor
+      uint16_t  kEff  = (uint16_t) ( ( (uint32_t) k * _factor ) >> 16 );
+
+      if (_factor >= 65536UL)
+        kEff = k;
+
+      // c = cn * 2^s0 / 2^16, c^2 = sq * 2^(s1 + 2s0) / 2^32, c^3 = cube * 2^(s2 + s1 + 3s0) / 2^48
+      uint16_t  cn    = normalize(c, s0);
+      uint16_t  sq    = normalize( (uint32_t) cn * cn, s1 );
+      uint16_t  cube  = normalize( (uint32_t) sq * cn, s2 );
+
+      // Kc^2 >= 1/16 <=> kEff * sq >= 2^(28 - s1 - 2s0 + kShift)
+      int16_t   eu    = 28 - s1 - 2 * s0 + kShift;
+
+      if ( (eu < 0) || ( (eu < 32) && ( (uint32_t) kEff * sq >= (1UL << eu) ) ) )
+        return UINT32_MAX;
+
+      // Kc^3 in Q16 = kEff * cube * 2^(s2 + s1 + 3s0 - 48 - kShift + 16)
+      uint32_t  delta = (uint32_t) kEff * cube;
+      int16_t   e     = s2 + s1 + 3 * s0 - 32 - kShift;
+
+      if (e >= 0)
+        return ( (e < 32) && (delta < (UINT32_MAX >> e)) ) ? (delta << e) : UINT32_MAX;
+
+      return (e > -32) ? (delta >> -e) : 0;
+    }
+
+    // Slow steps only, float
+    float getU(const uint32_t& c, const uint16_t& k, const int8_t& kShift) const
+    {
+      float ticks = c / 65536.0f;
+
+      return ldexpf( (float) k * _factor / 65536.0f, -kShift ) * ticks * ticks;
+    }
+
+    uint32_t accelerate(const uint32_t& c) const
+    {
+      uint32_t delta = getDelta(c, _accelK, _accelShift);
+
+      if (delta == UINT32_MAX)
+        return toQ16( c / 65536.0f / sqrtf(1.0f + 2.0f * getU(c, _accelK, _accelShift)) );
+
+      return (delta < c) ? (c - delta) : _cMin;
+    }
+
+    // Never slower than the first step : rounding can't leave the last steps crawling
+    uint32_t decelerate(const uint32_t& c) const
+    {
+      uint32_t delta = getDelta(c, _decelK, _decelShift);
+
+      if (delta == UINT32_MAX)
+      {
+        float d = 1.0f - 2.0f * getU(c, _decelK, _decelShift);
+
+        if (d <= 0)
+          return _cStop;
+
+        uint32_t next = toQ16( c / 65536.0f / sqrtf(d) );
+
+        return (next < _cStop) ? next : _cStop;
+      }
+
+      return (delta < _cStop - c) ? (c + delta) : ( (c < _cStop) ? _cStop : c );
+    }
+
+    uint32_t            _timerHz;
+    uint16_t            _minTicks;
+    uint16_t            _maxTicks;
+
+    float               _accel;
+    float               _decel;
+    float               _maxSpeed;
+    uint16_t            _jerkSteps;
+
+    // Current move, set by move() while stopped, then owned by nextInterval()
+    volatile uint8_t    _state;
+    volatile int32_t    _position;
+    volatile uint32_t   _remaining;
+
+    int8_t              _direction;
+    uint32_t            _total;
+    uint32_t            _issued;
+    uint32_t            _accelSteps;
+    uint32_t            _decelSteps;
+    uint32_t            _decelStart;
+    uint32_t            _phaseSteps;
+
+    uint16_t            _accelK;
+    int8_t              _accelShift;
+    uint16_t            _decelK;
+    int8_t              _decelShift;
+
+    uint16_t            _jerk;
+    uint32_t            _jerkInc;
+    uint32_t            _factor;          // S-curve acceleration factor, Q16
+
+    uint32_t            _c;               // period of the next step, ticks in Q16
+    uint32_t            _cMin;
+    uint32_t            _cStop;           // first period of the move, slowest of the deceleration
+};
+
+///////////////////////////////////////////
+
+#if ( defined(__AVR__) && defined(TCCR1A) && defined(OCR1B) ) || TIMER_INTERRUPT_USING_STM32
+
+#define TISR_STEPPER_HARDWARE         true
+
+#if defined(__AVR__)
+  #if USE_TIMER_1
+    #error TimerInterrupt_Generic_Stepper.h uses Timer1, USE_TIMER_1 must not be defined
+  #endif
+
+  #if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+    #define TISR_STEPPER_STEP_PIN     12
+  #else
+    #define TISR_STEPPER_STEP_PIN     10
+  #endif
+#endif
+
+class TISR_Stepper;
+
+// The TISR_Stepper running on the timer, for its ISR
+extern TISR_Stepper* TISR_StepperActive;
+
+class TISR_Stepper : public TISR_StepperRamp
+{
+  public:
+
+    TISR_Stepper() :
+#if !defined(__AVR__)
+      _hwTimer(NULL), _channel(0), _stepPin(0),
+#endif
+      _dirPin(0), _clockSelect(0), _pulseTicks(1), _lastTicks(1), _numIdle(0), _timerRunning(false)
+    {
+      TISR_ATOMIC_MUX_INIT(_mux);
+    }
+
+#if defined(__AVR__)
+
+    // Timer1 at F_CPU / prescaler, 1 or 8. Not more : the ISR must load the next period after the timer got to BOTTOM
+    void begin(const uint8_t& dirPin, const uint8_t& prescaler = 8)
+    {
+      uint32_t timerHz    = F_CPU / ( (prescaler == 1) ? 1 : 8 );
+
+      _dirPin       = dirPin;
+      _clockSelect  = (prescaler == 1) ? _BV(CS10) : _BV(CS11);
+      _timerRunning = false;
+      _pulseTicks   = (uint16_t) ( (uint32_t) TISR_STEPPER_PULSE_US * (timerHz / 1000) / 1000 ) + 1;
+
+      TISR_StepperRamp::begin(timerHz, _pulseTicks * 2, 0xFFFF);
+
+      pinMode(_dirPin, OUTPUT);
+      pinMode(TISR_STEPPER_STEP_PIN, OUTPUT);
+      digitalWrite(TISR_STEPPER_STEP_PIN, LOW);
+
+      TISR_StepperActive = this;
+    }
+
+#else
+
+    // timer : TIM1, TIM2, ... with stepPin on its PWM channel. timerHz : tick rate, e.g. 1 - 10MHz
+    void begin(TIM_TypeDef* timer, const uint8_t& stepPin, const uint8_t& dirPin, const uint32_t& timerHz = 2000000)
+    {
+      _hwTimer      = new HardwareTimer(timer);
+      _dirPin       = dirPin;
+      _timerRunning = false;
+      _channel    = STM_PIN_CHANNEL( pinmap_function( digitalPinToPinName(stepPin), PinMap_TIM ) );
+      _stepPin    = stepPin;
+
+      _hwTimer->setPrescaleFactor( _hwTimer->getTimerClkFreq() / timerHz );
+
+      uint32_t actualHz = _hwTimer->getTimerClkFreq() / _hwTimer->getPrescaleFactor();
+
+      _pulseTicks = (uint16_t) ( (uint64_t) TISR_STEPPER_PULSE_US * actualHz / 1000000 ) + 1;
+
+      TISR_StepperRamp::begin(actualHz, _pulseTicks * 2, 0xFFFF);
+
+      pinMode(_dirPin, OUTPUT);
+
+      TISR_StepperActive = this;
+    }
+
+#endif
+
+    ///////////////////////////////////////////
+
+    // Starts a relative move. false if still moving
+    bool moveSteps(const int32_t& steps)
+    {
+      if (_timerRunning || !move(steps))
+        return false;
+
+      if (!isRunning())
+        return true;
+
+      digitalWrite(_dirPin, (getDirection() > 0) ? HIGH : LOW);
+
+      // First two periods, the ISR then always loads the period after next
+      uint16_t first  = nextInterval();
+      uint16_t second = nextInterval();
+
+      _numIdle      = (second == 0) ? 1 : 0;
+      _timerRunning = true;
+
+      start(first, second);
+
+      return true;
+    }
+
+    // true until the last pulse is out. isRunning() is false as soon as it is computed, 2 periods earlier
+    bool isMoving() const
+    {
+      return _timerRunning;
+    }
+
+    // Called by the timer ISR, at the end of each period
+    void TISR_ATOMIC_IRAM_ATTR onPeriod()
+    {
+      uint16_t ticks = nextInterval();
+
+      if (ticks == 0)
+      {
+        // The period after next without pulse, then stop
+        if (++_numIdle > 2)
+        {
+          stop();
+          _timerRunning = false;
+
+          return;
+        }
+
+        setPeriod(_lastTicks, false);
+      }
+      else
+        setPeriod(ticks, true);
+    }
+
+  private:
+
+#if defined(__AVR__)
+
+    void start(const uint16_t& first, const uint16_t& second)
+    {
+      TISR_ATOMIC_ENTER(_mux);
+
+      // Normal mode while setting up : OCR1x written directly
+      TCCR1B  = 0;
+      TCCR1A  = 0;
+      OCR1A   = first - 1;
+      OCR1B   = first - _pulseTicks;
+
+      // Past BOTTOM, so the first period keeps these values
+      TCNT1   = 1;
+
+      // Fast PWM, TOP = OCR1A, clock stopped. Inverting OC1B : pulse at the end of each period, from OCR1B to TOP
+      TCCR1A  = _BV(COM1B1) | _BV(COM1B0) | _BV(WGM11) | _BV(WGM10);
+      TCCR1B  = _BV(WGM13) | _BV(WGM12);
+      TIFR1   = _BV(TOV1);
+      TIMSK1  = _BV(TOIE1);
+
+      // Double buffered, loaded at the end of the first period. A single step repeats first, without pulse
+      _lastTicks = first;
+      setPeriod(second, (second != 0) );
+
+      TCCR1B  = _BV(WGM13) | _BV(WGM12) | _clockSelect;
+
+      TISR_ATOMIC_EXIT(_mux);
+    }
+
+    void stop()
+    {
+      TCCR1B  = 0;
+      TIMSK1  = 0;
+      TCCR1A  = 0;
+    }
+
+    void setPeriod(const uint16_t& ticks, const bool& pulse)
+    {
+      uint16_t period = (ticks != 0) ? ticks : _lastTicks;
+
+      _lastTicks  = period;
+
+      OCR1A = period - 1;
+
+      // OCR1B == TOP : output constantly low
+      OCR1B = pulse ? (period - _pulseTicks) : (period - 1);
+    }
+
+#else
+
+    void start(const uint16_t& first, const uint16_t& second)
+    {
+      _hwTimer->pause();
+
+      // PWM2 : pulse at the end of each period, from CCR to ARR
+      _hwTimer->setMode(_channel, TIMER_OUTPUT_COMPARE_PWM2, _stepPin);
+      _hwTimer->setOverflow(first, TICK_FORMAT);
+      _hwTimer->setCaptureCompare(_channel, first - _pulseTicks, TICK_COMPARE_FORMAT);
+      _hwTimer->setCount(0, TICK_FORMAT);
+      _hwTimer->attachInterrupt(onUpdate);
+
+      // Preloaded, active after the first update
+      _hwTimer->resume();
+
+      // A single step repeats first, without pulse
+      _lastTicks = first;
+      setPeriod(second, (second != 0) );
+    }
+
+    void stop()
+    {
+      _hwTimer->pause();
+    }
+
+    void setPeriod(const uint16_t& ticks, const bool& pulse)
+    {
+      uint16_t period = (ticks != 0) ? ticks : _lastTicks;
+
+      _lastTicks = period;
+
+      // Direct register writes, the HAL is too slow at 200kHz. CCR > ARR : output constantly inactive
+      TIM_TypeDef* timer = _hwTimer->getHandle()->Instance;
+
+      timer->ARR = period - 1;
+      __HAL_TIM_SET_COMPARE(_hwTimer->getHandle(), (_channel - 1) * 4, pulse ? (period - _pulseTicks) : (period + 1));
+    }
+
+    static void onUpdate()
+    {
+      TISR_StepperActive->onPeriod();
+    }
+
+    HardwareTimer*      _hwTimer;
+    uint32_t            _channel;
+    uint8_t             _stepPin;
+
+#endif
+
+    uint8_t             _dirPin;
+    uint8_t             _clockSelect;
+    uint16_t            _pulseTicks;
+    uint16_t            _lastTicks;
+    uint8_t             _numIdle;
+    volatile bool       _timerRunning;
+
+    TISR_ATOMIC_MUX(_mux);
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_STEPPER_INSTANTIATED
+#define TISR_STEPPER_INSTANTIATED     // To force pre-instatiate only once
+
+  TISR_Stepper* TISR_StepperActive = NULL;
+
+  #if defined(__AVR__)
+    ISR(TIMER1_OVF_vect)
+    {
+      if (TISR_StepperActive)
+        TISR_StepperActive->onPeriod();
+    }
+  #endif
+
+#endif    // TISR_STEPPER_INSTANTIATED
+
+#endif    // TISR_STEPPER_HARDWARE
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_STEPPER_H
@@ -0,0 +1,412 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_TaskService.h
+  For ESP32, RP2040 (arduino-pico FreeRTOS) and STM32 (STM32FreeRTOS) boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  FreeRTOS timer service : hardware timer precision, task context execution. Include it explicitly, after
+  "TimerInterrupt_Generic.h" / "ISR_Timer_Generic.h".
+
+  addJob() registers a callback with a FreeRTOS priority. Jobs of the same priority share one worker task, up to
+  TISR_TASK_MAX_WORKERS workers, i.e. priorities. A hardware timer ISR (or an ISR_Timer callback, via
+  TISR_TaskService::postFromISR) calls notifyFromISR(), which sets the job bit in the notification value of its worker
+  (direct-to-task notification, no queue, no software timer daemon) and requests a context switch. The worker wakes
+  up as soon as the ISR returns if it is the highest priority ready task, so the wake latency only depends on the
+  priorities.
+
+  A job notified again before its worker ran it is run once, the extra notifications are counted as coalesced.
+  getStats() returns, per job, the ISR to task latency : from notifyFromISR() to the callback entry, in us.
+
+  Shared resources between jobs of different priorities must be guarded by a TISR_TaskMutex, a FreeRTOS mutex with
+  priority inheritance (a low priority job holding it runs at the priority of the highest one waiting for it).
+
+  On STM32, start the scheduler with vTaskStartScheduler() at the end of setup(), as usual with STM32FreeRTOS.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_TASKSERVICE_H
+#define TIMERINTERRUPT_GENERIC_TASKSERVICE_H
+
+#if ( defined(ESP32) || ESP32 )
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+  #include <freertos/semphr.h>
+#elif defined(ARDUINO_ARCH_STM32) && __has_include(<STM32FreeRTOS.h>)
+  #include <STM32FreeRTOS.h>
+#elif defined(ARDUINO_ARCH_RP2040) && __has_include(<FreeRTOS.h>)
+  #include <FreeRTOS.h>
+  #include <task.h>
+  #include <semphr.h>
+#else
+  #error TimerInterrupt_Generic_TaskService.h needs FreeRTOS : ESP32, RP2040 with FreeRTOS or STM32 with STM32FreeRTOS
+#endif
+
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#ifndef TISR_TASK_MAX_WORKERS
+  #define TISR_TASK_MAX_WORKERS       3
+#endif
+
+#ifndef TISR_TASK_MAX_JOBS
+  #define TISR_TASK_MAX_JOBS          16
+#endif
+
+#if (TISR_TASK_MAX_JOBS > 32)
+  #error TISR_TASK_MAX_JOBS must be 32 or less, one notification bit per job
+#endif
+
+#ifndef TISR_TASK_STACK_SIZE
+  #if ( defined(ESP32) || ESP32 )
+    // Bytes
+    #define TISR_TASK_STACK_SIZE      4096
+  #else
+    // Words
+    #define TISR_TASK_STACK_SIZE      512
+  #endif
+#endif
+
+#if ( defined(ESP32) || ESP32 )
+  #ifndef TISR_TASK_CORE
+    // Core the workers are pinned to
+    #define TISR_TASK_CORE            tskNO_AFFINITY
+  #endif
+
+  // CCOUNT is per core, the ISR and the worker can run on different cores
+  #define TISR_TASK_MICROS()          ( (uint32_t) esp_timer_get_time() )
+
+  #define TISR_TASK_YIELD_FROM_ISR(woken)   if (woken) portYIELD_FROM_ISR()
+
+  // Spinlock, taken from ISRs and tasks of both cores
+  #define TISR_TASK_MUX(mux)                TISR_ATOMIC_MUX(mux)
+  #define TISR_TASK_MUX_INIT(mux)           TISR_ATOMIC_MUX_INIT(mux)
+
+  #define TISR_TASK_ENTER_FROM_ISR(mux)     TISR_ATOMIC_ENTER(mux)
+  #define TISR_TASK_EXIT_FROM_ISR(mux)      TISR_ATOMIC_EXIT(mux)
+  #define TISR_TASK_ENTER(mux)              TISR_ATOMIC_ENTER(mux)
+  #define TISR_TASK_EXIT(mux)               TISR_ATOMIC_EXIT(mux)
+#else
+  #define TISR_TASK_MICROS()          ( (uint32_t) micros() )
+
+  #define TISR_TASK_YIELD_FROM_ISR(woken)   portYIELD_FROM_ISR(woken)
+
+  // FreeRTOS critical sections, which also take the inter-core lock with FreeRTOS SMP on RP2040
+  #define TISR_TASK_MUX(mux)
+  #define TISR_TASK_MUX_INIT(mux)
+
+  #define TISR_TASK_ENTER_FROM_ISR(mux)     UBaseType_t _tisrTaskState = taskENTER_CRITICAL_FROM_ISR()
+  #define TISR_TASK_EXIT_FROM_ISR(mux)      taskEXIT_CRITICAL_FROM_ISR(_tisrTaskState)
+  #define TISR_TASK_ENTER(mux)              taskENTER_CRITICAL()
+  #define TISR_TASK_EXIT(mux)               taskEXIT_CRITICAL()
+#endif
+
+///////////////////////////////////////////
+
+typedef void (*tisr_task_callback)(void *);
+
+typedef struct
+{
+  uint32_t  count;            // Runs
+  uint32_t  coalesced;        // Notifications merged into a run already pending
+  uint32_t  latencyMin;       // notifyFromISR() to callback entry, us
+  uint32_t  latencyMax;
+  uint32_t  latencyAvg;
+} tisr_task_stats_t;
+
+///////////////////////////////////////////
+
+class TISR_TaskService
+{
+  public:
+
+    TISR_TaskService() : _numJobs(0), _numWorkers(0)
+    {
+      TISR_TASK_MUX_INIT(_lock);
+    }
+
+    // Returns the job id, or -1 if there is no job slot left or the worker task can't be created.
+    // A new priority gets a new worker : -1 too if TISR_TASK_MAX_WORKERS are already running, at other priorities
+    int addJob(tisr_task_callback callback, void* param, const UBaseType_t& priority)
+    {
+      if ( (callback == NULL) || (_numJobs >= TISR_TASK_MAX_JOBS) )
+        return -1;
+
+      int worker = findWorker(priority);
+
+      if (worker < 0)
+        return -1;
+
+      job_t* job = &_jobs[_numJobs];
+
+      job->callback   = callback;
+      job->param      = param;
+      job->worker     = (uint8_t) worker;
+      job->pending    = false;
+      job->postMicros = 0;
+
+      clearStats(*job);
+
+      _workers[worker].jobMask |= ( 1UL << _numJobs );
+
+      return _numJobs++;
+    }
+
+    ///////////////////////////////////////////
+
+    // From a hardware timer ISR. Returns true if a higher priority task was woken, e.g. as the return value of the
+    // ESP32 timer callbacks. The context switch is requested anyway
+    bool TISR_ATOMIC_IRAM_ATTR notifyFromISR(const uint8_t& jobId)
+    {
+      if (jobId >= _numJobs)
+        return false;
+
+      job_t* job = &_jobs[jobId];
+
+      TISR_TASK_ENTER_FROM_ISR(_lock);
+
+      if (job->pending)
+        job->stats.coalesced++;
+
+      job->pending    = true;
+      job->postMicros = TISR_TASK_MICROS();
+
+      TISR_TASK_EXIT_FROM_ISR(_lock);
+
+      BaseType_t woken = pdFALSE;
+
+      xTaskNotifyFromISR(_workers[job->worker].handle, 1UL << jobId, eSetBits, &woken);
+
+      TISR_TASK_YIELD_FROM_ISR(woken);
+
+      return (woken != pdFALSE);
+    }
+
+    // From task context
+    bool notify(const uint8_t& jobId)
+    {
+      if (jobId >= _numJobs)
+        return false;
+
+      job_t* job = &_jobs[jobId];
+
+      TISR_TASK_ENTER(_lock);
+
+      if (job->pending)
+        job->stats.coalesced++;
+
+      job->pending    = true;
+      job->postMicros = TISR_TASK_MICROS();
+
+      TISR_TASK_EXIT(_lock);
+
+      xTaskNotify(_workers[job->worker].handle, 1UL << jobId, eSetBits);
+
+      return true;
+    }
+
+    // ISR_Timer callback, with the job id as parameter :
+    //   ISR_timer.setInterval(100, TISR_TaskService::postFromISR, (void*) (uintptr_t) jobId)
+    static void TISR_ATOMIC_IRAM_ATTR postFromISR(void* jobId);
+
+    ///////////////////////////////////////////
+
+    bool getStats(const uint8_t& jobId, tisr_task_stats_t& stats)
+    {
+      if (jobId >= _numJobs)
+        return false;
+
+      TISR_TASK_ENTER(_lock);
+
+      stats             = _jobs[jobId].stats;
+      stats.latencyAvg  = (stats.count > 0) ? (uint32_t) (_jobs[jobId].latencySum / stats.count) : 0;
+
+      TISR_TASK_EXIT(_lock);
+
+      return true;
+    }
+
+    void resetStats(const uint8_t& jobId)
+    {
+      if (jobId >= _numJobs)
+        return;
+
+      TISR_TASK_ENTER(_lock);
+
+      clearStats(_jobs[jobId]);
+
+      TISR_TASK_EXIT(_lock);
+    }
+
+    TaskHandle_t getWorkerHandle(const uint8_t& jobId) const
+    {
+      return (jobId < _numJobs) ? _workers[_jobs[jobId].worker].handle : NULL;
+    }
+
+  private:
+
+    typedef struct
+    {
+      tisr_task_callback  callback;
+      void*               param;
+      uint8_t             worker;
+      volatile bool       pending;
+      volatile uint32_t   postMicros;
+      tisr_task_stats_t   stats;
+      uint64_t            latencySum;
+    } job_t;
+
+    typedef struct
+    {
+      TaskHandle_t        handle;
+      UBaseType_t         priority;
+      volatile uint32_t   jobMask;
+    } worker_t;
+
+    static void clearStats(job_t& job)
+    {
+      job.stats.count       = 0;
+      job.stats.coalesced   = 0;
+      job.stats.latencyMin  = 0xFFFFFFFFUL;
+      job.stats.latencyMax  = 0;
+      job.stats.latencyAvg  = 0;
+      job.latencySum        = 0;
+    }
+
+    int findWorker(const UBaseType_t& priority)
+    {
+      for (uint8_t i = 0; i < _numWorkers; i++)
+      {
+        if (_workers[i].priority == priority)
+          return i;
+      }
+
+      // Sharing a worker of another priority would silently run the job at that one
+      if (_numWorkers >= TISR_TASK_MAX_WORKERS)
+        return -1;
+
+      worker_t* worker = &_workers[_numWorkers];
+
+      worker->priority  = priority;
+      worker->jobMask   = 0;
+
+#if ( defined(ESP32) || ESP32 )
+      BaseType_t created = xTaskCreatePinnedToCore(workerTask, "TISR_Worker", TISR_TASK_STACK_SIZE, worker, priority,
+                                                   &worker->handle, TISR_TASK_CORE);
+#else
+      BaseType_t created = xTaskCreate(workerTask, "TISR_Worker", TISR_TASK_STACK_SIZE, worker, priority, &worker->handle);
+#endif
+
+      if (created != pdPASS)
+        return -1;
+
+      return _numWorkers++;
+    }
+
+    // Runs the notified jobs, lowest job id first
+    static void workerTask(void* param);
+
+    void runJobs(const uint32_t& bits)
+    {
+      for (uint8_t i = 0; i < _numJobs; i++)
+      {
+        if ( (bits & ( 1UL << i )) == 0 )
+          continue;
+
+        job_t* job = &_jobs[i];
+
+        TISR_TASK_ENTER(_lock);
+
+        uint32_t latency = TISR_TASK_MICROS() - job->postMicros;
+
+        job->pending = false;
+
+        job->stats.count++;
+        job->latencySum += latency;
+
+        if (latency < job->stats.latencyMin)
+          job->stats.latencyMin = latency;
+
+        if (latency > job->stats.latencyMax)
+          job->stats.latencyMax = latency;
+
+        TISR_TASK_EXIT(_lock);
+
+        job->callback(job->param);
+      }
+    }
+
+    job_t       _jobs[TISR_TASK_MAX_JOBS];
+    uint8_t     _numJobs;
+
+    worker_t    _workers[TISR_TASK_MAX_WORKERS];
+    uint8_t     _numWorkers;
+
+    // Shared by the timer ISRs and the worker tasks (both cores on ESP32 and RP2040)
+    TISR_TASK_MUX(_lock);
+};
+
+///////////////////////////////////////////
+
+// FreeRTOS mutex, with priority inheritance. Not usable from ISRs
+class TISR_TaskMutex
+{
+  public:
+
+    TISR_TaskMutex() : _mutex(NULL)
+    {
+    }
+
+    // Call once the FreeRTOS heap is usable, e.g. in setup()
+    bool begin()
+    {
+      if (_mutex == NULL)
+        _mutex = xSemaphoreCreateMutex();
+
+      return (_mutex != NULL);
+    }
+
+    bool lock(const TickType_t& timeout = portMAX_DELAY)
+    {
+      return (xSemaphoreTake(_mutex, timeout) == pdTRUE);
+    }
+
+    void unlock()
+    {
+      xSemaphoreGive(_mutex);
+    }
+
+  private:
+
+    SemaphoreHandle_t   _mutex;
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_TASK_SERVICE_INSTANTIATED
+  // To force pre-instatiate only once
+  #define TISR_TASK_SERVICE_INSTANTIATED
+  TISR_TaskService TISR_Tasks;
+
+  void TISR_ATOMIC_IRAM_ATTR TISR_TaskService::postFromISR(void* jobId)
+  {
+    TISR_Tasks.notifyFromISR( (uint8_t) (uintptr_t) jobId );
+  }
+
+  void TISR_TaskService::workerTask(void* param)
+  {
+    worker_t* worker = (worker_t*) param;
+
+    for (;;)
+    {
+      uint32_t bits = 0;
+
+      if (xTaskNotifyWait(0, 0xFFFFFFFFUL, &bits, portMAX_DELAY) == pdTRUE)
+        TISR_Tasks.runJobs(bits & worker->jobMask);
+    }
+  }
+#endif
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_TASKSERVICE_H
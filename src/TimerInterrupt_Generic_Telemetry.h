@@ -0,0 +1,405 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Telemetry.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Compact binary telemetry of the timers, as an alternative to printing human-readable stats from loop().
+
+  Records are encoded into a RAM queue by the sendXXX() functions, and poll() moves them to any Stream, never more than
+  availableForWrite() bytes at once and never faster than the configured bandwidth (token bucket). Both must be called
+  from loop() or another low priority context, not from ISRs. Records that don't fit in the queue are dropped and
+  counted, so the telemetry never blocks nor perturbs the timing being observed. The Stream must implement
+  availableForWrite() (HardwareSerial, USB CDC, ...), the Print default of 0 means nothing is ever written.
+
+  Frame, all fields little-endian :
+    0xA7 0x7A, uint8_t type, uint8_t sequence, uint8_t payload length, payload, uint16_t CRC-16/CCITT-FALSE of
+    type .. payload
+
+  Payloads :
+    TISR_TELEMETRY_STATUS : uint32_t millis, uint32_t frames dropped, uint32_t bytes sent, uint32_t TISR_CYCLES_HZ
+    TISR_TELEMETRY_CONFIG : uint8_t source, uint8_t id, uint8_t enabled, float period in ms
+    TISR_TELEMETRY_STATS  : uint8_t source, uint8_t id, uint32_t count, uint32_t missed, uint32_t durMin, uint32_t durAvg,
+                            uint32_t durMax, int32_t lateMin, int32_t lateMax         (TISR_STATS_ENABLE)
+    TISR_TELEMETRY_TRACE  : uint16_t first index, uint16_t total events, n * 12-byte events as in the TTRC dump
+                                                                                      (TISR_TRACE_ENABLE)
+    TISR_TELEMETRY_LOAD   : uint32_t window number, uint16_t cpu, uint16_t hw timers, uint16_t callbacks, in 1/100 %
+                                                                                      (TISR_LOAD_ENABLE)
+    TISR_TELEMETRY_USER   : anything
+
+  extras/telemetry/tisr_telemetry decodes the stream into a live text dashboard.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_TELEMETRY_H
+#define TIMERINTERRUPT_GENERIC_TELEMETRY_H
+
+#if defined(ARDUINO)
+  #if ARDUINO >= 100
+    #include <Arduino.h>
+  #else
+    #include <WProgram.h>
+  #endif
+#endif
+
+#include <string.h>
+
+#include "TimerInterrupt_Generic_Cycles.h"
+#include "TimerInterrupt_Generic_Debug.h"
+
+#define TISR_TELEMETRY_SYNC0            0xA7
+#define TISR_TELEMETRY_SYNC1            0x7A
+
+#define TISR_TELEMETRY_STATUS           0
+#define TISR_TELEMETRY_CONFIG           1
+#define TISR_TELEMETRY_STATS            2
+#define TISR_TELEMETRY_TRACE            3
+#define TISR_TELEMETRY_LOAD             4
+#define TISR_TELEMETRY_USER             5
+
+// Sources of CONFIG and STATS records
+#define TISR_TELEMETRY_HW_TIMER         0
+#define TISR_TELEMETRY_ISR_TIMER        1
+
+#define TISR_TELEMETRY_OVERHEAD         7
+
+#ifndef TISR_TELEMETRY_QUEUE_SIZE
+  #if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+    #define TISR_TELEMETRY_QUEUE_SIZE   128
+  #else
+    #define TISR_TELEMETRY_QUEUE_SIZE   1024
+  #endif
+#endif
+
+#if ( (TISR_TELEMETRY_QUEUE_SIZE & (TISR_TELEMETRY_QUEUE_SIZE - 1)) != 0 ) || (TISR_TELEMETRY_QUEUE_SIZE < 128)
+  #error TISR_TELEMETRY_QUEUE_SIZE must be a power of 2, at least 128
+#endif
+
+#ifndef TISR_TELEMETRY_TRACE_EVENTS
+  // Events per TRACE record
+  #define TISR_TELEMETRY_TRACE_EVENTS   8
+#endif
+
+// A whole TRACE record, 12 bytes per event, must fit in the payload length and in the queue, else it's never sent
+#if (TISR_TELEMETRY_TRACE_EVENTS < 1) || (4 + TISR_TELEMETRY_TRACE_EVENTS * 12 > 255) || \
+    (4 + TISR_TELEMETRY_TRACE_EVENTS * 12 + TISR_TELEMETRY_OVERHEAD > TISR_TELEMETRY_QUEUE_SIZE - 1)
+  #error TISR_TELEMETRY_TRACE_EVENTS must be from 1 to 20, and a TRACE record fit in TISR_TELEMETRY_QUEUE_SIZE - 1 bytes
+#endif
+
+///////////////////////////////////////////
+
+class TISR_TelemetryStream
+{
+  public:
+
+    TISR_TelemetryStream() : _head(0), _tail(0), _sequence(0), _bytesPerSecond(0), _tokens(0), _lastRefill(0),
+      _refillRemainder(0), _framesDropped(0), _bytesSent(0), _traceNext(0), _traceTotal(0), _traceWasPaused(false), _tracing(false)
+    {
+    }
+
+    // bytesPerSecond = 0 : no limit besides availableForWrite(). 10% of the UART bandwidth is a sensible budget,
+    // e.g. 1152 for 115200 bps
+    void begin(const uint32_t& bytesPerSecond)
+    {
+      _bytesPerSecond = bytesPerSecond;
+      _tokens           = 0;
+      _lastRefill       = millis();
+      _refillRemainder  = 0;
+    }
+
+    ///////////////////////////////////////////
+
+    // Moves queued bytes to out, within the bandwidth budget. Returns the number of bytes written
+    uint16_t poll(Stream& out)
+    {
+#if TISR_TRACE_ENABLE
+      continueTrace();
+#endif
+
+      uint32_t budget = getNumQueued();
+
+      if (_bytesPerSecond > 0)
+      {
+        uint32_t now = millis();
+
+        // The fraction of a byte not credited is carried, else polling every few ms loses most of the bandwidth
+        uint64_t credit = (uint64_t) (now - _lastRefill) * _bytesPerSecond + _refillRemainder;
+
+        _tokens          += (uint32_t) (credit / 1000);
+        _refillRemainder  = (uint16_t) (credit % 1000);
+        _lastRefill       = now;
+
+        // At most one full queue of burst
+        if (_tokens > TISR_TELEMETRY_QUEUE_SIZE)
+          _tokens = TISR_TELEMETRY_QUEUE_SIZE;
+
+        if (budget > _tokens)
+          budget = _tokens;
+      }
+
+      int room = out.availableForWrite();
+
+      if ( (room >= 0) && (budget > (uint32_t) room) )
+        budget = room;
+
+      for (uint32_t i = 0; i < budget; i++)
+      {
+        out.write(_queue[_tail]);
+        _tail = (_tail + 1) & (TISR_TELEMETRY_QUEUE_SIZE - 1);
+      }
+
+      if (_bytesPerSecond > 0)
+        _tokens -= budget;
+
+      _bytesSent += budget;
+
+      return (uint16_t) budget;
+    }
+
+    uint16_t getNumQueued() const
+    {
+      return (_head - _tail) & (TISR_TELEMETRY_QUEUE_SIZE - 1);
+    }
+
+    uint32_t getFramesDropped() const
+    {
+      return _framesDropped;
+    }
+
+    ///////////////////////////////////////////
+
+    bool sendStatus()
+    {
+      uint8_t payload[16];
+
+      putLE(&payload[0],  millis(), 4);
+      putLE(&payload[4],  _framesDropped, 4);
+      putLE(&payload[8],  _bytesSent, 4);
+      putLE(&payload[12], TISR_CYCLES_HZ, 4);
+
+      return send(TISR_TELEMETRY_STATUS, payload, sizeof(payload));
+    }
+
+    // periodMs : ISR_Timer interval, or 1000 / frequency of a hardware timer
+    bool sendConfig(const uint8_t& source, const uint8_t& id, const bool& enabled, const float& periodMs)
+    {
+      uint8_t   payload[7];
+      uint32_t  periodBits;
+
+      memcpy(&periodBits, &periodMs, sizeof(periodBits));
+
+      payload[0] = source;
+      payload[1] = id;
+      payload[2] = enabled ? 1 : 0;
+      putLE(&payload[3], periodBits, 4);
+
+      return send(TISR_TELEMETRY_CONFIG, payload, sizeof(payload));
+    }
+
+#if TISR_STATS_ENABLE
+    bool sendStats(const uint8_t& source, const uint8_t& id, const tisr_timer_stats_t& stats)
+    {
+      uint8_t payload[30];
+
+      payload[0] = source;
+      payload[1] = id;
+      putLE(&payload[2],  stats.count, 4);
+      putLE(&payload[6],  stats.missed, 4);
+      putLE(&payload[10], stats.durMin, 4);
+      putLE(&payload[14], TISR_TimerStats::getAvgDuration(stats), 4);
+      putLE(&payload[18], stats.durMax, 4);
+      putLE(&payload[22], (uint32_t) stats.lateMin, 4);
+      putLE(&payload[26], (uint32_t) stats.lateMax, 4);
+
+      return send(TISR_TELEMETRY_STATS, payload, sizeof(payload));
+    }
+#endif
+
+#if TISR_LOAD_ENABLE
+    bool sendLoad(const tisr_load_window_t& window)
+    {
+      uint8_t payload[10];
+
+      putLE(&payload[0], window.windowNumber, 4);
+      putLE(&payload[4], window.cpuLoad, 2);
+      putLE(&payload[6], window.hwTimerLoad, 2);
+      putLE(&payload[8], window.callbackLoad, 2);
+
+      return send(TISR_TELEMETRY_LOAD, payload, sizeof(payload));
+    }
+#endif
+
+#if TISR_TRACE_ENABLE
+    // Streams the whole TISR_Trace ring over the next poll() calls. Recording is paused until it's done
+    void sendTrace()
+    {
+      if (_tracing)
+        return;
+
+      _traceWasPaused = TISR_Trace.isPaused();
+      TISR_Trace.pause();
+
+      _traceNext    = 0;
+      _traceTotal   = TISR_Trace.getNumEvents();
+      _tracing      = true;
+
+      continueTrace();
+    }
+
+    bool isSendingTrace() const
+    {
+      return _tracing;
+    }
+#endif
+
+    bool sendUser(const uint8_t* data, const uint8_t& length)
+    {
+      return send(TISR_TELEMETRY_USER, data, length);
+    }
+
+    ///////////////////////////////////////////
+
+    // Queues one frame, all or nothing
+    bool send(const uint8_t& type, const uint8_t* payload, const uint8_t& length)
+    {
+      if (getFree() < (uint16_t) length + TISR_TELEMETRY_OVERHEAD)
+      {
+        _framesDropped++;
+        return false;
+      }
+
+      uint16_t crc = 0xFFFF;
+
+      push(TISR_TELEMETRY_SYNC0);
+      push(TISR_TELEMETRY_SYNC1);
+
+      crc = pushCRC(type, crc);
+      crc = pushCRC(_sequence++, crc);
+      crc = pushCRC(length, crc);
+
+      for (uint8_t i = 0; i < length; i++)
+        crc = pushCRC(payload[i], crc);
+
+      push( (uint8_t) crc );
+      push( (uint8_t) (crc >> 8) );
+
+      return true;
+    }
+
+  private:
+
+    uint16_t getFree() const
+    {
+      // One slot kept empty to tell full from empty
+      return TISR_TELEMETRY_QUEUE_SIZE - 1 - getNumQueued();
+    }
+
+    void push(const uint8_t& value)
+    {
+      _queue[_head] = value;
+      _head = (_head + 1) & (TISR_TELEMETRY_QUEUE_SIZE - 1);
+    }
+
+    uint16_t pushCRC(const uint8_t& value, uint16_t crc)
+    {
+      push(value);
+
+      crc ^= (uint16_t) value << 8;
+
+      for (uint8_t bit = 0; bit < 8; bit++)
+        crc = (crc & 0x8000) ? ( (crc << 1) ^ 0x1021 ) : (crc << 1);
+
+      return crc;
+    }
+
+    static void putLE(uint8_t* dest, uint32_t value, const uint8_t& numBytes)
+    {
+      for (uint8_t i = 0; i < numBytes; i++)
+      {
+        dest[i] = (uint8_t) value;
+        value >>= 8;
+      }
+    }
+
+#if TISR_TRACE_ENABLE
+    // Queues as many TRACE records as fit right now
+    void continueTrace()
+    {
+      while (_tracing)
+      {
+        uint8_t numEvents = TISR_TELEMETRY_TRACE_EVENTS;
+
+        if (_traceTotal - _traceNext < numEvents)
+          numEvents = _traceTotal - _traceNext;
+
+        if (getFree() < 4 + numEvents * sizeof(tisr_trace_event_t) + TISR_TELEMETRY_OVERHEAD)
+          return;
+
+        uint8_t payload[4 + TISR_TELEMETRY_TRACE_EVENTS * sizeof(tisr_trace_event_t)];
+        uint8_t length = 4;
+
+        putLE(&payload[0], _traceNext, 2);
+        putLE(&payload[2], _traceTotal, 2);
+
+        for (uint8_t i = 0; i < numEvents; i++)
+        {
+          tisr_trace_event_t event;
+
+          TISR_Trace.getEvent(_traceNext + i, event);
+
+          putLE(&payload[length],     event.start, 4);
+          putLE(&payload[length + 4], event.duration, 4);
+          payload[length + 8] = event.type;
+          payload[length + 9] = event.id;
+          putLE(&payload[length + 10], 0, 2);
+
+          length += sizeof(tisr_trace_event_t);
+        }
+
+        send(TISR_TELEMETRY_TRACE, payload, length);
+
+        _traceNext += numEvents;
+
+        if (_traceNext >= _traceTotal)
+        {
+          _tracing = false;
+
+          if (!_traceWasPaused)
+            TISR_Trace.resume();
+        }
+      }
+    }
+#endif
+
+    uint8_t   _queue[TISR_TELEMETRY_QUEUE_SIZE];
+    uint16_t  _head;
+    uint16_t  _tail;
+    uint8_t   _sequence;
+
+    uint32_t  _bytesPerSecond;
+    uint32_t  _tokens;
+    uint32_t  _lastRefill;
+    uint16_t  _refillRemainder;   // In byte.ms / s, below 1000
+
+    uint32_t  _framesDropped;
+    uint32_t  _bytesSent;
+
+    uint16_t  _traceNext;
+    uint16_t  _traceTotal;
+    bool      _traceWasPaused;
+    bool      _tracing;
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_TELEMETRY_INSTANTIATED
+  // To force pre-instatiate only once
+  #define TISR_TELEMETRY_INSTANTIATED
+  TISR_TelemetryStream TISR_Telemetry;
+#endif
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_TELEMETRY_H
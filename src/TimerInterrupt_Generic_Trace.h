@@ -0,0 +1,246 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Trace.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Optional binary event tracing of the hardware timer ISRs, ISR_Timer::run() and every ISR_Timer callback dispatch.
+
+  Define TISR_TRACE_ENABLE true before #include "TimerInterrupt_Generic.h" / "ISR_Timer_Generic.h" to compile the
+  trace points in. Otherwise all TISR_TRACE_xxx macros are empty and there is no RAM or cycle cost at all.
+
+  Each event is one complete span (start timestamp, duration, event type, id) written into a fixed-size ring in RAM
+  when the span ends, so nested ISRs show up as nested spans. The ring overwrites its oldest events (flight recorder),
+  dump() streams it over any Print / Stream, and extras/trace/tisr_trace2json converts dumps to Chrome trace JSON
+  to be opened in Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+
+  Dump format, all fields little-endian :
+    header : "TTRC", uint8_t version, uint8_t eventSize, uint16_t numEvents, uint32_t timestamp Hz
+    events : numEvents * { uint32_t start, uint32_t duration, uint8_t type, uint8_t id, uint16_t reserved }, oldest first
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_TRACE_H
+#define TIMERINTERRUPT_GENERIC_TRACE_H
+
+#ifndef TISR_TRACE_ENABLE
+  #define TISR_TRACE_ENABLE     false
+#endif
+
+// Event types, shared with the host decoder
+#define TISR_TRACE_HW_TIMER         1     // Hardware timer ISR callback, id = hardware timer number
+#define TISR_TRACE_RUN              2     // ISR_Timer::run(), id = 0
+#define TISR_TRACE_CALLBACK         3     // ISR_Timer callback dispatch, id = ISR_Timer slot (0 - 15)
+#define TISR_TRACE_USER             4     // User span, from TISR_TRACE_BEGIN / TISR_TRACE_END in user code
+
+#define TISR_TRACE_VERSION          1
+
+///////////////////////////////////////////
+
+#if TISR_TRACE_ENABLE
+
+#include "TimerInterrupt_Generic_Cycles.h"
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#if (TISR_CYCLES_MASK != 0xFFFFFFFFUL)
+  #warning TISR_CYCLES() is narrower than 32 bits, trace timestamps will wrap faster than the host decoder can unwrap them
+#endif
+
+#ifndef TISR_TRACE_BUFFER_SIZE
+  #if defined(__AVR__) || defined(ARDUINO_ARCH_MEGAAVR)
+    // 32 * 12 = 384 bytes of RAM
+    #define TISR_TRACE_BUFFER_SIZE      32
+  #else
+    // 512 * 12 = 6KB of RAM
+    #define TISR_TRACE_BUFFER_SIZE      512
+  #endif
+#endif
+
+#if ( (TISR_TRACE_BUFFER_SIZE & (TISR_TRACE_BUFFER_SIZE - 1)) != 0 ) || (TISR_TRACE_BUFFER_SIZE > 32768)
+  #error TISR_TRACE_BUFFER_SIZE must be a power of 2, up to 32768
+#endif
+
+///////////////////////////////////////////
+
+typedef struct
+{
+  uint32_t  start;        // TISR_CYCLES() at span start
+  uint32_t  duration;     // TISR_CYCLES() counts
+  uint8_t   type;         // TISR_TRACE_xxx
+  uint8_t   id;
+  uint16_t  reserved;
+} tisr_trace_event_t;
+
+///////////////////////////////////////////
+
+class TISR_TraceBuffer
+{
+  public:
+
+    TISR_TraceBuffer() : _head(0), _full(false), _paused(false)
+    {
+      TISR_ATOMIC_MUX_INIT(_lock);
+    }
+
+    void TISR_ATOMIC_IRAM_ATTR begin()
+    {
+      tisr_cycles_init();
+      clear();
+    }
+
+    void TISR_ATOMIC_IRAM_ATTR clear()
+    {
+      TISR_ATOMIC_ENTER(_lock);
+
+      _head = 0;
+      _full = false;
+
+      TISR_ATOMIC_EXIT(_lock);
+    }
+
+    // Stop / restart recording, e.g. to freeze the ring right after a deadline miss is detected
+    void pause()
+    {
+      _paused = true;
+    }
+
+    void resume()
+    {
+      _paused = false;
+    }
+
+    ///////////////////////////////////////////
+
+    // Called by the TISR_TRACE_END macro when a span ends. Safe from any ISR
+    void TISR_ATOMIC_IRAM_ATTR record(const uint8_t& type, const uint8_t& id, const tisr_cycles_t& start, const tisr_cycles_t& end)
+    {
+      if (_paused)
+        return;
+
+      TISR_ATOMIC_ENTER(_lock);
+
+      uint16_t index = _head;
+
+      _head = (index + 1) & (TISR_TRACE_BUFFER_SIZE - 1);
+
+      if (_head == 0)
+        _full = true;
+
+      TISR_ATOMIC_EXIT(_lock);
+
+      // The slot is owned by this writer now, fill it with interrupts enabled
+      tisr_trace_event_t* event = (tisr_trace_event_t*) &_events[index];
+
+      event->start    = start;
+      event->duration = TISR_CYCLES_ELAPSED(start, end);
+      event->type     = type;
+      event->id       = id;
+    }
+
+    uint16_t getNumEvents() const
+    {
+      return _full ? TISR_TRACE_BUFFER_SIZE : _head;
+    }
+
+    // Copies event number index, 0 = oldest. Pause recording while reading several events, so they stay consistent
+    bool getEvent(const uint16_t& index, tisr_trace_event_t& event) const
+    {
+      if (index >= getNumEvents())
+        return false;
+
+      const volatile tisr_trace_event_t* source = &_events[ ( (_full ? _head : 0) + index ) & (TISR_TRACE_BUFFER_SIZE - 1) ];
+
+      event.start     = source->start;
+      event.duration  = source->duration;
+      event.type      = source->type;
+      event.id        = source->id;
+      event.reserved  = 0;
+
+      return true;
+    }
+
+    bool isPaused() const
+    {
+      return _paused;
+    }
+
+    ///////////////////////////////////////////
+
+    // Streams the ring, oldest event first. Recording is paused meanwhile and restored afterwards
+    void dump(Print& out)
+    {
+      bool wasPaused = _paused;
+
+      _paused = true;
+
+      uint16_t numEvents  = getNumEvents();
+      uint16_t index      = _full ? _head : 0;
+      uint32_t hz         = TISR_CYCLES_HZ;
+
+      out.write((const uint8_t*) "TTRC", 4);
+      out.write((uint8_t) TISR_TRACE_VERSION);
+      out.write((uint8_t) sizeof(tisr_trace_event_t));
+      writeLE(out, numEvents, 2);
+      writeLE(out, hz, 4);
+
+      for (uint16_t i = 0; i < numEvents; i++)
+      {
+        const tisr_trace_event_t* event = (const tisr_trace_event_t*) &_events[index];
+
+        writeLE(out, event->start, 4);
+        writeLE(out, event->duration, 4);
+        out.write(event->type);
+        out.write(event->id);
+        writeLE(out, 0, 2);
+
+        index = (index + 1) & (TISR_TRACE_BUFFER_SIZE - 1);
+      }
+
+      _paused = wasPaused;
+    }
+
+  private:
+
+    static void writeLE(Print& out, uint32_t value, const uint8_t& numBytes)
+    {
+      for (uint8_t i = 0; i < numBytes; i++)
+      {
+        out.write((uint8_t) value);
+        value >>= 8;
+      }
+    }
+
+    volatile tisr_trace_event_t   _events[TISR_TRACE_BUFFER_SIZE];
+    volatile uint16_t             _head;
+    volatile bool                 _full;
+    volatile bool                 _paused;
+
+    // Writers can be ISRs of different priorities (and both cores on ESP32), so claiming a slot must be atomic
+    TISR_ATOMIC_MUX(_lock);
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_TRACE_INSTANTIATED
+  // To force pre-instatiate only once
+  #define TISR_TRACE_INSTANTIATED
+  TISR_TraceBuffer TISR_Trace;
+#endif
+
+///////////////////////////////////////////
+
+#define TISR_TRACE_BEGIN(start)               tisr_cycles_t start = TISR_CYCLES()
+#define TISR_TRACE_END(type, id, start)       TISR_Trace.record((type), (id), (start), TISR_CYCLES())
+
+#else   // TISR_TRACE_ENABLE
+
+#define TISR_TRACE_BEGIN(start)
+#define TISR_TRACE_END(type, id, start)
+
+#endif  // TISR_TRACE_ENABLE
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_TRACE_H
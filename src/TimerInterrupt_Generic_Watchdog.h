@@ -0,0 +1,461 @@
+/****************************************************************************************************************************
+  TimerInterrupt_Generic_Watchdog.h
+  For Generic boards
+
+  Built by Khoi Hoang https://github.com/khoih-prog/TimerInterrupt_Generic
+  Licensed under MIT license
+
+  Optional execution-budget watchdog for the hardware timer callbacks and the ISR_Timer callbacks.
+
+  Define TISR_WATCHDOG_ENABLE true before #include "TimerInterrupt_Generic.h" / "ISR_Timer_Generic.h" to compile it in.
+  Otherwise all TISR_WATCHDOG_xxx macros are empty and there is no RAM or cycle cost.
+
+  setBudget() gives a source (TISR_WATCHDOG_HW_TIMER(n) or TISR_WATCHDOG_CALLBACK(n)) a time budget and the action
+  taken when a dispatch of it goes over budget :
+    TISR_WATCHDOG_LOG   : the violation is recorded, see getNumViolations() / getLastViolation() and setCallback()
+    TISR_WATCHDOG_SKIP  : recorded, and the next invocations of the source are skipped until unskip() / reset()
+    TISR_WATCHDOG_RESET : recorded, then the MCU is reset. After reboot, getResetSource() names the offender
+
+  Overruns are detected in three ways :
+  1) On exit of every dispatch, after the fact. Enough for callbacks which are just too slow
+  2) By check(), called from a periodic ISR of higher priority than the timer being watched (e.g. a second hardware
+     timer with a higher NVIC priority on ARM). It catches a callback which never returns, while it is still running.
+     check() can't preempt anything on AVR, nor a dispatch from the same core in ISR_Timer::run() on ESP32. On the
+     dual core ESP32 and RP2040, the running dispatch is kept per core, and check() from either core watches both
+  3) On AVR, with TISR_WATCHDOG_USE_WDT, the hardware watchdog is armed at the start of every budgeted dispatch and
+     disarmed at its end. A callback stuck for TISR_WATCHDOG_WDT_TIMEOUT resets the MCU, and getResetSource() names it.
+     Don't use the WDT in the sketch then
+
+  getResetSource() needs RAM left alone by the startup code, available on AVR and ESP32 (TISR_WATCHDOG_NOINIT).
+  On AVR without TISR_CYCLES_AVR_USE_TIMER1, micros() doesn't advance for long inside an ISR, so exit checks under
+  estimate overruns of more than ~1ms. Budgets must be shorter than one TISR_CYCLES() wrap.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef TIMERINTERRUPT_GENERIC_WATCHDOG_H
+#define TIMERINTERRUPT_GENERIC_WATCHDOG_H
+
+#ifndef TISR_WATCHDOG_ENABLE
+  #define TISR_WATCHDOG_ENABLE  false
+#endif
+
+// Actions
+#define TISR_WATCHDOG_LOG                 0
+#define TISR_WATCHDOG_SKIP                1
+#define TISR_WATCHDOG_RESET               2
+
+#define TISR_WATCHDOG_MAX_HW_TIMERS       8
+#define TISR_WATCHDOG_MAX_CALLBACKS       16
+
+#define TISR_WATCHDOG_HW_TIMER(timerNo)   ( (timerNo) % TISR_WATCHDOG_MAX_HW_TIMERS )
+#define TISR_WATCHDOG_CALLBACK(numTimer)  ( TISR_WATCHDOG_MAX_HW_TIMERS + ( (numTimer) % TISR_WATCHDOG_MAX_CALLBACKS ) )
+
+#define TISR_WATCHDOG_NUM_SOURCES         ( TISR_WATCHDOG_MAX_HW_TIMERS + TISR_WATCHDOG_MAX_CALLBACKS )
+
+// No dispatch running
+#define TISR_WATCHDOG_NO_SOURCE           0xFF
+
+///////////////////////////////////////////
+
+#if TISR_WATCHDOG_ENABLE
+
+#include "TimerInterrupt_Generic_Cycles.h"
+#include "TimerInterrupt_Generic_Atomic.h"
+
+#if defined(__AVR__) && !defined(ARDUINO_ARCH_MEGAAVR)
+  #include <avr/wdt.h>
+#endif
+
+#if defined(__AVR__) && defined(MCUSR)
+
+  #ifndef TISR_WATCHDOG_USE_WDT
+    #define TISR_WATCHDOG_USE_WDT         false
+  #endif
+
+  #ifndef TISR_WATCHDOG_WDT_TIMEOUT
+    #define TISR_WATCHDOG_WDT_TIMEOUT     WDTO_30MS
+  #endif
+
+#else
+
+  #undef  TISR_WATCHDOG_USE_WDT
+  #define TISR_WATCHDOG_USE_WDT           false
+
+#endif
+
+#ifndef TISR_WATCHDOG_NOINIT
+  #if defined(__AVR__)
+    #define TISR_WATCHDOG_NOINIT          __attribute__((section(".noinit")))
+  #elif ( defined(ESP32) || ESP32 ) && defined(__NOINIT_ATTR)
+    #define TISR_WATCHDOG_NOINIT          __NOINIT_ATTR
+  #else
+    // Zeroed at boot, getResetSource() never reports anything
+    #define TISR_WATCHDOG_NOINIT
+  #endif
+#endif
+
+#define TISR_WATCHDOG_MAGIC               0x57444F47UL
+
+// Each core runs its own dispatches, nested or not
+#if ( defined(ESP32) || ESP32 ) && defined(portNUM_PROCESSORS)
+  #define TISR_WATCHDOG_NUM_CORES         portNUM_PROCESSORS
+  #define TISR_WATCHDOG_CORE_ID()         xPortGetCoreID()
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+  #define TISR_WATCHDOG_NUM_CORES         2
+  #define TISR_WATCHDOG_CORE_ID()         get_core_num()
+#else
+  #define TISR_WATCHDOG_NUM_CORES         1
+  #define TISR_WATCHDOG_CORE_ID()         0
+#endif
+
+///////////////////////////////////////////
+
+// Called on every violation, from the ISR which detected it
+typedef void (*tisr_watchdog_callback)(uint8_t source, uint32_t elapsedUs);
+
+typedef struct
+{
+  uint8_t   source;         // TISR_WATCHDOG_HW_TIMER(n) / TISR_WATCHDOG_CALLBACK(n)
+  uint8_t   action;         // TISR_WATCHDOG_xxx
+  uint32_t  elapsedUs;      // When detected, the dispatch may still be running
+  uint32_t  millis;
+} tisr_watchdog_violation_t;
+
+// Previous dispatch state, kept on the stack by TISR_WATCHDOG_BEGIN so nested dispatches restore it
+typedef struct
+{
+  uint8_t         source;
+  bool            tripped;
+  bool            armedWDT;       // This dispatch armed the hardware watchdog
+  tisr_cycles_t   start;
+} tisr_watchdog_frame_t;
+
+// Survives a reset in TISR_WATCHDOG_NOINIT RAM
+typedef struct
+{
+  uint32_t  magic;
+  uint8_t   source;
+} tisr_watchdog_persist_t;
+
+extern tisr_watchdog_persist_t TISR_WatchdogPersist;
+
+///////////////////////////////////////////
+
+static inline void tisr_watchdog_system_reset()
+{
+#if defined(ARDUINO_ARCH_MEGAAVR)
+
+  _PROTECTED_WRITE(RSTCTRL.SWRR, RSTCTRL_SWRE_bm);
+
+#elif defined(__AVR__)
+
+  wdt_enable(WDTO_15MS);
+
+  for (;;);
+
+#elif ( defined(ESP32) || ESP32 )
+
+  esp_restart();
+
+#elif ( defined(ESP8266) || ESP8266 )
+
+  ESP.reset();
+
+#elif defined(__arm__)
+
+  // SCB->AIRCR = VECTKEY | SYSRESETREQ, same as NVIC_SystemReset()
+  __asm__ volatile ("dsb 0xF" ::: "memory");
+  ( *(volatile uint32_t *) 0xE000ED0CUL ) = 0x05FA0004UL;
+  __asm__ volatile ("dsb 0xF" ::: "memory");
+
+  for (;;);
+
+#endif
+}
+
+///////////////////////////////////////////
+
+class TISR_ExecWatchdog
+{
+  public:
+
+    TISR_ExecWatchdog() : _armedWDT(false), _skipped(0), _numViolations(0), _callback(NULL),
+      _resetSource(TISR_WATCHDOG_NO_SOURCE)
+    {
+      TISR_ATOMIC_MUX_INIT(_lock);
+
+      for (uint8_t core = 0; core < TISR_WATCHDOG_NUM_CORES; core++)
+      {
+        _activeSource[core] = TISR_WATCHDOG_NO_SOURCE;
+        _activeStart[core]  = 0;
+        _tripped[core]      = false;
+      }
+
+      for (uint8_t i = 0; i < TISR_WATCHDOG_NUM_SOURCES; i++)
+      {
+        _budget[i] = 0;
+        _action[i] = TISR_WATCHDOG_LOG;
+      }
+    }
+
+    // Call first thing in setup() : reads what the last reset left in TISR_WATCHDOG_NOINIT RAM
+    void begin()
+    {
+#if TISR_WATCHDOG_USE_WDT
+      // After a WDT reset, the WDT stays enabled with its shortest timeout
+      MCUSR &= ~_BV(WDRF);
+      wdt_disable();
+#endif
+
+      if (TISR_WatchdogPersist.magic == TISR_WATCHDOG_MAGIC)
+        _resetSource = TISR_WatchdogPersist.source;
+      else
+        _resetSource = TISR_WATCHDOG_NO_SOURCE;
+
+      TISR_WatchdogPersist.magic  = TISR_WATCHDOG_MAGIC;
+      TISR_WatchdogPersist.source = TISR_WATCHDOG_NO_SOURCE;
+    }
+
+    // budgetUs = 0 : no budget
+    void setBudget(const uint8_t& source, const uint32_t& budgetUs, const uint8_t& action = TISR_WATCHDOG_LOG)
+    {
+      if (source >= TISR_WATCHDOG_NUM_SOURCES)
+        return;
+
+      _budget[source] = (uint32_t) ( ( (uint64_t) budgetUs * TISR_CYCLES_HZ ) / 1000000UL );
+      _action[source] = action;
+    }
+
+    void setCallback(tisr_watchdog_callback callback)
+    {
+      _callback = callback;
+    }
+
+    ///////////////////////////////////////////
+
+    // Called by TISR_WATCHDOG_BEGIN when a dispatch starts
+    tisr_watchdog_frame_t TISR_ATOMIC_IRAM_ATTR onEntry(const uint8_t& source)
+    {
+      tisr_watchdog_frame_t previous;
+
+      uint8_t core = TISR_WATCHDOG_CORE_ID();
+
+      previous.source   = _activeSource[core];
+      previous.tripped  = _tripped[core];
+      previous.start    = _activeStart[core];
+      previous.armedWDT = false;
+
+      // check() ignores the dispatch while it is being switched
+      _activeSource[core] = TISR_WATCHDOG_NO_SOURCE;
+      _tripped[core]      = false;
+      _activeStart[core]  = TISR_CYCLES();
+      _activeSource[core] = source;
+
+      TISR_WatchdogPersist.source = source;
+
+#if TISR_WATCHDOG_USE_WDT
+      // Armed by the outermost budgeted dispatch, e.g. an ISR_Timer callback inside the hardware timer ISR
+      if ( !_armedWDT && (_budget[source] != 0) )
+      {
+        wdt_enable(TISR_WATCHDOG_WDT_TIMEOUT);
+
+        _armedWDT         = true;
+        previous.armedWDT = true;
+      }
+#endif
+
+      return previous;
+    }
+
+    // Called by TISR_WATCHDOG_END when the dispatch returns
+    void TISR_ATOMIC_IRAM_ATTR onExit(const uint8_t& source, const tisr_watchdog_frame_t& previous)
+    {
+      // An ISR doesn't move to the other core
+      uint8_t       core    = TISR_WATCHDOG_CORE_ID();
+      tisr_cycles_t elapsed = TISR_CYCLES_ELAPSED(_activeStart[core], TISR_CYCLES());
+
+#if TISR_WATCHDOG_USE_WDT
+      if (previous.armedWDT)
+      {
+        wdt_disable();
+
+        _armedWDT = false;
+      }
+#endif
+
+      if (!_tripped[core] && (_budget[source] != 0) && (elapsed > _budget[source]))
+        violation(source, elapsed);
+
+      _activeSource[core] = TISR_WATCHDOG_NO_SOURCE;
+      _tripped[core]      = previous.tripped;
+      _activeStart[core]  = previous.start;
+      _activeSource[core] = previous.source;
+
+      TISR_WatchdogPersist.source = previous.source;
+    }
+
+    // Call from a periodic ISR of higher priority than the watched timers. Checks the dispatch running on each core
+    void TISR_ATOMIC_IRAM_ATTR check()
+    {
+      for (uint8_t core = 0; core < TISR_WATCHDOG_NUM_CORES; core++)
+      {
+        uint8_t         source  = _activeSource[core];
+        tisr_cycles_t   start   = _activeStart[core];
+
+        // Dispatch switched meanwhile
+        if ( (source == TISR_WATCHDOG_NO_SOURCE) || (source != _activeSource[core]) || _tripped[core] )
+          continue;
+
+        tisr_cycles_t elapsed = TISR_CYCLES_ELAPSED(start, TISR_CYCLES());
+
+        if ( (_budget[source] != 0) && (elapsed > _budget[source]) )
+        {
+          // Reported once per dispatch
+          _tripped[core] = true;
+          violation(source, elapsed);
+        }
+      }
+    }
+
+    ///////////////////////////////////////////
+
+    bool isSkipped(const uint8_t& source) const
+    {
+      return (_skipped & ( 1UL << source )) != 0;
+    }
+
+    void unskip(const uint8_t& source)
+    {
+      TISR_ATOMIC_ENTER(_lock);
+
+      _skipped &= ~( 1UL << source );
+
+      TISR_ATOMIC_EXIT(_lock);
+    }
+
+    // Clears the violations and the skipped sources, keeps the budgets
+    void reset()
+    {
+      TISR_ATOMIC_ENTER(_lock);
+
+      _skipped        = 0;
+      _numViolations  = 0;
+
+      TISR_ATOMIC_EXIT(_lock);
+    }
+
+    uint32_t getNumViolations() const
+    {
+      return _numViolations;
+    }
+
+    // Returns false if there was no violation yet
+    bool getLastViolation(tisr_watchdog_violation_t& violation)
+    {
+      TISR_ATOMIC_ENTER(_lock);
+
+      violation.source    = _last.source;
+      violation.action    = _last.action;
+      violation.elapsedUs = _last.elapsedUs;
+      violation.millis    = _last.millis;
+
+      bool valid = (_numViolations != 0);
+
+      TISR_ATOMIC_EXIT(_lock);
+
+      return valid;
+    }
+
+    // Source whose dispatch was running when the MCU was last reset (watchdog action, hardware watchdog, crash, ...),
+    // TISR_WATCHDOG_NO_SOURCE if none or unknown. Valid after begin()
+    uint8_t getResetSource() const
+    {
+      return _resetSource;
+    }
+
+  private:
+
+    void TISR_ATOMIC_IRAM_ATTR violation(const uint8_t& source, const tisr_cycles_t& elapsed)
+    {
+      uint32_t elapsedUs = tisr_cycles_to_us(elapsed);
+
+      TISR_ATOMIC_ENTER(_lock);
+
+      _numViolations++;
+
+      _last.source    = source;
+      _last.action    = _action[source];
+      _last.elapsedUs = elapsedUs;
+      _last.millis    = millis();
+
+      if (_action[source] == TISR_WATCHDOG_SKIP)
+        _skipped |= ( 1UL << source );
+
+      TISR_ATOMIC_EXIT(_lock);
+
+      if (_callback)
+        _callback(source, elapsedUs);
+
+      if (_action[source] == TISR_WATCHDOG_RESET)
+      {
+        // TISR_WatchdogPersist.source is the innermost running dispatch, make sure it names the offender
+        TISR_WatchdogPersist.source = source;
+
+        tisr_watchdog_system_reset();
+
+        // No reset on this platform, fall back to skipping
+        _skipped |= ( 1UL << source );
+      }
+    }
+
+    volatile uint32_t               _budget[TISR_WATCHDOG_NUM_SOURCES];    // TISR_CYCLES() counts
+    uint8_t                         _action[TISR_WATCHDOG_NUM_SOURCES];
+
+    // Running dispatch, per core
+    volatile uint8_t                _activeSource[TISR_WATCHDOG_NUM_CORES];
+    volatile tisr_cycles_t          _activeStart[TISR_WATCHDOG_NUM_CORES];
+    volatile bool                   _tripped[TISR_WATCHDOG_NUM_CORES];
+
+    volatile bool                   _armedWDT;          // AVR only, single core
+
+    volatile uint32_t               _skipped;           // Bit per source
+    volatile uint32_t               _numViolations;
+    tisr_watchdog_violation_t       _last;
+
+    tisr_watchdog_callback          _callback;
+
+    uint8_t                         _resetSource;
+
+    // Violations can be detected by ISRs of different priorities (and both cores on ESP32)
+    TISR_ATOMIC_MUX(_lock);
+};
+
+///////////////////////////////////////////
+
+#ifndef TISR_WATCHDOG_INSTANTIATED
+  // To force pre-instatiate only once
+  #define TISR_WATCHDOG_INSTANTIATED
+  // Written on every dispatch entry / exit, read back by begin() after a reset
+  tisr_watchdog_persist_t TISR_WatchdogPersist TISR_WATCHDOG_NOINIT;
+  TISR_ExecWatchdog TISR_Watchdog;
+#endif
+
+///////////////////////////////////////////
+
+#define TISR_WATCHDOG_BEGIN(source, frame)        tisr_watchdog_frame_t frame = TISR_Watchdog.onEntry(source)
+#define TISR_WATCHDOG_END(source, frame)          TISR_Watchdog.onExit((source), (frame))
+#define TISR_WATCHDOG_SKIPPED(source)             TISR_Watchdog.isSkipped(source)
+
+#else   // TISR_WATCHDOG_ENABLE
+
+#define TISR_WATCHDOG_BEGIN(source, frame)
+#define TISR_WATCHDOG_END(source, frame)
+#define TISR_WATCHDOG_SKIPPED(source)             false
+
+#endif  // TISR_WATCHDOG_ENABLE
+
+///////////////////////////////////////////
+
+#endif    // TIMERINTERRUPT_GENERIC_WATCHDOG_H
@@ -395,6 +395,9 @@ class TimerInterrupt
         noInterrupts();
 
         _frequency = frequency;
+
+        TISR_STATS_HW_SET_FREQUENCY(_timer, frequency);
+
         _callback  = (void*) callback;
         _params    = reinterpret_cast<void*>(params);
 
@@ -697,7 +700,20 @@ class TimerInterrupt
           {  
             TISR_LOGDEBUG3(("T0 callback, _CCMPValueRemaining ="), ITimer0.get_CCMPValueRemaining(), (", millis ="), millis());
             
-            ITimer0.callback();
+            TISR_TRACE_BEGIN(traceStart);
+            TISR_STATS_HW_BEGIN(0, statsStart);
+            TISR_LOAD_BEGIN(loadStart);
+            TISR_STACK_BEGIN(stackStart);
+            TISR_WATCHDOG_BEGIN(TISR_WATCHDOG_HW_TIMER(0), watchdogFrame);
+
+            if (!TISR_WATCHDOG_SKIPPED(TISR_WATCHDOG_HW_TIMER(0)))
+              ITimer0.callback();
+
+            TISR_WATCHDOG_END(TISR_WATCHDOG_HW_TIMER(0), watchdogFrame);
+            TISR_STACK_END(TISR_STACK_HW_TIMER(0), stackStart);
+            TISR_LOAD_END(TISR_LOAD_HW_TIMER, loadStart);
+            TISR_STATS_HW_END(0, statsStart);
+            TISR_TRACE_END(TISR_TRACE_HW_TIMER, 0, traceStart);
             
             // To reload _CCMPValueRemaining as well as _CCMP register to MAX_COUNT_16BIT
             if (ITimer0.get_CCMPValue() > MAX_COUNT_16BIT)            
@@ -754,7 +770,20 @@ class TimerInterrupt
         {
           TISR_LOGDEBUG3(("T1 callback, _CCMPValueRemaining ="), ITimer1.get_CCMPValueRemaining(), (", millis ="), millis());
           
-          ITimer1.callback();
+          TISR_TRACE_BEGIN(traceStart);
+          TISR_STATS_HW_BEGIN(1, statsStart);
+          TISR_LOAD_BEGIN(loadStart);
+          TISR_STACK_BEGIN(stackStart);
+          TISR_WATCHDOG_BEGIN(TISR_WATCHDOG_HW_TIMER(1), watchdogFrame);
+
+          if (!TISR_WATCHDOG_SKIPPED(TISR_WATCHDOG_HW_TIMER(1)))
+            ITimer1.callback();
+
+          TISR_WATCHDOG_END(TISR_WATCHDOG_HW_TIMER(1), watchdogFrame);
+          TISR_STACK_END(TISR_STACK_HW_TIMER(1), stackStart);
+          TISR_LOAD_END(TISR_LOAD_HW_TIMER, loadStart);
+          TISR_STATS_HW_END(1, statsStart);
+          TISR_TRACE_END(TISR_TRACE_HW_TIMER, 1, traceStart);
           
           // To reload _CCMPValueRemaining as well as _CCMP register to MAX_COUNT_16BIT if _CCMPValueRemaining > MAX_COUNT_16BIT
           if (ITimer1.get_CCMPValue() > MAX_COUNT_16BIT)
@@ -807,7 +836,20 @@ class TimerInterrupt
         {
           TISR_LOGDEBUG3(("T2 callback, _CCMPValueRemaining ="), ITimer2.get_CCMPValueRemaining(), (", millis ="), millis());
            
-          ITimer2.callback();
+          TISR_TRACE_BEGIN(traceStart);
+          TISR_STATS_HW_BEGIN(2, statsStart);
+          TISR_LOAD_BEGIN(loadStart);
+          TISR_STACK_BEGIN(stackStart);
+          TISR_WATCHDOG_BEGIN(TISR_WATCHDOG_HW_TIMER(2), watchdogFrame);
+
+          if (!TISR_WATCHDOG_SKIPPED(TISR_WATCHDOG_HW_TIMER(2)))
+            ITimer2.callback();
+
+          TISR_WATCHDOG_END(TISR_WATCHDOG_HW_TIMER(2), watchdogFrame);
+          TISR_STACK_END(TISR_STACK_HW_TIMER(2), stackStart);
+          TISR_LOAD_END(TISR_LOAD_HW_TIMER, loadStart);
+          TISR_STATS_HW_END(2, statsStart);
+          TISR_TRACE_END(TISR_TRACE_HW_TIMER, 2, traceStart);
           
           // To reload _CCMPValueRemaining as well as _CCMP register to MAX_COUNT_16BIT if _CCMPValueRemaining > MAX_COUNT_16BIT
           if (ITimer2.get_CCMPValue() > MAX_COUNT_16BIT)
@@ -861,7 +903,20 @@ class TimerInterrupt
           { 
             TISR_LOGDEBUG3(("T3 callback, _CCMPValueRemaining ="), ITimer3.get_CCMPValueRemaining(), (", millis ="), millis());
             
-            ITimer3.callback();
+            TISR_TRACE_BEGIN(traceStart);
+            TISR_STATS_HW_BEGIN(3, statsStart);
+            TISR_LOAD_BEGIN(loadStart);
+            TISR_STACK_BEGIN(stackStart);
+            TISR_WATCHDOG_BEGIN(TISR_WATCHDOG_HW_TIMER(3), watchdogFrame);
+
+            if (!TISR_WATCHDOG_SKIPPED(TISR_WATCHDOG_HW_TIMER(3)))
+              ITimer3.callback();
+
+            TISR_WATCHDOG_END(TISR_WATCHDOG_HW_TIMER(3), watchdogFrame);
+            TISR_STACK_END(TISR_STACK_HW_TIMER(3), stackStart);
+            TISR_LOAD_END(TISR_LOAD_HW_TIMER, loadStart);
+            TISR_STATS_HW_END(3, statsStart);
+            TISR_TRACE_END(TISR_TRACE_HW_TIMER, 3, traceStart);
             
             // To reload _CCMPValueRemaining as well as _CCMP register to MAX_COUNT_16BIT if _CCMPValueRemaining > MAX_COUNT_16BIT
             if (ITimer3.get_CCMPValue() > MAX_COUNT_16BIT)